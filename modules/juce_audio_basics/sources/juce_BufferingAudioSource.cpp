@@ -50,9 +50,11 @@ BufferingAudioSource::~BufferingAudioSource()
 void BufferingAudioSource::prepareToPlay (int samplesPerBlockExpected, double newSampleRate)
 {
     auto bufferSizeNeeded = jmax (samplesPerBlockExpected * 2, numberOfSamplesToBuffer);
+    auto newChunkSize = jlimit (128, 2048, bufferSizeNeeded / 8);
+    auto numChunks = (bufferSizeNeeded + newChunkSize - 1) / newChunkSize;
 
     if (newSampleRate != sampleRate
-         || bufferSizeNeeded != buffer.getNumSamples()
+         || numChunks * newChunkSize != buffer.getNumSamples()
          || ! isPrepared)
     {
         backgroundThread.removeTimeSliceClient (this);
@@ -62,21 +64,36 @@ void BufferingAudioSource::prepareToPlay (int samplesPerBlockExpected, double ne
 
         source->prepareToPlay (samplesPerBlockExpected, newSampleRate);
 
-        buffer.setSize (numberOfChannels, bufferSizeNeeded);
+        chunkSize = newChunkSize;
+        buffer.setSize (numberOfChannels, numChunks * chunkSize);
         buffer.clear();
 
-        bufferValidStart = 0;
-        bufferValidEnd = 0;
+        chunkInfo.calloc ((size_t) numChunks);
+        freeChunks.reset (new SPSCQueue<int> (numChunks));
+        filledChunks.reset (new SPSCQueue<int> (numChunks));
+        currentChunk = -1;
+
+        for (int i = 0; i < numChunks; ++i)
+            freeChunks->push (i);
+
+        // makes the background thread start again from the current position
+        ++generation;
 
         backgroundThread.addTimeSliceClient (this);
 
+        auto getNumSamplesBuffered = [this]
+        {
+            const SpinLock::ScopedLockType sl (bufferedRangeLock);
+            return bufferedGeneration == generation.load() ? bufferedEnd - bufferedStart : 0;
+        };
+
         do
         {
             backgroundThread.moveToFrontOfQueue (this);
             Thread::sleep (5);
         }
         while (prefillBuffer
-         && (bufferValidEnd - bufferValidStart < jmin (((int) newSampleRate) / 4, buffer.getNumSamples() / 2)));
+         && (getNumSamplesBuffered() < jmin (((int) newSampleRate) / 4, buffer.getNumSamples() / 2)));
     }
 }
 
@@ -86,6 +103,9 @@ void BufferingAudioSource::releaseResources()
     backgroundThread.removeTimeSliceClient (this);
 
     buffer.setSize (numberOfChannels, 0);
+    freeChunks.reset();
+    filledChunks.reset();
+    currentChunk = -1;
 
     // MSVC2015 seems to need this if statement to not generate a warning during linking.
     // As source is set in the constructor, there is no way that source could
@@ -96,65 +116,75 @@ void BufferingAudioSource::releaseResources()
 
 void BufferingAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& info)
 {
-    const ScopedLock sl (bufferStartPosLock);
-
-    auto start = bufferValidStart.load();
-    auto end   = bufferValidEnd.load();
-    auto pos   = nextPlayPos.load();
-
-    auto validStart = (int) (jlimit (start, end, pos) - pos);
-    auto validEnd   = (int) (jlimit (start, end, pos + info.numSamples) - pos);
-
-    if (validStart == validEnd)
+    if (filledChunks == nullptr)
     {
-        // total cache miss
         info.clearActiveBufferRegion();
+        return;
     }
-    else
-    {
-        if (validStart > 0)
-            info.buffer->clear (info.startSample, validStart);  // partial cache miss at start
 
-        if (validEnd < info.numSamples)
-            info.buffer->clear (info.startSample + validEnd,
-                                info.numSamples - validEnd);    // partial cache miss at end
+    auto currentGeneration = generation.load();
+    auto pos = nextPlayPos.load();
+    int numDone = 0;
+
+    while (numDone < info.numSamples && findCurrentChunk (pos + numDone, currentGeneration))
+    {
+        auto& chunk = chunkInfo[currentChunk];
+        auto offset = pos + numDone - chunk.start;
 
-        if (validStart < validEnd)
+        if (offset < 0)
         {
-            for (int chan = jmin (numberOfChannels, info.buffer->getNumChannels()); --chan >= 0;)
-            {
-                jassert (buffer.getNumSamples() > 0);
-                auto startBufferIndex = (int) ((validStart + nextPlayPos) % buffer.getNumSamples());
-                auto endBufferIndex   = (int) ((validEnd + nextPlayPos)   % buffer.getNumSamples());
-
-                if (startBufferIndex < endBufferIndex)
-                {
-                    info.buffer->copyFrom (chan, info.startSample + validStart,
-                                           buffer,
-                                           chan, startBufferIndex,
-                                           validEnd - validStart);
-                }
-                else
-                {
-                    auto initialSize = buffer.getNumSamples() - startBufferIndex;
-
-                    info.buffer->copyFrom (chan, info.startSample + validStart,
-                                           buffer,
-                                           chan, startBufferIndex,
-                                           initialSize);
-
-                    info.buffer->copyFrom (chan, info.startSample + validStart + initialSize,
-                                           buffer,
-                                           chan, 0,
-                                           (validEnd - validStart) - initialSize);
-                }
-            }
+            // the next chunk starts later on, so there's a gap to fill
+            auto numToClear = (int) jmin ((int64) (info.numSamples - numDone), -offset);
+            info.buffer->clear (info.startSample + numDone, numToClear);
+            numDone += numToClear;
+            continue;
         }
 
-        nextPlayPos += info.numSamples;
+        auto numToCopy = jmin (info.numSamples - numDone, chunk.numSamples - (int) offset);
+
+        for (int chan = jmin (numberOfChannels, info.buffer->getNumChannels()); --chan >= 0;)
+            info.buffer->copyFrom (chan, info.startSample + numDone,
+                                   buffer,
+                                   chan, currentChunk * chunkSize + (int) offset,
+                                   numToCopy);
+
+        numDone += numToCopy;
+
+        if (offset + numToCopy == chunk.numSamples)
+            releaseCurrentChunk();
+    }
+
+    if (numDone < info.numSamples)
+        info.buffer->clear (info.startSample + numDone, info.numSamples - numDone);   // cache miss
+
+    // the position moves on even if the data wasn't ready, to stay in step with the caller's
+    // timeline - but if it has been changed by another thread in the meantime, leave it alone
+    nextPlayPos.compare_exchange_strong (pos, pos + info.numSamples);
+}
+
+bool BufferingAudioSource::findCurrentChunk (int64 position, uint32 currentGeneration)
+{
+    for (;;)
+    {
+        if (currentChunk < 0 && ! filledChunks->pop (currentChunk))
+            return false;
+
+        auto& chunk = chunkInfo[currentChunk];
+
+        if (chunk.generation == currentGeneration && chunk.start + chunk.numSamples > position)
+            return true;
+
+        // this chunk is from before the last change of position, or has already been played
+        releaseCurrentChunk();
     }
 }
 
+void BufferingAudioSource::releaseCurrentChunk()
+{
+    freeChunks->push (currentChunk);
+    currentChunk = -1;
+}
+
 bool BufferingAudioSource::waitForNextAudioBlockReady (const AudioSourceChannelInfo& info, uint32 timeout)
 {
     if (!source || source->getTotalLength() <= 0)
@@ -175,16 +205,18 @@ bool BufferingAudioSource::waitForNextAudioBlockReady (const AudioSourceChannelI
     while (elapsed <= timeout)
     {
         {
-            const ScopedLock sl (bufferStartPosLock);
+            auto currentGeneration = generation.load();
+            auto pos = nextPlayPos.load();
 
-            auto start = bufferValidStart.load();
-            auto end   = bufferValidEnd.load();
-            auto pos   = nextPlayPos.load();
+            // this gives any out-of-date chunks back to the background thread, in case
+            // nothing else is calling getNextAudioBlock()
+            if (filledChunks != nullptr)
+                findCurrentChunk (pos, currentGeneration);
 
-            auto validStart = static_cast<int> (jlimit (start, end, pos) - pos);
-            auto validEnd   = static_cast<int> (jlimit (start, end, pos + info.numSamples) - pos);
+            const SpinLock::ScopedLockType sl (bufferedRangeLock);
 
-            if (validStart <= 0 && validStart < validEnd && validEnd >= info.numSamples)
+            if (bufferedGeneration == currentGeneration
+                 && bufferedStart <= pos && bufferedEnd >= pos + info.numSamples)
                 return true;
         }
 
@@ -211,87 +243,57 @@ int64 BufferingAudioSource::getNextReadPosition() const
 
 void BufferingAudioSource::setNextReadPosition (int64 newPosition)
 {
-    const ScopedLock sl (bufferStartPosLock);
-
     nextPlayPos = newPosition;
+    ++generation;
     backgroundThread.moveToFrontOfQueue (this);
 }
 
 bool BufferingAudioSource::readNextBufferChunk()
 {
-    int64 newBVS, newBVE, sectionToReadStart, sectionToReadEnd;
-
+    if (wasSourceLooping != isLooping())
     {
-        const ScopedLock sl (bufferStartPosLock);
-
-        if (wasSourceLooping != isLooping())
-        {
-            wasSourceLooping = isLooping();
-            bufferValidStart = 0;
-            bufferValidEnd = 0;
-        }
-
-        newBVS = jmax ((int64) 0, nextPlayPos.load());
-        newBVE = newBVS + buffer.getNumSamples() - 4;
-        sectionToReadStart = 0;
-        sectionToReadEnd = 0;
-
-        const int maxChunkSize = 2048;
-
-        if (newBVS < bufferValidStart || newBVS >= bufferValidEnd)
-        {
-            newBVE = jmin (newBVE, newBVS + maxChunkSize);
-
-            sectionToReadStart = newBVS;
-            sectionToReadEnd = newBVE;
+        wasSourceLooping = isLooping();
+        ++generation;
+    }
 
-            bufferValidStart = 0;
-            bufferValidEnd = 0;
-        }
-        else if (std::abs ((int) (newBVS - bufferValidStart)) > 512
-                  || std::abs ((int) (newBVE - bufferValidEnd)) > 512)
-        {
-            newBVE = jmin (newBVE, bufferValidEnd + maxChunkSize);
+    auto currentGeneration = generation.load();
+    auto playPos = nextPlayPos.load();
 
-            sectionToReadStart = bufferValidEnd;
-            sectionToReadEnd = newBVE;
+    // start again from the play position if it has been moved, or if playback has overtaken us
+    if (currentGeneration != readerGeneration || playPos > nextReadPos)
+    {
+        readerGeneration = currentGeneration;
+        nextReadPos = playPos;
 
-            bufferValidStart = newBVS;
-            bufferValidEnd = jmin (bufferValidEnd.load(), newBVE);
-        }
+        const SpinLock::ScopedLockType sl (bufferedRangeLock);
+        bufferedGeneration = currentGeneration;
+        bufferedStart = playPos;
+        bufferedEnd = playPos;
     }
 
-    if (sectionToReadStart == sectionToReadEnd)
+    int chunkIndex;
+
+    if (! freeChunks->pop (chunkIndex))
         return false;
 
-    jassert (buffer.getNumSamples() > 0);
-    auto bufferIndexStart = (int) (sectionToReadStart % buffer.getNumSamples());
-    auto bufferIndexEnd   = (int) (sectionToReadEnd   % buffer.getNumSamples());
+    auto& chunk = chunkInfo[chunkIndex];
+    chunk.start = nextReadPos;
+    chunk.numSamples = nextReadPos < 0 ? (int) jmin ((int64) chunkSize, -nextReadPos) : chunkSize;
+    chunk.generation = currentGeneration;
 
-    if (bufferIndexStart < bufferIndexEnd)
-    {
-        readBufferSection (sectionToReadStart,
-                           (int) (sectionToReadEnd - sectionToReadStart),
-                           bufferIndexStart);
-    }
+    if (chunk.start < 0)
+        buffer.clear (chunkIndex * chunkSize, chunk.numSamples);
     else
-    {
-        auto initialSize = buffer.getNumSamples() - bufferIndexStart;
-
-        readBufferSection (sectionToReadStart,
-                           initialSize,
-                           bufferIndexStart);
+        readBufferSection (chunk.start, chunk.numSamples, chunkIndex * chunkSize);
 
-        readBufferSection (sectionToReadStart + initialSize,
-                           (int) (sectionToReadEnd - sectionToReadStart) - initialSize,
-                           0);
-    }
+    nextReadPos += chunk.numSamples;
+    filledChunks->push (chunkIndex);
 
     {
-        const ScopedLock sl2 (bufferStartPosLock);
+        const SpinLock::ScopedLockType sl (bufferedRangeLock);
 
-        bufferValidStart = newBVS;
-        bufferValidEnd = newBVE;
+        if (bufferedGeneration == currentGeneration)
+            bufferedEnd = nextReadPos;
     }
 
     bufferReadyEvent.signal();
@@ -309,7 +311,126 @@ void BufferingAudioSource::readBufferSection (int64 start, int length, int buffe
 
 int BufferingAudioSource::useTimeSlice()
 {
-    return readNextBufferChunk() ? 1 : 100;
+    if (readNextBufferChunk())
+        return 1;
+
+    // wait for roughly the time it takes to play a chunk
+    return jlimit (1, 100, roundToInt (1000.0 * chunkSize / jmax (1.0, sampleRate)));
 }
 
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct BufferingAudioSourceTests  : public UnitTest
+{
+    BufferingAudioSourceTests() : UnitTest ("BufferingAudioSource", "Audio") {}
+
+    // fills each sample with its position in the source
+    struct RampSource  : public PositionableAudioSource
+    {
+        RampSource (int64 totalLength) : length (totalLength) {}
+
+        void prepareToPlay (int, double) override {}
+        void releaseResources() override {}
+
+        void getNextAudioBlock (const AudioSourceChannelInfo& info) override
+        {
+            for (int i = 0; i < info.numSamples; ++i)
+            {
+                auto value = (float) (looping ? position % length : position);
+
+                for (int chan = 0; chan < info.buffer->getNumChannels(); ++chan)
+                    info.buffer->setSample (chan, info.startSample + i, value);
+
+                ++position;
+            }
+        }
+
+        void setNextReadPosition (int64 newPosition) override   { position = newPosition; }
+        int64 getNextReadPosition() const override              { return position; }
+        int64 getTotalLength() const override                   { return length; }
+        bool isLooping() const override                         { return looping; }
+        void setLooping (bool shouldLoop) override              { looping = shouldLoop; }
+
+        std::atomic<int64> length;
+        int64 position = 0;
+        std::atomic<bool> looping { false };
+    };
+
+    void checkBlocks (BufferingAudioSource& source, int64 startPosition, int numBlocks, int64 loopLength)
+    {
+        const int blockSize = 512;
+        AudioBuffer<float> block (2, blockSize);
+        AudioSourceChannelInfo info (&block, 0, blockSize);
+        int numErrors = 0;
+
+        for (int i = 0; i < numBlocks; ++i)
+        {
+            expect (source.waitForNextAudioBlockReady (info, 5000));
+            source.getNextAudioBlock (info);
+
+            for (int n = 0; n < blockSize; ++n)
+            {
+                auto pos = startPosition + i * blockSize + n;
+                auto expected = (float) (pos < 0 ? 0 : (loopLength > 0 ? pos % loopLength : pos));
+
+                if (block.getSample (0, n) != expected || block.getSample (1, n) != expected)
+                    ++numErrors;
+            }
+        }
+
+        expectEquals (numErrors, 0);
+    }
+
+    void runTest() override
+    {
+        TimeSliceThread thread ("Buffering test");
+        thread.startThread();
+
+        auto* ramp = new RampSource (1000000);
+        BufferingAudioSource source (ramp, thread, true, 8192, 2, true);
+        source.prepareToPlay (512, 44100.0);
+
+        beginTest ("Reading");
+        source.setNextReadPosition (0);
+        checkBlocks (source, 0, 100, 0);
+        expectEquals (source.getNextReadPosition(), (int64) 100 * 512);
+
+        beginTest ("Changing position");
+        source.setNextReadPosition (500000);
+        checkBlocks (source, 500000, 50, 0);
+        source.setNextReadPosition (1000);
+        checkBlocks (source, 1000, 50, 0);
+        source.setNextReadPosition (-700);
+        checkBlocks (source, -700, 10, 0);
+
+        beginTest ("Underruns");
+        {
+            // the position must keep moving whether or not the data is ready yet
+            AudioBuffer<float> block (2, 512);
+            AudioSourceChannelInfo info (&block, 0, 512);
+            source.setNextReadPosition (900000);
+
+            for (int i = 0; i < 4; ++i)
+                source.getNextAudioBlock (info);
+
+            expectEquals (source.getNextReadPosition(), (int64) 900000 + 4 * 512);
+        }
+
+        beginTest ("Looping");
+        ramp->length = 3000;
+        ramp->looping = true;
+        source.setNextReadPosition (0);
+        checkBlocks (source, 0, 50, 3000);
+        expectEquals (source.getNextReadPosition(), (int64) (50 * 512) % 3000);
+
+        source.releaseResources();
+        thread.stopThread (1000);
+    }
+};
+
+static BufferingAudioSourceTests bufferingAudioSourceTests;
+
+#endif
+
 } // namespace juce
@@ -31,6 +31,10 @@ namespace juce
     a background thread to smooth out playback. You can either create one of these
     directly, or use it indirectly using an AudioTransportSource.
 
+    The buffer is divided into chunks which are passed between the background thread
+    and the audio thread using lock-free queues, so getNextAudioBlock() never has to
+    wait for the background thread.
+
     @see PositionableAudioSource, AudioTransportSource
 
     @tags{Audio}
@@ -93,7 +97,8 @@ public:
 
     /** A useful function to block until the next the buffer info can be filled.
 
-        This is useful for offline rendering.
+        This is useful for offline rendering. It must be called on the same thread that
+        calls getNextAudioBlock().
     */
     bool waitForNextAudioBlockReady (const AudioSourceChannelInfo& info, const uint32 timeout);
 
@@ -103,14 +108,42 @@ private:
     TimeSliceThread& backgroundThread;
     int numberOfSamplesToBuffer, numberOfChannels;
     AudioBuffer<float> buffer;
-    CriticalSection bufferStartPosLock;
     WaitableEvent bufferReadyEvent;
-    std::atomic<int64> bufferValidStart { 0 }, bufferValidEnd { 0 }, nextPlayPos { 0 };
+    std::atomic<int64> nextPlayPos { 0 };
     double sampleRate = 0;
-    bool wasSourceLooping = false, isPrepared = false, prefillBuffer;
+    bool isPrepared = false, prefillBuffer;
+
+    struct ChunkInfo
+    {
+        int64 start;
+        int numSamples;
+        uint32 generation;
+    };
+
+    // Chunks are passed to the background thread through freeChunks, and come back filled
+    // through filledChunks. Whichever thread has taken a chunk from a queue owns its data.
+    int chunkSize = 0;
+    HeapBlock<ChunkInfo> chunkInfo;
+    std::unique_ptr<SPSCQueue<int>> freeChunks, filledChunks;
+    std::atomic<uint32> generation { 0 };
+
+    // used by the audio thread
+    int currentChunk = -1;
+
+    // used by the background thread
+    int64 nextReadPos = 0;
+    uint32 readerGeneration = 0;
+    bool wasSourceLooping = false;
+
+    // what the background thread has read so far, used for waiting until it's ready
+    SpinLock bufferedRangeLock;
+    int64 bufferedStart = 0, bufferedEnd = 0;
+    uint32 bufferedGeneration = 0;
 
     bool readNextBufferChunk();
     void readBufferSection (int64 start, int length, int bufferOffset);
+    bool findCurrentChunk (int64 position, uint32 currentGeneration);
+    void releaseCurrentChunk();
     int useTimeSlice() override;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BufferingAudioSource)
@@ -43,6 +43,13 @@ void MidiMessageCollector::reset (const double newSampleRate)
     sampleRate = newSampleRate;
     incomingMessages.clear();
     lastCallbackTime = Time::getMillisecondCounterHiRes();
+
+    MidiMessage discarded;
+    while (pendingMessages.pop (discarded)) {}
+
+    const ScopedLock overflowScopedLock (overflowLock);
+    overflow.clear();
+    numOverflowMessages = 0;
 }
 
 void MidiMessageCollector::addMessageToQueue (const MidiMessage& message)
@@ -55,16 +62,14 @@ void MidiMessageCollector::addMessageToQueue (const MidiMessage& message)
     // for details of what the number should be.
     jassert (message.getTimeStamp() != 0);
 
-    const ScopedLock sl (midiCallbackLock);
-
-    auto sampleNumber = (int) ((message.getTimeStamp() - 0.001 * lastCallbackTime) * sampleRate);
-
-    incomingMessages.addEvent (message, sampleNumber);
-
-    // if the messages don't get used for over a second, we'd better
-    // get rid of any old ones to avoid the queue getting too big
-    if (sampleNumber > sampleRate)
-        incomingMessages.clear (0, sampleNumber - (int) sampleRate);
+    // once the queue has overflowed, everything goes into the overflow list until
+    // it's been emptied, so that messages from each thread stay in order
+    if (numOverflowMessages.load() > 0 || ! pendingMessages.push (message))
+    {
+        const ScopedLock sl (overflowLock);
+        overflow.add (message);
+        ++numOverflowMessages;
+    }
 }
 
 void MidiMessageCollector::removeNextBlockOfMessages (MidiBuffer& destBuffer,
@@ -80,6 +85,43 @@ void MidiMessageCollector::removeNextBlockOfMessages (MidiBuffer& destBuffer,
     auto msElapsed = timeNow - lastCallbackTime;
 
     const ScopedLock sl (midiCallbackLock);
+
+    {
+        MidiMessage message;
+        int latestSample = 0;
+
+        auto addMessage = [&] (const MidiMessage& m)
+        {
+            auto sampleNumber = (int) ((m.getTimeStamp() - 0.001 * lastCallbackTime) * sampleRate);
+            incomingMessages.addEvent (m, sampleNumber);
+            latestSample = jmax (latestSample, sampleNumber);
+        };
+
+        while (pendingMessages.pop (message))
+            addMessage (message);
+
+        // the audio thread mustn't wait for the overflow list, so if another thread
+        // is adding to it, its messages are left for the next block
+        if (numOverflowMessages.load() > 0)
+        {
+            const ScopedTryLock overflowTryLock (overflowLock);
+
+            if (overflowTryLock.isLocked())
+            {
+                for (auto& m : overflow)
+                    addMessage (m);
+
+                overflow.clearQuick();
+                numOverflowMessages = 0;
+            }
+        }
+
+        // if the messages haven't been collected for over a second, we'd
+        // better get rid of any old ones rather than squashing them all in
+        if (latestSample > sampleRate)
+            incomingMessages.clear (0, latestSample - (int) sampleRate);
+    }
+
     lastCallbackTime = timeNow;
 
     if (! incomingMessages.isEmpty())
@@ -59,8 +59,11 @@ public:
         The message's timestamp is taken, and it will be ready for retrieval as part
         of the block returned by the next call to removeNextBlockOfMessages().
 
-        This method is fully thread-safe when overlapping calls are made with
-        removeNextBlockOfMessages().
+        This can be called from any number of threads at the same time as
+        removeNextBlockOfMessages(). It's lock-free until 2048 messages are waiting,
+        e.g. during a large SysEx burst or before the audio callback has started. Any
+        further messages are kept in a locked overflow list until they're collected,
+        so none of them are lost.
     */
     void addMessageToQueue (const MidiMessage& message);
 
@@ -73,8 +76,9 @@ public:
         callback, because the time that it happens is used in calculating the
         midi event positions.
 
-        This method is fully thread-safe when overlapping calls are made with
-        addMessageToQueue().
+        Calls to addMessageToQueue() can overlap with this method without ever
+        blocking it. If the overflow list is in use by another thread, its messages
+        are collected by the next call instead.
 
         Precondition: numSamples must be greater than 0.
     */
@@ -93,6 +97,10 @@ private:
     //==============================================================================
     double lastCallbackTime = 0;
     CriticalSection midiCallbackLock;
+    MPMCQueue<MidiMessage> pendingMessages { 2048 };
+    CriticalSection overflowLock;
+    Array<MidiMessage> overflow;
+    std::atomic<int> numOverflowMessages { 0 };
     MidiBuffer incomingMessages;
     double sampleRate = 44100.0;
    #if JUCE_DEBUG
@@ -676,6 +676,8 @@ public:
 
     void run() override
     {
+        Thread::applyAudioThreadRealtimeOptions();
+
         while (! threadShouldExit())
         {
             if (inputDevice != nullptr && inputDevice->handle != nullptr)
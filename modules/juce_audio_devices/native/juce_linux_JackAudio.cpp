@@ -70,6 +70,7 @@ JUCE_DECL_JACK_FUNCTION (jack_port_t* , jack_port_by_id, (jack_client_t* client,
 JUCE_DECL_JACK_FUNCTION (int, jack_port_connected, (const jack_port_t* port), (port));
 JUCE_DECL_JACK_FUNCTION (int, jack_port_connected_to, (const jack_port_t* port, const char* port_name), (port, port_name));
 JUCE_DECL_JACK_FUNCTION (int, jack_set_xrun_callback, (jack_client_t* client, JackXRunCallback xrun_callback, void* arg), (client, xrun_callback, arg));
+JUCE_DECL_JACK_FUNCTION (int, jack_set_thread_init_callback, (jack_client_t* client, JackThreadInitCallback thread_init_callback, void* arg), (client, thread_init_callback, arg));
 
 #if JUCE_DEBUG
  #define JACK_LOGGING_ENABLED 1
@@ -264,6 +265,7 @@ public:
         juce::jack_set_port_connect_callback (client, portConnectCallback, this);
         juce::jack_on_shutdown (client, shutdownCallback, this);
         juce::jack_set_xrun_callback (client, xrunCallback, this);
+        juce::jack_set_thread_init_callback (client, threadInitCallback, nullptr);
         juce::jack_activate (client);
         deviceIsOpen = true;
 
@@ -414,6 +416,11 @@ private:
         return 0;
     }
 
+    static void threadInitCallback (void*)
+    {
+        Thread::applyAudioThreadRealtimeOptions();
+    }
+
     static int xrunCallback (void* callbackArgument)
     {
         if (callbackArgument != nullptr)
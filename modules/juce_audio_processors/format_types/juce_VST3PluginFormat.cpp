@@ -1129,7 +1129,8 @@ private:
     bool open (const String& filePath)
     {
         const File file (filePath);
-        const char* const utf8 = file.getFullPathName().toRawUTF8();
+        const auto path = file.getFullPathName();
+        const char* const utf8 = path.toRawUTF8();
 
         if (CFURLRef url = CFURLCreateFromFileSystemRepresentation (0, (const UInt8*) utf8, (CFIndex) std::strlen (utf8), file.isDirectory()))
         {
@@ -721,7 +721,8 @@ struct ModuleHandle    : public ReferenceCountedObject
 
         if (file.hasFileExtension (".vst"))
         {
-            auto* utf8 = file.getFullPathName().toRawUTF8();
+            auto path = file.getFullPathName();
+            auto* utf8 = path.toRawUTF8();
 
             if (CFURLRef url = CFURLCreateFromFileSystemRepresentation (0, (const UInt8*) utf8,
                                                                         (CFIndex) strlen (utf8), file.isDirectory()))
@@ -170,3 +170,7 @@ struct AutoResizingNSViewComponentWithParent  : public AutoResizingNSViewCompone
 #include "scanning/juce_PluginListComponent.cpp"
 #include "utilities/juce_AudioProcessorParameters.cpp"
 #include "utilities/juce_AudioProcessorValueTreeState.cpp"
+
+#if JUCE_UNIT_TESTS
+ #include "processors/juce_AudioProcessorGraph_test.cpp"
+#endif
@@ -38,9 +38,12 @@ struct GraphRenderSequence
         MidiBuffer* midiBuffers;
         AudioPlayHead* audioPlayHead;
         int numSamples;
+        double sampleRate;
+        bool measureNodeTimes;
     };
 
-    void perform (AudioBuffer<FloatType>& buffer, MidiBuffer& midiMessages, AudioPlayHead* audioPlayHead)
+    void perform (AudioBuffer<FloatType>& buffer, MidiBuffer& midiMessages, AudioPlayHead* audioPlayHead,
+                  double sampleRate = 0, bool measureNodeTimes = false)
     {
         auto numSamples = buffer.getNumSamples();
         auto maxSamples = renderingBuffer.getNumSamples();
@@ -54,11 +57,11 @@ struct GraphRenderSequence
             {
                 AudioBuffer<FloatType> startAudio (buffer.getArrayOfWritePointers(), buffer.getNumChannels(), maxSamples);
                 midiMessages.clear (maxSamples, numSamples);
-                perform (startAudio, midiMessages, audioPlayHead);
+                perform (startAudio, midiMessages, audioPlayHead, sampleRate, measureNodeTimes);
             }
 
             AudioBuffer<FloatType> endAudio (buffer.getArrayOfWritePointers(), buffer.getNumChannels(), maxSamples, numSamples - maxSamples);
-            perform (endAudio, tempMIDI, audioPlayHead);
+            perform (endAudio, tempMIDI, audioPlayHead, sampleRate, measureNodeTimes);
             return;
         }
 
@@ -69,7 +72,8 @@ struct GraphRenderSequence
         currentMidiOutputBuffer.clear();
 
         {
-            const Context context { renderingBuffer.getArrayOfWritePointers(), midiBuffers.begin(), audioPlayHead, numSamples };
+            const Context context { renderingBuffer.getArrayOfWritePointers(), midiBuffers.begin(), audioPlayHead,
+                                    numSamples, sampleRate, measureNodeTimes && sampleRate > 0 };
 
             for (auto* op : renderOps)
                 op->perform (context);
@@ -121,6 +125,9 @@ struct GraphRenderSequence
     void addDelayChannelOp (int chan, int delaySize)
     {
         renderOps.add (new DelayChannelOp (chan, delaySize));
+
+        ++numDelayLines;
+        totalDelaySamples += delaySize;
     }
 
     void addProcessOp (const AudioProcessorGraph::Node::Ptr& node,
@@ -129,20 +136,35 @@ struct GraphRenderSequence
         renderOps.add (new ProcessOp (node, audioChannelsUsed, totalNumChans, midiBuffer));
     }
 
-    void prepareBuffers (int blockSize)
+    void prepareBuffers (int blockSize, GraphRenderSequence* sequenceToReuseBuffersFrom = nullptr)
     {
-        renderingBuffer.setSize (numBuffersNeeded + 1, blockSize);
+        if (sequenceToReuseBuffersFrom != nullptr)
+        {
+            // take over the storage of the sequence that this one replaces, which saves
+            // re-allocating everything after each small change to the graph
+            renderingBuffer = std::move (sequenceToReuseBuffersFrom->renderingBuffer);
+            currentAudioOutputBuffer = std::move (sequenceToReuseBuffersFrom->currentAudioOutputBuffer);
+            midiBuffers.swapWith (sequenceToReuseBuffersFrom->midiBuffers);
+        }
+        else
+        {
+            midiBuffers.clearQuick();
+        }
+
+        renderingBuffer.setSize (numBuffersNeeded + 1, blockSize, false, false, true);
         renderingBuffer.clear();
-        currentAudioOutputBuffer.setSize (numBuffersNeeded + 1, blockSize);
+        currentAudioOutputBuffer.setSize (numBuffersNeeded + 1, blockSize, false, false, true);
         currentAudioOutputBuffer.clear();
 
         currentAudioInputBuffer = nullptr;
         currentMidiInputBuffer = nullptr;
         currentMidiOutputBuffer.clear();
 
-        midiBuffers.clearQuick();
         midiBuffers.resize (numMidiBuffersNeeded);
 
+        for (auto& m : midiBuffers)
+            m.clear();
+
         const int defaultMIDIBufferSize = 512;
 
         tempMIDI.ensureSize (defaultMIDIBufferSize);
@@ -151,6 +173,15 @@ struct GraphRenderSequence
             m.ensureSize (defaultMIDIBufferSize);
     }
 
+    size_t getNumBytesAllocated() const noexcept
+    {
+        auto numAudioSamples = (size_t) (renderingBuffer.getNumChannels() + currentAudioOutputBuffer.getNumChannels())
+                                 * (size_t) renderingBuffer.getNumSamples();
+
+        // each delay line holds one more sample than its length
+        return sizeof (FloatType) * (numAudioSamples + (size_t) (totalDelaySamples + numDelayLines));
+    }
+
     void releaseBuffers()
     {
         renderingBuffer.setSize (1, 1);
@@ -161,7 +192,8 @@ struct GraphRenderSequence
         midiBuffers.clear();
     }
 
-    int numBuffersNeeded = 0, numMidiBuffersNeeded = 0;
+    int numBuffersNeeded = 0, numMidiBuffersNeeded = 0, numDelayLines = 0;
+    int64 totalDelaySamples = 0;
 
     AudioBuffer<FloatType> renderingBuffer, currentAudioOutputBuffer;
     AudioBuffer<FloatType>* currentAudioInputBuffer = nullptr;
@@ -260,9 +292,21 @@ private:
             AudioBuffer<FloatType> buffer (audioChannels, totalChans, c.numSamples);
 
             if (processor.isSuspended())
+            {
                 buffer.clear();
+            }
+            else if (c.measureNodeTimes)
+            {
+                auto startTicks = Time::getHighResolutionTicks();
+                callProcess (buffer, c.midiBuffers[midiBufferToUse]);
+
+                node->addProcessingTime (Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - startTicks),
+                                         c.numSamples / c.sampleRate);
+            }
             else
+            {
                 callProcess (buffer, c.midiBuffers[midiBufferToUse]);
+            }
         }
 
         void callProcess (AudioBuffer<float>& buffer, MidiBuffer& midiMessages)
@@ -326,10 +370,17 @@ private:
 template <typename RenderSequence>
 struct RenderSequenceBuilder
 {
-    RenderSequenceBuilder (AudioProcessorGraph& g, RenderSequence& s)
-        : graph (g), sequence (s)
+    RenderSequenceBuilder (AudioProcessorGraph& g, RenderSequence& s,
+                           const Array<AudioProcessorGraph::Node*>& nodeOrder)
+        : graph (g), sequence (s), orderedNodes (nodeOrder)
     {
-        createOrderedNodeList();
+        // an empty order means that the graph contains a feedback loop, so
+        // fall back to the slower ordering, which can cope with that
+        if (orderedNodes.isEmpty())
+            createOrderedNodeList();
+
+        createConnectionLists();
+        calculateLatencies();
 
         audioBuffers.add (AssignedBuffer::createReadOnlyEmpty()); // first buffer is read-only zeros
         midiBuffers .add (AssignedBuffer::createReadOnlyEmpty());
@@ -337,8 +388,11 @@ struct RenderSequenceBuilder
         for (int i = 0; i < orderedNodes.size(); ++i)
         {
             createRenderingOpsForNode (*orderedNodes.getUnchecked(i), i);
-            markAnyUnusedBuffersAsFree (audioBuffers, i);
-            markAnyUnusedBuffersAsFree (midiBuffers, i);
+            createOpsForNodeOutputs (*orderedNodes.getUnchecked(i), i);
+
+            // a buffer can be re-used as soon as the last step that reads it is done
+            markAnyUnusedBuffersAsFree (audioBuffers, i + 1);
+            markAnyUnusedBuffersAsFree (midiBuffers, i + 1);
         }
 
         graph.setLatencySamples (totalLatency);
@@ -358,21 +412,45 @@ struct RenderSequenceBuilder
     struct AssignedBuffer
     {
         AudioProcessorGraph::NodeAndChannel channel;
+        int delay;          // if non-zero, the buffer holds the channel's output delayed by this many samples
+        bool isInputMix;    // if true, the channel is a node's input, and its sources are being summed into this buffer
 
-        static AssignedBuffer createReadOnlyEmpty() noexcept    { return { { (NodeID) zeroNodeID, 0 } }; }
-        static AssignedBuffer createFree() noexcept             { return { { (NodeID) freeNodeID, 0 } }; }
+        static AssignedBuffer createReadOnlyEmpty() noexcept    { return { { (NodeID) zeroNodeID, 0 }, 0, false }; }
+        static AssignedBuffer createFree() noexcept             { return { { (NodeID) freeNodeID, 0 }, 0, false }; }
 
         bool isReadOnlyEmpty() const noexcept                   { return channel.nodeID == (NodeID) zeroNodeID; }
         bool isFree() const noexcept                            { return channel.nodeID == (NodeID) freeNodeID; }
         bool isAssigned() const noexcept                        { return ! (isReadOnlyEmpty() || isFree()); }
 
-        void setFree() noexcept                                 { channel = { (NodeID) freeNodeID, 0 }; }
-        void setAssignedToNonExistentNode() noexcept            { channel = { (NodeID) anonNodeID, 0 }; }
+        bool holdsOutput (AudioProcessorGraph::NodeAndChannel output, int delaySamples) const noexcept
+        {
+            return channel == output && delay == delaySamples && ! isInputMix;
+        }
+
+        bool holdsInputMix (AudioProcessorGraph::NodeAndChannel input) const noexcept
+        {
+            return channel == input && isInputMix;
+        }
+
+        void setFree() noexcept                                 { setOutput ({ (NodeID) freeNodeID, 0 }); }
+
+        void setOutput (AudioProcessorGraph::NodeAndChannel output, int delaySamples = 0) noexcept
+        {
+            channel = output;
+            delay = delaySamples;
+            isInputMix = false;
+        }
+
+        void setInputMix (AudioProcessorGraph::NodeAndChannel input) noexcept
+        {
+            channel = input;
+            delay = 0;
+            isInputMix = true;
+        }
 
     private:
         enum
         {
-            anonNodeID = 0x7ffffffd,
             zeroNodeID = 0x7ffffffe,
             freeNodeID = 0x7fffffff
         };
@@ -382,13 +460,8 @@ struct RenderSequenceBuilder
 
     enum { readOnlyEmptyBufferIndex = 0 };
 
-    struct Delay
-    {
-        NodeID nodeID;
-        int delay;
-    };
-
     HashMap<NodeID, int> delays;
+    Array<int> inputLatencies;
     int totalLatency = 0;
 
     int getNodeDelay (NodeID nodeID) const noexcept
@@ -396,15 +469,78 @@ struct RenderSequenceBuilder
         return delays[nodeID];
     }
 
-    int getInputLatencyForNode (NodeID nodeID) const
+    void calculateLatencies()
     {
-        int maxLatency = 0;
+        for (int i = 0; i < orderedNodes.size(); ++i)
+        {
+            auto& node = *orderedNodes.getUnchecked (i);
+            int maxLatency = 0;
 
-        for (auto&& c : graph.getConnections())
-            if (c.destination.nodeID == nodeID)
-                maxLatency = jmax (maxLatency, getNodeDelay (c.source.nodeID));
+            // a source that comes later in the sequence is part of a feedback loop, so it can't be compensated
+            for (auto& c : inputConnections[(size_t) i])
+                if (getStepIndex (c.source.nodeID) < i)
+                    maxLatency = jmax (maxLatency, getNodeDelay (c.source.nodeID));
 
-        return maxLatency;
+            inputLatencies.add (maxLatency);
+            delays.set (node.nodeID, maxLatency + node.getProcessor()->getLatencySamples());
+
+            if (node.getProcessor()->getTotalNumOutputChannels() == 0)
+                totalLatency = maxLatency;
+        }
+    }
+
+    // Returns the number of samples by which a connection's source must be delayed to line up
+    // with the other inputs of its destination.
+    int getCompensationDelay (const AudioProcessorGraph::Connection& c) const noexcept
+    {
+        auto destStepIndex = getStepIndex (c.destination.nodeID);
+
+        if (getStepIndex (c.source.nodeID) >= destStepIndex)
+            return 0;
+
+        return inputLatencies.getUnchecked (destStepIndex) - getNodeDelay (c.source.nodeID);
+    }
+
+    //==============================================================================
+    // The connections of each node, indexed by its position in orderedNodes, so that
+    // none of the lookups made while building the sequence need to scan the whole graph.
+    HashMap<NodeID, int> stepIndexes;
+    std::vector<std::vector<AudioProcessorGraph::Connection>> inputConnections, outputConnections;
+
+    void createConnectionLists()
+    {
+        for (int i = 0; i < orderedNodes.size(); ++i)
+            stepIndexes.set (orderedNodes.getUnchecked (i)->nodeID, i);
+
+        inputConnections.resize ((size_t) orderedNodes.size());
+        outputConnections.resize ((size_t) orderedNodes.size());
+
+        for (auto& c : graph.getConnections())
+        {
+            inputConnections[(size_t) getStepIndex (c.destination.nodeID)].push_back (c);
+            outputConnections[(size_t) getStepIndex (c.source.nodeID)].push_back (c);
+        }
+    }
+
+    int getStepIndex (NodeID nodeID) const noexcept
+    {
+        return stepIndexes.contains (nodeID) ? stepIndexes[nodeID] : -1;
+    }
+
+    bool isLegalAudioInput (AudioProcessorGraph::NodeAndChannel input, int stepIndex) const noexcept
+    {
+        return input.channelIndex < orderedNodes.getUnchecked (stepIndex)->getProcessor()->getTotalNumInputChannels();
+    }
+
+    bool hasMultipleSources (AudioProcessorGraph::NodeAndChannel input, int stepIndex) const noexcept
+    {
+        int numSources = 0;
+
+        for (auto& c : inputConnections[(size_t) stepIndex])
+            if (c.destination == input && ++numSources > 1)
+                return true;
+
+        return false;
     }
 
     //==============================================================================
@@ -422,42 +558,27 @@ struct RenderSequenceBuilder
         }
     }
 
-    int findBufferForInputAudioChannel (AudioProcessorGraph::Node& node, const int inputChan,
-                                        const int ourRenderingIndex, const int maxLatency)
+    int findBufferForInputAudioChannel (AudioProcessorGraph::Node& node, const int inputChan, const int ourRenderingIndex)
     {
         auto& processor = *node.getProcessor();
         auto numOuts = processor.getTotalNumOutputChannels();
+        AudioProcessorGraph::NodeAndChannel input { node.nodeID, inputChan };
 
         auto sources = getSourcesForChannel (node, inputChan);
+        int bufIndex = -1;
 
-        // Handle an unconnected input channel...
-        if (sources.isEmpty())
-        {
-            if (inputChan >= numOuts)
-                return readOnlyEmptyBufferIndex;
-
-            auto index = getFreeBuffer (audioBuffers);
-            sequence.addClearChannelOp (index);
-            return index;
-        }
-
-        // Handle an input from a single source..
         if (sources.size() == 1)
         {
-            // channel with a straightforward single input..
+            // channel with a straightforward single input, which has already been
+            // delayed if it needs compensating..
             auto src = sources.getUnchecked(0);
+            auto delay = getCompensationDelay ({ src, input });
 
-            int bufIndex = getBufferContaining (src);
-
-            if (bufIndex < 0)
-            {
-                // if not found, this is probably a feedback loop
-                bufIndex = readOnlyEmptyBufferIndex;
-                jassert (bufIndex >= 0);
-            }
+            bufIndex = getBufferContaining (src, delay);
 
-            if (inputChan < numOuts
-                 && isBufferNeededLater (ourRenderingIndex, inputChan, src))
+            if (bufIndex >= 0
+                 && inputChan < numOuts
+                 && isBufferNeededLater (ourRenderingIndex, inputChan, src, delay))
             {
                 // can't mess up this channel because it's needed later by another node,
                 // so we need to use a copy of it..
@@ -465,90 +586,21 @@ struct RenderSequenceBuilder
                 sequence.addCopyChannelOp (bufIndex, newFreeBuffer);
                 bufIndex = newFreeBuffer;
             }
-
-            auto nodeDelay = getNodeDelay (src.nodeID);
-
-            if (nodeDelay < maxLatency)
-                sequence.addDelayChannelOp (bufIndex, maxLatency - nodeDelay);
-
-            return bufIndex;
-        }
-
-        // Handle a mix of several outputs coming into this input..
-        int reusableInputIndex = -1;
-        int bufIndex = -1;
-
-        for (int i = 0; i < sources.size(); ++i)
-        {
-            auto src = sources.getReference(i);
-            auto sourceBufIndex = getBufferContaining (src);
-
-            if (sourceBufIndex >= 0 && ! isBufferNeededLater (ourRenderingIndex, inputChan, src))
-            {
-                // we've found one of our input chans that can be re-used..
-                reusableInputIndex = i;
-                bufIndex = sourceBufIndex;
-
-                auto nodeDelay = getNodeDelay (src.nodeID);
-
-                if (nodeDelay < maxLatency)
-                    sequence.addDelayChannelOp (bufIndex, maxLatency - nodeDelay);
-
-                break;
-            }
         }
-
-        if (reusableInputIndex < 0)
+        else if (sources.size() > 1)
         {
-            // can't re-use any of our input chans, so get a new one and copy everything into it..
-            bufIndex = getFreeBuffer (audioBuffers);
-            jassert (bufIndex != 0);
-
-            audioBuffers.getReference (bufIndex).setAssignedToNonExistentNode();
-
-            auto srcIndex = getBufferContaining (sources.getFirst());
-
-            if (srcIndex < 0)
-                sequence.addClearChannelOp (bufIndex);  // if not found, this is probably a feedback loop
-            else
-                sequence.addCopyChannelOp (srcIndex, bufIndex);
-
-            reusableInputIndex = 0;
-            auto nodeDelay = getNodeDelay (sources.getFirst().nodeID);
-
-            if (nodeDelay < maxLatency)
-                sequence.addDelayChannelOp (bufIndex, maxLatency - nodeDelay);
+            // a mix of several outputs, which were added up as soon as each of them was rendered
+            bufIndex = getInputMixBuffer (input);
         }
 
-        for (int i = 0; i < sources.size(); ++i)
+        if (bufIndex < 0)
         {
-            if (i != reusableInputIndex)
-            {
-                auto src = sources.getReference(i);
-                int srcIndex = getBufferContaining (src);
+            // Handle an unconnected input channel, or one whose sources are all part of feedback loops...
+            if (inputChan >= numOuts)
+                return readOnlyEmptyBufferIndex;
 
-                if (srcIndex >= 0)
-                {
-                    auto nodeDelay = getNodeDelay (src.nodeID);
-
-                    if (nodeDelay < maxLatency)
-                    {
-                        if (! isBufferNeededLater (ourRenderingIndex, inputChan, src))
-                        {
-                            sequence.addDelayChannelOp (srcIndex, maxLatency - nodeDelay);
-                        }
-                        else // buffer is reused elsewhere, can't be delayed
-                        {
-                            auto bufferToDelay = getFreeBuffer (audioBuffers);
-                            sequence.addCopyChannelOp (srcIndex, bufferToDelay);
-                            sequence.addDelayChannelOp (bufferToDelay, maxLatency - nodeDelay);
-                            srcIndex = bufferToDelay;
-                        }
-                    }
-
-                    sequence.addAddChannelOp (srcIndex, bufIndex);
-                }
-            }
+            bufIndex = getFreeBuffer (audioBuffers);
+            sequence.addClearChannelOp (bufIndex);
         }
 
         return bufIndex;
@@ -653,18 +705,17 @@ struct RenderSequenceBuilder
         auto totalChans = jmax (numIns, numOuts);
 
         Array<int> audioChannelsToUse;
-        auto maxLatency = getInputLatencyForNode (node.nodeID);
 
         for (int inputChan = 0; inputChan < numIns; ++inputChan)
         {
             // get a list of all the inputs to this node
-            auto index = findBufferForInputAudioChannel (node, inputChan, ourRenderingIndex, maxLatency);
+            auto index = findBufferForInputAudioChannel (node, inputChan, ourRenderingIndex);
             jassert (index >= 0);
 
             audioChannelsToUse.add (index);
 
             if (inputChan < numOuts)
-                audioBuffers.getReference (index).channel = { node.nodeID, inputChan };
+                audioBuffers.getReference (index).setOutput ({ node.nodeID, inputChan });
         }
 
         for (int outputChan = numIns; outputChan < numOuts; ++outputChan)
@@ -673,30 +724,132 @@ struct RenderSequenceBuilder
             jassert (index != 0);
             audioChannelsToUse.add (index);
 
-            audioBuffers.getReference (index).channel = { node.nodeID, outputChan };
+            audioBuffers.getReference (index).setOutput ({ node.nodeID, outputChan });
         }
 
         auto midiBufferToUse = findBufferForInputMidiChannel (node, ourRenderingIndex);
 
         if (processor.producesMidi())
-            midiBuffers.getReference (midiBufferToUse).channel = { node.nodeID, AudioProcessorGraph::midiChannelIndex };
+            midiBuffers.getReference (midiBufferToUse).setOutput ({ node.nodeID, AudioProcessorGraph::midiChannelIndex });
+
+        sequence.addProcessOp (&node, audioChannelsToUse, totalChans, midiBufferToUse);
+    }
+
+    //==============================================================================
+    /*  Once a node has been rendered, each of its audio outputs is immediately delayed and
+        added to any mixed inputs that it feeds, rather than waiting for the destination's
+        turn. This means that a wide set of parallel branches only needs one buffer for each
+        mixed input, instead of keeping all the branches' outputs until the mix is rendered.
+
+        Each distinct delay that an output needs is only applied once, and the delayed copy
+        is shared by all the inputs that need to be compensated by the same amount.
+    */
+    void createOpsForNodeOutputs (AudioProcessorGraph::Node& node, const int ourRenderingIndex)
+    {
+        auto numOuts = node.getProcessor()->getTotalNumOutputChannels();
 
-        delays.set (node.nodeID, maxLatency + processor.getLatencySamples());
+        for (int outputChan = 0; outputChan < numOuts; ++outputChan)
+        {
+            AudioProcessorGraph::NodeAndChannel output { node.nodeID, outputChan };
+            auto bufIndex = getBufferContaining (output);
+            jassert (bufIndex > 0);
 
-        if (numOuts == 0)
-            totalLatency = maxLatency;
+            Array<int> delaysNeeded;
+            bool anyUndelayedMixes = false;
 
-        sequence.addProcessOp (&node, audioChannelsToUse, totalChans, midiBufferToUse);
+            for (auto& c : outputConnections[(size_t) ourRenderingIndex])
+            {
+                auto destStepIndex = getStepIndex (c.destination.nodeID);
+
+                if (c.source == output && destStepIndex > ourRenderingIndex
+                     && isLegalAudioInput (c.destination, destStepIndex))
+                {
+                    auto delay = getCompensationDelay (c);
+
+                    if (delay > 0)
+                        delaysNeeded.addIfNotAlreadyThere (delay);
+                    else if (hasMultipleSources (c.destination, destStepIndex))
+                        anyUndelayedMixes = true;
+                }
+            }
+
+            delaysNeeded.sort();
+            auto isUndelayedOutputNeededLater = anyUndelayedMixes
+                                                  || isBufferNeededLater (ourRenderingIndex + 1, -1, output, 0);
+
+            for (int i = 0; i < delaysNeeded.size(); ++i)
+            {
+                auto delay = delaysNeeded.getUnchecked (i);
+                auto delayedIndex = bufIndex;
+
+                if (i < delaysNeeded.size() - 1 || isUndelayedOutputNeededLater)
+                {
+                    delayedIndex = getFreeBuffer (audioBuffers);
+                    sequence.addCopyChannelOp (bufIndex, delayedIndex);
+                }
+
+                sequence.addDelayChannelOp (delayedIndex, delay);
+                audioBuffers.getReference (delayedIndex).setOutput (output, delay);
+
+                addToInputMixes (output, delay, delayedIndex, ourRenderingIndex);
+            }
+
+            if (anyUndelayedMixes)
+                addToInputMixes (output, 0, bufIndex, ourRenderingIndex);
+        }
+    }
+
+    void addToInputMixes (AudioProcessorGraph::NodeAndChannel output, int delay, int bufIndex, int ourRenderingIndex)
+    {
+        Array<AudioProcessorGraph::NodeAndChannel> mixedInputs;
+
+        for (auto& c : outputConnections[(size_t) ourRenderingIndex])
+        {
+            auto destStepIndex = getStepIndex (c.destination.nodeID);
+
+            if (c.source == output && destStepIndex > ourRenderingIndex
+                 && isLegalAudioInput (c.destination, destStepIndex)
+                 && hasMultipleSources (c.destination, destStepIndex)
+                 && getCompensationDelay (c) == delay)
+                mixedInputs.add (c.destination);
+        }
+
+        auto canReuseBuffer = ! isBufferNeededLater (ourRenderingIndex + 1, -1, output, delay);
+
+        for (int i = 0; i < mixedInputs.size(); ++i)
+        {
+            auto input = mixedInputs.getReference (i);
+            auto mixIndex = getInputMixBuffer (input);
+
+            if (mixIndex >= 0)
+            {
+                sequence.addAddChannelOp (bufIndex, mixIndex);
+            }
+            else if (canReuseBuffer && i == mixedInputs.size() - 1)
+            {
+                // this is the first source of the mix, and nothing else needs it, so the mix can just take it over
+                audioBuffers.getReference (bufIndex).setInputMix (input);
+                return;
+            }
+            else
+            {
+                mixIndex = getFreeBuffer (audioBuffers);
+                sequence.addCopyChannelOp (bufIndex, mixIndex);
+                audioBuffers.getReference (mixIndex).setInputMix (input);
+            }
+        }
+
+        if (canReuseBuffer)
+            audioBuffers.getReference (bufIndex).setFree();
     }
 
     //==============================================================================
     Array<AudioProcessorGraph::NodeAndChannel> getSourcesForChannel (AudioProcessorGraph::Node& node, int inputChannelIndex)
     {
         Array<AudioProcessorGraph::NodeAndChannel> results;
-        AudioProcessorGraph::NodeAndChannel nc { node.nodeID, inputChannelIndex };
 
-        for (auto&& c : graph.getConnections())
-            if (c.destination == nc)
+        for (auto& c : inputConnections[(size_t) getStepIndex (node.nodeID)])
+            if (c.destination.channelIndex == inputChannelIndex)
                 results.add (c.source);
 
         return results;
@@ -712,13 +865,28 @@ struct RenderSequenceBuilder
         return buffers.size() - 1;
     }
 
-    int getBufferContaining (AudioProcessorGraph::NodeAndChannel output) const noexcept
+    int getBufferContaining (AudioProcessorGraph::NodeAndChannel output, int delay = 0) const noexcept
     {
         int i = 0;
 
         for (auto& b : output.isMIDI() ? midiBuffers : audioBuffers)
         {
-            if (b.channel == output)
+            if (b.holdsOutput (output, delay))
+                return i;
+
+            ++i;
+        }
+
+        return -1;
+    }
+
+    int getInputMixBuffer (AudioProcessorGraph::NodeAndChannel input) const noexcept
+    {
+        int i = 0;
+
+        for (auto& b : audioBuffers)
+        {
+            if (b.holdsInputMix (input))
                 return i;
 
             ++i;
@@ -730,34 +898,50 @@ struct RenderSequenceBuilder
     void markAnyUnusedBuffersAsFree (Array<AssignedBuffer>& buffers, const int stepIndex)
     {
         for (auto& b : buffers)
-            if (b.isAssigned() && ! isBufferNeededLater (stepIndex, -1, b.channel))
-                b.setFree();
+        {
+            if (b.isAssigned())
+            {
+                auto isNeeded = b.isInputMix ? getStepIndex (b.channel.nodeID) >= stepIndex
+                                             : isBufferNeededLater (stepIndex, -1, b.channel, b.delay);
+                if (! isNeeded)
+                    b.setFree();
+            }
+        }
     }
 
+    // Returns true if an output, delayed by the given number of samples, is read by any of the steps from
+    // stepIndexToSearchFrom onwards. Audio that is added to a mixed input doesn't count, because that
+    // is done straight after the source has been rendered.
     bool isBufferNeededLater (int stepIndexToSearchFrom,
                               int inputChannelOfIndexToIgnore,
-                              AudioProcessorGraph::NodeAndChannel output) const
+                              AudioProcessorGraph::NodeAndChannel output,
+                              int delay = 0) const
     {
-        while (stepIndexToSearchFrom < orderedNodes.size())
+        auto sourceStepIndex = getStepIndex (output.nodeID);
+
+        if (sourceStepIndex < 0)
+            return false;
+
+        for (auto& c : outputConnections[(size_t) sourceStepIndex])
         {
-            auto* node = orderedNodes.getUnchecked (stepIndexToSearchFrom);
+            if (c.source != output)
+                continue;
+
+            auto destStepIndex = getStepIndex (c.destination.nodeID);
+
+            if (destStepIndex < stepIndexToSearchFrom)
+                continue;
+
+            if (destStepIndex == stepIndexToSearchFrom && c.destination.channelIndex == inputChannelOfIndexToIgnore)
+                continue;
 
             if (output.isMIDI())
-            {
-                if (inputChannelOfIndexToIgnore != AudioProcessorGraph::midiChannelIndex
-                     && graph.isConnected ({ { output.nodeID, AudioProcessorGraph::midiChannelIndex },
-                                             { node->nodeID,  AudioProcessorGraph::midiChannelIndex } }))
-                    return true;
-            }
-            else
-            {
-                for (int i = 0; i < node->getProcessor()->getTotalNumInputChannels(); ++i)
-                    if (i != inputChannelOfIndexToIgnore && graph.isConnected ({ output, { node->nodeID, i } }))
-                        return true;
-            }
+                return true;
 
-            inputChannelOfIndexToIgnore = -1;
-            ++stepIndexToSearchFrom;
+            if (isLegalAudioInput (c.destination, destStepIndex)
+                 && ! hasMultipleSources (c.destination, destStepIndex)
+                 && getCompensationDelay (c) == delay)
+                return true;
         }
 
         return false;
@@ -796,13 +980,123 @@ bool AudioProcessorGraph::Connection::operator< (const Connection& other) const
     return destination.channelIndex < other.destination.channelIndex;
 }
 
+//==============================================================================
+// The counters are only written by the rendering thread, so they don't need any
+// read-modify-write operations, and readers can load them without ever waiting.
+struct AudioProcessorGraph::Node::ProcessingStatsCollector
+{
+    ProcessingStatsCollector() noexcept     { clear(); }
+
+    void addBlock (double seconds, double blockDurationSeconds) noexcept
+    {
+        if (resetPending.load (std::memory_order_relaxed) && resetPending.exchange (false))
+            clear();
+
+        auto load = seconds / blockDurationSeconds;
+        auto n = numBlocks.load (std::memory_order_relaxed);
+
+        if (n == 0 || seconds < minSeconds.load (std::memory_order_relaxed))
+            minSeconds.store (seconds, std::memory_order_relaxed);
+
+        if (seconds > maxSeconds.load (std::memory_order_relaxed))
+            maxSeconds.store (seconds, std::memory_order_relaxed);
+
+        if (load > maxLoad.load (std::memory_order_relaxed))
+            maxLoad.store (load, std::memory_order_relaxed);
+
+        if (load > 1.0)
+            increment (numDeadlineMisses);
+
+        totalSeconds.store (totalSeconds.load (std::memory_order_relaxed) + seconds, std::memory_order_relaxed);
+        totalLoad.store (totalLoad.load (std::memory_order_relaxed) + load, std::memory_order_relaxed);
+
+        auto bucket = jlimit (0, (int) ProcessingStats::numHistogramBuckets - 1,
+                              (int) (load / ProcessingStats::getHistogramBucketSize()));
+        increment (histogram[bucket]);
+
+        numBlocks.store (n + 1, std::memory_order_release);
+    }
+
+    ProcessingStats getSnapshot() const noexcept
+    {
+        ProcessingStats stats;
+
+        if (resetPending.load (std::memory_order_relaxed))
+            return stats;
+
+        stats.numBlocks = numBlocks.load (std::memory_order_acquire);
+
+        if (stats.numBlocks == 0)
+            return stats;
+
+        stats.numDeadlineMisses = numDeadlineMisses.load (std::memory_order_relaxed);
+        stats.minSeconds  = minSeconds.load (std::memory_order_relaxed);
+        stats.maxSeconds  = maxSeconds.load (std::memory_order_relaxed);
+        stats.meanSeconds = totalSeconds.load (std::memory_order_relaxed) / (double) stats.numBlocks;
+        stats.meanLoad    = totalLoad.load (std::memory_order_relaxed) / (double) stats.numBlocks;
+        stats.maxLoad     = maxLoad.load (std::memory_order_relaxed);
+
+        for (int i = 0; i < ProcessingStats::numHistogramBuckets; ++i)
+            stats.histogram[i] = histogram[i].load (std::memory_order_relaxed);
+
+        return stats;
+    }
+
+    void clear() noexcept
+    {
+        numBlocks = 0;
+        numDeadlineMisses = 0;
+        minSeconds = 0;
+        maxSeconds = 0;
+        totalSeconds = 0;
+        totalLoad = 0;
+        maxLoad = 0;
+
+        for (auto& h : histogram)
+            h = 0;
+    }
+
+    template <typename Type>
+    static void increment (std::atomic<Type>& value) noexcept
+    {
+        value.store (value.load (std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    std::atomic<int64> numBlocks, numDeadlineMisses;
+    std::atomic<double> minSeconds, maxSeconds, totalSeconds, totalLoad, maxLoad;
+    std::atomic<uint32> histogram[ProcessingStats::numHistogramBuckets];
+    std::atomic<bool> resetPending { false };
+};
+
+double AudioProcessorGraph::Node::ProcessingStats::getLoadPercentile (double percentile) const noexcept
+{
+    jassert (percentile >= 0 && percentile <= 100.0);
+
+    auto target = (double) numBlocks * percentile / 100.0;
+    int64 count = 0;
+
+    for (int i = 0; i < numHistogramBuckets; ++i)
+    {
+        count += histogram[i];
+
+        if ((double) count >= target && count > 0)
+            return jmin (maxLoad, (i + 1) * getHistogramBucketSize());
+    }
+
+    return maxLoad;
+}
+
 //==============================================================================
 AudioProcessorGraph::Node::Node (NodeID n, AudioProcessor* p) noexcept
-    : nodeID (n), processor (p)
+    : nodeID (n), processor (p), processingStats (new ProcessingStatsCollector())
 {
     jassert (processor != nullptr);
 }
 
+AudioProcessorGraph::Node::~Node()
+{
+}
+
 void AudioProcessorGraph::Node::prepare (double newSampleRate, int newBlockSize,
                                          AudioProcessorGraph* graph, ProcessingPrecision precision)
 {
@@ -865,6 +1159,22 @@ void AudioProcessorGraph::Node::setBypassed (bool shouldBeBypassed) noexcept
     bypassed = shouldBeBypassed;
 }
 
+//==============================================================================
+AudioProcessorGraph::Node::ProcessingStats AudioProcessorGraph::Node::getProcessingStats() const noexcept
+{
+    return processingStats->getSnapshot();
+}
+
+void AudioProcessorGraph::Node::resetProcessingStats() noexcept
+{
+    processingStats->resetPending = true;
+}
+
+void AudioProcessorGraph::Node::addProcessingTime (double seconds, double blockDurationSeconds) noexcept
+{
+    processingStats->addBlock (seconds, blockDurationSeconds);
+}
+
 //==============================================================================
 struct AudioProcessorGraph::RenderSequenceFloat   : public GraphRenderSequence<float> {};
 struct AudioProcessorGraph::RenderSequenceDouble  : public GraphRenderSequence<double> {};
@@ -900,6 +1210,8 @@ void AudioProcessorGraph::clear()
         return;
 
     nodes.clear();
+    renderOrder.clear();
+    renderOrderIsValid = true;
     topologyChanged();
 }
 
@@ -939,6 +1251,7 @@ AudioProcessorGraph::Node::Ptr AudioProcessorGraph::addNode (AudioProcessor* new
 
     Node::Ptr n (new Node (nodeID, newProcessor));
     nodes.add (n);
+    addToRenderOrder (n.get());
     n->setParentGraph (this);
     topologyChanged();
     return n;
@@ -951,6 +1264,7 @@ bool AudioProcessorGraph::removeNode (NodeID nodeId)
         if (nodes.getUnchecked(i)->nodeID == nodeId)
         {
             disconnectNode (nodeId);
+            removeFromRenderOrder (nodes.getUnchecked (i));
             nodes.remove (i);
             topologyChanged();
             return true;
@@ -1092,6 +1406,7 @@ bool AudioProcessorGraph::addConnection (const Connection& c)
             {
                 source->outputs.add ({ dest, destChan, sourceChan });
                 dest->inputs.add ({ source, sourceChan, destChan });
+                updateRenderOrderForConnection (source, dest);
                 jassert (isConnected (c));
                 topologyChanged();
                 return true;
@@ -1160,6 +1475,11 @@ bool AudioProcessorGraph::isConnectionLegal (const Connection& c) const
     return false;
 }
 
+void AudioProcessorGraph::setNodeTimingEnabled (bool shouldMeasureNodes) noexcept
+{
+    nodeTimingEnabled = shouldMeasureNodes ? 1 : 0;
+}
+
 bool AudioProcessorGraph::removeIllegalConnections()
 {
     bool anyRemoved = false;
@@ -1177,6 +1497,137 @@ bool AudioProcessorGraph::removeIllegalConnections()
     return anyRemoved;
 }
 
+//==============================================================================
+// The graph keeps its nodes in a topological order which is patched after each edit,
+// so that rebuilding the rendering sequence never has to sort the whole graph again.
+// While the graph contains a feedback loop, the order is left empty and the sequence
+// builder falls back to its own ordering.
+void AudioProcessorGraph::addToRenderOrder (Node* node)
+{
+    // an unconnected node can go anywhere, so just put it at the end
+    if (renderOrderIsValid)
+    {
+        node->renderOrderIndex = renderOrder.size();
+        renderOrder.add (node);
+    }
+}
+
+void AudioProcessorGraph::removeFromRenderOrder (Node* node)
+{
+    if (renderOrderIsValid)
+    {
+        jassert (renderOrder[node->renderOrderIndex] == node);
+        renderOrder.remove (node->renderOrderIndex);
+
+        for (int i = node->renderOrderIndex; i < renderOrder.size(); ++i)
+            renderOrder.getUnchecked (i)->renderOrderIndex = i;
+    }
+}
+
+void AudioProcessorGraph::updateRenderOrderForConnection (Node* source, Node* dest)
+{
+    if (! renderOrderIsValid || source->renderOrderIndex < dest->renderOrderIndex)
+        return;
+
+    // The new connection goes backwards, so this uses the Pearce-Kelly algorithm to only
+    // re-order the nodes which lie between the destination and the source: the ones that
+    // can be reached from the destination must move after the ones that lead to the source.
+    auto lowerBound = dest->renderOrderIndex;
+    auto upperBound = source->renderOrderIndex;
+
+    Array<Node*> forwardNodes, backwardNodes;
+    SortedSet<Node*> visited;
+
+    forwardNodes.add (dest);
+    visited.add (dest);
+
+    for (int i = 0; i < forwardNodes.size(); ++i)
+    {
+        for (auto& o : forwardNodes.getUnchecked (i)->outputs)
+        {
+            if (o.otherNode == source)
+            {
+                // this connection has created a feedback loop
+                renderOrderIsValid = false;
+                renderOrder.clear();
+                return;
+            }
+
+            if (o.otherNode->renderOrderIndex < upperBound && ! visited.contains (o.otherNode))
+            {
+                visited.add (o.otherNode);
+                forwardNodes.add (o.otherNode);
+            }
+        }
+    }
+
+    backwardNodes.add (source);
+    visited.add (source);
+
+    for (int i = 0; i < backwardNodes.size(); ++i)
+    {
+        for (auto& in : backwardNodes.getUnchecked (i)->inputs)
+        {
+            if (in.otherNode->renderOrderIndex > lowerBound && ! visited.contains (in.otherNode))
+            {
+                visited.add (in.otherNode);
+                backwardNodes.add (in.otherNode);
+            }
+        }
+    }
+
+    auto compareOrder = [] (Node* a, Node* b) { return a->renderOrderIndex < b->renderOrderIndex; };
+    std::sort (forwardNodes.begin(), forwardNodes.end(), compareOrder);
+    std::sort (backwardNodes.begin(), backwardNodes.end(), compareOrder);
+
+    Array<int> freeSlots;
+
+    for (auto* n : backwardNodes)   freeSlots.add (n->renderOrderIndex);
+    for (auto* n : forwardNodes)    freeSlots.add (n->renderOrderIndex);
+
+    freeSlots.sort();
+
+    int slot = 0;
+
+    for (auto* n : backwardNodes)   renderOrder.set (n->renderOrderIndex = freeSlots.getUnchecked (slot++), n);
+    for (auto* n : forwardNodes)    renderOrder.set (n->renderOrderIndex = freeSlots.getUnchecked (slot++), n);
+}
+
+bool AudioProcessorGraph::sortRenderOrder()
+{
+    // Kahn's algorithm, using the render order indexes to count each node's pending inputs
+    renderOrder.clearQuick();
+
+    for (auto* node : nodes)
+        node->renderOrderIndex = 0;
+
+    for (auto* node : nodes)
+        for (auto& o : node->outputs)
+            ++(o.otherNode->renderOrderIndex);
+
+    for (auto* node : nodes)
+        if (node->renderOrderIndex == 0)
+            renderOrder.add (node);
+
+    for (int i = 0; i < renderOrder.size(); ++i)
+        for (auto& o : renderOrder.getUnchecked (i)->outputs)
+            if (--(o.otherNode->renderOrderIndex) == 0)
+                renderOrder.add (o.otherNode);
+
+    renderOrderIsValid = (renderOrder.size() == nodes.size());
+
+    if (! renderOrderIsValid)
+    {
+        renderOrder.clear();
+        return false;
+    }
+
+    for (int i = 0; i < renderOrder.size(); ++i)
+        renderOrder.getUnchecked (i)->renderOrderIndex = i;
+
+    return true;
+}
+
 //==============================================================================
 void AudioProcessorGraph::clearRenderingSequence()
 {
@@ -1207,14 +1658,11 @@ void AudioProcessorGraph::buildRenderingSequence()
     {
         MessageManagerLock mml;
 
-        RenderSequenceBuilder<RenderSequenceFloat>  builderF (*this, *newSequenceF);
-        RenderSequenceBuilder<RenderSequenceDouble> builderD (*this, *newSequenceD);
-    }
+        if (! renderOrderIsValid)
+            sortRenderOrder();
 
-    {
-        const ScopedLock sl (getCallbackLock());
-        newSequenceF->prepareBuffers (getBlockSize());
-        newSequenceD->prepareBuffers (getBlockSize());
+        RenderSequenceBuilder<RenderSequenceFloat>  builderF (*this, *newSequenceF, renderOrder);
+        RenderSequenceBuilder<RenderSequenceDouble> builderD (*this, *newSequenceD, renderOrder);
     }
 
     if (anyNodesNeedPreparing())
@@ -1229,10 +1677,27 @@ void AudioProcessorGraph::buildRenderingSequence()
             node->prepare (getSampleRate(), getBlockSize(), this, getProcessingPrecision());
     }
 
-    const ScopedLock sl (getCallbackLock());
+    {
+        const ScopedLock sl (getCallbackLock());
+
+        newSequenceF->prepareBuffers (getBlockSize(), renderSequenceFloat.get());
+        newSequenceD->prepareBuffers (getBlockSize(), renderSequenceDouble.get());
 
-    std::swap (renderSequenceFloat, newSequenceF);
-    std::swap (renderSequenceDouble, newSequenceD);
+        std::swap (renderSequenceFloat, newSequenceF);
+        std::swap (renderSequenceDouble, newSequenceD);
+    }
+
+    renderingStats.numAudioBuffers   = renderSequenceFloat->numBuffersNeeded;
+    renderingStats.numMidiBuffers    = renderSequenceFloat->numMidiBuffersNeeded;
+    renderingStats.numDelayLines     = renderSequenceFloat->numDelayLines;
+    renderingStats.totalDelaySamples = renderSequenceFloat->totalDelaySamples;
+    renderingStats.numBytes          = renderSequenceFloat->getNumBytesAllocated()
+                                         + renderSequenceDouble->getNumBytesAllocated();
+}
+
+void AudioProcessorGraph::rebuild()
+{
+    handleUpdateNowIfNeeded();
 }
 
 void AudioProcessorGraph::handleAsyncUpdate()
@@ -1311,7 +1776,8 @@ static void processBlockForBuffer (AudioBuffer<FloatType>& buffer, MidiBuffer& m
         const ScopedLock sl (graph.getCallbackLock());
 
         if (renderSequence != nullptr)
-            renderSequence->perform (buffer, midiMessages, graph.getPlayHead());
+            renderSequence->perform (buffer, midiMessages, graph.getPlayHead(),
+                                     graph.getSampleRate(), graph.isNodeTimingEnabled());
     }
     else
     {
@@ -1320,7 +1786,8 @@ static void processBlockForBuffer (AudioBuffer<FloatType>& buffer, MidiBuffer& m
         if (isPrepared.get() == 1)
         {
             if (renderSequence != nullptr)
-                renderSequence->perform (buffer, midiMessages, graph.getPlayHead());
+                renderSequence->perform (buffer, midiMessages, graph.getPlayHead(),
+                                         graph.getSampleRate(), graph.isNodeTimingEnabled());
         }
         else
         {
@@ -115,10 +115,65 @@ public:
         /** Tell this node to bypass processing. */
         void setBypassed (bool shouldBeBypassed) noexcept;
 
+        //==============================================================================
+        /** A snapshot of the time spent processing this node.
+
+            These are only measured while AudioProcessorGraph::setNodeTimingEnabled() is
+            turned on. The load of a block is the time that was spent processing it,
+            divided by the real-time duration of the block.
+
+            @see getProcessingStats
+        */
+        struct ProcessingStats
+        {
+            enum { numHistogramBuckets = 64 };
+
+            /** Returns the range of load covered by each bucket of the histogram.
+                The last bucket also counts all the blocks with a higher load.
+            */
+            static double getHistogramBucketSize() noexcept     { return 1.0 / 32.0; }
+
+            /** Returns an estimate of a percentile (0 to 100) of the load of this
+                node, taken from the upper edge of the matching histogram bucket.
+            */
+            double getLoadPercentile (double percentile) const noexcept;
+
+            int64 numBlocks = 0;            /**< The number of blocks that were measured. */
+            int64 numDeadlineMisses = 0;    /**< The number of blocks whose load was over 1, i.e. for which
+                                                 this node alone took longer than the duration of the block. */
+            double minSeconds = 0;          /**< The shortest time spent processing a block. */
+            double meanSeconds = 0;         /**< The average time spent processing a block. */
+            double maxSeconds = 0;          /**< The longest time spent processing a block. */
+            double meanLoad = 0;            /**< The average load of the blocks. */
+            double maxLoad = 0;             /**< The highest load of any block. */
+
+            /** The number of blocks whose load fell into each bucket. */
+            uint32 histogram[numHistogramBuckets] = {};
+        };
+
+        /** Returns the processing statistics of this node.
+
+            This is wait-free, so it can be polled from the message thread while the
+            audio thread is rendering. The counters are updated independently, so a
+            snapshot taken in the middle of a block may mix values from two blocks.
+        */
+        ProcessingStats getProcessingStats() const noexcept;
+
+        /** Clears the processing statistics.
+            The counters are actually reset by the audio thread before it measures the next block.
+        */
+        void resetProcessingStats() noexcept;
+
+        /** @internal */
+        void addProcessingTime (double seconds, double blockDurationSeconds) noexcept;
+
         //==============================================================================
         /** A convenient typedef for referring to a pointer to a node object. */
         using Ptr = ReferenceCountedObjectPtr<Node>;
 
+        /** Destructor. */
+        ~Node();
+
     private:
         //==============================================================================
         friend class AudioProcessorGraph;
@@ -131,9 +186,13 @@ public:
             bool operator== (const Connection&) const noexcept;
         };
 
+        struct ProcessingStatsCollector;
+
         const std::unique_ptr<AudioProcessor> processor;
+        const std::unique_ptr<ProcessingStatsCollector> processingStats;
         Array<Connection> inputs, outputs;
         bool isPrepared = false, bypassed = false;
+        int renderOrderIndex = -1;
 
         Node (NodeID, AudioProcessor*) noexcept;
 
@@ -262,6 +321,54 @@ public:
     */
     bool removeIllegalConnections();
 
+    /** Updates the rendering sequence straight away if the graph has been changed.
+
+        The graph normally does this asynchronously on the message thread after its nodes
+        or connections have been edited, but calling this lets you make sure that a batch of
+        changes has been applied before the next block is processed. Only the parts of the
+        node ordering affected by each edit are recalculated, so this is cheap even for
+        large graphs.
+    */
+    void rebuild();
+
+    //==============================================================================
+    /** Enables or disables the measurement of the time spent processing each node.
+
+        While this is enabled, the rendering thread times every node's processBlock()
+        call, and the results can be read with Node::getProcessingStats(), e.g. to show
+        the DSP load of each plug-in, or to find which one caused an overrun.
+    */
+    void setNodeTimingEnabled (bool shouldMeasureNodes) noexcept;
+
+    /** Returns true if the time spent processing each node is being measured.
+        @see setNodeTimingEnabled
+    */
+    bool isNodeTimingEnabled() const noexcept                       { return nodeTimingEnabled.get() != 0; }
+
+    //==============================================================================
+    /** Describes the buffers and delay lines used to render the graph.
+        @see getRenderingStats
+    */
+    struct RenderingStats
+    {
+        int numAudioBuffers = 0;        /**< The number of audio channels used to pass audio between the nodes. */
+        int numMidiBuffers = 0;         /**< The number of buffers used to pass MIDI between the nodes. */
+        int numDelayLines = 0;          /**< The number of delay lines used to compensate for the latency of the nodes. */
+        int64 totalDelaySamples = 0;    /**< The total length of all the delay lines. */
+        size_t numBytes = 0;            /**< The memory taken by the audio buffers and delay lines, for both
+                                             the single and double precision versions of the sequence. */
+    };
+
+    /** Returns some statistics about the memory used by the current rendering sequence.
+
+        The audio buffers are allocated by colouring the intervals during which each
+        channel is in use, so channels whose lifetimes don't overlap share a buffer, and
+        an output that several inputs need to delay by the same amount only needs one
+        delay line. These figures are updated whenever the sequence is rebuilt, and
+        should only be read on the message thread.
+    */
+    RenderingStats getRenderingStats() const noexcept               { return renderingStats; }
+
     //==============================================================================
     /** A special type of AudioProcessor that can live inside an AudioProcessorGraph
         in order to use the audio that comes into and out of the graph itself.
@@ -385,12 +492,20 @@ private:
 
     friend class AudioGraphIOProcessor;
 
-    Atomic<int> isPrepared { 0 };
+    Atomic<int> isPrepared { 0 }, nodeTimingEnabled { 0 };
+
+    Array<Node*> renderOrder;
+    bool renderOrderIsValid = true;
+    RenderingStats renderingStats;
 
     void topologyChanged();
     void handleAsyncUpdate() override;
     void clearRenderingSequence();
     void buildRenderingSequence();
+    void addToRenderOrder (Node*);
+    void removeFromRenderOrder (Node*);
+    void updateRenderOrderForConnection (Node* src, Node* dest);
+    bool sortRenderOrder();
     bool anyNodesNeedPreparing() const noexcept;
     bool isConnected (Node* src, int sourceChannel, Node* dest, int destChannel) const noexcept;
     bool isAnInputTo (Node& src, Node& dst, int recursionCheck) const noexcept;
@@ -0,0 +1,536 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 5 End-User License
+   Agreement and JUCE 5 Privacy Policy (both updated and effective as of the
+   27th April 2017).
+
+   End User License Agreement: www.juce.com/juce-5-licence
+   Privacy Policy: www.juce.com/juce-5-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+struct AudioProcessorGraphTests  : public UnitTest
+{
+    AudioProcessorGraphTests()  : UnitTest ("AudioProcessorGraph", "Audio Processors") {}
+
+    struct TestProcessor  : public AudioProcessor
+    {
+        TestProcessor (float gainToApply = 0.5f, int latency = 0)
+            : AudioProcessor (BusesProperties().withInput  ("Input",  AudioChannelSet::stereo())
+                                               .withOutput ("Output", AudioChannelSet::stereo())),
+              gain (gainToApply), delayLine (2, latency + 1)
+        {
+            setLatencySamples (latency);
+            delayLine.clear();
+        }
+
+        const String getName() const override                        { return "Test"; }
+        void prepareToPlay (double, int) override                    {}
+        void releaseResources() override                             {}
+        double getTailLengthSeconds() const override                 { return 0; }
+        bool acceptsMidi() const override                            { return false; }
+        bool producesMidi() const override                           { return false; }
+        AudioProcessorEditor* createEditor() override                { return nullptr; }
+        bool hasEditor() const override                              { return false; }
+        int getNumPrograms() override                                { return 1; }
+        int getCurrentProgram() override                             { return 0; }
+        void setCurrentProgram (int) override                        {}
+        const String getProgramName (int) override                   { return {}; }
+        void changeProgramName (int, const String&) override         {}
+        void getStateInformation (juce::MemoryBlock&) override       {}
+        void setStateInformation (const void*, int) override         {}
+
+        void processBlock (AudioBuffer<float>& buffer, MidiBuffer&) override
+        {
+            auto endTicks = Time::getHighResolutionTicks()
+                              + Time::secondsToHighResolutionTicks (busySeconds.load());
+
+            while (Time::getHighResolutionTicks() < endTicks)
+            {}
+
+            buffer.applyGain (gain);
+
+            auto latency = getLatencySamples();
+            int writePosition = 0;
+
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            {
+                auto* data = buffer.getWritePointer (ch);
+                auto* line = delayLine.getWritePointer (ch);
+                writePosition = delayPosition;
+
+                for (int i = 0; i < buffer.getNumSamples(); ++i)
+                {
+                    line[writePosition] = data[i];
+
+                    if (++writePosition > latency)
+                        writePosition = 0;
+
+                    data[i] = line[writePosition];
+                }
+            }
+
+            delayPosition = writePosition;
+        }
+
+        std::atomic<double> busySeconds { 0.0 };
+        const float gain;
+        AudioBuffer<float> delayLine;
+        int delayPosition = 0;
+    };
+
+    using Node = AudioProcessorGraph::Node;
+    using IOProcessor = AudioProcessorGraph::AudioGraphIOProcessor;
+
+    static void connectStereo (AudioProcessorGraph& graph, Node* source, Node* dest)
+    {
+        for (int i = 0; i < 2; ++i)
+            graph.addConnection ({ { source->nodeID, i }, { dest->nodeID, i } });
+    }
+
+    void expectOutputGain (AudioProcessorGraph& graph, float expectedGain)
+    {
+        AudioBuffer<float> buffer (2, graph.getBlockSize());
+        MidiBuffer midi;
+
+        graph.rebuild();
+
+        for (int ch = 0; ch < 2; ++ch)
+            FloatVectorOperations::fill (buffer.getWritePointer (ch), 1.0f, buffer.getNumSamples());
+
+        graph.processBlock (buffer, midi);
+
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            auto range = buffer.findMinMax (ch, 0, buffer.getNumSamples());
+            expectWithinAbsoluteError (range.getStart(), expectedGain, 1.0e-6f);
+            expectWithinAbsoluteError (range.getEnd(),   expectedGain, 1.0e-6f);
+        }
+    }
+
+    void runIncrementalRebuildTests()
+    {
+        beginTest ("Connections made in reverse order");
+
+        AudioProcessorGraph graph;
+        graph.setPlayConfigDetails (2, 2, 44100.0, 256);
+        graph.prepareToPlay (44100.0, 256);
+
+        auto input  = graph.addNode (new IOProcessor (IOProcessor::audioInputNode));
+        auto output = graph.addNode (new IOProcessor (IOProcessor::audioOutputNode));
+
+        ReferenceCountedArray<Node> chain;
+
+        for (int i = 0; i < 6; ++i)
+            chain.add (graph.addNode (new TestProcessor()));
+
+        connectStereo (graph, chain.getLast(), output);
+
+        for (int i = chain.size() - 1; --i >= 0;)
+            connectStereo (graph, chain[i], chain[i + 1]);
+
+        connectStereo (graph, input, chain.getFirst());
+        expectOutputGain (graph, std::pow (0.5f, 6.0f));
+
+        beginTest ("Feedback loops");
+        {
+            graph.addConnection ({ { chain[4]->nodeID, 0 }, { chain[1]->nodeID, 0 } });
+            graph.rebuild();
+
+            AudioBuffer<float> buffer (2, 256);
+            MidiBuffer midi;
+            buffer.clear();
+            graph.processBlock (buffer, midi);
+
+            graph.removeConnection ({ { chain[4]->nodeID, 0 }, { chain[1]->nodeID, 0 } });
+            expectOutputGain (graph, std::pow (0.5f, 6.0f));
+        }
+
+        beginTest ("Removing nodes");
+        {
+            graph.removeNode (chain[3]);
+            connectStereo (graph, chain[2], chain[4]);
+            expectOutputGain (graph, std::pow (0.5f, 5.0f));
+
+            auto extra = graph.addNode (new TestProcessor());
+            connectStereo (graph, chain.getLast(), extra);
+            graph.disconnectNode (output->nodeID);
+            connectStereo (graph, extra, output);
+            expectOutputGain (graph, std::pow (0.5f, 6.0f));
+        }
+    }
+
+    static AudioBuffer<float> renderImpulse (AudioProcessorGraph& graph, int numBlocks, int impulsePosition)
+    {
+        auto blockSize = graph.getBlockSize();
+        AudioBuffer<float> result (2, blockSize * numBlocks);
+        MidiBuffer midi;
+
+        graph.rebuild();
+        graph.reset();
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            AudioBuffer<float> buffer (result.getArrayOfWritePointers(), 2, block * blockSize, blockSize);
+            buffer.clear();
+
+            if (block == 0)
+                for (int ch = 0; ch < 2; ++ch)
+                    buffer.setSample (ch, impulsePosition, 1.0f);
+
+            graph.processBlock (buffer, midi);
+        }
+
+        return result;
+    }
+
+    void expectImpulse (const AudioBuffer<float>& response, int position, float expectedLevel0, float expectedLevel1)
+    {
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            auto expectedLevel = ch == 0 ? expectedLevel0 : expectedLevel1;
+            auto tolerance = 1.0e-4f * jmax (1.0f, std::abs (expectedLevel));
+            int numWrongSamples = 0;
+
+            for (int i = 0; i < response.getNumSamples(); ++i)
+                if (std::abs (response.getSample (ch, i) - (i == position ? expectedLevel : 0.0f)) > tolerance)
+                    ++numWrongSamples;
+
+            expectEquals (numWrongSamples, 0);
+        }
+    }
+
+    void runLatencyCompensationTests()
+    {
+        beginTest ("Latency compensation in random graphs");
+
+        struct Link { int source, sourceChannel, dest, destChannel; };
+
+        const int numNodes = 10, impulsePosition = 5;
+        const int possibleLatencies[] = { 0, 0, 3, 8, 20 };
+        auto random = getRandom();
+
+        for (int iteration = 0; iteration < 20; ++iteration)
+        {
+            AudioProcessorGraph graph;
+            graph.setPlayConfigDetails (2, 2, 44100.0, 256);
+            graph.prepareToPlay (44100.0, 256);
+
+            // index 0 is the graph's input, and numNodes + 1 is its output
+            ReferenceCountedArray<Node> nodes;
+            Array<float> gains;
+            Array<int> latencies;
+            Array<Link> links;
+
+            nodes.add (graph.addNode (new IOProcessor (IOProcessor::audioInputNode)));
+            gains.add (1.0f);
+            latencies.add (0);
+
+            for (int i = 0; i < numNodes; ++i)
+            {
+                gains.add (0.5f + random.nextFloat());
+                latencies.add (possibleLatencies[random.nextInt (numElementsInArray (possibleLatencies))]);
+                nodes.add (graph.addNode (new TestProcessor (gains.getLast(), latencies.getLast())));
+            }
+
+            nodes.add (graph.addNode (new IOProcessor (IOProcessor::audioOutputNode)));
+            gains.add (1.0f);
+            latencies.add (0);
+
+            for (int dest = 1; dest < nodes.size(); ++dest)
+            {
+                for (int source = 0; source < dest; ++source)
+                {
+                    if (random.nextInt (3) == 0)
+                    {
+                        Link link { source, random.nextInt (2), dest, random.nextInt (2) };
+
+                        if (graph.addConnection ({ { nodes[source]->nodeID, link.sourceChannel },
+                                                   { nodes[dest]->nodeID,   link.destChannel } }))
+                            links.add (link);
+                    }
+                }
+            }
+
+            // work out the level that should come out of each channel, and when
+            Array<float> levels { 1.0f, 1.0f };
+            Array<int> delays { 0 };
+
+            for (int node = 1; node < nodes.size(); ++node)
+            {
+                float sums[2] = {};
+                int maxInputDelay = 0;
+
+                for (auto& link : links)
+                {
+                    if (link.dest == node)
+                    {
+                        sums[link.destChannel] += levels[link.source * 2 + link.sourceChannel];
+                        maxInputDelay = jmax (maxInputDelay, delays[link.source]);
+                    }
+                }
+
+                levels.add (sums[0] * gains[node]);
+                levels.add (sums[1] * gains[node]);
+                delays.add (maxInputDelay + latencies[node]);
+            }
+
+            auto totalLatency = delays.getLast();
+            auto response = renderImpulse (graph, 3, impulsePosition);
+            expectEquals (graph.getLatencySamples(), totalLatency);
+
+            expectImpulse (response, impulsePosition + totalLatency,
+                           levels[levels.size() - 2], levels.getLast());
+        }
+    }
+
+    void runBufferAssignmentTests()
+    {
+        beginTest ("Wide graphs");
+        {
+            AudioProcessorGraph graph;
+            graph.setPlayConfigDetails (2, 2, 44100.0, 256);
+            graph.prepareToPlay (44100.0, 256);
+
+            auto input  = graph.addNode (new IOProcessor (IOProcessor::audioInputNode));
+            auto output = graph.addNode (new IOProcessor (IOProcessor::audioOutputNode));
+
+            for (int i = 0; i < 64; ++i)
+            {
+                auto branch = graph.addNode (new TestProcessor (1.0f, (i % 4) * 16));
+                connectStereo (graph, input, branch);
+                connectStereo (graph, branch, output);
+            }
+
+            expectImpulse (renderImpulse (graph, 2, 5), 5 + 48, 64.0f, 64.0f);
+
+            auto stats = graph.getRenderingStats();
+            expect (stats.numAudioBuffers <= 8, "the branches should share their buffers");
+            expectEquals (stats.numDelayLines, 96);
+            expectEquals ((int) stats.totalDelaySamples, 2 * 16 * (16 + 32 + 48));
+            expect (stats.numBytes > 0);
+        }
+
+        beginTest ("Shared delay lines");
+        {
+            AudioProcessorGraph graph;
+            graph.setPlayConfigDetails (2, 2, 44100.0, 256);
+            graph.prepareToPlay (44100.0, 256);
+
+            auto input  = graph.addNode (new IOProcessor (IOProcessor::audioInputNode));
+            auto output = graph.addNode (new IOProcessor (IOProcessor::audioOutputNode));
+            auto latent = graph.addNode (new TestProcessor (1.0f, 32));
+            auto direct = graph.addNode (new TestProcessor (1.0f, 0));
+
+            connectStereo (graph, input, latent);
+            connectStereo (graph, input, direct);
+
+            for (int i = 0; i < 16; ++i)
+            {
+                auto mixer = graph.addNode (new TestProcessor (1.0f, 0));
+                connectStereo (graph, latent, mixer);
+                connectStereo (graph, direct, mixer);
+                connectStereo (graph, mixer, output);
+            }
+
+            expectImpulse (renderImpulse (graph, 2, 5), 5 + 32, 32.0f, 32.0f);
+
+            // the direct path only needs delaying once for all the mixers
+            auto stats = graph.getRenderingStats();
+            expectEquals (stats.numDelayLines, 2);
+            expectEquals ((int) stats.totalDelaySamples, 64);
+        }
+    }
+
+    void runEditLatencyBenchmark()
+    {
+        beginTest ("Benchmark: edit and rebuild latency");
+
+        for (auto numNodes : { 50, 200, 500 })
+        {
+            AudioProcessorGraph graph;
+            graph.setPlayConfigDetails (2, 2, 44100.0, 256);
+            graph.prepareToPlay (44100.0, 256);
+
+            auto input  = graph.addNode (new IOProcessor (IOProcessor::audioInputNode));
+            auto output = graph.addNode (new IOProcessor (IOProcessor::audioOutputNode));
+
+            ReferenceCountedArray<Node> chain;
+
+            for (int i = 0; i < numNodes; ++i)
+            {
+                chain.add (graph.addNode (new TestProcessor()));
+                connectStereo (graph, i == 0 ? input.get() : chain[i - 1].get(), chain[i]);
+            }
+
+            connectStereo (graph, chain.getLast(), output);
+            expectOutputGain (graph, std::pow (0.5f, (float) numNodes));
+
+            auto random = getRandom();
+            const int numEdits = 10;
+            auto startTicks = Time::getHighResolutionTicks();
+
+            for (int i = 0; i < numEdits; ++i)
+            {
+                auto index = 1 + random.nextInt (numNodes - 1);
+                AudioProcessorGraph::Connection c { { chain[index - 1]->nodeID, 0 }, { chain[index]->nodeID, 0 } };
+
+                graph.removeConnection (c);
+                graph.rebuild();
+                graph.addConnection (c);
+                graph.rebuild();
+            }
+
+            auto seconds = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - startTicks);
+
+            logMessage ("  " + String (numNodes) + " nodes: " + String (seconds * 1000.0 / (numEdits * 2), 3)
+                          + " ms per edit and rebuild");
+
+            expectOutputGain (graph, std::pow (0.5f, (float) numNodes));
+        }
+    }
+
+    void runProcessingStatsTests()
+    {
+        const double sampleRate = 48000.0;
+        const int blockSize = 480;
+        const double blockDuration = blockSize / sampleRate;
+
+        AudioProcessorGraph graph;
+        graph.setPlayConfigDetails (2, 2, sampleRate, blockSize);
+        graph.prepareToPlay (sampleRate, blockSize);
+
+        auto* busy = new TestProcessor();
+        busy->busySeconds = blockDuration * 0.2;
+        auto node = graph.addNode (busy);
+
+        AudioBuffer<float> buffer (2, blockSize);
+        MidiBuffer midi;
+
+        auto processBlocks = [&] (int numBlocks)
+        {
+            for (int i = 0; i < numBlocks; ++i)
+            {
+                buffer.clear();
+                graph.processBlock (buffer, midi);
+            }
+        };
+
+        beginTest ("Timing is disabled by default");
+        {
+            processBlocks (2);
+            expect (! graph.isNodeTimingEnabled());
+            expectEquals ((int) node->getProcessingStats().numBlocks, 0);
+        }
+
+        beginTest ("Measuring the nodes");
+        {
+            graph.setNodeTimingEnabled (true);
+            processBlocks (8);
+
+            // The processor spins for at least busySeconds, but the scheduler can make
+            // any block take longer, so only the lower bounds are checked here
+            auto stats = node->getProcessingStats();
+            expectEquals ((int) stats.numBlocks, 8);
+            expect (stats.minSeconds >= blockDuration * 0.2);
+            expect (stats.meanLoad >= 0.2);
+
+            graph.setNodeTimingEnabled (false);
+            processBlocks (2);
+            expectEquals ((int) node->getProcessingStats().numBlocks, 8);
+        }
+
+        // The rest of the tests pass the processing times in directly, so that
+        // the results don't depend on how the test thread gets scheduled
+        auto addBlocks = [&] (std::initializer_list<double> loads)
+        {
+            for (auto load : loads)
+                node->addProcessingTime (blockDuration * load, blockDuration);
+        };
+
+        beginTest ("Processing statistics");
+        {
+            node->resetProcessingStats();
+            addBlocks ({ 0.2, 0.25, 0.3, 0.35, 0.4, 0.45, 0.5, 0.55 });
+
+            auto stats = node->getProcessingStats();
+            expectEquals ((int) stats.numBlocks, 8);
+            expectEquals ((int) stats.numDeadlineMisses, 0);
+            expectWithinAbsoluteError (stats.minSeconds, blockDuration * 0.2, 1.0e-12);
+            expectWithinAbsoluteError (stats.maxSeconds, blockDuration * 0.55, 1.0e-12);
+            expect (stats.minSeconds <= stats.meanSeconds && stats.meanSeconds <= stats.maxSeconds);
+            expectWithinAbsoluteError (stats.meanLoad, 0.375, 1.0e-12);
+            expectWithinAbsoluteError (stats.maxLoad, 0.55, 1.0e-12);
+            expectWithinAbsoluteError (stats.getLoadPercentile (50.0), 12.0 / 32.0, 1.0e-12);
+
+            uint32 histogramTotal = 0;
+
+            for (auto count : stats.histogram)
+                histogramTotal += count;
+
+            expectEquals ((int) histogramTotal, 8);
+        }
+
+        beginTest ("Deadline misses");
+        {
+            addBlocks ({ 1.1, 1.5 });
+
+            auto stats = node->getProcessingStats();
+            expectEquals ((int) stats.numBlocks, 10);
+            expectEquals ((int) stats.numDeadlineMisses, 2);
+            expectWithinAbsoluteError (stats.maxLoad, 1.5, 1.0e-12);
+
+            uint32 numOverloadedBlocks = 0;
+
+            for (int i = 32; i < AudioProcessorGraph::Node::ProcessingStats::numHistogramBuckets; ++i)
+                numOverloadedBlocks += stats.histogram[i];
+
+            expectEquals ((int) numOverloadedBlocks, 2);
+        }
+
+        beginTest ("Resetting the statistics");
+        {
+            node->resetProcessingStats();
+            expectEquals ((int) node->getProcessingStats().numBlocks, 0);
+
+            addBlocks ({ 0.1, 0.15, 0.05 });
+
+            auto stats = node->getProcessingStats();
+            expectEquals ((int) stats.numBlocks, 3);
+            expectEquals ((int) stats.numDeadlineMisses, 0);
+            expect (stats.minSeconds <= stats.meanSeconds && stats.meanSeconds <= stats.maxSeconds);
+            expectWithinAbsoluteError (stats.maxLoad, 0.15, 1.0e-12);
+        }
+    }
+
+    void runTest() override
+    {
+        runIncrementalRebuildTests();
+        runLatencyCompensationTests();
+        runBufferAssignmentTests();
+        runEditLatencyBenchmark();
+        runProcessingStatsTests();
+    }
+};
+
+static AudioProcessorGraphTests audioProcessorGraphTests;
+
+} // namespace juce
@@ -142,7 +142,12 @@ private:
     struct CodeLocation
     {
         CodeLocation (const String& code) noexcept        : program (code), location (program.getCharPointer()) {}
-        CodeLocation (const CodeLocation& other) noexcept : program (other.program), location (other.location) {}
+        CodeLocation (const CodeLocation& other) noexcept
+            : program (other.program),
+              location (addBytesToPointer (program.getCharPointer().getAddress(),
+                                           (int) (other.location.getAddress() - other.program.getCharPointer().getAddress())))
+        {
+        }
 
         [[noreturn]] void throwError (const String& message) const
         {
@@ -164,7 +169,7 @@ private:
     //==============================================================================
     struct TokenIterator
     {
-        TokenIterator (const String& code) : location (code), p (code.getCharPointer()) { skip(); }
+        TokenIterator (const String& code) : location (code), p (location.program.getCharPointer()) { skip(); }
 
         TokenType skip()
         {
@@ -0,0 +1,830 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 5 End-User License
+   Agreement and JUCE 5 Privacy Policy (both updated and effective as of the
+   27th April 2017).
+
+   End User License Agreement: www.juce.com/juce-5-licence
+   Privacy Policy: www.juce.com/juce-5-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#if JUCE_INTEL && (defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2))
+ #define JUCE_FLAT_HASH_USE_SSE2 1
+ #include <emmintrin.h>
+#else
+ #define JUCE_FLAT_HASH_USE_SSE2 0
+#endif
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Generates full-width hash values for use with FlatHashMap and FlatHashSet.
+
+    All the string-like types are hashed from their characters, so a map with
+    String or Identifier keys can be searched using a StringRef or a const char*
+    without having to create a temporary String.
+
+    @see FlatHashMap, FlatHashSet, DefaultHashFunctions
+
+    @tags{Core}
+*/
+struct FlatHashFunctions
+{
+    /** Generates a hash from an unsigned int. */
+    static uint64 generateHash (uint32 key) noexcept                { return key; }
+    /** Generates a hash from an integer. */
+    static uint64 generateHash (int32 key) noexcept                 { return (uint32) key; }
+    /** Generates a hash from a uint64. */
+    static uint64 generateHash (uint64 key) noexcept                { return key; }
+    /** Generates a hash from an int64. */
+    static uint64 generateHash (int64 key) noexcept                 { return (uint64) key; }
+    /** Generates a hash from a void ptr. */
+    static uint64 generateHash (const void* key) noexcept           { return (uint64) (pointer_sized_uint) key; }
+    /** Generates a hash from a string. */
+    static uint64 generateHash (const String& key) noexcept         { return hashText (key.getCharPointer()); }
+    /** Generates a hash from a string. */
+    static uint64 generateHash (StringRef key) noexcept             { return hashText (key.text); }
+    /** Generates a hash from a string. */
+    static uint64 generateHash (const char* key) noexcept           { return hashText (CharPointer_UTF8 (key)); }
+    /** Generates a hash from an Identifier. */
+    static uint64 generateHash (const Identifier& key) noexcept     { return hashText (key.getCharPointer()); }
+    /** Generates a hash from a variant. */
+    static uint64 generateHash (const var& key)                     { return generateHash (key.toString()); }
+    /** Generates a hash from a UUID. */
+    static uint64 generateHash (const Uuid& key) noexcept           { return key.hash(); }
+
+    /** Generates a hash from a sequence of characters. */
+    template <typename CharPointerType>
+    static uint64 hashText (CharPointerType text) noexcept
+    {
+        uint64 result = 14695981039346656037ULL;
+
+        while (! text.isEmpty())
+            result = (result ^ (uint64) text.getAndAdvance()) * 1099511628211ULL;
+
+        return result;
+    }
+};
+
+#ifndef DOXYGEN
+namespace FlatHashHelpers
+{
+    /*  The table stores one control byte per slot, which is either empty, deleted, or
+        holds the bottom 7 bits of the hash of the key in that slot. The slots are searched
+        a group at a time, so that a whole group's control bytes can be compared at once.
+    */
+    enum : int8 { emptySlot = -128, deletedSlot = -2 };
+    enum { groupSize = 16 };
+
+    struct Group
+    {
+        explicit Group (const int8* controlBytes) noexcept
+        {
+           #if JUCE_FLAT_HASH_USE_SSE2
+            control = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (controlBytes));
+           #else
+            memcpy (control, controlBytes, groupSize);
+           #endif
+        }
+
+        // returns a mask with a bit set for each slot whose control byte matches
+        uint32 match (int8 value) const noexcept
+        {
+           #if JUCE_FLAT_HASH_USE_SSE2
+            return (uint32) _mm_movemask_epi8 (_mm_cmpeq_epi8 (control, _mm_set1_epi8 (value)));
+           #else
+            uint32 mask = 0;
+
+            for (int i = 0; i < groupSize; ++i)
+                if (control[i] == value)
+                    mask |= (1u << i);
+
+            return mask;
+           #endif
+        }
+
+        uint32 matchEmpty() const noexcept      { return match (emptySlot); }
+
+        uint32 matchEmptyOrDeleted() const noexcept
+        {
+           #if JUCE_FLAT_HASH_USE_SSE2
+            return (uint32) _mm_movemask_epi8 (control);
+           #else
+            uint32 mask = 0;
+
+            for (int i = 0; i < groupSize; ++i)
+                if (control[i] < 0)
+                    mask |= (1u << i);
+
+            return mask;
+           #endif
+        }
+
+       #if JUCE_FLAT_HASH_USE_SSE2
+        __m128i control;
+       #else
+        int8 control[groupSize];
+       #endif
+    };
+
+    // spreads the bits of a possibly poor-quality hash across the whole word
+    inline uint64 mixHash (uint64 h) noexcept
+    {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        return h ^ (h >> 33);
+    }
+
+    //==============================================================================
+    template <typename KeyType, typename EntryType, typename HashFunctionType>
+    class Table
+    {
+    public:
+        Table (int initialCapacity, const HashFunctionType& hashFunction)
+            : hashFunctionToUse (hashFunction)
+        {
+            reserve (initialCapacity);
+        }
+
+        Table (const Table& other)
+            : hashFunctionToUse (other.hashFunctionToUse)
+        {
+            reserve (other.numItems);
+
+            for (int i = 0; i < other.capacity; ++i)
+                if (other.control[(size_t) i] >= 0)
+                    insertUnique (other.getEntry (i));
+        }
+
+        Table (Table&& other) noexcept
+            : hashFunctionToUse (other.hashFunctionToUse)
+        {
+            swapWith (other);
+        }
+
+        Table& operator= (const Table& other)
+        {
+            if (this != &other)
+            {
+                Table copy (other);
+                swapWith (copy);
+            }
+
+            return *this;
+        }
+
+        Table& operator= (Table&& other) noexcept
+        {
+            swapWith (other);
+            return *this;
+        }
+
+        ~Table()
+        {
+            destroyEntries();
+        }
+
+        //==============================================================================
+        int size() const noexcept           { return numItems; }
+        int getCapacity() const noexcept    { return capacity; }
+
+        void clear()
+        {
+            destroyEntries();
+
+            if (capacity > 0)
+                memset (control.get(), emptySlot, (size_t) capacity);
+
+            numItems = 0;
+            numDeleted = 0;
+        }
+
+        void reserve (int numItemsNeeded)
+        {
+            auto newCapacity = capacity;
+
+            while (getMaxLoad (newCapacity) < numItemsNeeded)
+                newCapacity = jmax ((int) groupSize, newCapacity * 2);
+
+            if (newCapacity != capacity)
+                rehash (newCapacity);
+        }
+
+        void swapWith (Table& other) noexcept
+        {
+            std::swap (hashFunctionToUse, other.hashFunctionToUse);
+            std::swap (control, other.control);
+            std::swap (storage, other.storage);
+            std::swap (capacity, other.capacity);
+            std::swap (numItems, other.numItems);
+            std::swap (numDeleted, other.numDeleted);
+        }
+
+        //==============================================================================
+        template <typename OtherKeyType>
+        int find (const OtherKeyType& key) const
+        {
+            if (numItems == 0)
+                return -1;
+
+            return find (key, getHash (key));
+        }
+
+        // returns the index of the key's entry, adding a new one if it wasn't already there
+        template <typename OtherKeyType>
+        int findOrInsert (const OtherKeyType& key)
+        {
+            auto hash = getHash (key);
+
+            if (numItems > 0)
+            {
+                auto index = find (key, hash);
+
+                if (index >= 0)
+                    return index;
+            }
+
+            if (numItems + numDeleted >= getMaxLoad (capacity))
+                growOrTidy();
+
+            auto index = findFreeSlot (hash);
+            new (getEntryAddress (index)) EntryType (key);
+            markAsUsed (index, hash);
+            return index;
+        }
+
+        void removeAt (int index)
+        {
+            jassert (control[(size_t) index] >= 0);
+            getEntry (index).~EntryType();
+            --numItems;
+
+            // If this slot's group has an empty slot, then no search can ever have gone past
+            // it, so this slot can be made empty too. Otherwise, a search might need to carry
+            // on past it, so it has to be marked as deleted.
+            auto groupStart = index & ~(groupSize - 1);
+
+            if (Group (control.get() + groupStart).matchEmpty() != 0)
+            {
+                control[(size_t) index] = emptySlot;
+            }
+            else
+            {
+                control[(size_t) index] = deletedSlot;
+                ++numDeleted;
+            }
+        }
+
+        template <typename OtherKeyType>
+        bool remove (const OtherKeyType& key)
+        {
+            auto index = find (key);
+
+            if (index < 0)
+                return false;
+
+            removeAt (index);
+            return true;
+        }
+
+        template <typename Predicate>
+        int removeIf (Predicate&& shouldRemove)
+        {
+            int numRemoved = 0;
+
+            // removing an entry never moves any of the others
+            for (int i = 0; i < capacity; ++i)
+            {
+                if (control[(size_t) i] >= 0 && shouldRemove (getEntry (i)))
+                {
+                    removeAt (i);
+                    ++numRemoved;
+                }
+            }
+
+            return numRemoved;
+        }
+
+        //==============================================================================
+        bool isUsed (int index) const noexcept              { return control[(size_t) index] >= 0; }
+        EntryType& getEntry (int index) const noexcept      { return *getEntryAddress (index); }
+
+        int getNextUsedIndex (int index) const noexcept
+        {
+            while (++index < capacity)
+                if (control[(size_t) index] >= 0)
+                    return index;
+
+            return capacity;
+        }
+
+    private:
+        //==============================================================================
+        using Storage = typename std::aligned_storage<sizeof (EntryType), alignof (EntryType)>::type;
+
+        HashFunctionType hashFunctionToUse;
+        std::unique_ptr<int8[]> control;
+        std::unique_ptr<Storage[]> storage;
+        int capacity = 0, numItems = 0, numDeleted = 0;
+
+        static int getMaxLoad (int numSlots) noexcept       { return numSlots - numSlots / 8; }
+
+        EntryType* getEntryAddress (int index) const noexcept
+        {
+            return reinterpret_cast<EntryType*> (storage.get() + index);
+        }
+
+        template <typename OtherKeyType>
+        uint64 getHash (const OtherKeyType& key) const
+        {
+            return mixHash ((uint64) hashFunctionToUse.generateHash (key));
+        }
+
+        static int8 getControlByte (uint64 hash) noexcept   { return (int8) (hash & 0x7f); }
+
+        // The groups are searched in a triangular sequence, which visits each of them once
+        template <typename Callback>
+        int searchGroups (uint64 hash, Callback&& callback) const
+        {
+            jassert (capacity > 0);
+            auto groupMask = (size_t) (capacity / groupSize - 1);
+            auto groupIndex = (size_t) (hash >> 7) & groupMask;
+
+            for (size_t step = 1;; ++step)
+            {
+                auto groupStart = (int) (groupIndex * groupSize);
+                auto result = callback (Group (control.get() + groupStart), groupStart);
+
+                if (result != -2)
+                    return result;
+
+                groupIndex = (groupIndex + step) & groupMask;
+            }
+        }
+
+        template <typename OtherKeyType>
+        int find (const OtherKeyType& key, uint64 hash) const
+        {
+            auto controlByte = getControlByte (hash);
+
+            return searchGroups (hash, [&] (const Group& group, int groupStart)
+            {
+                for (auto mask = group.match (controlByte); mask != 0; mask &= mask - 1)
+                {
+                    auto index = groupStart + findLowestSetBit (mask);
+
+                    if (getEntry (index).key == key)
+                        return index;
+                }
+
+                return group.matchEmpty() != 0 ? -1 : -2;
+            });
+        }
+
+        int findFreeSlot (uint64 hash) const
+        {
+            return searchGroups (hash, [] (const Group& group, int groupStart)
+            {
+                auto mask = group.matchEmptyOrDeleted();
+                return mask != 0 ? groupStart + findLowestSetBit (mask) : -2;
+            });
+        }
+
+        void markAsUsed (int index, uint64 hash) noexcept
+        {
+            if (control[(size_t) index] == deletedSlot)
+                --numDeleted;
+
+            control[(size_t) index] = getControlByte (hash);
+            ++numItems;
+        }
+
+        void insertUnique (const EntryType& entry)
+        {
+            auto hash = getHash (entry.key);
+            auto index = findFreeSlot (hash);
+            new (getEntryAddress (index)) EntryType (entry);
+            markAsUsed (index, hash);
+        }
+
+        void growOrTidy()
+        {
+            // if most of the used slots are just deleted ones, rebuilding at the
+            // same size is enough to get rid of them
+            if (numDeleted > numItems)
+                rehash (capacity);
+            else
+                rehash (jmax ((int) groupSize, capacity * 2));
+        }
+
+        void rehash (int newCapacity)
+        {
+            jassert (isPowerOfTwo (newCapacity) && newCapacity >= groupSize);
+
+            std::unique_ptr<int8[]> oldControl (std::move (control));
+            std::unique_ptr<Storage[]> oldStorage (std::move (storage));
+            auto oldCapacity = capacity;
+
+            control.reset (new int8[(size_t) newCapacity]);
+            storage.reset (new Storage[(size_t) newCapacity]);
+            memset (control.get(), emptySlot, (size_t) newCapacity);
+            capacity = newCapacity;
+            numItems = 0;
+            numDeleted = 0;
+
+            for (int i = 0; i < oldCapacity; ++i)
+            {
+                if (oldControl[(size_t) i] >= 0)
+                {
+                    auto& entry = *reinterpret_cast<EntryType*> (oldStorage.get() + i);
+                    auto hash = getHash (entry.key);
+                    auto index = findFreeSlot (hash);
+                    new (getEntryAddress (index)) EntryType (std::move (entry));
+                    markAsUsed (index, hash);
+                    entry.~EntryType();
+                }
+            }
+        }
+
+        void destroyEntries()
+        {
+            if (numItems > 0)
+                for (int i = 0; i < capacity; ++i)
+                    if (control[(size_t) i] >= 0)
+                        getEntry (i).~EntryType();
+        }
+    };
+}
+#endif
+
+//==============================================================================
+/**
+    A hash map which keeps its keys and values in a single flat array.
+
+    Unlike HashMap, which allocates a separate object for each item, this uses open
+    addressing: the items live directly in the table's slots, with one extra control
+    byte per slot that holds part of the key's hash. A lookup compares a whole group
+    of 16 control bytes at once (using SSE2 where it's available), so most lookups
+    only touch one or two cache lines, and iterating the map is a linear scan.
+
+    The price of this is that adding or removing items can move the other items, so
+    you mustn't keep pointers or references to values across calls that modify the map.
+
+    The lookup methods are templated, so you can search for a key using any type that
+    the hash function accepts and that can be compared with the key type, e.g. looking
+    up a String key with a StringRef or a const char*. The hash function class must
+    have the form:
+
+    @code
+    struct MyHashGenerator
+    {
+        uint64 generateHash (const MyKeyType& key) const
+        {
+            return someFunctionOfMyKeyType (key);
+        }
+    };
+    @endcode
+
+    The values that it returns don't need to be well-distributed, as they get mixed
+    before they're used. FlatHashFunctions handles the common key types.
+
+    @code
+    FlatHashMap<String, int> map;
+    map.set ("one", 1);
+    map.set ("two", 2);
+
+    DBG (map["two"]); // prints 2
+
+    for (auto i = map.begin(); i != map.end(); ++i)
+        DBG (i.getKey() << " -> " << i.getValue());
+    @endcode
+
+    @see FlatHashSet, FlatHashFunctions, HashMap
+
+    @tags{Core}
+*/
+template <typename KeyType,
+          typename ValueType,
+          class HashFunctionType = FlatHashFunctions>
+class FlatHashMap
+{
+private:
+    struct Entry
+    {
+        template <typename OtherKeyType>
+        explicit Entry (const OtherKeyType& k) : key (k), value() {}
+
+        KeyType key;
+        ValueType value;
+    };
+
+    using TableType = FlatHashHelpers::Table<KeyType, Entry, HashFunctionType>;
+
+public:
+    //==============================================================================
+    /** Creates an empty map.
+
+        @param numItemsToReserve    the number of items to make space for, so that the map
+                                    doesn't need to be resized while they're being added
+        @param hashFunction         an instance of HashFunctionType, which will be copied and
+                                    stored to use with the map
+    */
+    explicit FlatHashMap (int numItemsToReserve = 0,
+                          HashFunctionType hashFunction = HashFunctionType())
+        : table (numItemsToReserve, hashFunction)
+    {
+    }
+
+    /** Creates a copy of another map. */
+    FlatHashMap (const FlatHashMap&) = default;
+    /** Moves the contents of another map into this one. */
+    FlatHashMap (FlatHashMap&&) noexcept = default;
+    /** Copies another map into this one. */
+    FlatHashMap& operator= (const FlatHashMap&) = default;
+    /** Moves the contents of another map into this one. */
+    FlatHashMap& operator= (FlatHashMap&&) noexcept = default;
+
+    //==============================================================================
+    /** Removes all the items from the map, but keeps the memory that it's using. */
+    void clear()                                    { table.clear(); }
+
+    /** Returns the number of items in the map. */
+    int size() const noexcept                       { return table.size(); }
+
+    /** Returns true if the map is empty. */
+    bool isEmpty() const noexcept                   { return table.size() == 0; }
+
+    /** Returns the number of slots that the table currently has. */
+    int getCapacity() const noexcept                { return table.getCapacity(); }
+
+    /** Makes sure that the map can hold the given number of items without having to grow. */
+    void reserve (int numItems)                     { table.reserve (numItems); }
+
+    //==============================================================================
+    /** Returns the value for the given key, or a default-constructed value if it isn't in the map. */
+    template <typename OtherKeyType>
+    ValueType operator[] (const OtherKeyType& key) const
+    {
+        if (auto* value = find (key))
+            return *value;
+
+        return ValueType();
+    }
+
+    /** Returns a pointer to the value for a key, or nullptr if the key isn't in the map.
+        The pointer is only valid until the map is next modified.
+    */
+    template <typename OtherKeyType>
+    ValueType* find (const OtherKeyType& key) noexcept
+    {
+        auto index = table.find (key);
+        return index >= 0 ? &(table.getEntry (index).value) : nullptr;
+    }
+
+    /** Returns a pointer to the value for a key, or nullptr if the key isn't in the map.
+        The pointer is only valid until the map is next modified.
+    */
+    template <typename OtherKeyType>
+    const ValueType* find (const OtherKeyType& key) const noexcept
+    {
+        auto index = table.find (key);
+        return index >= 0 ? &(table.getEntry (index).value) : nullptr;
+    }
+
+    /** Returns a reference to the value for a key, adding a default-constructed one if the key
+        isn't already in the map. The reference is only valid until the map is next modified.
+    */
+    template <typename OtherKeyType>
+    ValueType& getReference (const OtherKeyType& key)
+    {
+        return table.getEntry (table.findOrInsert (key)).value;
+    }
+
+    /** Returns true if the map contains the given key. */
+    template <typename OtherKeyType>
+    bool contains (const OtherKeyType& key) const noexcept      { return table.find (key) >= 0; }
+
+    /** Adds or replaces the value for a key. */
+    template <typename OtherKeyType, typename OtherValueType>
+    void set (const OtherKeyType& key, OtherValueType&& value)  { getReference (key) = std::forward<OtherValueType> (value); }
+
+    /** Removes a key and its value, returning true if it was in the map. */
+    template <typename OtherKeyType>
+    bool remove (const OtherKeyType& key)                       { return table.remove (key); }
+
+    /** Removes all the items for which a predicate returns true, and returns the number removed.
+        The predicate is called with the key and value of each item, as (const KeyType&, ValueType&).
+    */
+    template <typename Predicate>
+    int removeIf (Predicate&& shouldRemove)
+    {
+        return table.removeIf ([&] (Entry& e) { return shouldRemove (static_cast<const KeyType&> (e.key), e.value); });
+    }
+
+    /** Efficiently swaps the contents of two maps. */
+    void swapWith (FlatHashMap& other) noexcept                 { table.swapWith (other.table); }
+
+    //==============================================================================
+    /** Iterates the items in a FlatHashMap.
+
+        The order of the items bears no resemblance to the order in which they were added.
+        Any iterators become invalid as soon as the map is modified.
+    */
+    class Iterator
+    {
+    public:
+        /** Returns the current item's key. */
+        const KeyType& getKey() const noexcept              { return table->getEntry (index).key; }
+        /** Returns the current item's value. */
+        ValueType& getValue() const noexcept                { return table->getEntry (index).value; }
+
+        Iterator& operator++() noexcept                     { index = table->getNextUsedIndex (index); return *this; }
+        ValueType& operator*() const noexcept               { return getValue(); }
+        bool operator== (const Iterator& other) const noexcept  { return index == other.index; }
+        bool operator!= (const Iterator& other) const noexcept  { return index != other.index; }
+
+    private:
+        friend class FlatHashMap;
+        Iterator (const TableType& t, int i) noexcept : table (&t), index (i) {}
+
+        const TableType* table;
+        int index;
+    };
+
+    /** Returns an iterator for the first item in the map. */
+    Iterator begin() const noexcept                 { return { table, table.getNextUsedIndex (-1) }; }
+
+    /** Returns an iterator that points past the last item in the map. */
+    Iterator end() const noexcept                   { return { table, table.getCapacity() }; }
+
+private:
+    //==============================================================================
+    TableType table;
+
+    JUCE_LEAK_DETECTOR (FlatHashMap)
+};
+
+//==============================================================================
+/**
+    A set of unique keys, stored in the same flat open-addressed table as FlatHashMap.
+
+    The lookup methods are templated, so a set of Strings can be searched using a
+    StringRef or a const char*.
+
+    @see FlatHashMap, FlatHashFunctions, SortedSet
+
+    @tags{Core}
+*/
+template <typename KeyType,
+          class HashFunctionType = FlatHashFunctions>
+class FlatHashSet
+{
+private:
+    struct Entry
+    {
+        template <typename OtherKeyType>
+        explicit Entry (const OtherKeyType& k) : key (k) {}
+
+        KeyType key;
+    };
+
+    using TableType = FlatHashHelpers::Table<KeyType, Entry, HashFunctionType>;
+
+public:
+    //==============================================================================
+    /** Creates an empty set.
+
+        @param numItemsToReserve    the number of items to make space for, so that the set
+                                    doesn't need to be resized while they're being added
+        @param hashFunction         an instance of HashFunctionType, which will be copied and
+                                    stored to use with the set
+    */
+    explicit FlatHashSet (int numItemsToReserve = 0,
+                          HashFunctionType hashFunction = HashFunctionType())
+        : table (numItemsToReserve, hashFunction)
+    {
+    }
+
+    /** Creates a copy of another set. */
+    FlatHashSet (const FlatHashSet&) = default;
+    /** Moves the contents of another set into this one. */
+    FlatHashSet (FlatHashSet&&) noexcept = default;
+    /** Copies another set into this one. */
+    FlatHashSet& operator= (const FlatHashSet&) = default;
+    /** Moves the contents of another set into this one. */
+    FlatHashSet& operator= (FlatHashSet&&) noexcept = default;
+
+    //==============================================================================
+    /** Removes all the items from the set, but keeps the memory that it's using. */
+    void clear()                                    { table.clear(); }
+
+    /** Returns the number of items in the set. */
+    int size() const noexcept                       { return table.size(); }
+
+    /** Returns true if the set is empty. */
+    bool isEmpty() const noexcept                   { return table.size() == 0; }
+
+    /** Returns the number of slots that the table currently has. */
+    int getCapacity() const noexcept                { return table.getCapacity(); }
+
+    /** Makes sure that the set can hold the given number of items without having to grow. */
+    void reserve (int numItems)                     { table.reserve (numItems); }
+
+    //==============================================================================
+    /** Adds a key to the set, returning true if it wasn't already there. */
+    template <typename OtherKeyType>
+    bool add (const OtherKeyType& key)
+    {
+        auto oldSize = table.size();
+        table.findOrInsert (key);
+        return table.size() != oldSize;
+    }
+
+    /** Returns the key in the set that matches the one passed in, adding it if it isn't already there.
+        The reference is only valid until the set is next modified.
+    */
+    template <typename OtherKeyType>
+    const KeyType& getOrAdd (const OtherKeyType& key)           { return table.getEntry (table.findOrInsert (key)).key; }
+
+    /** Returns true if the set contains the given key. */
+    template <typename OtherKeyType>
+    bool contains (const OtherKeyType& key) const noexcept      { return table.find (key) >= 0; }
+
+    /** Returns a pointer to the key in the set that matches the one passed in, or nullptr if
+        there isn't one. The pointer is only valid until the set is next modified.
+    */
+    template <typename OtherKeyType>
+    const KeyType* find (const OtherKeyType& key) const noexcept
+    {
+        auto index = table.find (key);
+        return index >= 0 ? &(table.getEntry (index).key) : nullptr;
+    }
+
+    /** Removes a key, returning true if it was in the set. */
+    template <typename OtherKeyType>
+    bool remove (const OtherKeyType& key)                       { return table.remove (key); }
+
+    /** Removes all the keys for which a predicate returns true, and returns the number removed. */
+    template <typename Predicate>
+    int removeIf (Predicate&& shouldRemove)
+    {
+        return table.removeIf ([&] (Entry& e) { return shouldRemove (static_cast<const KeyType&> (e.key)); });
+    }
+
+    /** Efficiently swaps the contents of two sets. */
+    void swapWith (FlatHashSet& other) noexcept                 { table.swapWith (other.table); }
+
+    //==============================================================================
+    /** Iterates the keys in a FlatHashSet.
+        Any iterators become invalid as soon as the set is modified.
+    */
+    class Iterator
+    {
+    public:
+        Iterator& operator++() noexcept                     { index = table->getNextUsedIndex (index); return *this; }
+        const KeyType& operator*() const noexcept           { return table->getEntry (index).key; }
+        bool operator== (const Iterator& other) const noexcept  { return index == other.index; }
+        bool operator!= (const Iterator& other) const noexcept  { return index != other.index; }
+
+    private:
+        friend class FlatHashSet;
+        Iterator (const TableType& t, int i) noexcept : table (&t), index (i) {}
+
+        const TableType* table;
+        int index;
+    };
+
+    /** Returns an iterator for the first key in the set. */
+    Iterator begin() const noexcept                 { return { table, table.getNextUsedIndex (-1) }; }
+
+    /** Returns an iterator that points past the last key in the set. */
+    Iterator end() const noexcept                   { return { table, table.getCapacity() }; }
+
+private:
+    //==============================================================================
+    TableType table;
+
+    JUCE_LEAK_DETECTOR (FlatHashSet)
+};
+
+} // namespace juce
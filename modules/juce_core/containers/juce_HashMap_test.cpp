@@ -20,6 +20,8 @@
   ==============================================================================
 */
 
+#include <unordered_map>
+
 namespace juce
 {
 
@@ -33,16 +35,231 @@ struct HashMapTest : public UnitTest
         doTest<AccessTest> ("AccessTest");
         doTest<RemoveTest> ("RemoveTest");
         doTest<PersistantMemoryLocationOfValues> ("PersistantMemoryLocationOfValues");
+
+        // values in a FlatHashMap can move, so it doesn't do the PersistantMemoryLocationOfValues test
+        doTest<AddElementsTest, FlatHashMap> ("FlatHashMap AddElementsTest");
+        doTest<AccessTest, FlatHashMap> ("FlatHashMap AccessTest");
+        doTest<RemoveTest, FlatHashMap> ("FlatHashMap RemoveTest");
+
+        testFlatHashMapLookups();
+        testFlatHashMapChurn();
+        testFlatHashSet();
+        runBenchmark();
+    }
+
+    //==============================================================================
+    void testFlatHashMapLookups()
+    {
+        beginTest ("FlatHashMap heterogeneous lookups");
+
+        FlatHashMap<String, int> map;
+        map.set ("alpha", 1);
+        map.set (String ("beta"), 2);
+        map.getReference (StringRef ("gamma")) = 3;
+
+        expectEquals (map.size(), 3);
+        expectEquals (map["alpha"], 1);
+        expectEquals (map[StringRef ("beta")], 2);
+        expectEquals (map[String ("gamma")], 3);
+        expectEquals (map["delta"], 0);
+        expect (map.find ("delta") == nullptr);
+        expect (map.find (StringRef ("alpha")) != nullptr && *map.find ("alpha") == 1);
+
+        FlatHashMap<Identifier, String> ids;
+        ids.set (Identifier ("width"), "100");
+        ids.set (Identifier ("height"), "50");
+
+        expectEquals (ids[StringRef ("width")], String ("100"));
+        expect (ids.contains (Identifier ("height")));
+        expect (! ids.contains (StringRef ("depth")));
+
+        auto copy = map;
+        map.remove ("alpha");
+        expect (! map.contains ("alpha"));
+        expectEquals (copy["alpha"], 1);
+
+        auto moved = std::move (copy);
+        expectEquals (moved.size(), 3);
+
+        int total = 0, numItems = 0;
+
+        for (auto i = moved.begin(); i != moved.end(); ++i)
+        {
+            expectEquals (i.getValue(), moved[i.getKey()]);
+            total += *i;
+            ++numItems;
+        }
+
+        expectEquals (numItems, 3);
+        expectEquals (total, 6);
+    }
+
+    void testFlatHashMapChurn()
+    {
+        beginTest ("FlatHashMap repeated adding and removing");
+
+        FlatHashMap<int, String> map;
+        std::unordered_map<int, String> groundTruth;
+        Random r (1234);
+
+        for (int i = 0; i < 100000; ++i)
+        {
+            auto key = r.nextInt (2000);
+
+            if (r.nextBool())
+            {
+                map.set (key, String (i));
+                groundTruth[key] = String (i);
+            }
+            else
+            {
+                expect (map.remove (key) == (groundTruth.erase (key) != 0));
+            }
+        }
+
+        expectEquals (map.size(), (int) groundTruth.size());
+
+        // removed slots must get reused rather than making the table keep growing
+        expect (map.getCapacity() <= 4096);
+
+        for (auto& pair : groundTruth)
+            expectEquals (map[pair.first], pair.second);
+
+        map.clear();
+        expect (map.isEmpty());
+        expect (map.begin() == map.end());
+    }
+
+    void testFlatHashSet()
+    {
+        beginTest ("FlatHashSet");
+
+        FlatHashSet<String> set;
+        expect (set.add ("one"));
+        expect (set.add (String ("two")));
+        expect (! set.add (StringRef ("one")));
+        expectEquals (set.size(), 2);
+        expect (set.contains ("two"));
+        expect (! set.contains ("three"));
+
+        int numItems = 0;
+
+        for (auto& key : set)
+        {
+            expect (key == "one" || key == "two");
+            ++numItems;
+        }
+
+        expectEquals (numItems, 2);
+        expect (set.remove ("one"));
+        expect (! set.remove ("one"));
+        expectEquals (set.size(), 1);
+    }
+
+    //==============================================================================
+    struct StringHasher
+    {
+        size_t operator() (const String& s) const noexcept     { return s.hash(); }
+    };
+
+    template <typename MapType, typename KeyType, typename InsertFunction, typename FindFunction>
+    void benchmarkMap (const String& mapName, const Array<KeyType>& keys, const Array<KeyType>& missingKeys,
+                       InsertFunction&& insert, FindFunction&& find)
+    {
+        MapType map;
+
+        auto start = Time::getMillisecondCounterHiRes();
+
+        for (int i = 0; i < keys.size(); ++i)
+            insert (map, keys.getReference (i), i);
+
+        auto inserted = Time::getMillisecondCounterHiRes();
+        int64 total = 0;
+
+        for (auto& key : keys)
+            total += find (map, key);
+
+        auto foundHits = Time::getMillisecondCounterHiRes();
+
+        for (auto& key : missingKeys)
+            total += find (map, key);
+
+        auto foundMisses = Time::getMillisecondCounterHiRes();
+
+        logMessage ("  " + mapName.paddedRight (' ', 24)
+                      + "insert: " + String (inserted - start, 1) + " ms, "
+                      + "hits: " + String (foundHits - inserted, 1) + " ms, "
+                      + "misses: " + String (foundMisses - foundHits, 1) + " ms");
+
+        expect (total >= 0);
+    }
+
+    template <typename KeyType>
+    void benchmarkKeys (const Array<KeyType>& keys, const Array<KeyType>& missingKeys)
+    {
+        benchmarkMap<HashMap<KeyType, int>> ("HashMap", keys, missingKeys,
+                                             [] (HashMap<KeyType, int>& m, const KeyType& k, int v) { m.set (k, v); },
+                                             [] (const HashMap<KeyType, int>& m, const KeyType& k) { return m.contains (k) ? 1 : 0; });
+
+        benchmarkMap<FlatHashMap<KeyType, int>> ("FlatHashMap", keys, missingKeys,
+                                                 [] (FlatHashMap<KeyType, int>& m, const KeyType& k, int v) { m.set (k, v); },
+                                                 [] (const FlatHashMap<KeyType, int>& m, const KeyType& k) { return m.contains (k) ? 1 : 0; });
+
+        using StdMapType = typename std::conditional<std::is_same<KeyType, String>::value,
+                                                     std::unordered_map<KeyType, int, StringHasher>,
+                                                     std::unordered_map<KeyType, int>>::type;
+
+        benchmarkMap<StdMapType> ("std::unordered_map", keys, missingKeys,
+                                  [] (StdMapType& m, const KeyType& k, int v) { m[k] = v; },
+                                  [] (const StdMapType& m, const KeyType& k) { return m.count (k) != 0 ? 1 : 0; });
+    }
+
+    void runBenchmark()
+    {
+        beginTest ("Benchmark");
+
+        auto random = getRandom();
+
+        {
+            const int numKeys = 1000000;
+            logMessage ("  " + String (numKeys) + " int keys:");
+
+            Array<int> keys, missingKeys;
+
+            for (int i = 0; i < numKeys; ++i)
+            {
+                // even numbers are in the map, odd ones aren't
+                keys.add (random.nextInt() & ~1);
+                missingKeys.add (random.nextInt() | 1);
+            }
+
+            benchmarkKeys (keys, missingKeys);
+        }
+
+        {
+            const int numKeys = 200000;
+            logMessage ("  " + String (numKeys) + " String keys:");
+
+            Array<String> keys, missingKeys;
+
+            for (int i = 0; i < numKeys; ++i)
+            {
+                keys.add ("key_" + String::toHexString (random.nextInt64()));
+                missingKeys.add ("missing_" + String::toHexString (random.nextInt64()));
+            }
+
+            benchmarkKeys (keys, missingKeys);
+        }
     }
 
     //==============================================================================
     struct AddElementsTest
     {
-        template <typename KeyType>
+        template <typename KeyType, template <typename...> class MapType>
         static void run (UnitTest& u)
         {
             AssociativeMap<KeyType, int> groundTruth;
-            HashMap<KeyType, int> hashMap;
+            MapType<KeyType, int> hashMap;
 
             RandomKeys<KeyType> keyOracle (300, 3827829);
             Random valueOracle (48735);
@@ -68,11 +285,11 @@ struct HashMapTest : public UnitTest
 
     struct AccessTest
     {
-        template <typename KeyType>
+        template <typename KeyType, template <typename...> class MapType>
         static void run (UnitTest& u)
         {
             AssociativeMap<KeyType, int> groundTruth;
-            HashMap<KeyType, int> hashMap;
+            MapType<KeyType, int> hashMap;
 
             fillWithRandomValues (hashMap, groundTruth);
 
@@ -83,11 +300,11 @@ struct HashMapTest : public UnitTest
 
     struct RemoveTest
     {
-        template <typename KeyType>
+        template <typename KeyType, template <typename...> class MapType>
         static void run (UnitTest& u)
         {
             AssociativeMap<KeyType, int> groundTruth;
-            HashMap<KeyType, int> hashMap;
+            MapType<KeyType, int> hashMap;
 
             fillWithRandomValues (hashMap, groundTruth);
             auto n = groundTruth.size();
@@ -115,11 +332,11 @@ struct HashMapTest : public UnitTest
     {
         struct AddressAndValue { int value; const int* valueAddress; };
 
-        template <typename KeyType>
+        template <typename KeyType, template <typename...> class MapType>
         static void run (UnitTest& u)
         {
             AssociativeMap<KeyType, AddressAndValue> groundTruth;
-            HashMap<KeyType, int> hashMap;
+            MapType<KeyType, int> hashMap;
 
             RandomKeys<KeyType> keyOracle (300, 3827829);
             Random valueOracle (48735);
@@ -173,14 +390,14 @@ struct HashMapTest : public UnitTest
     };
 
     //==============================================================================
-    template <class Test>
+    template <class Test, template <typename...> class MapType = HashMap>
     void doTest (const String& testName)
     {
         beginTest (testName);
 
-        Test::template run<int> (*this);
-        Test::template run<void*> (*this);
-        Test::template run<String> (*this);
+        Test::template run<int, MapType> (*this);
+        Test::template run<void*, MapType> (*this);
+        Test::template run<String, MapType> (*this);
     }
 
     //==============================================================================
@@ -217,8 +434,8 @@ struct HashMapTest : public UnitTest
         Array<KeyValuePair> pairs;
     };
 
-    template <typename KeyType, typename ValueType>
-    static void fillWithRandomValues (HashMap<KeyType, int>& hashMap, AssociativeMap<KeyType, ValueType>& groundTruth)
+    template <typename MapType, typename KeyType, typename ValueType>
+    static void fillWithRandomValues (MapType& hashMap, AssociativeMap<KeyType, ValueType>& groundTruth)
     {
         RandomKeys<KeyType> keyOracle (300, 3827829);
         Random valueOracle (48735);
@@ -0,0 +1,370 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 5 End-User License
+   Agreement and JUCE 5 Privacy Policy (both updated and effective as of the
+   27th April 2017).
+
+   End User License Agreement: www.juce.com/juce-5-licence
+   Privacy Policy: www.juce.com/juce-5-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+struct LockFreeQueueTests : public UnitTest
+{
+    LockFreeQueueTests() : UnitTest ("Lock-free queues", "Containers") {}
+
+    //==============================================================================
+    struct TestThread : public Thread
+    {
+        TestThread (std::function<void()> f) : Thread ("Queue test"), function (std::move (f)) {}
+        ~TestThread() override   { stopThread (-1); }
+
+        void run() override      { function(); }
+
+        std::function<void()> function;
+    };
+
+    static void runOnThreads (int numThreads, std::function<void (int)> function)
+    {
+        OwnedArray<TestThread> threads;
+
+        for (int i = 0; i < numThreads; ++i)
+            threads.add (new TestThread ([=] { function (i); }));
+
+        for (auto* t : threads)
+            t->startThread();
+
+        for (auto* t : threads)
+            t->waitForThreadToExit (-1);
+    }
+
+    struct Counted
+    {
+        Counted (int v = 0) : value (v)                  { ++numAlive; }
+        Counted (const Counted& other) : value (other.value) { ++numAlive; }
+        Counted& operator= (const Counted&) = default;
+        ~Counted()                                       { --numAlive; }
+
+        int value;
+        static std::atomic<int> numAlive;
+    };
+
+    //==============================================================================
+    template <template <typename> class QueueType>
+    void testSingleThreaded (const String& queueName)
+    {
+        beginTest (queueName + ": ordering and capacity");
+        {
+            QueueType<int> queue (5);
+            expectEquals (queue.getCapacity(), 8);
+            expect (queue.isEmpty());
+
+            int value = 0;
+            expect (! queue.pop (value));
+
+            for (int round = 0; round < 10; ++round)
+            {
+                for (int i = 0; i < 8; ++i)
+                    expect (queue.push (round * 100 + i));
+
+                expect (! queue.push (-1));
+                expectEquals (queue.getNumReady(), 8);
+
+                for (int i = 0; i < 5; ++i)
+                {
+                    expect (queue.pop (value));
+                    expectEquals (value, round * 100 + i);
+                }
+
+                for (int i = 5; i < 8; ++i)
+                {
+                    expect (queue.pop (value));
+                    expectEquals (value, round * 100 + i);
+                }
+
+                expect (queue.isEmpty());
+            }
+        }
+
+        beginTest (queueName + ": batches");
+        {
+            QueueType<int> queue (16);
+            Array<int> source, dest;
+
+            for (int i = 0; i < 20; ++i)
+                source.add (i);
+
+            expectEquals (queue.pushBatch (source.begin(), 10), 10);
+            expectEquals (queue.pushBatch (source.begin() + 10, 10), 6);
+
+            int results[32] = {};
+            expectEquals (queue.popBatch (results, 4), 4);
+            expectEquals (queue.popBatch (results + 4, 32), 12);
+
+            for (int i = 0; i < 16; ++i)
+                expectEquals (results[i], i);
+
+            expectEquals (queue.popBatch (results, 4), 0);
+        }
+
+        beginTest (queueName + ": move-only types");
+        {
+            QueueType<std::unique_ptr<int>> queue (4);
+            std::unique_ptr<int> item (new int (123));
+
+            expect (queue.push (std::move (item)));
+            expect (item == nullptr);
+            expect (queue.emplace (new int (456)));
+
+            std::unique_ptr<int> result;
+            expect (queue.pop (result) && *result == 123);
+            expect (queue.pop (result) && *result == 456);
+            expect (! queue.pop (result));
+        }
+
+        beginTest (queueName + ": object lifetimes");
+        {
+            Counted::numAlive = 0;
+
+            {
+                QueueType<Counted> queue (8);
+
+                for (int i = 0; i < 6; ++i)
+                    queue.push (Counted (i));
+
+                expectEquals (Counted::numAlive.load(), 6);
+
+                Counted c;
+                queue.pop (c);
+                expectEquals (c.value, 0);
+                expectEquals (Counted::numAlive.load(), 6);
+            }
+
+            expectEquals (Counted::numAlive.load(), 0);
+        }
+    }
+
+    //==============================================================================
+    void testSPSCThreaded()
+    {
+        beginTest ("SPSC: producer and consumer threads");
+
+        SPSCQueue<int> queue (256);
+        const int numItems = 500000;
+        std::atomic<bool> inOrder { true };
+
+        runOnThreads (2, [&] (int threadIndex)
+        {
+            if (threadIndex == 0)
+            {
+                for (int i = 0; i < numItems;)
+                {
+                    if (queue.push (i))
+                        ++i;
+                    else
+                        Thread::yield();
+                }
+            }
+            else
+            {
+                int buffer[64];
+
+                for (int expected = 0; expected < numItems;)
+                {
+                    auto num = queue.popBatch (buffer, numElementsInArray (buffer));
+
+                    if (num == 0)
+                        Thread::yield();
+
+                    for (int i = 0; i < num; ++i)
+                        if (buffer[i] != expected++)
+                            inOrder = false;
+                }
+            }
+        });
+
+        expect (inOrder);
+        expect (queue.isEmpty());
+    }
+
+    void testMPMCThreaded()
+    {
+        beginTest ("MPMC: multiple producers and consumers");
+
+        const int numProducers = 3, numConsumers = 3, itemsPerProducer = 100000;
+        MPMCQueue<int> queue (128);
+        std::atomic<int64> total { 0 };
+        std::atomic<int> numConsumed { 0 };
+        std::atomic<bool> inOrder { true };
+
+        runOnThreads (numProducers + numConsumers, [&] (int threadIndex)
+        {
+            if (threadIndex < numProducers)
+            {
+                for (int i = 0; i < itemsPerProducer;)
+                {
+                    if (queue.push (threadIndex * itemsPerProducer + i))
+                        ++i;
+                    else
+                        Thread::yield();
+                }
+            }
+            else
+            {
+                int lastSeen[numProducers] = { -1, -1, -1 };
+                int value;
+
+                while (numConsumed.load() < numProducers * itemsPerProducer)
+                {
+                    if (! queue.pop (value))
+                    {
+                        Thread::yield();
+                        continue;
+                    }
+
+                    auto producer = value / itemsPerProducer;
+                    auto index = value % itemsPerProducer;
+
+                    // each consumer must see any one producer's items in the order they were pushed
+                    if (index <= lastSeen[producer])
+                        inOrder = false;
+
+                    lastSeen[producer] = index;
+                    total += value;
+                    ++numConsumed;
+                }
+            }
+        });
+
+        auto n = (int64) numProducers * itemsPerProducer;
+        expectEquals (numConsumed.load(), (int) n);
+        expectEquals (total.load(), n * (n - 1) / 2);
+        expect (inOrder);
+        expect (queue.isEmpty());
+    }
+
+    //==============================================================================
+    struct LockedQueue
+    {
+        LockedQueue (int) {}
+
+        bool push (int v)
+        {
+            const ScopedLock sl (lock);
+            items.add (v);
+            return true;
+        }
+
+        bool pop (int& v)
+        {
+            const ScopedLock sl (lock);
+
+            if (readIndex >= items.size())
+                return false;
+
+            v = items.getUnchecked (readIndex++);
+
+            if (readIndex == items.size())
+            {
+                items.clearQuick();
+                readIndex = 0;
+            }
+
+            return true;
+        }
+
+        CriticalSection lock;
+        Array<int> items;
+        int readIndex = 0;
+    };
+
+    template <typename QueueType>
+    double measureThroughput (int numProducers, int numItems)
+    {
+        QueueType queue (1024);
+        std::atomic<int> numConsumed { 0 };
+        const int itemsPerProducer = numItems / numProducers;
+        const int totalItems = itemsPerProducer * numProducers;
+        auto startTime = Time::getMillisecondCounterHiRes();
+
+        runOnThreads (numProducers + 1, [&] (int threadIndex)
+        {
+            if (threadIndex < numProducers)
+            {
+                for (int i = 0; i < itemsPerProducer;)
+                {
+                    if (queue.push (i))
+                        ++i;
+                    else
+                        Thread::yield();
+                }
+            }
+            else
+            {
+                int value;
+
+                while (numConsumed.load (std::memory_order_relaxed) < totalItems)
+                {
+                    if (queue.pop (value))
+                        numConsumed.fetch_add (1, std::memory_order_relaxed);
+                    else
+                        Thread::yield();
+                }
+            }
+        });
+
+        return totalItems / jmax (0.001, (Time::getMillisecondCounterHiRes() - startTime) / 1000.0);
+    }
+
+    void runBenchmark()
+    {
+        beginTest ("Benchmark");
+
+        const int numItems = 400000;
+
+        for (auto numProducers : { 1, 2, 4 })
+        {
+            logMessage ("  " + String (numProducers) + " producer(s), 1 consumer, items/sec:");
+
+            if (numProducers == 1)
+                logMessage ("    SPSCQueue:                " + String (roundToInt (measureThroughput<SPSCQueue<int>> (1, numItems))));
+
+            logMessage ("    MPMCQueue:                " + String (roundToInt (measureThroughput<MPMCQueue<int>> (numProducers, numItems))));
+            logMessage ("    CriticalSection + Array:  " + String (roundToInt (measureThroughput<LockedQueue> (numProducers, numItems))));
+        }
+    }
+
+    //==============================================================================
+    void runTest() override
+    {
+        testSingleThreaded<SPSCQueue> ("SPSC");
+        testSingleThreaded<MPMCQueue> ("MPMC");
+        testSPSCThreaded();
+        testMPMCThreaded();
+        runBenchmark();
+    }
+};
+
+std::atomic<int> LockFreeQueueTests::Counted::numAlive { 0 };
+
+static LockFreeQueueTests lockFreeQueueTests;
+
+} // namespace juce
@@ -0,0 +1,241 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 5 End-User License
+   Agreement and JUCE 5 Privacy Policy (both updated and effective as of the
+   27th April 2017).
+
+   End User License Agreement: www.juce.com/juce-5-licence
+   Privacy Policy: www.juce.com/juce-5-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A bounded, lock-free queue that any number of threads can push to and pop from.
+
+    Each slot in the queue has a sequence number which tells the threads whose turn it is
+    to write or read it, so that pushing and popping only need a single compare-and-swap
+    on a shared position in the common case. The queue never allocates after it's been
+    created, and can hold move-only types.
+
+    If you only have one producer and one consumer, an SPSCQueue will be faster.
+
+    e.g.
+    @code
+    MPMCQueue<std::unique_ptr<Job>> jobs (256);
+
+    // on any thread:
+    std::unique_ptr<Job> job (new Job());
+
+    if (! jobs.push (std::move (job)))
+        runNow (*job);
+
+    // on any other thread:
+    std::unique_ptr<Job> next;
+
+    while (jobs.pop (next))
+        next->run();
+    @endcode
+
+    @see SPSCQueue, AbstractFifo
+
+    @tags{Core}
+*/
+template <typename Type>
+class MPMCQueue
+{
+public:
+    //==============================================================================
+    /** Creates a queue that can hold at least the given number of items.
+        The capacity will be rounded up to a power of two.
+    */
+    explicit MPMCQueue (int minimumCapacity)
+        : capacity ((size_t) nextPowerOfTwo (jmax (2, minimumCapacity))),
+          cells (new Cell[capacity])
+    {
+        for (size_t i = 0; i < capacity; ++i)
+            cells[i].sequence.store (i, std::memory_order_relaxed);
+    }
+
+    /** Destructor. Any items that are still in the queue are destroyed. */
+    ~MPMCQueue()
+    {
+        for (auto i = readPosition.load(); i != writePosition.load(); ++i)
+            getItem (cells[i & (capacity - 1)])->~Type();
+    }
+
+    //==============================================================================
+    /** Adds a copy of an item to the queue.
+        This can be called by any thread. It returns false if the queue is full.
+    */
+    bool push (const Type& item)                    { return emplace (item); }
+
+    /** Moves an item into the queue.
+        This can be called by any thread. It returns false if the queue is full, in which
+        case the item will not have been moved from.
+    */
+    bool push (Type&& item)                         { return emplace (std::move (item)); }
+
+    /** Constructs an item in place at the back of the queue.
+        This can be called by any thread. It returns false if the queue is full.
+    */
+    template <typename... Args>
+    bool emplace (Args&&... args)
+    {
+        auto pos = writePosition.load (std::memory_order_relaxed);
+
+        for (;;)
+        {
+            auto& cell = cells[pos & (capacity - 1)];
+            auto diff = (intptr_t) cell.sequence.load (std::memory_order_acquire) - (intptr_t) pos;
+
+            if (diff == 0)
+            {
+                if (writePosition.compare_exchange_weak (pos, pos + 1, std::memory_order_relaxed))
+                {
+                    new (getItem (cell)) Type (std::forward<Args> (args)...);
+                    cell.sequence.store (pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = writePosition.load (std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /** Adds up to numItems items from a sequence, stopping when the queue is full.
+
+        The items are copied from the iterator, so use std::make_move_iterator() to move them
+        instead. Items pushed by other threads at the same time may be interleaved with these
+        ones. Returns the number of items that were added.
+    */
+    template <typename InputIterator>
+    int pushBatch (InputIterator source, int numItems)
+    {
+        for (int i = 0; i < numItems; ++i, ++source)
+            if (! emplace (*source))
+                return i;
+
+        return jmax (0, numItems);
+    }
+
+    //==============================================================================
+    /** Moves the item at the front of the queue into result.
+        This can be called by any thread. It returns false if the queue is empty.
+    */
+    bool pop (Type& result)
+    {
+        auto pos = readPosition.load (std::memory_order_relaxed);
+
+        for (;;)
+        {
+            auto& cell = cells[pos & (capacity - 1)];
+            auto diff = (intptr_t) cell.sequence.load (std::memory_order_acquire) - (intptr_t) (pos + 1);
+
+            if (diff == 0)
+            {
+                if (readPosition.compare_exchange_weak (pos, pos + 1, std::memory_order_relaxed))
+                {
+                    auto* item = getItem (cell);
+                    result = std::move (*item);
+                    item->~Type();
+                    cell.sequence.store (pos + capacity, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = readPosition.load (std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /** Moves up to maxItems items from the front of the queue to an output iterator.
+        This can be called by any thread, and returns the number of items that were removed.
+    */
+    template <typename OutputIterator>
+    int popBatch (OutputIterator destination, int maxItems)
+    {
+        Type item;
+
+        for (int i = 0; i < maxItems; ++i, ++destination)
+        {
+            if (! pop (item))
+                return i;
+
+            *destination = std::move (item);
+        }
+
+        return jmax (0, maxItems);
+    }
+
+    //==============================================================================
+    /** Returns the approximate number of items in the queue.
+        If other threads are using the queue, this may be out of date by the time it returns.
+    */
+    int getNumReady() const noexcept
+    {
+        auto numItems = (intptr_t) (writePosition.load (std::memory_order_acquire) - readPosition.load (std::memory_order_acquire));
+        return (int) jlimit ((intptr_t) 0, (intptr_t) capacity, numItems);
+    }
+
+    /** Returns true if the queue appears to be empty. */
+    bool isEmpty() const noexcept                   { return getNumReady() == 0; }
+
+    /** Returns the number of items that the queue can hold. */
+    int getCapacity() const noexcept                { return (int) capacity; }
+
+private:
+    //==============================================================================
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        typename std::aligned_storage<sizeof (Type), alignof (Type)>::type storage;
+    };
+
+    enum { cacheLineSize = 64 };
+
+    const size_t capacity;
+    std::unique_ptr<Cell[]> cells;
+
+    // the two positions are padded onto separate cache lines, as they're written by different threads
+    char padding1[cacheLineSize];
+    std::atomic<size_t> writePosition { 0 };
+    char padding2[cacheLineSize];
+    std::atomic<size_t> readPosition { 0 };
+    char padding3[cacheLineSize];
+
+    static Type* getItem (Cell& cell) noexcept     { return reinterpret_cast<Type*> (&cell.storage); }
+
+    JUCE_DECLARE_NON_COPYABLE (MPMCQueue)
+};
+
+} // namespace juce
@@ -54,29 +54,88 @@ NamedValueSet::NamedValue& NamedValueSet::NamedValue::operator= (NamedValue&& ot
 bool NamedValueSet::NamedValue::operator== (const NamedValue& other) const noexcept   { return name == other.name && value == other.value; }
 bool NamedValueSet::NamedValue::operator!= (const NamedValue& other) const noexcept   { return ! operator== (other); }
 
+//==============================================================================
+/*  Once a set has this many values, a hash index of their names is kept, as a linear
+    search through the array starts getting slower than a hash lookup.
+*/
+enum { minNumValuesToIndex = 16 };
+
+struct NamedValueSet::Index
+{
+    // Identifiers are pooled, so two of them are equal if their text is at the same address.
+    // This relies on the StringPool keeping even short pooled strings on the heap rather
+    // than inside each String object, so that every copy of an Identifier shares the same
+    // character pointer.
+    static const void* getKey (const Identifier& name) noexcept     { return name.getCharPointer().getAddress(); }
+
+    FlatHashMap<const void*, int> positions;
+};
+
 //==============================================================================
 NamedValueSet::NamedValueSet() noexcept {}
 NamedValueSet::~NamedValueSet() noexcept {}
 
-NamedValueSet::NamedValueSet (const NamedValueSet& other)  : values (other.values) {}
-NamedValueSet::NamedValueSet (NamedValueSet&& other) noexcept  : values (static_cast<Array<NamedValue>&&> (other.values)) {}
+NamedValueSet::NamedValueSet (const NamedValueSet& other)  : values (other.values)
+{
+    updateIndex();
+}
+
+NamedValueSet::NamedValueSet (NamedValueSet&& other) noexcept
+    : values (static_cast<Array<NamedValue>&&> (other.values)),
+      nameIndex (std::move (other.nameIndex))
+{
+}
 
 NamedValueSet& NamedValueSet::operator= (const NamedValueSet& other)
 {
     clear();
     values = other.values;
+    updateIndex();
     return *this;
 }
 
 NamedValueSet& NamedValueSet::operator= (NamedValueSet&& other) noexcept
 {
     other.values.swapWith (values);
+    std::swap (other.nameIndex, nameIndex);
     return *this;
 }
 
 void NamedValueSet::clear()
 {
     values.clear();
+    nameIndex.reset();
+}
+
+void NamedValueSet::addValue (NamedValue&& newValue)
+{
+    auto key = Index::getKey (newValue.name);
+    values.add (static_cast<NamedValue&&> (newValue));
+
+    if (nameIndex != nullptr)
+        nameIndex->positions.set (key, values.size() - 1);
+    else if (values.size() >= minNumValuesToIndex)
+        updateIndex();
+}
+
+void NamedValueSet::updateIndex()
+{
+    auto numValues = values.size();
+
+    if (numValues < minNumValuesToIndex)
+    {
+        nameIndex.reset();
+        return;
+    }
+
+    if (nameIndex == nullptr)
+        nameIndex.reset (new Index());
+
+    nameIndex->positions.clear();
+    nameIndex->positions.reserve (numValues);
+
+    for (int i = 0; i < numValues; ++i)
+        nameIndex->positions.set (Index::getKey (values.getReference (i).name), i);
 }
 
 bool NamedValueSet::operator== (const NamedValueSet& other) const noexcept
@@ -142,11 +201,8 @@ var NamedValueSet::getWithDefault (const Identifier& name, const var& defaultRet
 
 var* NamedValueSet::getVarPointer (const Identifier& name) const noexcept
 {
-    for (auto& i : values)
-        if (i.name == name)
-            return &(i.value);
-
-    return {};
+    auto i = indexOf (name);
+    return i >= 0 ? &(values.getReference (i).value) : nullptr;
 }
 
 bool NamedValueSet::set (const Identifier& name, var&& newValue)
@@ -160,7 +216,7 @@ bool NamedValueSet::set (const Identifier& name, var&& newValue)
         return true;
     }
 
-    values.add ({ name, static_cast<var&&> (newValue) });
+    addValue ({ name, static_cast<var&&> (newValue) });
     return true;
 }
 
@@ -175,7 +231,7 @@ bool NamedValueSet::set (const Identifier& name, const var& newValue)
         return true;
     }
 
-    values.add ({ name, newValue });
+    addValue ({ name, newValue });
     return true;
 }
 
@@ -186,6 +242,12 @@ bool NamedValueSet::contains (const Identifier& name) const noexcept
 
 int NamedValueSet::indexOf (const Identifier& name) const noexcept
 {
+    if (nameIndex != nullptr)
+    {
+        auto* position = nameIndex->positions.find (Index::getKey (name));
+        return position != nullptr ? *position : -1;
+    }
+
     auto numValues = values.size();
 
     for (int i = 0; i < numValues; ++i)
@@ -197,18 +259,20 @@ int NamedValueSet::indexOf (const Identifier& name) const noexcept
 
 bool NamedValueSet::remove (const Identifier& name)
 {
-    auto numValues = values.size();
+    auto i = indexOf (name);
 
-    for (int i = 0; i < numValues; ++i)
-    {
-        if (values.getReference(i).name == name)
-        {
-            values.remove (i);
-            return true;
-        }
-    }
+    if (i < 0)
+        return false;
+
+    values.remove (i);
 
-    return false;
+    // removing the last item doesn't move any of the others
+    if (nameIndex != nullptr && i == values.size() && values.size() >= minNumValuesToIndex)
+        nameIndex->positions.remove (Index::getKey (name));
+    else
+        updateIndex();
+
+    return true;
 }
 
 Identifier NamedValueSet::getName (const int index) const noexcept
@@ -256,6 +320,8 @@ void NamedValueSet::setFromXmlAttributes (const XmlElement& xml)
 
         values.add ({ att->name, var (att->value) });
     }
+
+    updateIndex();
 }
 
 void NamedValueSet::copyToXmlAttributes (XmlElement& xml) const
@@ -279,4 +345,132 @@ void NamedValueSet::copyToXmlAttributes (XmlElement& xml) const
     }
 }
 
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class NamedValueSetTests  : public UnitTest
+{
+public:
+    NamedValueSetTests() : UnitTest ("NamedValueSet", "Containers") {}
+
+    static Identifier getName (int i)       { return Identifier ("name" + String (i)); }
+
+    void expectMatches (const NamedValueSet& set, const Array<int>& expectedOrder)
+    {
+        expectEquals (set.size(), expectedOrder.size());
+
+        for (int i = 0; i < expectedOrder.size(); ++i)
+        {
+            auto valueName = getName (expectedOrder[i]);
+
+            expect (set.getName (i) == valueName);
+            expectEquals (set.indexOf (valueName), i);
+            expect (set[valueName] == var (expectedOrder[i]));
+        }
+    }
+
+    void runTest() override
+    {
+        beginTest ("Lookups as the set grows and shrinks");
+        {
+            NamedValueSet set;
+            Array<int> order;
+
+            for (int i = 0; i < 200; ++i)
+            {
+                expect (set.set (getName (i), i));
+                expect (! set.set (getName (i), i));
+                order.add (i);
+
+                expect (! set.contains (getName (i + 1)));
+                expectMatches (set, order);
+            }
+
+            auto r = getRandom();
+
+            while (! order.isEmpty())
+            {
+                auto item = order.removeAndReturn (r.nextInt (order.size()));
+                expect (set.remove (getName (item)));
+                expect (! set.remove (getName (item)));
+                expect (set.getVarPointer (getName (item)) == nullptr);
+                expectMatches (set, order);
+            }
+        }
+
+        beginTest ("Copying and moving");
+        {
+            NamedValueSet set;
+            Array<int> order;
+
+            for (int i = 0; i < 100; ++i)
+            {
+                set.set (getName (i), i);
+                order.add (i);
+            }
+
+            NamedValueSet copy (set);
+            expect (copy == set);
+            expectMatches (copy, order);
+
+            NamedValueSet assigned;
+            assigned.set ("x", 1);
+            assigned = copy;
+            expectMatches (assigned, order);
+
+            NamedValueSet moved (std::move (copy));
+            expectMatches (moved, order);
+
+            moved.clear();
+            expect (moved.isEmpty());
+            expect (! moved.contains (getName (1)));
+
+            moved = std::move (assigned);
+            expectMatches (moved, order);
+        }
+
+        beginTest ("Benchmark");
+        {
+            for (auto numKeys : { 8, 16, 24, 32, 100, 1000, 5000 })
+            {
+                Array<Identifier> names;
+                String json ("{");
+
+                for (int i = 0; i < numKeys; ++i)
+                {
+                    names.add (getName (i));
+                    json << (i > 0 ? ", " : "") << "\"" << names.getLast().toString() << "\": " << i;
+                }
+
+                json << "}";
+
+                auto start = Time::getMillisecondCounterHiRes();
+                auto parsed = JSON::parse (json);
+                auto parseTime = Time::getMillisecondCounterHiRes() - start;
+
+                auto* object = parsed.getDynamicObject();
+                expect (object != nullptr && object->getProperties().size() == numKeys);
+
+                auto numLookups = numKeys * (1000000 / numKeys);
+                int64 total = 0;
+                start = Time::getMillisecondCounterHiRes();
+
+                for (int i = 0; i < numLookups; ++i)
+                    total += (int) object->getProperty (names.getReference (i % numKeys));
+
+                auto lookupTime = Time::getMillisecondCounterHiRes() - start;
+                expectEquals (total, (int64) (numLookups / numKeys) * numKeys * (numKeys - 1) / 2);
+
+                logMessage ("  " + String (numKeys).paddedLeft (' ', 5) + " keys: "
+                              + "JSON parse " + String (parseTime, 2) + " ms, "
+                              + "lookup " + String (lookupTime * 1.0e6 / numLookups, 1) + " ns");
+            }
+        }
+    }
+};
+
+static NamedValueSetTests namedValueSetTests;
+
+#endif
+
 } // namespace juce
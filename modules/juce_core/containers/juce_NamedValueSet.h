@@ -29,6 +29,10 @@ namespace juce
     This can be used as a basic structure to hold a set of var object, which can
     be retrieved by using their identifier.
 
+    The values are kept in the order in which they were added. Small sets are searched
+    linearly, but once a set has more than a handful of items, it also keeps a hash index
+    of the names, so that looking up a value stays fast however many there are.
+
     @tags{Core}
 */
 class JUCE_API  NamedValueSet
@@ -155,7 +159,13 @@ public:
 
 private:
     //==============================================================================
+    struct Index;
+
     Array<NamedValue> values;
+    std::unique_ptr<Index> nameIndex;
+
+    void addValue (NamedValue&&);
+    void updateIndex();
 };
 
 } // namespace juce
@@ -0,0 +1,221 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 5 End-User License
+   Agreement and JUCE 5 Privacy Policy (both updated and effective as of the
+   27th April 2017).
+
+   End User License Agreement: www.juce.com/juce-5-licence
+   Privacy Policy: www.juce.com/juce-5-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A bounded, lock-free queue with a single producer thread and a single consumer thread.
+
+    Unlike AbstractFifo, this holds the items itself, so it can be used directly with any
+    type that can be moved, including move-only types like std::unique_ptr. Only one thread
+    may call the push methods and only one thread may call the pop methods, but those can
+    be different threads, and neither will ever block or allocate memory once the queue has
+    been created.
+
+    The read and write positions are kept on separate cache lines, so that the producer
+    and consumer threads don't slow each other down.
+
+    e.g.
+    @code
+    SPSCQueue<MidiMessage> queue (1024);
+
+    // on the producer thread:
+    if (! queue.push (message))
+        handleOverflow();
+
+    // on the consumer thread:
+    MidiMessage m;
+
+    while (queue.pop (m))
+        process (m);
+    @endcode
+
+    @see MPMCQueue, AbstractFifo
+
+    @tags{Core}
+*/
+template <typename Type>
+class SPSCQueue
+{
+public:
+    //==============================================================================
+    /** Creates a queue that can hold at least the given number of items.
+        The capacity will be rounded up to a power of two.
+    */
+    explicit SPSCQueue (int minimumCapacity)
+        : capacity ((size_t) nextPowerOfTwo (jmax (2, minimumCapacity))),
+          slots (new Slot[capacity])
+    {
+    }
+
+    /** Destructor. Any items that are still in the queue are destroyed. */
+    ~SPSCQueue()
+    {
+        for (auto i = readPosition.load(); i != writePosition.load(); ++i)
+            getSlot (i)->~Type();
+    }
+
+    //==============================================================================
+    /** Adds a copy of an item to the queue.
+        This must only be called by the producer thread. It returns false if the queue is full.
+    */
+    bool push (const Type& item)                    { return emplace (item); }
+
+    /** Moves an item into the queue.
+        This must only be called by the producer thread. It returns false if the queue is full,
+        in which case the item will not have been moved from.
+    */
+    bool push (Type&& item)                         { return emplace (std::move (item)); }
+
+    /** Constructs an item in place at the back of the queue.
+        This must only be called by the producer thread. It returns false if the queue is full.
+    */
+    template <typename... Args>
+    bool emplace (Args&&... args)
+    {
+        auto pos = writePosition.load (std::memory_order_relaxed);
+
+        if (pos - cachedReadPosition >= capacity)
+        {
+            cachedReadPosition = readPosition.load (std::memory_order_acquire);
+
+            if (pos - cachedReadPosition >= capacity)
+                return false;
+        }
+
+        new (getSlot (pos)) Type (std::forward<Args> (args)...);
+        writePosition.store (pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** Adds up to numItems items from a sequence, stopping when the queue is full.
+
+        The items are copied from the iterator, so use std::make_move_iterator() to move
+        them instead. All the items become visible to the consumer at once. This must only
+        be called by the producer thread, and returns the number of items that were added.
+    */
+    template <typename InputIterator>
+    int pushBatch (InputIterator source, int numItems)
+    {
+        auto pos = writePosition.load (std::memory_order_relaxed);
+        cachedReadPosition = readPosition.load (std::memory_order_acquire);
+
+        auto numToAdd = (int) jmin ((size_t) jmax (0, numItems), capacity - (size_t) (pos - cachedReadPosition));
+
+        for (int i = 0; i < numToAdd; ++i, ++source)
+            new (getSlot (pos + (size_t) i)) Type (*source);
+
+        writePosition.store (pos + (size_t) numToAdd, std::memory_order_release);
+        return numToAdd;
+    }
+
+    //==============================================================================
+    /** Moves the item at the front of the queue into result.
+        This must only be called by the consumer thread. It returns false if the queue is empty.
+    */
+    bool pop (Type& result)
+    {
+        auto pos = readPosition.load (std::memory_order_relaxed);
+
+        if (pos == cachedWritePosition)
+        {
+            cachedWritePosition = writePosition.load (std::memory_order_acquire);
+
+            if (pos == cachedWritePosition)
+                return false;
+        }
+
+        auto* item = getSlot (pos);
+        result = std::move (*item);
+        item->~Type();
+        readPosition.store (pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** Moves up to maxItems items from the front of the queue to an output iterator.
+        This must only be called by the consumer thread, and returns the number of items
+        that were removed.
+    */
+    template <typename OutputIterator>
+    int popBatch (OutputIterator destination, int maxItems)
+    {
+        auto pos = readPosition.load (std::memory_order_relaxed);
+        cachedWritePosition = writePosition.load (std::memory_order_acquire);
+
+        auto numToRemove = (int) jmin ((size_t) jmax (0, maxItems), (size_t) (cachedWritePosition - pos));
+
+        for (int i = 0; i < numToRemove; ++i, ++destination)
+        {
+            auto* item = getSlot (pos + (size_t) i);
+            *destination = std::move (*item);
+            item->~Type();
+        }
+
+        readPosition.store (pos + (size_t) numToRemove, std::memory_order_release);
+        return numToRemove;
+    }
+
+    //==============================================================================
+    /** Returns the number of items in the queue.
+        If the other thread is busy, this may be out of date by the time it returns.
+    */
+    int getNumReady() const noexcept
+    {
+        return (int) (writePosition.load (std::memory_order_acquire) - readPosition.load (std::memory_order_acquire));
+    }
+
+    /** Returns true if the queue is empty. */
+    bool isEmpty() const noexcept                   { return getNumReady() == 0; }
+
+    /** Returns the number of items that the queue can hold. */
+    int getCapacity() const noexcept                { return (int) capacity; }
+
+private:
+    //==============================================================================
+    using Slot = typename std::aligned_storage<sizeof (Type), alignof (Type)>::type;
+
+    enum { cacheLineSize = 64 };
+
+    const size_t capacity;
+    std::unique_ptr<Slot[]> slots;
+
+    // the producer's data and the consumer's data are padded onto separate cache lines
+    char padding1[cacheLineSize];
+    std::atomic<size_t> writePosition { 0 };
+    size_t cachedReadPosition = 0;
+    char padding2[cacheLineSize];
+    std::atomic<size_t> readPosition { 0 };
+    size_t cachedWritePosition = 0;
+    char padding3[cacheLineSize];
+
+    Type* getSlot (size_t position) const noexcept   { return reinterpret_cast<Type*> (slots.get() + (position & (capacity - 1))); }
+
+    JUCE_DECLARE_NON_COPYABLE (SPSCQueue)
+};
+
+} // namespace juce
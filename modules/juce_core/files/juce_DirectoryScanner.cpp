@@ -0,0 +1,444 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+struct DirectoryScanner::ScanState
+{
+    struct Folder
+    {
+        String path, relativePath;
+    };
+
+    ScanState (DirectoryScanner& s, const String& wildCard, int type, Array<Entry>& r)
+        : owner (s), whatToLookFor (type), results (r)
+    {
+        wildCards.addTokens (wildCard, ";,", "\"'");
+        wildCards.trim();
+        wildCards.removeEmptyStrings();
+        matchesAllNames = wildCards.size() == 1 && wildCards[0] == "*";
+
+        for (auto& p : owner.ignorePatterns)
+            (p.containsChar ('/') ? ignoredPaths : ignoredNames).add (p);
+    }
+
+    void run()
+    {
+        Array<Entry> found;
+        Array<Folder> subFolders;
+        Folder folder;
+
+        while (getNextFolder (folder))
+        {
+            try
+            {
+                scanFolder (folder, found, subFolders);
+            }
+            catch (...)
+            {
+                owner.stop();
+                finishedFolder (subFolders);
+                throw;
+            }
+
+            finishedFolder (subFolders);
+            subFolders.clearQuick();
+        }
+
+        const ScopedLock sl (lock);
+        results.ensureStorageAllocated (results.size() + found.size());
+
+        for (auto& e : found)
+            results.add (static_cast<Entry&&> (e));
+    }
+
+    bool getNextFolder (Folder& folder)
+    {
+        const ScopedLock sl (lock);
+
+        for (;;)
+        {
+            if (owner.shouldStop)
+                return false;
+
+            if (! foldersToScan.isEmpty())
+                break;
+
+            // nothing left to scan, and nobody else is going to find anything else
+            if (numFoldersBeingScanned == 0)
+                return false;
+
+            workAvailable.reset();
+            const ScopedUnlock su (lock);
+            workAvailable.wait();
+        }
+
+        folder = foldersToScan.getLast();
+        foldersToScan.removeLast();
+        ++numFoldersBeingScanned;
+        return true;
+    }
+
+    void finishedFolder (const Array<Folder>& subFolders)
+    {
+        const ScopedLock sl (lock);
+        foldersToScan.addArray (subFolders);
+
+        if (--numFoldersBeingScanned == 0 || ! subFolders.isEmpty())
+            workAvailable.signal();
+    }
+
+    void scanFolder (const Folder& folder, Array<Entry>& found, Array<Folder>& subFolders)
+    {
+        NativeFolderReader reader (folder.path);
+        String filename;
+        Entry entry;
+
+        while (reader.next (filename, entry))
+        {
+            if (owner.shouldStop)
+                return;
+
+            if (entry.isHidden && (whatToLookFor & File::ignoreHiddenFiles) != 0)
+                continue;
+
+            if (isIgnored (folder, filename))
+                continue;
+
+            auto path = folder.path + filename;
+            entry.file = File::createFileWithoutCheckingPath (path);
+
+            if (owner.ignoreFilter != nullptr && owner.ignoreFilter (entry))
+                continue;
+
+            if (entry.isDirectory && ! entry.isSymbolicLink)
+                subFolders.add ({ path + File::getSeparatorChar(), folder.relativePath + filename + "/" });
+
+            if ((whatToLookFor & (entry.isDirectory ? File::findDirectories : File::findFiles)) != 0
+                 && (matchesAllNames || nameMatches (wildCards, filename)))
+            {
+                found.add (entry);
+                ++owner.numEntriesFound;
+            }
+        }
+    }
+
+    bool isIgnored (const Folder& folder, const String& filename) const
+    {
+        return nameMatches (ignoredNames, filename)
+                || (! ignoredPaths.isEmpty() && nameMatches (ignoredPaths, folder.relativePath + filename));
+    }
+
+    static bool nameMatches (const StringArray& patterns, const String& name)
+    {
+        for (auto& p : patterns)
+            if (name.matchesWildcard (p, ! File::areFileNamesCaseSensitive()))
+                return true;
+
+        return false;
+    }
+
+    DirectoryScanner& owner;
+    StringArray wildCards, ignoredNames, ignoredPaths;
+    bool matchesAllNames;
+    const int whatToLookFor;
+    Array<Entry>& results;
+
+    CriticalSection lock;
+    Array<Folder> foldersToScan;
+    int numFoldersBeingScanned = 0;
+    WaitableEvent workAvailable { true };
+
+    JUCE_DECLARE_NON_COPYABLE (ScanState)
+};
+
+//==============================================================================
+DirectoryScanner::DirectoryScanner() {}
+DirectoryScanner::~DirectoryScanner() {}
+
+Result DirectoryScanner::scan (const File& directory, Array<Entry>& results,
+                               const String& wildCard, int whatToLookFor, ThreadPool* pool)
+{
+    // you have to specify the type of files you're looking for!
+    jassert ((whatToLookFor & (File::findFiles | File::findDirectories)) != 0);
+    jassert (whatToLookFor > 0 && whatToLookFor <= 7);
+
+    shouldStop = false;
+    numEntriesFound = 0;
+
+    if (! directory.isDirectory())
+        return Result::fail ("Couldn't read the directory " + directory.getFullPathName());
+
+    if (pool == nullptr)
+    {
+        SharedResourcePointer<DefaultParallelThreadPool> defaultPool;
+        return scan (directory, results, wildCard, whatToLookFor, defaultPool);
+    }
+
+    ScanState state (*this, wildCard, whatToLookFor, results);
+    state.foldersToScan.add ({ File::addTrailingSeparator (directory.getFullPathName()), {} });
+
+    ParallelAlgorithmHelpers::runChunks (pool->getNumThreads() + 1, [&state] (int) { state.run(); }, pool);
+
+    return shouldStop ? Result::fail ("The scan was stopped") : Result::ok();
+}
+
+void DirectoryScanner::stop() noexcept
+{
+    shouldStop = true;
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class DirectoryScannerTests  : public UnitTest
+{
+public:
+    DirectoryScannerTests()  : UnitTest ("DirectoryScanner", "Files") {}
+
+    void runTest() override
+    {
+        auto r = getRandom();
+        ThreadPool pool (4);
+
+        auto root = File::getSpecialLocation (File::tempDirectory).getNonexistentChildFile ("DirectoryScannerTest", {});
+        auto numItems = createTree (r, root, 4, 4, 6);
+
+        beginTest ("Scanning");
+        {
+            for (auto type : { (int) File::findFiles, (int) File::findDirectories, (int) File::findFilesAndDirectories,
+                               (int) File::findFiles | (int) File::ignoreHiddenFiles })
+            {
+                for (auto* wildCard : { "*", "*.txt", "*.wav;*.txt" })
+                {
+                    DirectoryScanner scanner;
+                    Array<DirectoryScanner::Entry> entries;
+                    expect (scanner.scan (root, entries, wildCard, type, &pool).wasOk());
+                    expectEquals (scanner.getNumEntriesFound(), entries.size());
+
+                    StringArray expected;
+
+                    for (DirectoryIterator i (root, true, wildCard, type); i.next();)
+                        expected.add (i.getFile().getFullPathName());
+
+                    expect (getSortedPaths (entries) == sorted (expected));
+                }
+            }
+
+            DirectoryScanner scanner;
+            Array<DirectoryScanner::Entry> entries;
+            expect (scanner.scan (root, entries, "*", File::findFilesAndDirectories, &pool).wasOk());
+            expectEquals (entries.size(), numItems);
+
+            for (auto& e : entries)
+            {
+                expect (e.isDirectory == e.file.isDirectory());
+                expect (e.isHidden == e.file.isHidden());
+                expect (! e.isSymbolicLink);
+
+                if (! e.isDirectory)
+                    expectEquals (e.fileSize, e.file.getSize());
+
+                expect (e.modificationTime == e.file.getLastModificationTime());
+            }
+
+            expect (scanner.scan (root.getChildFile ("nonexistent"), entries).failed());
+            expect (scanner.scan (root.getChildFile ("nonexistent"), entries, "*", File::findFiles, &pool).failed());
+        }
+
+        beginTest ("Ignore rules");
+        {
+            DirectoryScanner scanner;
+            scanner.ignorePatterns.add ("*.wav");
+            scanner.ignorePatterns.add ("folder1");
+            scanner.ignorePatterns.add ("folder0/folder2");
+
+            std::atomic<int> numFiltered { 0 };
+
+            scanner.ignoreFilter = [&numFiltered] (const DirectoryScanner::Entry& e)
+            {
+                jassert (! e.file.getFileName().endsWith (".wav"));
+                ++numFiltered;
+                return ! e.isDirectory && e.fileSize > 150;
+            };
+
+            Array<DirectoryScanner::Entry> entries;
+            expect (scanner.scan (root, entries, "*", File::findFilesAndDirectories, &pool).wasOk());
+            expect (numFiltered > 0);
+
+            StringArray expected;
+
+            for (DirectoryIterator i (root, true, "*", File::findFilesAndDirectories); i.next();)
+            {
+                auto f = i.getFile();
+                auto relativePath = f.getRelativePathFrom (root).replaceCharacter ('\\', '/');
+
+                if (! (relativePath.contains (".wav") || relativePath.contains ("folder1")
+                        || relativePath.startsWith ("folder0/folder2")
+                        || (! f.isDirectory() && f.getSize() > 150)))
+                    expected.add (f.getFullPathName());
+            }
+
+            expect (getSortedPaths (entries) == sorted (expected));
+        }
+
+        beginTest ("Symbolic links");
+        {
+           #if ! JUCE_WINDOWS
+            auto link = root.getChildFile ("link");
+            expect (root.getChildFile ("folder0").createSymbolicLink (link, false));
+
+            DirectoryScanner scanner;
+            Array<DirectoryScanner::Entry> entries;
+            expect (scanner.scan (root, entries, "link", File::findDirectories, &pool).wasOk());
+            expectEquals (entries.size(), 1);
+            expect (entries[0].isDirectory && entries[0].isSymbolicLink);
+
+            // the link is returned, but the scanner mustn't look inside it
+            entries.clearQuick();
+            expect (scanner.scan (root, entries, "*", File::findFilesAndDirectories, &pool).wasOk());
+            expectEquals (entries.size(), numItems + 1);
+
+            ::unlink (link.getFullPathName().toUTF8());
+           #endif
+        }
+
+        beginTest ("Stopping");
+        {
+            for (auto* threadPool : { (ThreadPool*) nullptr, &pool })
+            {
+                DirectoryScanner scanner;
+                std::atomic<int> numSeen { 0 };
+
+                scanner.ignoreFilter = [&] (const DirectoryScanner::Entry&)
+                {
+                    if (++numSeen == 20)
+                        scanner.stop();
+
+                    return false;
+                };
+
+                Array<DirectoryScanner::Entry> entries;
+                auto result = scanner.scan (root, entries, "*", File::findFilesAndDirectories, threadPool);
+                expect (result.failed());
+                expect (entries.size() < numItems);
+                expectEquals (entries.size(), scanner.getNumEntriesFound());
+
+                // a stopped scanner can be used again
+                scanner.ignoreFilter = nullptr;
+                entries.clearQuick();
+                expect (scanner.scan (root, entries, "*", File::findFilesAndDirectories, threadPool).wasOk());
+                expectEquals (entries.size(), numItems);
+            }
+        }
+
+        root.deleteRecursively();
+
+        beginTest ("Benchmark");
+        {
+            auto benchmarkRoot = File::getSpecialLocation (File::tempDirectory).getNonexistentChildFile ("DirectoryScannerBenchmark", {});
+            auto numBenchmarkItems = createTree (r, benchmarkRoot, 7, 3, 10);
+
+            auto start = Time::getMillisecondCounterHiRes();
+            DirectoryIterator iter (benchmarkRoot, true, "*", File::findFilesAndDirectories);
+            bool isDirectory;
+            int64 size;
+            Time modTime;
+            int numFound = 0;
+
+            while (iter.next (&isDirectory, nullptr, &size, &modTime, nullptr, nullptr))
+                ++numFound;
+
+            auto iteratorTime = Time::getMillisecondCounterHiRes() - start;
+            expectEquals (numFound, numBenchmarkItems);
+
+            for (auto* threadPool : { (ThreadPool*) nullptr, &pool })
+            {
+                DirectoryScanner scanner;
+                Array<DirectoryScanner::Entry> entries;
+
+                start = Time::getMillisecondCounterHiRes();
+                expect (scanner.scan (benchmarkRoot, entries, "*", File::findFilesAndDirectories, threadPool).wasOk());
+                auto scanTime = Time::getMillisecondCounterHiRes() - start;
+
+                expectEquals (entries.size(), numBenchmarkItems);
+
+                logMessage (String ("  ") + String (numBenchmarkItems) + " items: DirectoryIterator "
+                              + String (iteratorTime, 1) + " ms, DirectoryScanner ("
+                              + (threadPool != nullptr ? String (threadPool->getNumThreads()) : String ("default"))
+                              + " threads) " + String (scanTime, 1) + " ms");
+            }
+
+            benchmarkRoot.deleteRecursively();
+        }
+    }
+
+    // Creates a tree of folders containing files of various sizes, including some
+    // hidden ones, and returns the total number of files and folders created
+    static int createTree (Random& r, const File& folder, int depth, int numSubFolders, int numFiles)
+    {
+        static const char* const extensions[] = { ".txt", ".wav", ".dat" };
+        folder.createDirectory();
+        int numCreated = 0;
+
+        for (int i = 0; i < numFiles; ++i)
+        {
+            auto name = (i == 0 ? String (".hidden") : String ("file")) + String (i) + extensions[r.nextInt (3)];
+            folder.getChildFile (name).replaceWithText (String::repeatedString ("x", r.nextInt (300)));
+            ++numCreated;
+        }
+
+        if (depth > 1)
+        {
+            for (int i = 0; i < numSubFolders; ++i)
+                numCreated += 1 + createTree (r, folder.getChildFile ("folder" + String (i)),
+                                              depth - 1, numSubFolders, numFiles);
+        }
+
+        return numCreated;
+    }
+
+    static StringArray getSortedPaths (const Array<DirectoryScanner::Entry>& entries)
+    {
+        StringArray paths;
+
+        for (auto& e : entries)
+            paths.add (e.file.getFullPathName());
+
+        return sorted (paths);
+    }
+
+    static StringArray sorted (StringArray s)
+    {
+        s.sort (false);
+        return s;
+    }
+};
+
+static DirectoryScannerTests directoryScannerTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,165 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Recursively scans a directory using several threads, and returns the files it
+    finds along with their sizes, times and types.
+
+    When you need to list a very large tree of files, this is much quicker than using
+    a DirectoryIterator or File::findChildFiles(). Each sub-directory is read by
+    whichever thread is free, so slow disks and network drives can have several
+    requests in flight at once, and the details of each file are read in the same
+    pass as the directory listing, so you don't need to call File::getSize() or
+    similar methods (which would query the file system again) afterwards.
+
+    E.g. @code
+    DirectoryScanner scanner;
+    scanner.ignorePatterns.add (".git");
+    scanner.ignorePatterns.add ("*.tmp");
+
+    Array<DirectoryScanner::Entry> samples;
+    auto result = scanner.scan (File ("/samples"), samples, "*.wav;*.aif");
+
+    for (auto& s : samples)
+        DBG (s.file.getFullPathName() << " " << s.fileSize);
+    @endcode
+
+    Please note that, as with DirectoryIterator, the order of the results is completely
+    undefined, and will vary between scans because of the way the work is shared out.
+
+    Symbolic links to directories are returned like any other directory, but the scanner
+    never follows them into the directories that they point to, so a tree which contains
+    links back to its own parent folders can't make it go round in circles.
+
+    @see DirectoryIterator, File::findChildFiles
+
+    @tags{Core}
+*/
+class JUCE_API  DirectoryScanner  final
+{
+public:
+    //==============================================================================
+    /** Creates a scanner. */
+    DirectoryScanner();
+
+    /** Destructor. */
+    ~DirectoryScanner();
+
+    //==============================================================================
+    /** Holds the details of one of the files that a scan has found. */
+    struct Entry
+    {
+        File file;
+        int64 fileSize = 0;
+        Time modificationTime, creationTime;
+        bool isDirectory = false, isHidden = false, isSymbolicLink = false;
+    };
+
+    /** Scans a directory and all of its sub-directories, adding the entries that are
+        found to an array.
+
+        The calling thread also does some of the work, and this method returns once the
+        whole tree has been read, or when stop() is called.
+
+        @param directory      the directory to scan
+        @param results        the array to add the entries to
+        @param wildCard       the pattern that the names of the results must match. This may
+                              contain multiple patterns separated by a semi-colon or comma,
+                              e.g. "*.jpg;*.png". The contents of all the sub-directories are
+                              scanned, whether their names match the pattern or not.
+        @param whatToLookFor  a value from the File::TypesOfFileToFind enum, specifying
+                              whether to look for files, directories, or both, and whether
+                              hidden files (and the contents of hidden directories) should
+                              be skipped
+        @param pool           the pool whose threads should read the directories, or nullptr
+                              to use the DefaultParallelThreadPool
+        @returns an error if the directory couldn't be read or the scan was stopped, in
+                 which case the array will still contain the entries that were found
+                 before that happened. Sub-directories that can't be read are skipped.
+    */
+    Result scan (const File& directory,
+                 Array<Entry>& results,
+                 const String& wildCard = "*",
+                 int whatToLookFor = File::findFiles,
+                 ThreadPool* pool = nullptr);
+
+    /** Makes a scan that's running on another thread finish as soon as possible. */
+    void stop() noexcept;
+
+    /** Returns the number of entries that the current scan has found so far. This can be
+        called from another thread to show the progress of a scan.
+    */
+    int getNumEntriesFound() const noexcept         { return numEntriesFound; }
+
+    //==============================================================================
+    /** A list of wildcard patterns for files and directories which should be left out
+        of a scan. If a directory is ignored, none of its contents are scanned either.
+
+        A pattern that contains a '/' is matched against the path of each entry relative
+        to the directory being scanned (using '/' as the separator on all platforms), e.g.
+        "build/Debug". Any other pattern is matched against the name of each entry, at any
+        depth, e.g. ".git" or "*.bak".
+    */
+    StringArray ignorePatterns;
+
+    /** An optional function which can decide whether each entry should be left out of
+        a scan, by returning true. If it returns true for a directory, none of its contents
+        are scanned. It's only called for entries that haven't already been excluded by the
+        ignorePatterns, and it's called concurrently on the pool's threads, so it must be
+        thread-safe.
+    */
+    std::function<bool (const Entry&)> ignoreFilter;
+
+private:
+    //==============================================================================
+    class NativeFolderReader
+    {
+    public:
+        NativeFolderReader (const String& folderPath);
+        ~NativeFolderReader();
+
+        /** Fills in everything in the entry except its File. */
+        bool next (String& filenameFound, Entry& entry);
+
+        class Pimpl;
+
+    private:
+        friend struct ContainerDeletePolicy<Pimpl>;
+        std::unique_ptr<Pimpl> pimpl;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (NativeFolderReader)
+    };
+
+    struct ScanState;
+    friend struct ContainerDeletePolicy<NativeFolderReader::Pimpl>;
+    std::atomic<bool> shouldStop { false };
+    std::atomic<int> numEntriesFound { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DirectoryScanner)
+};
+
+} // namespace juce
@@ -45,6 +45,16 @@ struct JSONParser
 
         for (;;)
         {
+           #if JUCE_STRING_UTF_TYPE == 8
+            {
+                // copy everything up to the next quote, escape or multi-byte character in one go
+                auto* start = t.getAddress();
+                auto* end = CharPointer_UTF8::findEndOfASCII (start, (char) quoteChar, '\\');
+                buffer.write (start, (size_t) (end - start));
+                t = String::CharPointerType (end);
+            }
+           #endif
+
             auto c = t.getAndAdvance();
 
             if (c == quoteChar)
@@ -379,6 +389,23 @@ struct JSONFormatter
     {
         for (;;)
         {
+           #if JUCE_STRING_UTF_TYPE == 8
+            {
+                // write any run of characters that don't need escaping in one go
+                auto* start = t.getAddress();
+                auto* end = start;
+
+                while (isPositiveAndBelow ((int) (uint8) *end - 32, 95) && *end != '"' && *end != '\\')
+                    ++end;
+
+                if (end != start)
+                {
+                    out.write (start, (size_t) (end - start));
+                    t = String::CharPointerType (end);
+                }
+            }
+           #endif
+
             auto c = t.getAndAdvance();
 
             switch (c)
@@ -0,0 +1,538 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+// Collects the items of each container in a single array until the container is
+// complete, and then moves them into one contiguous block in the arena
+struct JSONDocument::Builder  : public JSONReader::Handler
+{
+    using CharType = String::CharPointerType::CharType;
+
+    Builder (ArenaAllocator& a) : arena (a) {}
+
+    static Result build (JSONDocument& doc, JSONReader& reader)
+    {
+        doc.root = nullptr;
+        doc.arena.clear();
+
+        Builder builder (doc.arena);
+        auto r = reader.parse (builder);
+
+        if (r.failed())
+        {
+            doc.arena.clear();
+            return r;
+        }
+
+        auto* root = doc.arena.allocateArray<ItemData> (1);
+        *root = builder.pending.getReference (0);
+        doc.root = root;
+        return r;
+    }
+
+    bool startObject() override     { return startContainer (Type::object); }
+    bool startArray() override      { return startContainer (Type::array); }
+    bool endObject() override       { return endContainer(); }
+    bool endArray() override        { return endContainer(); }
+
+    bool propertyName (CharPointer_UTF8 start, CharPointer_UTF8 end) override
+    {
+        pendingName = copyText (start, end);
+        return true;
+    }
+
+    bool stringValue (CharPointer_UTF8 start, CharPointer_UTF8 end) override
+    {
+        addItem (Type::string).text = copyText (start, end);
+        return true;
+    }
+
+    bool intValue (int64 value) override        { addItem (Type::integer).intValue = value;          return true; }
+    bool doubleValue (double value) override    { addItem (Type::floatingPoint).doubleValue = value; return true; }
+    bool boolValue (bool value) override        { addItem (Type::boolean).boolValue = value;         return true; }
+    bool nullValue() override                   { addItem (Type::null);                              return true; }
+
+private:
+    ArenaAllocator& arena;
+    Array<ItemData> pending;
+    Array<int> containerStarts;
+    const CharType* pendingName = nullptr;
+
+    const CharType* copyText (CharPointer_UTF8 start, CharPointer_UTF8 end)
+    {
+       #if JUCE_STRING_UTF_TYPE == 8
+        return arena.copyString (start.getAddress(), (size_t) (end.getAddress() - start.getAddress()));
+       #else
+        String s (start, end);
+        auto numBytes = s.getCharPointer().sizeInBytes();
+        auto* copy = arena.allocate (numBytes, alignof (CharType));
+        memcpy (copy, s.getCharPointer().getAddress(), numBytes);
+        return static_cast<const CharType*> (copy);
+       #endif
+    }
+
+    ItemData& addItem (Type type)
+    {
+        ItemData item;
+        item.name = pendingName;
+        item.intValue = 0;
+        item.size = 0;
+        item.type = type;
+
+        pendingName = nullptr;
+        pending.add (item);
+        return pending.getReference (pending.size() - 1);
+    }
+
+    bool startContainer (Type type)
+    {
+        addItem (type);
+        containerStarts.add (pending.size());
+        return true;
+    }
+
+    bool endContainer()
+    {
+        auto start = containerStarts.removeAndReturn (containerStarts.size() - 1);
+        auto numChildren = pending.size() - start;
+        auto& container = pending.getReference (start - 1);
+
+        if (numChildren > 0)
+        {
+            auto* children = arena.allocateArray<ItemData> ((size_t) numChildren);
+            memcpy (children, pending.begin() + start, (size_t) numChildren * sizeof (ItemData));
+            container.children = children;
+            container.size = (uint32) numChildren;
+            pending.removeRange (start, numChildren);
+        }
+
+        return true;
+    }
+};
+
+//==============================================================================
+JSONDocument::JSONDocument() : arena (65536) {}
+JSONDocument::~JSONDocument() {}
+
+Result JSONDocument::parse (const void* data, size_t numBytes)
+{
+    JSONReader reader (data, numBytes);
+    return Builder::build (*this, reader);
+}
+
+Result JSONDocument::parse (const String& text)
+{
+    auto utf8 = text.toUTF8();
+    return parse (utf8.getAddress(), utf8.sizeInBytes() - 1);
+}
+
+Result JSONDocument::parse (InputStream& input)
+{
+    JSONReader reader (input);
+    return Builder::build (*this, reader);
+}
+
+Result JSONDocument::parse (const File& file)
+{
+    {
+        MemoryMappedFile mappedFile (file, MemoryMappedFile::readOnly);
+
+        // all the strings get copied into the document, so the file needn't stay mapped
+        if (mappedFile.getData() != nullptr)
+            return parse (mappedFile.getData(), mappedFile.getSize());
+    }
+
+    FileInputStream in (file);
+
+    if (in.failedToOpen())
+        return Result::fail ("Couldn't open " + file.getFullPathName());
+
+    return parse (in);
+}
+
+//==============================================================================
+JSONDocument::Type JSONDocument::Item::getType() const noexcept
+{
+    return item != nullptr ? item->type : Type::null;
+}
+
+bool JSONDocument::Item::getBool() const noexcept
+{
+    return isBool() && item->boolValue;
+}
+
+int64 JSONDocument::Item::getInt64() const noexcept
+{
+    switch (getType())
+    {
+        case Type::integer:         return item->intValue;
+        case Type::floatingPoint:   return (int64) item->doubleValue;
+        default:                    return 0;
+    }
+}
+
+double JSONDocument::Item::getDouble() const noexcept
+{
+    switch (getType())
+    {
+        case Type::integer:         return (double) item->intValue;
+        case Type::floatingPoint:   return item->doubleValue;
+        default:                    return 0;
+    }
+}
+
+StringRef JSONDocument::Item::getText() const noexcept
+{
+    return isString() ? StringRef (String::CharPointerType (item->text)) : StringRef();
+}
+
+StringRef JSONDocument::Item::getName() const noexcept
+{
+    return item != nullptr && item->name != nullptr ? StringRef (String::CharPointerType (item->name)) : StringRef();
+}
+
+int JSONDocument::Item::size() const noexcept
+{
+    return isArray() || isObject() ? (int) item->size : 0;
+}
+
+JSONDocument::Item JSONDocument::Item::operator[] (int index) const noexcept
+{
+    return isPositiveAndBelow (index, size()) ? Item (item->children + index) : Item();
+}
+
+JSONDocument::Item JSONDocument::Item::operator[] (StringRef propertyName) const noexcept
+{
+    if (isObject())
+        for (auto* child = item->children, * end = child + item->size; child != end; ++child)
+            if (String::CharPointerType (child->name).compare (propertyName.text) == 0)
+                return Item (child);
+
+    return {};
+}
+
+JSONDocument::Item::Iterator JSONDocument::Item::begin() const noexcept
+{
+    return { size() > 0 ? item->children : nullptr };
+}
+
+JSONDocument::Item::Iterator JSONDocument::Item::end() const noexcept
+{
+    return { size() > 0 ? item->children + item->size : nullptr };
+}
+
+var JSONDocument::Item::toVar() const
+{
+    switch (getType())
+    {
+        case Type::boolean:         return item->boolValue;
+        case Type::floatingPoint:   return item->doubleValue;
+        case Type::string:          return String (String::CharPointerType (item->text));
+
+        case Type::integer:
+            if (item->intValue >= -0x7fffffff && item->intValue <= 0x7fffffff)
+                return (int) item->intValue;
+
+            return item->intValue;
+
+        case Type::array:
+        {
+            Array<var> elements;
+            elements.ensureStorageAllocated (size());
+
+            for (auto element : *this)
+                elements.add (element.toVar());
+
+            return elements;
+        }
+
+        case Type::object:
+        {
+            auto* object = new DynamicObject();
+            var result (object);
+
+            for (auto member : *this)
+            {
+                auto name = member.getName();
+
+                if (name.isNotEmpty())
+                    object->setProperty (Identifier (name.text, name.text.findTerminatingNull()), member.toVar());
+            }
+
+            return result;
+        }
+
+        case Type::null:
+        default:
+            return {};
+    }
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class JSONStreamingTests  : public UnitTest
+{
+public:
+    JSONStreamingTests() : UnitTest ("JSON streaming", "JSON") {}
+
+    // Replays everything a reader finds into a writer
+    struct Replayer  : public JSONReader::Handler
+    {
+        Replayer (JSONWriter& w) : writer (w) {}
+
+        bool startObject() override         { writer.startObject(); return true; }
+        bool endObject() override           { writer.endObject();   return true; }
+        bool startArray() override          { writer.startArray();  return true; }
+        bool endArray() override            { writer.endArray();    return true; }
+        bool intValue (int64 v) override    { writer.writeInt (v);    return true; }
+        bool doubleValue (double v) override{ writer.writeDouble (v); return true; }
+        bool boolValue (bool v) override    { writer.writeBool (v);   return true; }
+        bool nullValue() override           { writer.writeNull();     return true; }
+
+        bool propertyName (CharPointer_UTF8 start, CharPointer_UTF8 end) override   { writer.writeName (String (start, end));   return true; }
+        bool stringValue (CharPointer_UTF8 start, CharPointer_UTF8 end) override    { writer.writeString (String (start, end)); return true; }
+
+        JSONWriter& writer;
+    };
+
+    struct Counter  : public JSONReader::Handler
+    {
+        bool startObject() override                                     { ++numItems; return true; }
+        bool startArray() override                                      { ++numItems; return true; }
+        bool propertyName (CharPointer_UTF8 s, CharPointer_UTF8 e) override { numBytes += (size_t) (e.getAddress() - s.getAddress()); return true; }
+        bool stringValue (CharPointer_UTF8 s, CharPointer_UTF8 e) override  { numBytes += (size_t) (e.getAddress() - s.getAddress()); ++numItems; return true; }
+        bool intValue (int64) override                                  { ++numItems; return true; }
+        bool doubleValue (double) override                              { ++numItems; return true; }
+        bool boolValue (bool) override                                  { ++numItems; return true; }
+        bool nullValue() override                                       { ++numItems; return true; }
+
+        size_t numItems = 0, numBytes = 0;
+    };
+
+    String replay (JSONReader& reader, bool oneLine)
+    {
+        MemoryOutputStream out;
+
+        {
+            JSONWriter writer (out, oneLine);
+            Replayer replayer (writer);
+            expect (reader.parse (replayer).wasOk());
+        }
+
+        return out.toUTF8();
+    }
+
+    static Result parseWithReader (const String& text, int bufferSize)
+    {
+        Counter counter;
+
+        if (bufferSize <= 0)
+        {
+            JSONReader reader (text.toRawUTF8(), text.getNumBytesAsUTF8());
+            return reader.parse (counter);
+        }
+
+        MemoryInputStream in (text.toRawUTF8(), text.getNumBytesAsUTF8(), false);
+        JSONReader reader (in, (size_t) bufferSize);
+        return reader.parse (counter);
+    }
+
+    void runTest() override
+    {
+        auto r = getRandom();
+
+        beginTest ("Reader and writer");
+        {
+            for (int i = 0; i < 100; ++i)
+            {
+                auto v = JSONTests::createRandomVar (r, 0);
+                auto oneLine = r.nextBool();
+                auto text = JSON::toString (v, oneLine);
+
+                JSONReader memoryReader (text.toRawUTF8(), text.getNumBytesAsUTF8());
+                expectEquals (replay (memoryReader, oneLine), text);
+                expect (memoryReader.isFinished());
+
+                MemoryInputStream in (text.toRawUTF8(), text.getNumBytesAsUTF8(), false);
+                JSONReader streamReader (in, (size_t) (16 + r.nextInt (64)));
+                expectEquals (replay (streamReader, oneLine), text);
+            }
+
+            const char* escaped = "\"a\\u00e9\\ud83d\\ude00\\n\\/\"";
+            JSONReader reader (escaped, strlen (escaped));
+            MemoryOutputStream out;
+
+            {
+                JSONWriter writer (out, true);
+                Replayer replayer (writer);
+                expect (reader.parse (replayer).wasOk());
+            }
+
+            expectEquals (out.toUTF8(), String ("\"a\\u00e9\\ud83d\\ude00\\n/\""));
+        }
+
+        beginTest ("Document");
+        {
+            for (int i = 0; i < 50; ++i)
+            {
+                auto text = JSON::toString (JSONTests::createRandomVar (r, 0), r.nextBool());
+                JSONDocument doc;
+                expect (doc.parse (text).wasOk());
+                expectEquals (JSON::toString (doc.getRoot().toVar()), JSON::toString (JSON::parse ("[" + text + "]")[0]));
+            }
+
+            JSONDocument doc;
+            expect (doc.parse (String (CharPointer_UTF8 ("{ \"a\": [1, 2.5, \"x\\u00e9\\\"\", true, null, [], {}],"
+                                                         "  \"b\": { \"c\": -9223372036854775808, \"d\": 12345678901234567890 } }"))).wasOk());
+
+            auto root = doc.getRoot();
+            auto a = root["a"];
+            expect (root.isObject() && root.size() == 2);
+            expectEquals (String (root[1].getName()), String ("b"));
+            expect (a.isArray() && a.size() == 7);
+            expect (a[0].isInt() && a[0].getInt64() == 1);
+            expect (a[1].isDouble() && a[1].getDouble() == 2.5);
+            expectEquals (String (a[2].getText()), String (CharPointer_UTF8 ("x\xc3\xa9\"")));
+            expect (a[3].getBool());
+            expect (a[4].isNull() && a[4].isValid());
+            expect (a[5].isArray() && a[5].size() == 0 && a[6].isObject() && a[6].size() == 0);
+            expect (! a[7].isValid() && ! root["nope"].isValid() && root["nope"]["deeper"].isNull());
+            expect (root["b"]["c"].getInt64() == std::numeric_limits<int64>::min());
+            expect (root["b"]["d"].isDouble());
+
+            int numElements = 0;
+
+            for (auto element : a)
+                numElements += element.isValid() ? 1 : 0;
+
+            expectEquals (numElements, 7);
+        }
+
+        beginTest ("Errors");
+        {
+            for (auto* bad : { "", "  ", "[", "[1,", "[1 2]", "{\"a\" 1}", "{\"a\": }", "{a: 1}", "[tru]", "[\"abc", "[1.]",
+                               "[-]", "[1e]", "[01x]", "{\"a\": 1]", "[1}", "\"\\u12x4\"", "@" })
+            {
+                expect (parseWithReader (bad, 0).failed(), bad);
+                expect (parseWithReader (bad, 16).failed(), bad);
+            }
+
+            for (auto* good : { "[]", "{}", "0", "-1.5e-3", "\"\"", "[1,]", " {\"a\": [ true , false , null ] } " })
+            {
+                expect (parseWithReader (good, 0).wasOk(), good);
+                expect (parseWithReader (good, 16).wasOk(), good);
+            }
+
+            struct Stopper  : public JSONReader::Handler
+            {
+                bool intValue (int64 v) override    { return v < 3; }
+            };
+
+            JSONReader reader ("[1, 2, 3, 4]", 12);
+            Stopper stopper;
+            expect (reader.parse (stopper).failed());
+
+            JSONReader sequence ("1 \"two\"\n[3]  ", 13);
+            Counter counter;
+
+            for (int i = 0; i < 3; ++i)
+                expect (! sequence.isFinished() && sequence.parse (counter).wasOk());
+
+            expect (sequence.isFinished());
+            expectEquals ((int) counter.numItems, 4);
+        }
+
+        beginTest ("Throughput");
+        {
+            MemoryOutputStream out;
+
+            {
+                JSONWriter writer (out);
+                writer.startArray();
+
+                for (int i = 0; i < 40000; ++i)
+                {
+                    writer.startObject();
+                    writer.writeName ("name");          writer.writeString ("Preset " + String (i));
+                    writer.writeName ("id");            writer.writeInt (r.nextInt64());
+                    writer.writeName ("enabled");       writer.writeBool (r.nextBool());
+                    writer.writeName ("description");   writer.writeString ("A \"quoted\" description of a preset\nwith a few lines of text, and some more text to pad it out a bit");
+                    writer.writeName ("values");
+                    writer.startArray();
+
+                    for (int j = 0; j < 10; ++j)
+                        writer.writeDouble (r.nextDouble());
+
+                    writer.endArray();
+                    writer.endObject();
+                }
+
+                writer.endArray();
+            }
+
+            auto text = out.toUTF8();
+            auto* utf8 = text.toRawUTF8();
+            auto numBytes = text.getNumBytesAsUTF8();
+
+            auto measure = [&] (const char* description, std::function<bool()> fn)
+            {
+                auto start = Time::getMillisecondCounterHiRes();
+                expect (fn());
+                auto seconds = (Time::getMillisecondCounterHiRes() - start) / 1000.0;
+
+                logMessage ("  " + String (description).paddedRight (' ', 28)
+                             + String ((double) numBytes / (1024.0 * 1024.0) / jmax (seconds, 0.000001), 1) + " MB/s");
+            };
+
+            logMessage ("  " + String ((double) numBytes / (1024.0 * 1024.0), 1) + " MB document:");
+
+            measure ("JSON::parse", [&] { return JSON::parse (text).size() == 40000; });
+            measure ("JSONReader (memory)", [&] { Counter c; JSONReader reader (utf8, numBytes); return reader.parse (c).wasOk() && c.numItems > 40000; });
+
+            measure ("JSONReader (stream)", [&]
+            {
+                Counter c;
+                MemoryInputStream in (utf8, numBytes, false);
+                JSONReader reader (in);
+                return reader.parse (c).wasOk() && c.numItems > 40000;
+            });
+
+            JSONDocument doc;
+            measure ("JSONDocument::parse", [&] { return doc.parse (utf8, numBytes).wasOk() && doc.getRoot().size() == 40000; });
+
+            auto parsed = JSON::parse (text);
+            measure ("JSON::writeToStream", [&] { MemoryOutputStream mo; JSON::writeToStream (mo, parsed); return mo.getDataSize() == numBytes; });
+
+            logMessage ("  JSONDocument memory use: " + String ((double) doc.getMemoryUsage() / (1024.0 * 1024.0), 1) + " MB");
+        }
+    }
+};
+
+static JSONStreamingTests jsonStreamingTests;
+
+#endif
+
+} // namespace juce
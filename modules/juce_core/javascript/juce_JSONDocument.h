@@ -0,0 +1,200 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A read-only, in-memory JSON document.
+
+    This is an alternative to parsing JSON into a tree of var objects, for when
+    you need random access to a large document. All the document's items and
+    strings are packed into a few big blocks of memory owned by the JSONDocument,
+    so it's much quicker to build and a fraction of the size of the equivalent
+    DynamicObject tree.
+
+    Items are accessed through lightweight Item handles, which only remain valid
+    while the document that they came from is alive and hasn't been re-parsed.
+
+    E.g.
+    @code
+    JSONDocument doc;
+
+    if (doc.parse (file).wasOk())
+        for (auto preset : doc.getRoot()["presets"])
+            DBG (preset["name"].getText());
+    @endcode
+
+    @see JSONReader, JSON
+
+    @tags{Core}
+*/
+class JUCE_API  JSONDocument
+{
+public:
+    //==============================================================================
+    /** Creates an empty document. */
+    JSONDocument();
+
+    /** Destructor. */
+    ~JSONDocument();
+
+    //==============================================================================
+    /** Replaces the contents of this document by parsing some UTF-8 JSON text. */
+    Result parse (const void* data, size_t numBytes);
+
+    /** Replaces the contents of this document by parsing some JSON text. */
+    Result parse (const String& text);
+
+    /** Replaces the contents of this document by parsing the text from a stream. */
+    Result parse (InputStream& input);
+
+    /** Replaces the contents of this document by parsing a file, which is memory-mapped
+        rather than loaded if possible.
+    */
+    Result parse (const File& file);
+
+    //==============================================================================
+    /** The different types of item that can appear in a document. */
+    enum class Type
+    {
+        null,
+        boolean,
+        integer,
+        floatingPoint,
+        string,
+        array,
+        object
+    };
+
+    /** @internal */
+    struct ItemData
+    {
+        const String::CharPointerType::CharType* name;
+        union
+        {
+            bool boolValue;
+            int64 intValue;
+            double doubleValue;
+            const String::CharPointerType::CharType* text;
+            const ItemData* children;
+        };
+        uint32 size;
+        Type type;
+    };
+
+    /**
+        A reference to one of the items in a JSONDocument.
+
+        An Item that doesn't refer to anything (e.g. one that's returned when you ask
+        for a non-existent property) behaves like a null.
+    */
+    class JUCE_API  Item
+    {
+    public:
+        /** Creates an Item that doesn't refer to anything. */
+        Item() noexcept {}
+
+        /** Returns true if this refers to an item in a document. */
+        bool isValid() const noexcept               { return item != nullptr; }
+
+        Type getType() const noexcept;
+
+        bool isNull() const noexcept                { return getType() == Type::null; }
+        bool isBool() const noexcept                { return getType() == Type::boolean; }
+        bool isInt() const noexcept                 { return getType() == Type::integer; }
+        bool isDouble() const noexcept              { return getType() == Type::floatingPoint; }
+        bool isString() const noexcept              { return getType() == Type::string; }
+        bool isArray() const noexcept               { return getType() == Type::array; }
+        bool isObject() const noexcept              { return getType() == Type::object; }
+
+        /** Returns the value of a boolean item, or false for other types. */
+        bool getBool() const noexcept;
+
+        /** Returns the value of a numeric item, or 0 for other types. */
+        int64 getInt64() const noexcept;
+
+        /** Returns the value of a numeric item, or 0 for other types. */
+        double getDouble() const noexcept;
+
+        /** Returns the text of a string item, or an empty string for other types.
+            The text belongs to the document, so this doesn't make a copy of it.
+        */
+        StringRef getText() const noexcept;
+
+        /** Returns the number of elements in an array, or members in an object. */
+        int size() const noexcept;
+
+        /** Returns one of the elements in an array (or the value of one of the members of an object). */
+        Item operator[] (int index) const noexcept;
+
+        /** Looks for a member of an object with the given name.
+            Note that this is a linear search through the object's members.
+        */
+        Item operator[] (StringRef propertyName) const noexcept;
+
+        /** If this is a member of an object, returns its name. */
+        StringRef getName() const noexcept;
+
+        /** Converts this item and everything inside it to a var, in the same way
+            that JSON::parse() would have done.
+        */
+        var toVar() const;
+
+        /** Iterates the elements of an array or the members of an object. */
+        struct Iterator
+        {
+            Item operator*() const noexcept                     { return Item (item); }
+            Iterator& operator++() noexcept                     { ++item; return *this; }
+            bool operator!= (const Iterator& other) const noexcept  { return item != other.item; }
+
+            const ItemData* item;
+        };
+
+        Iterator begin() const noexcept;
+        Iterator end() const noexcept;
+
+        /** @internal */
+        explicit Item (const ItemData* i) noexcept  : item (i) {}
+
+    private:
+        const ItemData* item = nullptr;
+    };
+
+    /** Returns the document's top-level item. */
+    Item getRoot() const noexcept                   { return Item (root); }
+
+    /** Returns the number of bytes of memory the document is using. */
+    size_t getMemoryUsage() const noexcept          { return arena.getTotalSize(); }
+
+private:
+    //==============================================================================
+    struct Builder;
+
+    ArenaAllocator arena;
+    const ItemData* root = nullptr;
+
+    JUCE_DECLARE_NON_COPYABLE (JSONDocument)
+};
+
+} // namespace juce
@@ -0,0 +1,463 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+JSONReader::JSONReader (const void* sourceData, size_t numBytes) noexcept
+    : SlidingInputBuffer (sourceData, numBytes)
+{
+}
+
+JSONReader::JSONReader (InputStream& source, size_t bufferSizeToUse)
+    : SlidingInputBuffer (source, bufferSizeToUse)
+{
+}
+
+JSONReader::~JSONReader() {}
+
+//==============================================================================
+bool JSONReader::skipWhitespace()
+{
+    for (;;)
+    {
+        while (position < numBytesAvailable)
+        {
+            auto c = data[position];
+
+            if (c != ' ' && (c < 9 || c > 13))
+                return true;
+
+            ++position;
+        }
+
+        if (! ensureAvailable (1))
+            return false;
+    }
+}
+
+bool JSONReader::isFinished()
+{
+    return ! skipWhitespace();
+}
+
+Result JSONReader::createFail (const char* message) const
+{
+    return Result::fail (String (message) + " (at byte " + String (getPosition()) + ")");
+}
+
+static Result checkJSONHandler (bool shouldContinue)
+{
+    return shouldContinue ? Result::ok() : Result::fail ("Parsing was stopped by the handler");
+}
+
+//==============================================================================
+Result JSONReader::parse (Handler& handler)
+{
+    openContainers.clearQuick();
+
+    for (;;)
+    {
+        if (! skipWhitespace())
+            return createFail ("Unexpected end-of-input");
+
+        bool isContainerStart = false;
+        auto r = readValue (handler, isContainerStart);
+
+        if (r.failed())
+            return r;
+
+        if (isContainerStart)
+        {
+            if (! skipWhitespace())
+                return createFail ("Unexpected end-of-input");
+
+            auto isObject = openContainers.getLast() == '{';
+
+            if (data[position] != (isObject ? '}' : ']'))
+            {
+                if (isObject)
+                {
+                    r = readPropertyName (handler);
+
+                    if (r.failed())
+                        return r;
+                }
+
+                continue;
+            }
+
+            ++position;
+            openContainers.removeLast();
+            r = checkJSONHandler (isObject ? handler.endObject() : handler.endArray());
+
+            if (r.failed())
+                return r;
+        }
+
+        // now look for whatever follows the value that was just read..
+        for (;;)
+        {
+            if (openContainers.isEmpty())
+                return Result::ok();
+
+            if (! skipWhitespace())
+                return createFail ("Unexpected end-of-input");
+
+            auto isObject = openContainers.getLast() == '{';
+            auto closeChar = isObject ? '}' : ']';
+            auto c = data[position];
+
+            if (c == ',')
+            {
+                ++position;
+
+                if (! skipWhitespace())
+                    return createFail ("Unexpected end-of-input");
+
+                // JSON::parse allows a trailing comma, so this does too
+                if (data[position] != closeChar)
+                {
+                    if (isObject)
+                    {
+                        r = readPropertyName (handler);
+
+                        if (r.failed())
+                            return r;
+                    }
+
+                    break;
+                }
+
+                c = closeChar;
+            }
+
+            if (c != closeChar)
+                return createFail (isObject ? "Expected ',' or '}'" : "Expected ',' or ']'");
+
+            ++position;
+            openContainers.removeLast();
+            r = checkJSONHandler (isObject ? handler.endObject() : handler.endArray());
+
+            if (r.failed())
+                return r;
+        }
+    }
+}
+
+Result JSONReader::readValue (Handler& handler, bool& isContainerStart)
+{
+    auto c = data[position];
+
+    switch (c)
+    {
+        case '{':
+        case '[':
+            ++position;
+            isContainerStart = true;
+            openContainers.add (c);
+            return checkJSONHandler (c == '{' ? handler.startObject() : handler.startArray());
+
+        case '"':
+        case '\'':
+            ++position;
+            return readString (handler, c, false);
+
+        case 't':
+        {
+            auto r = readLiteral ("true", 4);
+            return r.failed() ? r : checkJSONHandler (handler.boolValue (true));
+        }
+
+        case 'f':
+        {
+            auto r = readLiteral ("false", 5);
+            return r.failed() ? r : checkJSONHandler (handler.boolValue (false));
+        }
+
+        case 'n':
+        {
+            auto r = readLiteral ("null", 4);
+            return r.failed() ? r : checkJSONHandler (handler.nullValue());
+        }
+
+        default:
+            if (c == '-' || (c >= '0' && c <= '9'))
+                return readNumber (handler);
+
+            break;
+    }
+
+    return createFail ("Syntax error");
+}
+
+Result JSONReader::readLiteral (const char* literal, size_t length)
+{
+    if (! ensureAvailable (length) || memcmp (data + position, literal, length) != 0)
+        return createFail ("Syntax error");
+
+    position += length;
+    return Result::ok();
+}
+
+Result JSONReader::readPropertyName (Handler& handler)
+{
+    if (data[position] != '"')
+        return createFail ("Expected object member declaration");
+
+    ++position;
+    auto r = readString (handler, '"', true);
+
+    if (r.failed())
+        return r;
+
+    if (! skipWhitespace() || data[position] != ':')
+        return createFail ("Expected ':'");
+
+    ++position;
+    return Result::ok();
+}
+
+//==============================================================================
+static Result reportJSONString (JSONReader::Handler& handler, bool isPropertyName, const char* start, const char* end)
+{
+    return checkJSONHandler (isPropertyName ? handler.propertyName (CharPointer_UTF8 (start), CharPointer_UTF8 (end))
+                                            : handler.stringValue  (CharPointer_UTF8 (start), CharPointer_UTF8 (end)));
+}
+
+// Returns the number of bytes before the next quote or backslash, or numBytes if there isn't one
+static size_t findEndOfPlainJSONString (const char* text, size_t numBytes, char quoteChar) noexcept
+{
+    if (auto* quote = memchr (text, quoteChar, numBytes))
+        numBytes = (size_t) (static_cast<const char*> (quote) - text);
+
+    if (auto* backslash = memchr (text, '\\', numBytes))
+        return (size_t) (static_cast<const char*> (backslash) - text);
+
+    return numBytes;
+}
+
+Result JSONReader::readString (Handler& handler, char quoteChar, bool isPropertyName)
+{
+    for (size_t numBytes = 0;;)
+    {
+        auto* start = data + position;
+        auto numAvailable = numBytesAvailable - position;
+        numBytes += findEndOfPlainJSONString (start + numBytes, numAvailable - numBytes, quoteChar);
+
+        if (numBytes < numAvailable)
+        {
+            if (start[numBytes] == '\\')
+                return readEscapedString (handler, quoteChar, isPropertyName, numBytes);
+
+            // No escapes, so the handler can be given the text straight out of the input
+            position += numBytes + 1;
+            return reportJSONString (handler, isPropertyName, start, start + numBytes);
+        }
+
+        if (! ensureAvailable (numBytes + 1))
+            return createFail ("Unexpected end-of-input in string constant");
+    }
+}
+
+Result JSONReader::readEscapedString (Handler& handler, char quoteChar, bool isPropertyName, size_t numPlainBytes)
+{
+    unescapedString.reset();
+    unescapedString.write (data + position, numPlainBytes);
+    position += numPlainBytes;
+
+    auto readHexCharacter = [this] (juce_wchar& result)
+    {
+        if (! ensureAvailable (4))
+            return false;
+
+        result = 0;
+
+        for (int i = 0; i < 4; ++i)
+        {
+            auto digitValue = CharacterFunctions::getHexDigitValue ((juce_wchar) (uint8) data[position++]);
+
+            if (digitValue < 0)
+                return false;
+
+            result = (result << 4) + (juce_wchar) digitValue;
+        }
+
+        return true;
+    };
+
+    for (;;)
+    {
+        if (! ensureAvailable (1))
+            return createFail ("Unexpected end-of-input in string constant");
+
+        auto numPlain = findEndOfPlainJSONString (data + position, numBytesAvailable - position, quoteChar);
+        unescapedString.write (data + position, numPlain);
+        position += numPlain;
+
+        if (position == numBytesAvailable)
+            continue;
+
+        if (data[position++] == quoteChar)
+            return reportJSONString (handler, isPropertyName,
+                                     static_cast<const char*> (unescapedString.getData()),
+                                     static_cast<const char*> (unescapedString.getData()) + unescapedString.getDataSize());
+
+        if (! ensureAvailable (1))
+            return createFail ("Unexpected end-of-input in string constant");
+
+        auto c = (juce_wchar) (uint8) data[position++];
+
+        switch (c)
+        {
+            case 'a':  c = '\a'; break;
+            case 'b':  c = '\b'; break;
+            case 'f':  c = '\f'; break;
+            case 'n':  c = '\n'; break;
+            case 'r':  c = '\r'; break;
+            case 't':  c = '\t'; break;
+
+            case 'u':
+            {
+                if (! readHexCharacter (c))
+                    return createFail ("Syntax error in unicode escape sequence");
+
+                // join up a UTF-16 surrogate pair if there is one
+                if (c >= 0xd800 && c < 0xdc00 && ensureAvailable (6)
+                     && data[position] == '\\' && data[position + 1] == 'u')
+                {
+                    auto oldPosition = position;
+                    position += 2;
+                    juce_wchar low;
+
+                    if (readHexCharacter (low) && low >= 0xdc00 && low < 0xe000)
+                        c = 0x10000 + ((c - 0xd800) << 10) + (low - 0xdc00);
+                    else
+                        position = oldPosition;
+                }
+
+                break;
+            }
+
+            default:
+                // any other escaped character (e.g. a quote or slash) just stands for itself
+                if (c >= 0x80)
+                {
+                    unescapedString.writeByte ((char) c);
+                    continue;
+                }
+
+                break;
+        }
+
+        unescapedString.appendUTF8Char (c);
+    }
+}
+
+//==============================================================================
+Result JSONReader::readNumber (Handler& handler)
+{
+    auto isNumberChar = [] (char c) { return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E'; };
+
+    size_t numBytes = 0;
+
+    for (;;)
+    {
+        auto numAvailable = numBytesAvailable - position;
+
+        while (numBytes < numAvailable && isNumberChar (data[position + numBytes]))
+            ++numBytes;
+
+        if (numBytes < numAvailable || ! ensureAvailable (numBytes + 1))
+            break;
+    }
+
+    unescapedString.reset();
+    unescapedString.write (data + position, numBytes);
+    unescapedString.writeByte (0);
+
+    auto* text = static_cast<const char*> (unescapedString.getData());
+    auto* p = text;
+    auto isNegative = (*p == '-');
+    auto isDigit = [] (char c) { return c >= '0' && c <= '9'; };
+
+    if (isNegative)
+        ++p;
+
+    if (! isDigit (*p))
+        return createFail ("Syntax error in number");
+
+    uint64 magnitude = 0;
+    bool isInteger = true;
+
+    for (; isDigit (*p); ++p)
+    {
+        if (magnitude > (std::numeric_limits<uint64>::max() - 9) / 10)
+            isInteger = false;
+
+        magnitude = magnitude * 10 + (uint64) (*p - '0');
+    }
+
+    if (*p == '.')
+    {
+        isInteger = false;
+
+        if (! isDigit (*++p))
+            return createFail ("Syntax error in number");
+
+        while (isDigit (*p))
+            ++p;
+    }
+
+    if (*p == 'e' || *p == 'E')
+    {
+        isInteger = false;
+        ++p;
+
+        if (*p == '+' || *p == '-')
+            ++p;
+
+        if (! isDigit (*p))
+            return createFail ("Syntax error in number");
+
+        while (isDigit (*p))
+            ++p;
+    }
+
+    if (*p != 0)
+        return createFail ("Syntax error in number");
+
+    position += numBytes;
+
+    const auto maxMagnitude = (uint64) std::numeric_limits<int64>::max();
+
+    if (isInteger && magnitude <= maxMagnitude)
+        return checkJSONHandler (handler.intValue (isNegative ? -(int64) magnitude : (int64) magnitude));
+
+    if (isInteger && isNegative && magnitude == maxMagnitude + 1)
+        return checkJSONHandler (handler.intValue (std::numeric_limits<int64>::min()));
+
+    CharPointer_ASCII t (text);
+    return checkJSONHandler (handler.doubleValue (CharacterFunctions::readDoubleValue (t)));
+}
+
+} // namespace juce
@@ -0,0 +1,165 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    An event-driven JSON parser, which reports the structure of a document to a
+    Handler object as it reads it, rather than building a tree of var objects.
+
+    The reader can either work on a block of memory (e.g. a String, a MemoryBlock or
+    the contents of a MemoryMappedFile), or pull its data from an InputStream through
+    a fixed-size buffer, so a document of any size can be processed in a constant
+    amount of memory.
+
+    Strings are passed to the handler as a pair of pointers into the input data
+    wherever possible, and only need copying if they contain escape sequences, so
+    nothing gets allocated for each item that's parsed.
+
+    E.g.
+    @code
+    struct NameCounter  : public JSONReader::Handler
+    {
+        bool propertyName (CharPointer_UTF8 start, CharPointer_UTF8 end) override
+        {
+            if (String (start, end) == "name")
+                ++numNames;
+
+            return true;
+        }
+
+        int numNames = 0;
+    };
+
+    MemoryMappedFile mappedFile (file, MemoryMappedFile::readOnly);
+    JSONReader reader (mappedFile.getData(), mappedFile.getSize());
+    NameCounter counter;
+    auto result = reader.parse (counter);
+    @endcode
+
+    @see JSON, JSONDocument, JSONWriter
+
+    @tags{Core}
+*/
+class JUCE_API  JSONReader  : private SlidingInputBuffer
+{
+public:
+    //==============================================================================
+    /** Creates a reader for a block of UTF-8 JSON text.
+        The data must remain valid for as long as the reader is in use.
+    */
+    JSONReader (const void* data, size_t numBytes) noexcept;
+
+    /** Creates a reader which pulls its UTF-8 JSON text from a stream.
+
+        The stream is read in chunks of the given size, which will only be increased
+        if a single string or number in the document turns out to be longer than that.
+        The stream must remain valid for as long as the reader is in use.
+    */
+    JSONReader (InputStream& source, size_t bufferSize = 65536);
+
+    /** Destructor. */
+    ~JSONReader();
+
+    //==============================================================================
+    /**
+        Receives the items that a JSONReader finds.
+
+        Each callback returns true to carry on parsing, or false to stop the reader
+        (which will then return a failed Result from parse()).
+
+        The text passed to propertyName() and stringValue() is UTF-8, and only remains
+        valid until the callback returns.
+    */
+    class JUCE_API  Handler
+    {
+    public:
+        /** Destructor. */
+        virtual ~Handler() = default;
+
+        /** Called when a '{' is found. */
+        virtual bool startObject()                                                  { return true; }
+
+        /** Called when the object that was most recently started comes to an end. */
+        virtual bool endObject()                                                    { return true; }
+
+        /** Called when a '[' is found. */
+        virtual bool startArray()                                                   { return true; }
+
+        /** Called when the array that was most recently started comes to an end. */
+        virtual bool endArray()                                                     { return true; }
+
+        /** Called with the name of an object member, before its value is reported. */
+        virtual bool propertyName (CharPointer_UTF8 start, CharPointer_UTF8 end)    { ignoreUnused (start, end); return true; }
+
+        /** Called for a string value. */
+        virtual bool stringValue (CharPointer_UTF8 start, CharPointer_UTF8 end)     { ignoreUnused (start, end); return true; }
+
+        /** Called for a number that has no fractional part or exponent, and fits into 64 bits. */
+        virtual bool intValue (int64)                                               { return true; }
+
+        /** Called for any other number. */
+        virtual bool doubleValue (double)                                           { return true; }
+
+        /** Called for 'true' or 'false'. */
+        virtual bool boolValue (bool)                                               { return true; }
+
+        /** Called for 'null'. */
+        virtual bool nullValue()                                                    { return true; }
+    };
+
+    //==============================================================================
+    /** Reads the next value from the input, passing everything it contains to the handler.
+
+        The value can be of any type, so this will also accept a document that's just a
+        single string or number. If the input holds a sequence of values (e.g. a file
+        with one JSON object on each line), you can call this repeatedly until
+        isFinished() returns true.
+    */
+    Result parse (Handler& handler);
+
+    /** Returns true if there's nothing but whitespace left in the input. */
+    bool isFinished();
+
+    /** Returns the number of bytes of input that have been consumed so far. */
+    int64 getPosition() const noexcept          { return bytesBeforeBuffer + (int64) position; }
+
+private:
+    //==============================================================================
+    MemoryOutputStream unescapedString;
+    Array<char> openContainers;
+
+    bool skipWhitespace();
+    Result readValue (Handler&, bool& isContainerStart);
+    Result readString (Handler&, char quoteChar, bool isPropertyName);
+    Result readEscapedString (Handler&, char quoteChar, bool isPropertyName, size_t numPlainBytes);
+    Result readNumber (Handler&);
+    Result readLiteral (const char* literal, size_t length);
+    Result readPropertyName (Handler&);
+    Result createFail (const char* message) const;
+
+    JUCE_DECLARE_NON_COPYABLE (JSONReader)
+};
+
+} // namespace juce
@@ -0,0 +1,184 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+JSONWriter::JSONWriter (OutputStream& destination, bool allOnOneLine, int maximumDecimalPlaces)
+    : out (destination), oneLine (allOnOneLine), decimalPlaces (maximumDecimalPlaces)
+{
+}
+
+JSONWriter::~JSONWriter()
+{
+    // If you hit this, you've not closed all the objects or arrays that you started
+    jassert (levels.isEmpty());
+}
+
+//==============================================================================
+void JSONWriter::writeNewLineAndIndent (int indent)
+{
+    out << newLine;
+    JSONFormatter::writeSpaces (out, indent);
+}
+
+void JSONWriter::startValue()
+{
+    if (levels.isEmpty())
+        return;
+
+    auto& level = levels.getReference (levels.size() - 1);
+
+    if (level.isObject)
+    {
+        // Each value in an object must be preceded by a call to writeName()
+        jassert (hasName);
+        hasName = false;
+        return;
+    }
+
+    if (level.numItems++ > 0)
+    {
+        if (oneLine)
+            out << ", ";
+        else
+            out << ',';
+    }
+
+    if (! oneLine)
+        writeNewLineAndIndent (levels.size() * JSONFormatter::indentSize);
+}
+
+void JSONWriter::writeName (StringRef name)
+{
+    // Names can only be written inside an object, and each one must be followed by a value
+    jassert (levels.size() > 0 && levels.getLast().isObject && ! hasName);
+
+    auto& level = levels.getReference (levels.size() - 1);
+
+    if (level.numItems++ > 0)
+    {
+        if (oneLine)
+            out << ", ";
+        else
+            out << ',' << newLine;
+    }
+
+    if (! oneLine)
+        JSONFormatter::writeSpaces (out, levels.size() * JSONFormatter::indentSize);
+
+    out << '"';
+    JSONFormatter::writeString (out, name.text);
+    out << "\": ";
+    hasName = true;
+}
+
+//==============================================================================
+void JSONWriter::startObject()
+{
+    startValue();
+    out << '{';
+
+    if (! oneLine)
+        out << newLine;
+
+    levels.add ({ true, 0 });
+}
+
+void JSONWriter::endObject()
+{
+    // This doesn't match up with a call to startObject()
+    jassert (levels.size() > 0 && levels.getLast().isObject && ! hasName);
+
+    auto numItems = levels.removeAndReturn (levels.size() - 1).numItems;
+
+    if (! oneLine)
+    {
+        if (numItems > 0)
+            out << newLine;
+
+        JSONFormatter::writeSpaces (out, levels.size() * JSONFormatter::indentSize);
+    }
+
+    out << '}';
+}
+
+void JSONWriter::startArray()
+{
+    startValue();
+    out << '[';
+    levels.add ({ false, 0 });
+}
+
+void JSONWriter::endArray()
+{
+    // This doesn't match up with a call to startArray()
+    jassert (levels.size() > 0 && ! levels.getLast().isObject);
+
+    auto numItems = levels.removeAndReturn (levels.size() - 1).numItems;
+
+    if (numItems > 0 && ! oneLine)
+        writeNewLineAndIndent (levels.size() * JSONFormatter::indentSize);
+
+    out << ']';
+}
+
+//==============================================================================
+void JSONWriter::writeString (StringRef text)
+{
+    startValue();
+    out << '"';
+    JSONFormatter::writeString (out, text.text);
+    out << '"';
+}
+
+void JSONWriter::writeInt (int64 value)
+{
+    startValue();
+    out << String (value);
+}
+
+void JSONWriter::writeDouble (double value)
+{
+    startValue();
+    out << String (value, decimalPlaces);
+}
+
+void JSONWriter::writeBool (bool value)
+{
+    startValue();
+    out << (value ? "true" : "false");
+}
+
+void JSONWriter::writeNull()
+{
+    startValue();
+    out << "null";
+}
+
+void JSONWriter::writeVar (const var& value)
+{
+    startValue();
+    JSONFormatter::write (out, value, levels.size() * JSONFormatter::indentSize, oneLine, decimalPlaces);
+}
+
+} // namespace juce
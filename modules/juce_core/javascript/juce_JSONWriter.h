@@ -0,0 +1,127 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Writes JSON directly to an OutputStream, one item at a time.
+
+    Unlike JSON::writeToStream(), this doesn't need the whole document to be built
+    as a var first, so it can be used to write out very large documents. The text
+    is laid out in exactly the same way as JSON::toString() would do it.
+
+    E.g.
+    @code
+    JSONWriter writer (stream);
+    writer.startObject();
+    writer.writeName ("name");
+    writer.writeString ("foo");
+    writer.writeName ("values");
+    writer.startArray();
+
+    for (auto v : values)
+        writer.writeDouble (v);
+
+    writer.endArray();
+    writer.endObject();
+    @endcode
+
+    @see JSON, JSONReader
+
+    @tags{Core}
+*/
+class JUCE_API  JSONWriter
+{
+public:
+    //==============================================================================
+    /** Creates a writer for the given stream, which must stay valid for the lifetime
+        of this object. The other parameters have the same meaning as they do for
+        JSON::writeToStream().
+    */
+    JSONWriter (OutputStream& destination,
+                bool allOnOneLine = false,
+                int maximumDecimalPlaces = 20);
+
+    /** Destructor. */
+    ~JSONWriter();
+
+    //==============================================================================
+    /** Begins an object, which must be followed by pairs of calls to writeName() and
+        one of the value-writing methods, and then a call to endObject().
+    */
+    void startObject();
+
+    /** Finishes the object that was most recently started. */
+    void endObject();
+
+    /** Begins an array, which must be followed by any number of values, and then a
+        call to endArray().
+    */
+    void startArray();
+
+    /** Finishes the array that was most recently started. */
+    void endArray();
+
+    /** Writes the name of the next member of an object. */
+    void writeName (StringRef name);
+
+    //==============================================================================
+    /** Writes a string value. */
+    void writeString (StringRef text);
+
+    /** Writes an integer value. */
+    void writeInt (int64 value);
+
+    /** Writes a floating-point value. */
+    void writeDouble (double value);
+
+    /** Writes 'true' or 'false'. */
+    void writeBool (bool value);
+
+    /** Writes 'null'. */
+    void writeNull();
+
+    /** Writes a var, which may be an entire tree of arrays and objects. */
+    void writeVar (const var& value);
+
+private:
+    //==============================================================================
+    struct Level
+    {
+        bool isObject;
+        int numItems;
+    };
+
+    OutputStream& out;
+    Array<Level> levels;
+    bool oneLine, hasName = false;
+    int decimalPlaces;
+
+    void startValue();
+    void writeNewLineAndIndent (int indent);
+
+    JUCE_DECLARE_NON_COPYABLE (JSONWriter)
+};
+
+} // namespace juce
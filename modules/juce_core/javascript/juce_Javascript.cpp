@@ -74,6 +74,9 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     }
 
     Time timeout;
+    int numTimeOutChecksToSkip = 0;
+    int64 numInstructionsRemaining = 0;
+    int callDepthRemaining = 0;
 
     using Args = const var::NativeFunctionArgs&;
     using TokenType = const char*;
@@ -81,13 +84,13 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     void execute (const String& code)
     {
         ExpressionTreeBuilder tb (code);
-        std::unique_ptr<BlockStatement> (tb.parseStatementList())->perform (Scope (nullptr, this, this), nullptr);
+        CompiledCode (tb.parseStatementList(), false).run (Scope (nullptr, this, this));
     }
 
     var evaluate (const String& code)
     {
         ExpressionTreeBuilder tb (code);
-        return ExpPtr (tb.parseExpression())->getResult (Scope (nullptr, this, this));
+        return CompiledCode (tb.parseExpression()).run (Scope (nullptr, this, this));
     }
 
     //==============================================================================
@@ -109,7 +112,12 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     struct CodeLocation
     {
         CodeLocation (const String& code) noexcept        : program (code), location (program.getCharPointer()) {}
-        CodeLocation (const CodeLocation& other) noexcept : program (other.program), location (other.location) {}
+        CodeLocation (const CodeLocation& other) noexcept
+            : program (other.program),
+              location (addBytesToPointer (program.getCharPointer().getAddress(),
+                                           (int) (other.location.getAddress() - other.program.getCharPointer().getAddress())))
+        {
+        }
 
         void throwError (const String& message) const
         {
@@ -235,19 +243,728 @@ struct JavascriptEngine::RootObject   : public DynamicObject
 
         void checkTimeOut (const CodeLocation& location) const
         {
+            // reading the clock is relatively slow, so it's only done every few calls
+            if (--root->numTimeOutChecksToSkip >= 0)
+                return;
+
+            root->numTimeOutChecksToSkip = 255;
+
             if (Time::getCurrentTime() > root->timeout)
                 location.throwError (root->timeout == Time() ? "Interrupted" : "Execution timed-out");
         }
     };
 
+    //==============================================================================
+    /*  Rather than walking the tree of statements and expressions that the parser
+        produces, the tree is compiled into a flat list of instructions which are run by
+        a simple stack-based virtual machine.
+
+        Each instruction keeps a pointer to the node that it was generated from, which
+        supplies its operands and the location to use in error messages, so the tree is
+        kept alive alongside the compiled code.
+    */
+    enum class OpCode  : uint8
+    {
+        pushUndefined, pushLiteral, pushScope, pop, dup,
+        getName, setName, declareVar,
+        getProperty, getLength, setProperty, getElement, setElement,
+        binaryOp, typeEquals, typeNotEquals, toBool,
+        jump, jumpIfFalse, logicalAnd, logicalOr,
+        findMethod, call, beginNew, callNew,
+        makeObject, makeArray,
+        checkTimeOut, returnValue, exit, cannotAssign
+    };
+
+    //==============================================================================
+    /*  A value on the virtual machine's stack. Numbers and bools are held unboxed, so
+        that arithmetic on them doesn't have to go through var's virtual methods, and
+        they only get turned back into vars when they're stored or passed to a function.
+    */
+    struct StackValue
+    {
+        enum class Type  : uint8 { integer32, integer64, floatingPoint, boolean, variant };
+
+        StackValue (int v) noexcept      : type (Type::integer32)      { intValue = v; }
+        StackValue (int64 v) noexcept    : type (Type::integer64)      { int64Value = v; }
+        StackValue (double v) noexcept   : type (Type::floatingPoint)  { doubleValue = v; }
+        StackValue (bool v) noexcept     : type (Type::boolean)        { boolValue = v; }
+        StackValue (const var& v)        : type (Type::variant)        { new (&variant) var (v); }
+        StackValue (var&& v) noexcept    : type (Type::variant)        { new (&variant) var (std::move (v)); }
+
+        StackValue (const StackValue& other)  : type (other.type)
+        {
+            if (type == Type::variant)
+                new (&variant) var (other.variant);
+            else
+                copyNumber (other);
+        }
+
+        StackValue (StackValue&& other) noexcept  : type (other.type)
+        {
+            if (type == Type::variant)
+                new (&variant) var (std::move (other.variant));
+            else
+                copyNumber (other);
+        }
+
+        StackValue& operator= (StackValue&& other) noexcept
+        {
+            if (type == Type::variant)
+                variant.~var();
+
+            type = other.type;
+
+            if (type == Type::variant)
+                new (&variant) var (std::move (other.variant));
+            else
+                copyNumber (other);
+
+            return *this;
+        }
+
+        ~StackValue()
+        {
+            if (type == Type::variant)
+                variant.~var();
+        }
+
+        // Makes a StackValue from a var, checking first for the type that was found at this place last time
+        static StackValue fromVar (const var& v, Type& typeHint)
+        {
+            switch (typeHint)
+            {
+                case Type::integer32:       if (v.isInt())    return static_cast<int> (v);    break;
+                case Type::integer64:       if (v.isInt64())  return static_cast<int64> (v);  break;
+                case Type::floatingPoint:   if (v.isDouble()) return static_cast<double> (v); break;
+                case Type::boolean:         if (v.isBool())   return static_cast<bool> (v);   break;
+                case Type::variant:
+                default:                    return v;
+            }
+
+            StackValue result (v);
+            result.unbox();
+            typeHint = result.type;
+            return result;
+        }
+
+        // If this is a var which holds a number, this converts it to an unboxed one
+        void unbox()
+        {
+            if (type == Type::variant)
+            {
+                if (variant.isInt64())        *this = static_cast<int64> (variant);
+                else if (variant.isInt())     *this = static_cast<int> (variant);
+                else if (variant.isDouble())  *this = static_cast<double> (variant);
+                else if (variant.isBool())    *this = static_cast<bool> (variant);
+            }
+        }
+
+        bool isNumber() const noexcept        { return type != Type::variant; }
+        bool isDouble() const noexcept        { return type == Type::floatingPoint; }
+        bool isIndex() const noexcept         { return type == Type::integer32 || type == Type::integer64 || type == Type::floatingPoint; }
+
+        int64 toInt64() const noexcept
+        {
+            switch (type)
+            {
+                case Type::integer32:       return intValue;
+                case Type::integer64:       return int64Value;
+                case Type::floatingPoint:   return (int64) doubleValue;
+                case Type::boolean:         return boolValue ? 1 : 0;
+                case Type::variant:
+                default:                    return static_cast<int64> (variant);
+            }
+        }
+
+        int toInt() const noexcept
+        {
+            switch (type)
+            {
+                case Type::integer32:       return intValue;
+                case Type::integer64:       return (int) int64Value;
+                case Type::floatingPoint:   return (int) doubleValue;
+                case Type::boolean:         return boolValue ? 1 : 0;
+                case Type::variant:
+                default:                    return static_cast<int> (variant);
+            }
+        }
+
+        double toDouble() const noexcept
+        {
+            switch (type)
+            {
+                case Type::integer32:       return intValue;
+                case Type::integer64:       return (double) int64Value;
+                case Type::floatingPoint:   return doubleValue;
+                case Type::boolean:         return boolValue ? 1.0 : 0.0;
+                case Type::variant:
+                default:                    return static_cast<double> (variant);
+            }
+        }
+
+        bool toBool() const noexcept
+        {
+            switch (type)
+            {
+                case Type::integer32:       return intValue != 0;
+                case Type::integer64:       return int64Value != 0;
+                case Type::floatingPoint:   return doubleValue != 0;
+                case Type::boolean:         return boolValue;
+                case Type::variant:
+                default:                    return static_cast<bool> (variant);
+            }
+        }
+
+        var toVar() const
+        {
+            switch (type)
+            {
+                case Type::integer32:       return intValue;
+                case Type::integer64:       return int64Value;
+                case Type::floatingPoint:   return doubleValue;
+                case Type::boolean:         return boolValue;
+                case Type::variant:
+                default:                    return variant;
+            }
+        }
+
+        // Like toVar(), but if this holds a var, it gets moved rather than copied
+        var moveToVar()
+        {
+            return type == Type::variant ? std::move (variant) : toVar();
+        }
+
+        // Returns the var that this holds, or a null var if it's a number
+        const var& getVariant() const noexcept
+        {
+            static const var none;
+            return type == Type::variant ? variant : none;
+        }
+
+        Type type;
+
+        union
+        {
+            int intValue;
+            int64 int64Value;
+            double doubleValue;
+            bool boolValue;
+            var variant;
+        };
+
+    private:
+        void copyNumber (const StackValue& other) noexcept
+        {
+            switch (type)
+            {
+                case Type::integer32:       intValue = other.intValue; break;
+                case Type::integer64:       int64Value = other.int64Value; break;
+                case Type::floatingPoint:   doubleValue = other.doubleValue; break;
+                case Type::boolean:         boolValue = other.boolValue; break;
+                case Type::variant:
+                default:                    jassertfalse; break;
+            }
+        }
+    };
+
+    //==============================================================================
+    struct Statement;
+    struct Expression;
+
+    struct Instruction
+    {
+        OpCode opcode;
+        mutable StackValue::Type typeHint;   // the type of value that this instruction loaded last time
+        int argument;                   // a jump destination, or a number of stack items
+        mutable int cache, rootCache;   // the last-known indexes of the property that this instruction looks up
+        const Statement* node;
+    };
+
+    // Looks up a property, first trying the position at which it was found last time
+    static var* findPropertyWithCache (DynamicObject& o, const Identifier& name, int& cache) noexcept
+    {
+        auto& props = o.getProperties();
+
+        if (auto* v = props.getVarPointerAt (cache))
+            if (props.begin()[cache].name == name)
+                return v;
+
+        cache = props.indexOf (name);
+        return props.getVarPointerAt (cache);
+    }
+
+    //==============================================================================
+    // A stack of objects, which only allocates if it won't fit in a local buffer
+    template <typename ElementType>
+    struct LocalStack
+    {
+        LocalStack (int maxSize)
+        {
+            auto* slots = localSlots;
+
+            if (maxSize > numLocalSlots)
+            {
+                heapSlots.malloc ((size_t) maxSize);
+                slots = heapSlots.getData();
+            }
+
+            top = base = reinterpret_cast<ElementType*> (slots);
+        }
+
+        ~LocalStack()
+        {
+            while (top > base)
+                drop();
+        }
+
+        template <typename... Args>
+        void push (Args&&... args)      { new (top) ElementType (std::forward<Args> (args)...); ++top; }
+
+        void drop() noexcept            { (--top)->~ElementType(); }
+        void drop (int num) noexcept    { while (--num >= 0) drop(); }
+
+        ElementType pop()
+        {
+            ElementType e (std::move (top[-1]));
+            drop();
+            return e;
+        }
+
+        using Slot = typename std::aligned_storage<sizeof (ElementType), alignof (ElementType)>::type;
+        enum { numLocalSlots = 16 };
+
+        Slot localSlots[numLocalSlots];
+        HeapBlock<Slot> heapSlots;
+        ElementType* base;
+        ElementType* top;
+
+        JUCE_DECLARE_NON_COPYABLE (LocalStack)
+    };
+
+    //==============================================================================
+    struct CodeGenerator
+    {
+        CodeGenerator (Array<Instruction>& destination, bool canReturn) noexcept
+            : code (destination), canReturnValues (canReturn) {}
+
+        int emit (OpCode opcode, const Statement* node, int argument = 0)
+        {
+            code.add (Instruction { opcode, StackValue::Type::integer64, argument, -1, -1, node });
+            stackSize += getStackSizeChange (opcode, argument);
+            maxStackSize = jmax (maxStackSize, stackSize);
+            jassert (stackSize >= 0);
+            return code.size() - 1;
+        }
+
+        int getPosition() const noexcept                { return code.size(); }
+        void setJumpDestination (int jump) noexcept     { code.getReference (jump).argument = code.size(); }
+
+        // The places that break, continue and return statements need to jump to
+        struct JumpTargets
+        {
+            JumpTargets (CodeGenerator& g, bool ignoresReturnStatements)
+                : owner (g), ignoresReturns (ignoresReturnStatements)
+            {
+                owner.targets.add (this);
+            }
+
+            ~JumpTargets()
+            {
+                owner.targets.removeLast();
+            }
+
+            void resolveBreaks()        { for (auto j : breaks)     owner.setJumpDestination (j); }
+            void resolveContinues()     { for (auto j : continues)  owner.setJumpDestination (j); }
+
+            CodeGenerator& owner;
+            Array<int> breaks, continues;
+            const bool ignoresReturns;
+        };
+
+        void emitBreak (const Statement* node)
+        {
+            if (auto* t = targets.getLast())
+                t->breaks.add (emit (OpCode::jump, node));
+            else
+                emit (OpCode::exit, node);
+        }
+
+        void emitContinue (const Statement* node)
+        {
+            if (auto* t = targets.getLast())
+                t->continues.add (emit (OpCode::jump, node));
+            else
+                emit (OpCode::exit, node);
+        }
+
+        // Returns false if a return statement here would skip its value without evaluating it
+        bool canReturnValue (const Statement* node)
+        {
+            for (int i = targets.size(); --i >= 0;)
+            {
+                if (targets.getUnchecked (i)->ignoresReturns)
+                {
+                    targets.getUnchecked (i)->breaks.add (emit (OpCode::jump, node));
+                    return false;
+                }
+            }
+
+            if (canReturnValues)
+                return true;
+
+            emit (OpCode::exit, node);
+            return false;
+        }
+
+        static int getStackSizeChange (OpCode opcode, int argument) noexcept
+        {
+            switch (opcode)
+            {
+                case OpCode::pushUndefined:
+                case OpCode::pushLiteral:
+                case OpCode::pushScope:
+                case OpCode::dup:
+                case OpCode::getName:
+                case OpCode::findMethod:
+                case OpCode::beginNew:      return 1;
+
+                case OpCode::pop:
+                case OpCode::setName:
+                case OpCode::declareVar:
+                case OpCode::getElement:
+                case OpCode::binaryOp:
+                case OpCode::typeEquals:
+                case OpCode::typeNotEquals:
+                case OpCode::jumpIfFalse:
+                case OpCode::logicalAnd:
+                case OpCode::logicalOr:
+                case OpCode::returnValue:
+                case OpCode::cannotAssign:  return -1;
+
+                case OpCode::setProperty:   return -2;
+                case OpCode::setElement:    return -3;
+
+                case OpCode::call:
+                case OpCode::callNew:       return -(argument + 1);
+
+                case OpCode::makeObject:
+                case OpCode::makeArray:     return 1 - argument;
+
+                case OpCode::getProperty:
+                case OpCode::getLength:
+                case OpCode::toBool:
+                case OpCode::jump:
+                case OpCode::checkTimeOut:
+                case OpCode::exit:
+                default:                    return 0;
+            }
+        }
+
+        Array<Instruction>& code;
+        Array<JumpTargets*> targets;
+        int stackSize = 0, maxStackSize = 0;
+        const bool canReturnValues;
+    };
+
+    //==============================================================================
+    struct CompiledCode
+    {
+        CompiledCode (Statement* statements, bool isFunctionBody)  : tree (statements)
+        {
+            CodeGenerator g (instructions, isFunctionBody);
+            tree->compile (g);
+            g.emit (OpCode::exit, tree.get());
+            maxStackSize = g.maxStackSize;
+        }
+
+        CompiledCode (Expression* expression)  : tree (expression)
+        {
+            CodeGenerator g (instructions, true);
+            expression->compileValue (g);
+            g.emit (OpCode::returnValue, tree.get());
+            maxStackSize = g.maxStackSize;
+        }
+
+        var run (const Scope& s) const
+        {
+            LocalStack<StackValue> stack (maxStackSize);
+            auto& numInstructionsRemaining = s.root->numInstructionsRemaining;
+            auto* code = instructions.begin();
+            auto* ip = code;
+
+            for (;;)
+            {
+                auto& i = *ip++;
+
+                if (--numInstructionsRemaining < 0)
+                    i.node->location.throwError ("Execution exceeded the instruction limit");
+
+                switch (i.opcode)
+                {
+                    case OpCode::pushUndefined:  stack.push (var::undefined()); break;
+                    case OpCode::pushLiteral:    stack.push (static_cast<const LiteralValue*> (i.node)->value); break;
+                    case OpCode::pushScope:      stack.push (var (s.scope.get())); break;
+                    case OpCode::pop:            stack.drop(); break;
+                    case OpCode::dup:            stack.push (stack.top[-1]); break;
+
+                    case OpCode::getName:
+                    {
+                        if (auto* v = findSymbol (s, static_cast<const UnqualifiedName*> (i.node)->name, i))
+                            stack.push (StackValue::fromVar (*v, i.typeHint));
+                        else
+                            stack.push (var::undefined());
+
+                        break;
+                    }
+
+                    case OpCode::setName:
+                    {
+                        auto& name = static_cast<const UnqualifiedName*> (i.node)->name;
+
+                        if (auto* v = findPropertyWithCache (*s.scope, name, i.cache))
+                            *v = stack.pop().moveToVar();
+                        else
+                            s.root->setProperty (name, stack.pop().moveToVar());
+
+                        break;
+                    }
+
+                    case OpCode::declareVar:
+                    {
+                        auto& name = static_cast<const VarStatement*> (i.node)->name;
+
+                        if (auto* v = findPropertyWithCache (*s.scope, name, i.cache))
+                            *v = stack.pop().moveToVar();
+                        else
+                            s.scope->setProperty (name, stack.pop().moveToVar());
+
+                        break;
+                    }
+
+                    case OpCode::getProperty:    stack.top[-1] = getProperty (stack.top[-1], i); break;
+
+                    case OpCode::getLength:
+                    {
+                        auto& object = stack.top[-1].getVariant();
+
+                        if (auto* array = object.getArray())  stack.top[-1] = array->size();
+                        else if (object.isString())           stack.top[-1] = object.toString().length();
+                        else                                  stack.top[-1] = getProperty (stack.top[-1], i);
+
+                        break;
+                    }
+
+                    case OpCode::setProperty:
+                    {
+                        auto object = stack.pop();
+                        auto newValue = stack.pop();
+
+                        if (auto* o = object.getVariant().getDynamicObject())
+                            o->setProperty (static_cast<const DotOperator*> (i.node)->child, newValue.moveToVar());
+                        else
+                            i.node->location.throwError ("Cannot assign to this expression!");
+
+                        break;
+                    }
+
+                    case OpCode::getElement:
+                    {
+                        auto key = stack.pop();
+                        stack.top[-1] = ArraySubscript::getElement (stack.top[-1], key, i);
+                        break;
+                    }
+
+                    case OpCode::setElement:
+                    {
+                        auto key = stack.pop();
+                        auto arrayVar = stack.pop().moveToVar(); // must stay alive while it's being modified
+                        static_cast<const ArraySubscript*> (i.node)->setElement (arrayVar, key.toVar(), stack.pop().moveToVar());
+                        break;
+                    }
+
+                    case OpCode::binaryOp:
+                    {
+                        auto b = stack.pop();
+                        stack.top[-1] = static_cast<const BinaryOperator*> (i.node)->evaluate (stack.top[-1], b);
+                        break;
+                    }
+
+                    case OpCode::typeEquals:
+                    case OpCode::typeNotEquals:
+                    {
+                        auto b = stack.pop();
+                        stack.top[-1] = (areTypeEqual (stack.top[-1].toVar(), b.toVar()) == (i.opcode == OpCode::typeEquals));
+                        break;
+                    }
+
+                    case OpCode::toBool:        stack.top[-1] = stack.top[-1].toBool(); break;
+                    case OpCode::jump:          ip = code + i.argument; break;
+
+                    case OpCode::jumpIfFalse:
+                    {
+                        if (! stack.top[-1].toBool())
+                            ip = code + i.argument;
+
+                        stack.drop();
+                        break;
+                    }
+
+                    case OpCode::logicalAnd:
+                    case OpCode::logicalOr:
+                    {
+                        auto shortCircuitValue = (i.opcode == OpCode::logicalOr);
+
+                        if (stack.top[-1].toBool() == shortCircuitValue)
+                        {
+                            stack.top[-1] = shortCircuitValue;
+                            ip = code + i.argument;
+                        }
+                        else
+                        {
+                            stack.drop();
+                        }
+
+                        break;
+                    }
+
+                    case OpCode::findMethod:
+                    {
+                        auto& call = *static_cast<const FunctionCall*> (i.node);
+                        auto& name = static_cast<const DotOperator&> (*call.object).child;
+                        auto thisObject = stack.top[-1].toVar();
+                        auto* o = thisObject.getDynamicObject();
+
+                        if (auto* v = o != nullptr ? findPropertyWithCache (*o, name, i.cache) : nullptr)
+                            stack.top[-1] = *v;
+                        else
+                            stack.top[-1] = s.findFunctionCall (call.location, thisObject, name);
+
+                        stack.push (std::move (thisObject));
+                        break;
+                    }
+
+                    case OpCode::call:
+                    case OpCode::callNew:
+                    {
+                        s.checkTimeOut (i.node->location);
+
+                        auto numArgs = i.argument;
+                        auto* items = stack.top - (numArgs + 2); // the function, 'this', then the arguments
+                        LocalStack<var> args (numArgs);
+
+                        for (int n = 0; n < numArgs; ++n)
+                            args.push (items[n + 2].moveToVar());
+
+                        auto function = items[0].moveToVar();
+                        auto thisObject = items[1].moveToVar();
+                        stack.drop (numArgs + 2);
+
+                        auto result = static_cast<const FunctionCall*> (i.node)
+                                        ->invokeFunction (s, function, var::NativeFunctionArgs (thisObject, args.base, numArgs));
+
+                        stack.push (i.opcode == OpCode::call ? std::move (result) : std::move (thisObject));
+                        break;
+                    }
+
+                    case OpCode::beginNew:
+                    {
+                        auto& classOrFunc = stack.top[-1].getVariant();
+
+                        if (isFunction (classOrFunc))
+                        {
+                            stack.push (var (new DynamicObject()));
+                            break;
+                        }
+
+                        if (classOrFunc.getDynamicObject() != nullptr)
+                        {
+                            DynamicObject::Ptr newObject (new DynamicObject());
+                            newObject->setProperty (getPrototypeIdentifier(), classOrFunc);
+                            stack.top[-1] = var (newObject.get());
+                        }
+                        else
+                        {
+                            stack.top[-1] = var::undefined();
+                        }
+
+                        ip = code + i.argument;
+                        break;
+                    }
+
+                    case OpCode::makeObject:
+                    {
+                        auto& names = static_cast<const ObjectDeclaration*> (i.node)->names;
+                        auto* values = stack.top - i.argument;
+                        DynamicObject::Ptr newObject (new DynamicObject());
+
+                        for (int n = 0; n < i.argument; ++n)
+                            newObject->setProperty (names.getReference (n), values[n].moveToVar());
+
+                        stack.drop (i.argument);
+                        stack.push (var (newObject.get()));
+                        break;
+                    }
+
+                    case OpCode::makeArray:
+                    {
+                        auto* values = stack.top - i.argument;
+                        Array<var> a;
+                        a.ensureStorageAllocated (i.argument);
+
+                        for (int n = 0; n < i.argument; ++n)
+                            a.add (values[n].moveToVar());
+
+                        stack.drop (i.argument);
+                        stack.push (var (std::move (a)));
+                        break;
+                    }
+
+                    case OpCode::checkTimeOut:  s.checkTimeOut (i.node->location); break;
+                    case OpCode::returnValue:   return stack.pop().moveToVar();
+                    case OpCode::exit:          return {};
+                    case OpCode::cannotAssign:  i.node->location.throwError ("Cannot assign to this expression!"); break;
+
+                    default:                    jassertfalse; return {};
+                }
+            }
+        }
+
+        static StackValue getProperty (const StackValue& object, const Instruction& i)
+        {
+            if (auto* o = object.getVariant().getDynamicObject())
+                if (auto* v = findPropertyWithCache (*o, static_cast<const DotOperator*> (i.node)->child, i.cache))
+                    return StackValue::fromVar (*v, i.typeHint);
+
+            return var::undefined();
+        }
+
+        static var* findSymbol (const Scope& s, const Identifier& name, const Instruction& i)
+        {
+            if (auto* v = findPropertyWithCache (*s.scope, name, i.cache))
+                return v;
+
+            for (auto* p = s.parent; p != nullptr; p = p->parent)
+                if (auto* v = (p->scope.get() == p->root.get()) ? findPropertyWithCache (*p->scope, name, i.rootCache)
+                                                                : getPropertyPointer (p->scope, name))
+                    return v;
+
+            return nullptr;
+        }
+
+        std::unique_ptr<Statement> tree;
+        Array<Instruction> instructions;
+        int maxStackSize = 0;
+
+        JUCE_DECLARE_NON_COPYABLE (CompiledCode)
+    };
+
     //==============================================================================
     struct Statement
     {
         Statement (const CodeLocation& l) noexcept : location (l) {}
         virtual ~Statement() {}
 
-        enum ResultCode  { ok = 0, returnWasHit, breakWasHit, continueWasHit };
-        virtual ResultCode perform (const Scope&, var*) const  { return ok; }
+        virtual void compile (CodeGenerator&) const {}
 
         CodeLocation location;
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Statement)
@@ -257,10 +974,13 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         Expression (const CodeLocation& l) noexcept : Statement (l) {}
 
-        virtual var getResult (const Scope&) const            { return var::undefined(); }
-        virtual void assign (const Scope&, const var&) const  { location.throwError ("Cannot assign to this expression!"); }
+        // Generates code that pushes the expression's value onto the stack
+        virtual void compileValue (CodeGenerator& g) const        { g.emit (OpCode::pushUndefined, this); }
+
+        // Generates code that pops a value from the stack and assigns it to this expression
+        virtual void compileAssignment (CodeGenerator& g) const   { g.emit (OpCode::cannotAssign, this); }
 
-        ResultCode perform (const Scope& s, var*) const override  { getResult (s); return ok; }
+        void compile (CodeGenerator& g) const override            { compileValue (g); g.emit (OpCode::pop, this); }
     };
 
     using ExpPtr = std::unique_ptr<Expression>;
@@ -269,13 +989,10 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         BlockStatement (const CodeLocation& l) noexcept : Statement (l) {}
 
-        ResultCode perform (const Scope& s, var* returnedValue) const override
+        void compile (CodeGenerator& g) const override
         {
             for (auto* statement : statements)
-                if (auto r = statement->perform (s, returnedValue))
-                    return r;
-
-            return ok;
+                statement->compile (g);
         }
 
         OwnedArray<Statement> statements;
@@ -285,9 +1002,15 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         IfStatement (const CodeLocation& l) noexcept : Statement (l) {}
 
-        ResultCode perform (const Scope& s, var* returnedValue) const override
+        void compile (CodeGenerator& g) const override
         {
-            return (condition->getResult(s) ? trueBranch : falseBranch)->perform (s, returnedValue);
+            condition->compileValue (g);
+            auto jumpToFalseBranch = g.emit (OpCode::jumpIfFalse, this);
+            trueBranch->compile (g);
+            auto jumpToEnd = g.emit (OpCode::jump, this);
+            g.setJumpDestination (jumpToFalseBranch);
+            falseBranch->compile (g);
+            g.setJumpDestination (jumpToEnd);
         }
 
         ExpPtr condition;
@@ -298,10 +1021,10 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         VarStatement (const CodeLocation& l) noexcept : Statement (l) {}
 
-        ResultCode perform (const Scope& s, var*) const override
+        void compile (CodeGenerator& g) const override
         {
-            s.scope->setProperty (name, initialiser->getResult (s));
-            return ok;
+            initialiser->compileValue (g);
+            g.emit (OpCode::declareVar, this);
         }
 
         Identifier name;
@@ -312,25 +1035,44 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         LoopStatement (const CodeLocation& l, bool isDo) noexcept : Statement (l), isDoLoop (isDo) {}
 
-        ResultCode perform (const Scope& s, var* returnedValue) const override
+        void compile (CodeGenerator& g) const override
         {
-            initialiser->perform (s, nullptr);
-
-            while (isDoLoop || condition->getResult (s))
             {
-                s.checkTimeOut (location);
-                auto r = body->perform (s, returnedValue);
+                // Any break, continue or return statements in the initialiser just skip the rest of it
+                CodeGenerator::JumpTargets initialiserTargets (g, true);
+                initialiser->compile (g);
+                initialiserTargets.resolveBreaks();
+                initialiserTargets.resolveContinues();
+            }
 
-                if (r == returnWasHit)   return r;
-                if (r == breakWasHit)    break;
+            CodeGenerator::JumpTargets targets (g, false);
+            auto start = g.getPosition();
+            int jumpToEnd = -1;
+
+            if (! isDoLoop)
+            {
+                condition->compileValue (g);
+                jumpToEnd = g.emit (OpCode::jumpIfFalse, this);
+            }
 
-                iterator->perform (s, nullptr);
+            g.emit (OpCode::checkTimeOut, this);
+            body->compile (g);
 
-                if (isDoLoop && r != continueWasHit && ! condition->getResult (s))
-                    break;
+            if (isDoLoop)
+            {
+                // a continue statement in a do-loop goes round again without testing the condition
+                iterator->compile (g);
+                condition->compileValue (g);
+                jumpToEnd = g.emit (OpCode::jumpIfFalse, this);
+                g.emit (OpCode::jump, this, start);
             }
 
-            return ok;
+            targets.resolveContinues();
+            iterator->compile (g);
+            g.emit (OpCode::jump, this, start);
+
+            g.setJumpDestination (jumpToEnd);
+            targets.resolveBreaks();
         }
 
         std::unique_ptr<Statement> initialiser, iterator, body;
@@ -342,10 +1084,13 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         ReturnStatement (const CodeLocation& l, Expression* v) noexcept : Statement (l), returnValue (v) {}
 
-        ResultCode perform (const Scope& s, var* ret) const override
+        void compile (CodeGenerator& g) const override
         {
-            if (ret != nullptr)  *ret = returnValue->getResult (s);
-            return returnWasHit;
+            if (g.canReturnValue (this))
+            {
+                returnValue->compileValue (g);
+                g.emit (OpCode::returnValue, this);
+            }
         }
 
         ExpPtr returnValue;
@@ -354,35 +1099,28 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     struct BreakStatement  : public Statement
     {
         BreakStatement (const CodeLocation& l) noexcept : Statement (l) {}
-        ResultCode perform (const Scope&, var*) const override  { return breakWasHit; }
+        void compile (CodeGenerator& g) const override   { g.emitBreak (this); }
     };
 
     struct ContinueStatement  : public Statement
     {
         ContinueStatement (const CodeLocation& l) noexcept : Statement (l) {}
-        ResultCode perform (const Scope&, var*) const override  { return continueWasHit; }
+        void compile (CodeGenerator& g) const override   { g.emitContinue (this); }
     };
 
     struct LiteralValue  : public Expression
     {
-        LiteralValue (const CodeLocation& l, const var& v) noexcept : Expression (l), value (v) {}
-        var getResult (const Scope&) const override   { return value; }
-        var value;
+        LiteralValue (const CodeLocation& l, const var& v) : Expression (l), value (v) { value.unbox(); }
+        void compileValue (CodeGenerator& g) const override   { g.emit (OpCode::pushLiteral, this); }
+        StackValue value;
     };
 
     struct UnqualifiedName  : public Expression
     {
         UnqualifiedName (const CodeLocation& l, const Identifier& n) noexcept : Expression (l), name (n) {}
 
-        var getResult (const Scope& s) const override  { return s.findSymbolInParentScopes (name); }
-
-        void assign (const Scope& s, const var& newValue) const override
-        {
-            if (auto* v = getPropertyPointer (s.scope, name))
-                *v = newValue;
-            else
-                s.root->setProperty (name, newValue);
-        }
+        void compileValue (CodeGenerator& g) const override        { g.emit (OpCode::getName, this); }
+        void compileAssignment (CodeGenerator& g) const override   { g.emit (OpCode::setName, this); }
 
         Identifier name;
     };
@@ -391,30 +1129,18 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         DotOperator (const CodeLocation& l, ExpPtr& p, const Identifier& c) noexcept : Expression (l), parent (p.release()), child (c) {}
 
-        var getResult (const Scope& s) const override
+        void compileValue (CodeGenerator& g) const override
         {
-            auto p = parent->getResult (s);
             static const Identifier lengthID ("length");
 
-            if (child == lengthID)
-            {
-                if (auto* array = p.getArray())   return array->size();
-                if (p.isString())                 return p.toString().length();
-            }
-
-            if (auto* o = p.getDynamicObject())
-                if (auto* v = getPropertyPointer (o, child))
-                    return *v;
-
-            return var::undefined();
+            parent->compileValue (g);
+            g.emit (child == lengthID ? OpCode::getLength : OpCode::getProperty, this);
         }
 
-        void assign (const Scope& s, const var& newValue) const override
+        void compileAssignment (CodeGenerator& g) const override
         {
-            if (auto* o = parent->getResult (s).getDynamicObject())
-                o->setProperty (child, newValue);
-            else
-                Expression::assign (s, newValue);
+            parent->compileValue (g);
+            g.emit (OpCode::setProperty, this);
         }
 
         ExpPtr parent;
@@ -425,11 +1151,40 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         ArraySubscript (const CodeLocation& l) noexcept : Expression (l) {}
 
-        var getResult (const Scope& s) const override
+        void compileValue (CodeGenerator& g) const override
+        {
+            object->compileValue (g);
+            index->compileValue (g);
+            g.emit (OpCode::getElement, this);
+        }
+
+        void compileAssignment (CodeGenerator& g) const override
         {
-            auto arrayVar = object->getResult (s); // must stay alive for the scope of this method
-            auto key = index->getResult (s);
+            object->compileValue (g);
+            index->compileValue (g);
+            g.emit (OpCode::setElement, this);
+        }
+
+        static StackValue getElement (const StackValue& arrayValue, const StackValue& key, const Instruction& i)
+        {
+            if (const auto* array = arrayValue.getVariant().getArray())
+            {
+                if (key.isIndex())
+                {
+                    auto index = key.toInt();
 
+                    if (isPositiveAndBelow (index, array->size()))
+                        return StackValue::fromVar (array->getReference (index), i.typeHint);
+
+                    return var();
+                }
+            }
+
+            return getElement (arrayValue.getVariant(), key.toVar());
+        }
+
+        static var getElement (const var& arrayVar, const var& key)
+        {
             if (const auto* array = arrayVar.getArray())
                 if (key.isInt() || key.isInt64() || key.isDouble())
                     return (*array) [static_cast<int> (key)];
@@ -442,11 +1197,8 @@ struct JavascriptEngine::RootObject   : public DynamicObject
             return var::undefined();
         }
 
-        void assign (const Scope& s, const var& newValue) const override
+        void setElement (const var& arrayVar, const var& key, const var& newValue) const
         {
-            auto arrayVar = object->getResult (s); // must stay alive for the scope of this method
-            auto key = index->getResult (s);
-
             if (auto* array = arrayVar.getArray())
             {
                 if (key.isInt() || key.isInt64() || key.isDouble())
@@ -469,7 +1221,7 @@ struct JavascriptEngine::RootObject   : public DynamicObject
                 }
             }
 
-            Expression::assign (s, newValue);
+            location.throwError ("Cannot assign to this expression!");
         }
 
         ExpPtr object, index;
@@ -480,6 +1232,22 @@ struct JavascriptEngine::RootObject   : public DynamicObject
         BinaryOperatorBase (const CodeLocation& l, ExpPtr& a, ExpPtr& b, TokenType op) noexcept
             : Expression (l), lhs (a.release()), rhs (b.release()), operation (op) {}
 
+        void compileOperands (CodeGenerator& g) const
+        {
+            lhs->compileValue (g);
+            rhs->compileValue (g);
+        }
+
+        // Generates code for && or ||, which only evaluate their rhs if they need to
+        void compileShortCircuit (CodeGenerator& g, OpCode opcode) const
+        {
+            lhs->compileValue (g);
+            auto jumpToEnd = g.emit (opcode, this);
+            rhs->compileValue (g);
+            g.emit (OpCode::toBool, this);
+            g.setJumpDestination (jumpToEnd);
+        }
+
         ExpPtr lhs, rhs;
         TokenType operation;
     };
@@ -490,14 +1258,34 @@ struct JavascriptEngine::RootObject   : public DynamicObject
             : BinaryOperatorBase (l, a, b, op) {}
 
         virtual var getWithUndefinedArg() const                           { return var::undefined(); }
-        virtual var getWithDoubles (double, double) const                 { return throwError ("Double"); }
-        virtual var getWithInts (int64, int64) const                      { return throwError ("Integer"); }
+        virtual StackValue getWithDoubles (double, double) const          { return throwError ("Double"); }
+        virtual StackValue getWithInts (int64, int64) const               { return throwError ("Integer"); }
         virtual var getWithArrayOrObject (const var& a, const var&) const { return throwError (a.isArray() ? "Array" : "Object"); }
         virtual var getWithStrings (const String&, const String&) const   { return throwError ("String"); }
 
-        var getResult (const Scope& s) const override
+        void compileValue (CodeGenerator& g) const override
         {
-            var a (lhs->getResult (s)), b (rhs->getResult (s));
+            compileOperands (g);
+            g.emit (OpCode::binaryOp, this);
+        }
+
+        StackValue evaluate (StackValue& a, StackValue& b) const
+        {
+            a.unbox();
+            b.unbox();
+
+            if (a.isNumber() && b.isNumber())
+                return (a.isDouble() || b.isDouble()) ? getWithDoubles (a.toDouble(), b.toDouble())
+                                                      : getWithInts (a.toInt64(), b.toInt64());
+
+            return evaluate (a.toVar(), b.toVar());
+        }
+
+        StackValue evaluate (const var& a, const var& b) const
+        {
+            // check for the most common case of two integers first
+            if ((a.isInt64() || a.isInt()) && (b.isInt64() || b.isInt()))
+                return getWithInts (a, b);
 
             if ((a.isUndefined() || a.isVoid()) && (b.isUndefined() || b.isVoid()))
                 return getWithUndefinedArg();
@@ -519,8 +1307,8 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         EqualsOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperator (l, a, b, TokenTypes::equals) {}
         var getWithUndefinedArg() const override                               { return true; }
-        var getWithDoubles (double a, double b) const override                 { return a == b; }
-        var getWithInts (int64 a, int64 b) const override                      { return a == b; }
+        StackValue getWithDoubles (double a, double b) const override          { return a == b; }
+        StackValue getWithInts (int64 a, int64 b) const override               { return a == b; }
         var getWithStrings (const String& a, const String& b) const override   { return a == b; }
         var getWithArrayOrObject (const var& a, const var& b) const override   { return a == b; }
     };
@@ -529,8 +1317,8 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         NotEqualsOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperator (l, a, b, TokenTypes::notEquals) {}
         var getWithUndefinedArg() const override                               { return false; }
-        var getWithDoubles (double a, double b) const override                 { return a != b; }
-        var getWithInts (int64 a, int64 b) const override                      { return a != b; }
+        StackValue getWithDoubles (double a, double b) const override          { return a != b; }
+        StackValue getWithInts (int64 a, int64 b) const override               { return a != b; }
         var getWithStrings (const String& a, const String& b) const override   { return a != b; }
         var getWithArrayOrObject (const var& a, const var& b) const override   { return a != b; }
     };
@@ -538,137 +1326,150 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     struct LessThanOp  : public BinaryOperator
     {
         LessThanOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperator (l, a, b, TokenTypes::lessThan) {}
-        var getWithDoubles (double a, double b) const override                 { return a < b; }
-        var getWithInts (int64 a, int64 b) const override                      { return a < b; }
+        StackValue getWithDoubles (double a, double b) const override          { return a < b; }
+        StackValue getWithInts (int64 a, int64 b) const override               { return a < b; }
         var getWithStrings (const String& a, const String& b) const override   { return a < b; }
     };
 
     struct LessThanOrEqualOp  : public BinaryOperator
     {
         LessThanOrEqualOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperator (l, a, b, TokenTypes::lessThanOrEqual) {}
-        var getWithDoubles (double a, double b) const override                 { return a <= b; }
-        var getWithInts (int64 a, int64 b) const override                      { return a <= b; }
+        StackValue getWithDoubles (double a, double b) const override          { return a <= b; }
+        StackValue getWithInts (int64 a, int64 b) const override               { return a <= b; }
         var getWithStrings (const String& a, const String& b) const override   { return a <= b; }
     };
 
     struct GreaterThanOp  : public BinaryOperator
     {
         GreaterThanOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperator (l, a, b, TokenTypes::greaterThan) {}
-        var getWithDoubles (double a, double b) const override                 { return a > b; }
-        var getWithInts (int64 a, int64 b) const override                      { return a > b; }
+        StackValue getWithDoubles (double a, double b) const override          { return a > b; }
+        StackValue getWithInts (int64 a, int64 b) const override               { return a > b; }
         var getWithStrings (const String& a, const String& b) const override   { return a > b; }
     };
 
     struct GreaterThanOrEqualOp  : public BinaryOperator
     {
         GreaterThanOrEqualOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperator (l, a, b, TokenTypes::greaterThanOrEqual) {}
-        var getWithDoubles (double a, double b) const override                 { return a >= b; }
-        var getWithInts (int64 a, int64 b) const override                      { return a >= b; }
+        StackValue getWithDoubles (double a, double b) const override          { return a >= b; }
+        StackValue getWithInts (int64 a, int64 b) const override               { return a >= b; }
         var getWithStrings (const String& a, const String& b) const override   { return a >= b; }
     };
 
     struct AdditionOp  : public BinaryOperator
     {
         AdditionOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperator (l, a, b, TokenTypes::plus) {}
-        var getWithDoubles (double a, double b) const override                 { return a + b; }
-        var getWithInts (int64 a, int64 b) const override                      { return a + b; }
+        StackValue getWithDoubles (double a, double b) const override          { return a + b; }
+        StackValue getWithInts (int64 a, int64 b) const override               { return a + b; }
         var getWithStrings (const String& a, const String& b) const override   { return a + b; }
     };
 
     struct SubtractionOp  : public BinaryOperator
     {
         SubtractionOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperator (l, a, b, TokenTypes::minus) {}
-        var getWithDoubles (double a, double b) const override { return a - b; }
-        var getWithInts (int64 a, int64 b) const override      { return a - b; }
+        StackValue getWithDoubles (double a, double b) const override { return a - b; }
+        StackValue getWithInts (int64 a, int64 b) const override    { return a - b; }
     };
 
     struct MultiplyOp  : public BinaryOperator
     {
         MultiplyOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperator (l, a, b, TokenTypes::times) {}
-        var getWithDoubles (double a, double b) const override { return a * b; }
-        var getWithInts (int64 a, int64 b) const override      { return a * b; }
+        StackValue getWithDoubles (double a, double b) const override { return a * b; }
+        StackValue getWithInts (int64 a, int64 b) const override    { return a * b; }
     };
 
     struct DivideOp  : public BinaryOperator
     {
         DivideOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperator (l, a, b, TokenTypes::divide) {}
-        var getWithDoubles (double a, double b) const override  { return b != 0 ? a / b : std::numeric_limits<double>::infinity(); }
-        var getWithInts (int64 a, int64 b) const override       { return b != 0 ? var (a / (double) b) : var (std::numeric_limits<double>::infinity()); }
+        StackValue getWithDoubles (double a, double b) const override  { return b != 0 ? a / b : std::numeric_limits<double>::infinity(); }
+        StackValue getWithInts (int64 a, int64 b) const override     { return b != 0 ? (double) a / (double) b : std::numeric_limits<double>::infinity(); }
     };
 
     struct ModuloOp  : public BinaryOperator
     {
         ModuloOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperator (l, a, b, TokenTypes::modulo) {}
-        var getWithDoubles (double a, double b) const override  { return b != 0 ? fmod (a, b) : std::numeric_limits<double>::infinity(); }
-        var getWithInts (int64 a, int64 b) const override       { return b != 0 ? var (a % b) : var (std::numeric_limits<double>::infinity()); }
+        StackValue getWithDoubles (double a, double b) const override  { return b != 0 ? fmod (a, b) : std::numeric_limits<double>::infinity(); }
+        StackValue getWithInts (int64 a, int64 b) const override     { return b != 0 ? StackValue (a % b) : StackValue (std::numeric_limits<double>::infinity()); }
     };
 
     struct BitwiseOrOp  : public BinaryOperator
     {
         BitwiseOrOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperator (l, a, b, TokenTypes::bitwiseOr) {}
-        var getWithInts (int64 a, int64 b) const override   { return a | b; }
+        StackValue getWithInts (int64 a, int64 b) const override { return a | b; }
     };
 
     struct BitwiseAndOp  : public BinaryOperator
     {
         BitwiseAndOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperator (l, a, b, TokenTypes::bitwiseAnd) {}
-        var getWithInts (int64 a, int64 b) const override   { return a & b; }
+        StackValue getWithInts (int64 a, int64 b) const override { return a & b; }
     };
 
     struct BitwiseXorOp  : public BinaryOperator
     {
         BitwiseXorOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperator (l, a, b, TokenTypes::bitwiseXor) {}
-        var getWithInts (int64 a, int64 b) const override   { return a ^ b; }
+        StackValue getWithInts (int64 a, int64 b) const override { return a ^ b; }
     };
 
     struct LeftShiftOp  : public BinaryOperator
     {
         LeftShiftOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperator (l, a, b, TokenTypes::leftShift) {}
-        var getWithInts (int64 a, int64 b) const override   { return ((int) a) << (int) b; }
+        StackValue getWithInts (int64 a, int64 b) const override { return ((int) a) << (int) b; }
     };
 
     struct RightShiftOp  : public BinaryOperator
     {
         RightShiftOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperator (l, a, b, TokenTypes::rightShift) {}
-        var getWithInts (int64 a, int64 b) const override   { return ((int) a) >> (int) b; }
+        StackValue getWithInts (int64 a, int64 b) const override { return ((int) a) >> (int) b; }
     };
 
     struct RightShiftUnsignedOp  : public BinaryOperator
     {
         RightShiftUnsignedOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperator (l, a, b, TokenTypes::rightShiftUnsigned) {}
-        var getWithInts (int64 a, int64 b) const override   { return (int) (((uint32) a) >> (int) b); }
+        StackValue getWithInts (int64 a, int64 b) const override { return (int) (((uint32) a) >> (int) b); }
     };
 
     struct LogicalAndOp  : public BinaryOperatorBase
     {
         LogicalAndOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperatorBase (l, a, b, TokenTypes::logicalAnd) {}
-        var getResult (const Scope& s) const override       { return lhs->getResult (s) && rhs->getResult (s); }
+        void compileValue (CodeGenerator& g) const override     { compileShortCircuit (g, OpCode::logicalAnd); }
     };
 
     struct LogicalOrOp  : public BinaryOperatorBase
     {
         LogicalOrOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperatorBase (l, a, b, TokenTypes::logicalOr) {}
-        var getResult (const Scope& s) const override       { return lhs->getResult (s) || rhs->getResult (s); }
+        void compileValue (CodeGenerator& g) const override     { compileShortCircuit (g, OpCode::logicalOr); }
     };
 
     struct TypeEqualsOp  : public BinaryOperatorBase
     {
         TypeEqualsOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperatorBase (l, a, b, TokenTypes::typeEquals) {}
-        var getResult (const Scope& s) const override       { return areTypeEqual (lhs->getResult (s), rhs->getResult (s)); }
+        void compileValue (CodeGenerator& g) const override     { compileOperands (g); g.emit (OpCode::typeEquals, this); }
     };
 
     struct TypeNotEqualsOp  : public BinaryOperatorBase
     {
         TypeNotEqualsOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperatorBase (l, a, b, TokenTypes::typeNotEquals) {}
-        var getResult (const Scope& s) const override       { return ! areTypeEqual (lhs->getResult (s), rhs->getResult (s)); }
+        void compileValue (CodeGenerator& g) const override     { compileOperands (g); g.emit (OpCode::typeNotEquals, this); }
     };
 
     struct ConditionalOp  : public Expression
     {
         ConditionalOp (const CodeLocation& l) noexcept : Expression (l) {}
 
-        var getResult (const Scope& s) const override              { return (condition->getResult (s) ? trueBranch : falseBranch)->getResult (s); }
-        void assign (const Scope& s, const var& v) const override  { (condition->getResult (s) ? trueBranch : falseBranch)->assign (s, v); }
+        void compileValue (CodeGenerator& g) const override        { compileBranches (g, &Expression::compileValue); }
+        void compileAssignment (CodeGenerator& g) const override   { compileBranches (g, &Expression::compileAssignment); }
+
+        void compileBranches (CodeGenerator& g, void (Expression::*compileBranch) (CodeGenerator&) const) const
+        {
+            condition->compileValue (g);
+            auto jumpToFalseBranch = g.emit (OpCode::jumpIfFalse, this);
+            (trueBranch.get()->*compileBranch) (g);
+            auto jumpToEnd = g.emit (OpCode::jump, this);
+            auto stackSizeAtEnd = g.stackSize;
+            g.setJumpDestination (jumpToFalseBranch);
+            (falseBranch.get()->*compileBranch) (g);
+            g.setJumpDestination (jumpToEnd);
+            g.stackSize = stackSizeAtEnd; // (only one of the branches will have been taken)
+        }
 
         ExpPtr condition, trueBranch, falseBranch;
     };
@@ -677,11 +1478,18 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         Assignment (const CodeLocation& l, ExpPtr& dest, ExpPtr& source) noexcept : Expression (l), target (dest.release()), newValue (source.release()) {}
 
-        var getResult (const Scope& s) const override
+        void compileValue (CodeGenerator& g) const override
         {
-            auto value = newValue->getResult (s);
-            target->assign (s, value);
-            return value;
+            newValue->compileValue (g);
+            g.emit (OpCode::dup, this);
+            target->compileAssignment (g);
+        }
+
+        void compile (CodeGenerator& g) const override
+        {
+            // when the result isn't needed, there's no need to keep a copy of it on the stack
+            newValue->compileValue (g);
+            target->compileAssignment (g);
         }
 
         ExpPtr target, newValue;
@@ -692,11 +1500,17 @@ struct JavascriptEngine::RootObject   : public DynamicObject
         SelfAssignment (const CodeLocation& l, Expression* dest, Expression* source) noexcept
             : Expression (l), target (dest), newValue (source) {}
 
-        var getResult (const Scope& s) const override
+        void compileValue (CodeGenerator& g) const override
+        {
+            newValue->compileValue (g);
+            g.emit (OpCode::dup, this);
+            target->compileAssignment (g);
+        }
+
+        void compile (CodeGenerator& g) const override
         {
-            auto value = newValue->getResult (s);
-            target->assign (s, value);
-            return value;
+            newValue->compileValue (g);
+            target->compileAssignment (g);
         }
 
         Expression* target; // Careful! this pointer aliases a sub-term of newValue!
@@ -708,40 +1522,46 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         PostAssignment (const CodeLocation& l, Expression* dest, Expression* source) noexcept : SelfAssignment (l, dest, source) {}
 
-        var getResult (const Scope& s) const override
+        void compileValue (CodeGenerator& g) const override
         {
-            auto oldValue = target->getResult (s);
-            target->assign (s, newValue->getResult (s));
-            return oldValue;
+            target->compileValue (g);
+            newValue->compileValue (g);
+            target->compileAssignment (g);
         }
+
+        void compile (CodeGenerator& g) const override   { Expression::compile (g); }
     };
 
     struct FunctionCall  : public Expression
     {
         FunctionCall (const CodeLocation& l) noexcept : Expression (l) {}
 
-        var getResult (const Scope& s) const override
+        void compileValue (CodeGenerator& g) const override
         {
             if (auto* dot = dynamic_cast<DotOperator*> (object.get()))
             {
-                auto thisObject = dot->parent->getResult (s);
-                return invokeFunction (s, s.findFunctionCall (location, thisObject, dot->child), thisObject);
+                dot->parent->compileValue (g);
+                g.emit (OpCode::findMethod, this);
+            }
+            else
+            {
+                object->compileValue (g);
+                g.emit (OpCode::pushScope, this);
             }
 
-            auto function = object->getResult (s);
-            return invokeFunction (s, function, var (s.scope.get()));
+            compileArguments (g, OpCode::call);
         }
 
-        var invokeFunction (const Scope& s, const var& function, const var& thisObject) const
+        void compileArguments (CodeGenerator& g, OpCode opcode) const
         {
-            s.checkTimeOut (location);
-            Array<var> argVars;
-
             for (auto* a : arguments)
-                argVars.add (a->getResult (s));
+                a->compileValue (g);
 
-            const var::NativeFunctionArgs args (thisObject, argVars.begin(), argVars.size());
+            g.emit (opcode, this, arguments.size());
+        }
 
+        var invokeFunction (const Scope& s, const var& function, const var::NativeFunctionArgs& args) const
+        {
             if (var::NativeFunction nativeFunction = function.getNativeFunction())
                 return nativeFunction (args);
 
@@ -749,7 +1569,7 @@ struct JavascriptEngine::RootObject   : public DynamicObject
                 return fo->invoke (s, args);
 
             if (auto* dot = dynamic_cast<DotOperator*> (object.get()))
-                if (auto* o = thisObject.getDynamicObject())
+                if (auto* o = args.thisObject.getDynamicObject())
                     if (o->hasMethod (dot->child)) // allow an overridden DynamicObject::invokeMethod to accept a method call.
                         return o->invokeMethod (dot->child, args);
 
@@ -764,22 +1584,12 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         NewOperator (const CodeLocation& l) noexcept : FunctionCall (l) {}
 
-        var getResult (const Scope& s) const override
+        void compileValue (CodeGenerator& g) const override
         {
-            var classOrFunc = object->getResult (s);
-            const bool isFunc = isFunction (classOrFunc);
-
-            if (! (isFunc || classOrFunc.getDynamicObject() != nullptr))
-                return var::undefined();
-
-            DynamicObject::Ptr newObject (new DynamicObject());
-
-            if (isFunc)
-                invokeFunction (s, classOrFunc, newObject.get());
-            else
-                newObject->setProperty (getPrototypeIdentifier(), classOrFunc);
-
-            return newObject.get();
+            object->compileValue (g);
+            auto jumpToEnd = g.emit (OpCode::beginNew, this);
+            compileArguments (g, OpCode::callNew);
+            g.setJumpDestination (jumpToEnd);
         }
     };
 
@@ -787,14 +1597,12 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         ObjectDeclaration (const CodeLocation& l) noexcept : Expression (l) {}
 
-        var getResult (const Scope& s) const override
+        void compileValue (CodeGenerator& g) const override
         {
-            DynamicObject::Ptr newObject (new DynamicObject());
-
-            for (int i = 0; i < names.size(); ++i)
-                newObject->setProperty (names.getUnchecked(i), initialisers.getUnchecked(i)->getResult (s));
+            for (auto* i : initialisers)
+                i->compileValue (g);
 
-            return newObject.get();
+            g.emit (OpCode::makeObject, this, initialisers.size());
         }
 
         Array<Identifier> names;
@@ -805,14 +1613,12 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         ArrayDeclaration (const CodeLocation& l) noexcept : Expression (l) {}
 
-        var getResult (const Scope& s) const override
+        void compileValue (CodeGenerator& g) const override
         {
-            Array<var> a;
+            for (auto* v : values)
+                v->compileValue (g);
 
-            for (int i = 0; i < values.size(); ++i)
-                a.add (values.getUnchecked(i)->getResult (s));
-
-            return a;
+            g.emit (OpCode::makeArray, this, values.size());
         }
 
         OwnedArray<Expression> values;
@@ -838,6 +1644,12 @@ struct JavascriptEngine::RootObject   : public DynamicObject
 
         var invoke (const Scope& s, const var::NativeFunctionArgs& args) const
         {
+            auto& callDepthRemaining = s.root->callDepthRemaining;
+
+            if (callDepthRemaining <= 0)
+                body->tree->location.throwError ("Exceeded the maximum call depth");
+
+            const ScopedValueSetter<int> callDepthSetter (callDepthRemaining, callDepthRemaining - 1);
             DynamicObject::Ptr functionRoot (new DynamicObject());
 
             static const Identifier thisIdent ("this");
@@ -847,20 +1659,18 @@ struct JavascriptEngine::RootObject   : public DynamicObject
                 functionRoot->setProperty (parameters.getReference(i),
                                            i < args.numArguments ? args.arguments[i] : var::undefined());
 
-            var result;
-            body->perform (Scope (&s, s.root, functionRoot), &result);
-            return result;
+            return body->run (Scope (&s, s.root, functionRoot));
         }
 
         String functionCode;
         Array<Identifier> parameters;
-        std::unique_ptr<Statement> body;
+        std::unique_ptr<CompiledCode> body;
     };
 
     //==============================================================================
     struct TokenIterator
     {
-        TokenIterator (const String& code) : location (code), p (code.getCharPointer()) { skip(); }
+        TokenIterator (const String& code) : location (code), p (location.program.getCharPointer()) { skip(); }
 
         void skip()
         {
@@ -1081,7 +1891,7 @@ struct JavascriptEngine::RootObject   : public DynamicObject
             }
 
             match (TokenTypes::closeParen);
-            fo.body.reset (parseBlock());
+            fo.body.reset (new CompiledCode (parseBlock(), true));
         }
 
         Expression* parseExpression()
@@ -1809,7 +2619,16 @@ struct JavascriptEngine::RootObject   : public DynamicObject
 };
 
 //==============================================================================
-JavascriptEngine::JavascriptEngine()  : maximumExecutionTime (15.0), root (new RootObject())
+// Scripts remember the ID of the engine that compiled them, rather than its address,
+// which could be reused by a new engine after the old one has been deleted
+static uint32 createJavascriptEngineID() noexcept
+{
+    static Atomic<uint32> lastID { (uint32) 0 };
+    return ++lastID;
+}
+
+JavascriptEngine::JavascriptEngine()
+    : maximumExecutionTime (15.0), root (new RootObject()), engineID (createJavascriptEngineID())
 {
     registerNativeObject (RootObject::ObjectClass  ::getClassName(),  new RootObject::ObjectClass());
     registerNativeObject (RootObject::ArrayClass   ::getClassName(),  new RootObject::ArrayClass());
@@ -1821,8 +2640,15 @@ JavascriptEngine::JavascriptEngine()  : maximumExecutionTime (15.0), root (new R
 
 JavascriptEngine::~JavascriptEngine() {}
 
-void JavascriptEngine::prepareTimeout() const noexcept   { root->timeout = Time::getCurrentTime() + maximumExecutionTime; }
-void JavascriptEngine::stop() noexcept                   { root->timeout = {}; }
+void JavascriptEngine::stop() noexcept   { root->timeout = {}; }
+
+void JavascriptEngine::prepareExecutionLimits() const noexcept
+{
+    root->timeout = Time::getCurrentTime() + maximumExecutionTime;
+    root->numTimeOutChecksToSkip = 0;
+    root->numInstructionsRemaining = maximumInstructions > 0 ? maximumInstructions : std::numeric_limits<int64>::max();
+    root->callDepthRemaining = maximumCallDepth > 0 ? maximumCallDepth : std::numeric_limits<int>::max();
+}
 
 void JavascriptEngine::registerNativeObject (const Identifier& name, DynamicObject* object)
 {
@@ -1831,10 +2657,78 @@ void JavascriptEngine::registerNativeObject (const Identifier& name, DynamicObje
 
 Result JavascriptEngine::execute (const String& code)
 {
+    auto result = Result::ok();
+
+    if (auto script = compile (code, &result))
+        return execute (*script);
+
+    return result;
+}
+
+//==============================================================================
+struct JavascriptEngine::CompiledScript::Code  : public RootObject::CompiledCode
+{
+    using CompiledCode::CompiledCode;
+};
+
+JavascriptEngine::CompiledScript::CompiledScript (const String& source, int64 sourceHash, Code* compiledCode, uint32 engine)
+    : sourceCode (source), hash (sourceHash), code (compiledCode), ownerID (engine)
+{
+}
+
+JavascriptEngine::CompiledScript::~CompiledScript() {}
+
+JavascriptEngine::CompiledScript::Ptr JavascriptEngine::compile (const String& code, Result* result)
+{
+    if (result != nullptr) *result = Result::ok();
+
+    auto hash = code.hashCode64();
+
+    for (int i = 0; i < compiledScriptCache.size(); ++i)
+    {
+        CompiledScript::Ptr script (compiledScriptCache.getObjectPointerUnchecked (i));
+
+        if (script->hash == hash && script->sourceCode == code)
+        {
+            compiledScriptCache.move (i, 0);
+            return script;
+        }
+    }
+
+    try
+    {
+        RootObject::ExpressionTreeBuilder tb (code);
+        std::unique_ptr<CompiledScript::Code> compiledCode (new CompiledScript::Code (tb.parseStatementList(), false));
+        CompiledScript::Ptr script (new CompiledScript (code, hash, compiledCode.release(), engineID));
+
+        if (maximumCachedScripts > 0)
+        {
+            compiledScriptCache.insert (0, script.get());
+            compiledScriptCache.removeRange (maximumCachedScripts, compiledScriptCache.size());
+        }
+
+        return script;
+    }
+    catch (String& error)
+    {
+        if (result != nullptr) *result = Result::fail (error);
+    }
+
+    return {};
+}
+
+Result JavascriptEngine::execute (const CompiledScript& script)
+{
+    // A script can only be run by the engine that compiled it!
+    jassert (script.ownerID == engineID);
+
+    if (script.ownerID != engineID)
+        return Result::fail ("Script was compiled by a different engine");
+
     try
     {
-        prepareTimeout();
-        root->execute (code);
+        prepareExecutionLimits();
+        script.code->run (RootObject::Scope (nullptr, root, root));
     }
     catch (String& error)
     {
@@ -1844,11 +2738,18 @@ Result JavascriptEngine::execute (const String& code)
     return Result::ok();
 }
 
+void JavascriptEngine::clearCompiledScriptCache()
+{
+    compiledScriptCache.clear();
+}
+
+//==============================================================================
+
 var JavascriptEngine::evaluate (const String& code, Result* result)
 {
     try
     {
-        prepareTimeout();
+        prepareExecutionLimits();
         if (result != nullptr) *result = Result::ok();
         return root->evaluate (code);
     }
@@ -1866,7 +2767,7 @@ var JavascriptEngine::callFunction (const Identifier& function, const var::Nativ
 
     try
     {
-        prepareTimeout();
+        prepareExecutionLimits();
         if (result != nullptr) *result = Result::ok();
         RootObject::Scope (nullptr, root, root).findAndInvokeMethod (function, args, returnVal);
     }
@@ -1885,7 +2786,7 @@ var JavascriptEngine::callFunctionObject (DynamicObject* objectScope, const var&
 
     try
     {
-        prepareTimeout();
+        prepareExecutionLimits();
         if (result != nullptr) *result = Result::ok();
         RootObject::Scope rootScope (nullptr, root, root);
         RootObject::Scope (&rootScope, root, objectScope).invokeMethod (functionObject, args, returnVal);
@@ -1907,4 +2808,234 @@ const NamedValueSet& JavascriptEngine::getRootObjectProperties() const noexcept
  #pragma warning (pop)
 #endif
 
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class JavascriptEngineTests  : public UnitTest
+{
+public:
+    JavascriptEngineTests() : UnitTest ("JavascriptEngine", "Javascript") {}
+
+    var evaluate (JavascriptEngine& engine, const String& code)
+    {
+        Result result (Result::ok());
+        auto v = engine.evaluate (code, &result);
+        expect (result.wasOk(), result.getErrorMessage());
+        return v;
+    }
+
+    void expectResult (const String& code, const var& expected)
+    {
+        JavascriptEngine engine;
+        auto result = engine.execute (code);
+        expect (result.wasOk(), result.getErrorMessage());
+
+        auto v = evaluate (engine, "result");
+        expect (v == expected && v.isString() == expected.isString(),
+                code + " -> " + v.toString() + " (expected " + expected.toString() + ")");
+    }
+
+    void expectError (const String& code, const String& expectedError)
+    {
+        JavascriptEngine engine;
+        auto result = engine.execute (code);
+        expect (result.failed() && result.getErrorMessage().contains (expectedError),
+                code + " -> " + result.getErrorMessage());
+    }
+
+    void runTest() override
+    {
+        beginTest ("Expressions");
+        {
+            expectResult ("result = 1 + 2 * 3 - 4 / 2;", 5.0);
+            expectResult ("result = 7 % 3 + (1 << 4) + (-16 >> 2) + (7 & 3) + (4 | 1) + (6 ^ 3);", 1 + 16 - 4 + 3 + 5 + 5);
+            expectResult ("result = -1 >>> 28;", 15);
+            expectResult ("result = 0.5 * 3;", 1.5);
+            expectResult ("result = 1 / 0 > 1.0e300;", true);
+            expectResult ("result = 'ab' + 'cd' + 1;", "abcd1");
+            expectResult ("result = 2 < 3 && 3 <= 3 && 4 > 3 && 4 >= 4 && 1 != 2 && !(1 == 2);", true);
+            expectResult ("result = (0 || 1) + (1 && 0) + (1 && 2);", 2);
+            expectResult ("result = 1 === 1.0;", false);
+            expectResult ("result = 1 !== '1';", true);
+            expectResult ("var x = 5; result = x > 3 ? 'big' : 'small';", "big");
+            expectResult ("var i = 5; var j = i++ + i; result = j * 100 + i;", 1106);
+            expectResult ("var i = 5; i += 3; i -= 1; i = i / 2; result = i;", 3.5);
+            expectResult ("result = typeof 1 + typeof 'a' + typeof {} + typeof undefined;", "numberstringobjectundefined");
+            expectResult ("result = undefined + undefined;", var::undefined());
+        }
+
+        beginTest ("Objects and arrays");
+        {
+            expectResult ("var o = { a: 1, b: { c: 2 } }; o.b.c += 5; o.d = 3; result = o.a + o.b.c + o.d + o['a'];", 12);
+            expectResult ("var a = [1, 2, 3]; a[5] = 6; result = a.length + a[5] + (a[3] === undefined ? 0 : 100);", 12);
+            expectResult ("var a = [1, 2]; result = typeof a[1] + typeof a[7];", "numbervoid");
+            expectResult ("var a = [3, 1, 2]; a.push (4); result = a.indexOf (4) + a.join ('-');", "33-1-2-4");
+            expectResult ("var s = 'hello'; result = s.length + s.substring (1, 3);", "5el");
+            expectResult ("var o = { n: 1 }; function inc (x) { x.n++; } inc (o); inc (o); result = o.n;", 3);
+        }
+
+        beginTest ("Control flow");
+        {
+            expectResult ("var t = 0; for (var i = 0; i < 10; ++i) { if (i == 3) continue; if (i == 7) break; t += i; } result = t;", 18);
+            expectResult ("var t = 0, i = 0; while (i < 5) t += i++; result = t;", 10);
+            expectResult ("var t = 0, i = 0; do { ++i; if (i == 2) continue; t += i; } while (i < 4); result = t;", 8);
+            expectResult ("var t = 0; for (var i = 0; i < 3; ++i) for (var j = 0; j < 3; ++j) { if (j == 1) break; t += 10; } result = t;", 30);
+            expectResult ("var t = 0; if (t) t = 1; else if (! t) t = 2; else t = 3; result = t;", 2);
+        }
+
+        beginTest ("Functions");
+        {
+            expectResult ("function fib (n) { return n < 2 ? n : fib (n - 1) + fib (n - 2); } result = fib (15);", 610);
+            expectResult ("function f (a, b) { return typeof b; } result = f (1);", "undefined");
+            expectResult ("function f() { for (var i = 0; i < 10; ++i) if (i == 4) return i * 10; } result = f();", 40);
+            expectResult ("function f() { var x = 1; } result = typeof f();", "void");
+            expectResult ("var g = function (x) { return x * 2; }; result = g (21);", 42);
+            expectResult ("var o = { v: 3, get: function() { return this.v; } }; result = o.get();", 3);
+            expectResult ("function Point (x) { this.x = x; } var p = new Point (4); result = p.x;", 4);
+            expectResult ("var proto = { k: function() { return 9; } }; var q = new proto(); result = q.k();", 9);
+            expectResult ("function outer() { var v = 'outer'; return inner(); } function inner() { return v; } result = outer();", "outer");
+            expectResult ("function setGlobal() { g = 7; } setGlobal(); result = g;", 7);
+            expectResult ("var n = 0; function f() { ++n; return 0; } var a = [1]; a[f()]++; result = n;", 3);
+            expectResult ("result = Math.max (3, 9) + Math.abs (-2) + Math.floor (2.7);", 13);
+        }
+
+        beginTest ("Errors");
+        {
+            expectError ("3 = 4;", "Cannot assign to this expression!");
+            expectError ("var s = 'x'; s.y = 2;", "Cannot assign to this expression!");
+            expectError ("var o = {}; o.nope();", "Unknown function 'nope'");
+            expectError ("var x = 1; x();", "This expression is not a function!");
+            expectError ("var x = [] * 2;", "is not allowed on the Array type");
+            expectError ("var x = (1;", "Found ';' when expecting ')'");
+        }
+
+        beginTest ("Native functions");
+        {
+            JavascriptEngine engine;
+            DynamicObject::Ptr native (new DynamicObject());
+            native->setMethod ("twice", [] (const var::NativeFunctionArgs& a) { return var ((int) a.arguments[0] * 2); });
+            engine.registerNativeObject ("Native", native.get());
+
+            expect (engine.execute ("function add (a, b) { return a + b; }").wasOk());
+            expect (evaluate (engine, "Native.twice (add (2, 3))") == var (10));
+
+            var args[] = { 4, 5 };
+            expect (engine.callFunction ("add", var::NativeFunctionArgs ({}, args, 2)) == var (9));
+        }
+
+        beginTest ("Timeouts");
+        {
+            JavascriptEngine engine;
+            engine.maximumExecutionTime = RelativeTime::milliseconds (50);
+            expect (engine.execute ("while (true) {}").getErrorMessage().contains ("Execution timed-out"));
+            expect (engine.execute ("var x = 1;").wasOk());
+
+            DynamicObject::Ptr native (new DynamicObject());
+            native->setMethod ("stop", [&engine] (const var::NativeFunctionArgs&) { engine.stop(); return var(); });
+            engine.registerNativeObject ("Native", native.get());
+            expect (engine.execute ("Native.stop(); for (;;) {}").getErrorMessage().contains ("Interrupted"));
+        }
+
+        beginTest ("Compiled scripts");
+        {
+            JavascriptEngine engine;
+            engine.maximumCachedScripts = 2;
+
+            auto script = engine.compile ("var n = typeof n == 'undefined' ? 1 : n + 1;");
+            expect (script != nullptr);
+
+            for (int i = 0; i < 10; ++i)
+                expect (engine.execute (*script).wasOk());
+
+            expect (evaluate (engine, "n") == var (10));
+            expect (engine.compile (script->getSourceCode()) == script);
+            expect (engine.execute (script->getSourceCode()).wasOk());
+            expect (evaluate (engine, "n") == var (11));
+
+            engine.compile ("var a = 1;");
+            engine.compile ("var b = 2;");
+            expect (engine.compile (script->getSourceCode()) != script);
+
+            auto other = engine.compile ("var c = 3;");
+            engine.clearCompiledScriptCache();
+            expect (engine.compile ("var c = 3;") != other);
+
+            Result result (Result::ok());
+            expect (engine.compile ("var x = ;", &result) == nullptr);
+            expect (result.failed());
+            expect (engine.execute ("var x = ;").failed());
+
+            // a script can be kept after the engine that compiled it has gone
+            JavascriptEngine::CompiledScript::Ptr orphan;
+
+            {
+                std::unique_ptr<JavascriptEngine> temporary (new JavascriptEngine());
+                orphan = temporary->compile ("var d = 4;");
+            }
+
+            expectEquals (orphan->getSourceCode(), String ("var d = 4;"));
+            expect (engine.compile ("var d = 4;") != orphan);
+        }
+
+        beginTest ("Execution limits");
+        {
+            JavascriptEngine engine;
+            engine.maximumInstructions = 1000;
+            expect (engine.execute ("var t = 0; for (var i = 0; i < 10; ++i) t += i;").wasOk());
+            expect (engine.execute ("for (;;) {}").getErrorMessage().contains ("instruction limit"));
+            expect (engine.execute ("var t = 0; for (var i = 0; i < 10; ++i) t += i;").wasOk());
+
+            int numInstructions = 0;
+
+            for (int limit = 1; numInstructions == 0; ++limit)
+            {
+                engine.maximumInstructions = limit;
+
+                if (engine.execute ("var t = 0; for (var i = 0; i < 100; ++i) t += i;").wasOk())
+                    numInstructions = limit;
+            }
+
+            engine.maximumInstructions = numInstructions - 1;
+            expect (engine.execute ("var t = 0; for (var i = 0; i < 100; ++i) t += i;").failed());
+
+            engine.maximumInstructions = 0;
+            engine.maximumCallDepth = 100;
+            expect (engine.execute ("function f (n) { return n > 0 ? f (n - 1) + 1 : 0; } var depth = f (99);").wasOk());
+            expect (evaluate (engine, "depth") == var (99));
+            expect (engine.execute ("f (100);").getErrorMessage().contains ("maximum call depth"));
+            expect (engine.execute ("function g() { return g(); } g();").getErrorMessage().contains ("maximum call depth"));
+            expect (evaluate (engine, "f (50)") == var (50));
+        }
+
+        beginTest ("Benchmark");
+        {
+            const char* const scripts[] =
+            {
+                "var s = 0; for (var i = 0; i < 100000; ++i) { s = (s + i * 3) % 1000003; }",
+                "var x = 0.5; for (var i = 0; i < 100000; ++i) { x = x * 0.999 + 0.25 / (i + 1); }",
+                "function fib (n) { if (n < 2) return n; return fib (n - 1) + fib (n - 2); } fib (20);",
+                "var o = { x: 1, y: 2, z: 0 }; for (var i = 0; i < 100000; ++i) { o.z = o.z + o.x * o.y; o.x = o.x + 1; }",
+                "var a = []; for (var i = 0; i < 20000; ++i) a.push (i); var t = 0; for (var j = 0; j < a.length; ++j) t += a[j];"
+            };
+
+            for (auto* script : scripts)
+            {
+                JavascriptEngine engine;
+                engine.maximumExecutionTime = RelativeTime::seconds (60);
+
+                auto start = Time::getMillisecondCounterHiRes();
+                auto result = engine.execute (script);
+                auto elapsed = Time::getMillisecondCounterHiRes() - start;
+
+                expect (result.wasOk(), result.getErrorMessage());
+                logMessage ("  " + String (elapsed, 2) + " ms: " + String (script).substring (0, 60));
+            }
+        }
+    }
+};
+
+static JavascriptEngineTests javascriptEngineTests;
+
+#endif
+
 } // namespace juce
@@ -37,6 +37,10 @@ namespace juce
     Variables that the script sets can be retrieved with evaluate(), and if you need to provide
     native objects for the script to use, you can add them with registerNativeObject().
 
+    Internally, each script and function is compiled into a compact list of instructions
+    which are run by a simple stack-based virtual machine, with numbers held unboxed while
+    they're being worked on.
+
     One caveat: Because the values and objects that the engine works with are DynamicObject
     and var objects, they use reference-counting rather than garbage-collection, so if your
     script creates complex connections between objects, you run the risk of creating cyclic
@@ -61,9 +65,67 @@ public:
         the result.
         You can specify a maximum time for which the program is allowed to run, and
         it'll return with an error message if this time is exceeded.
+        The compiled code is kept in the engine's cache (see compile()), so running the
+        same code again won't need it to be parsed again.
     */
     Result execute (const String& javascriptCode);
 
+    //==============================================================================
+    /** A block of javascript code which has been parsed and compiled by an engine, so
+        that it can be run any number of times without being parsed again.
+        A CompiledScript can only be run by the engine that created it, but it can
+        safely outlive that engine.
+        @see compile, execute
+    */
+    class JUCE_API  CompiledScript  : public ReferenceCountedObject
+    {
+    public:
+        /** Destructor. */
+        ~CompiledScript();
+
+        using Ptr = ReferenceCountedObjectPtr<CompiledScript>;
+
+        /** Returns the code that was compiled. */
+        const String& getSourceCode() const noexcept     { return sourceCode; }
+
+    private:
+        friend class JavascriptEngine;
+        struct Code;
+
+        CompiledScript (const String&, int64, Code*, uint32 ownerID);
+
+        String sourceCode;
+        int64 hash;
+        std::unique_ptr<Code> code;
+        const uint32 ownerID;
+
+        JUCE_DECLARE_NON_COPYABLE (CompiledScript)
+    };
+
+    /** Parses and compiles a block of javascript code, so that it can be run by execute().
+        The engine keeps the most recently compiled scripts in a cache, looked-up by the
+        hash of their code, so compiling code that's already in the cache just returns the
+        existing CompiledScript. If there's a syntax error, this returns nullptr, and the
+        error description is returned in the errorMessage parameter.
+        @see maximumCachedScripts
+    */
+    CompiledScript::Ptr compile (const String& javascriptCode, Result* errorMessage = nullptr);
+
+    /** Runs a block of code that was compiled by this engine's compile() method.
+        If there's an execution error, the error description is returned in the result.
+    */
+    Result execute (const CompiledScript& script);
+
+    /** Removes all the scripts from the engine's cache of compiled code. */
+    void clearCompiledScriptCache();
+
+    /** The number of compiled scripts that the engine keeps in its cache. When the cache
+        is full, the one that was used least recently is removed.
+    */
+    int maximumCachedScripts = 32;
+
+    //==============================================================================
+
     /** Attempts to parse and run a javascript expression, and returns the result.
         If there's a syntax error, or the expression can't be evaluated, the return value
         will be var::undefined(). The errorMessage parameter gives you a way to find out
@@ -105,6 +167,21 @@ public:
     */
     RelativeTime maximumExecutionTime;
 
+    /** The maximum number of virtual machine instructions that a call to one of the
+        evaluate methods is permitted to run before failing, or 0 for no limit.
+        Unlike maximumExecutionTime, this doesn't depend on how busy the machine is, so a
+        script that's too expensive will always fail at the same place, and it can be used
+        to put a strict bound on the time taken by scripts that run on time-critical threads.
+    */
+    int64 maximumInstructions = 0;
+
+    /** The maximum depth to which javascript functions may be called from each other, or 0
+        for no limit. Each nested call uses some memory on the native stack, so if scripts
+        might recurse without ending, it's a good idea to set this to a value that's small
+        enough to stay within the stack size of the thread that runs them.
+    */
+    int maximumCallDepth = 0;
+
     /** When called from another thread, causes the interpreter to time-out as soon as possible */
     void stop() noexcept;
 
@@ -114,7 +191,9 @@ public:
 private:
     JUCE_PUBLIC_IN_DLL_BUILD (struct RootObject)
     const ReferenceCountedObjectPtr<RootObject> root;
-    void prepareTimeout() const noexcept;
+    ReferenceCountedArray<CompiledScript> compiledScriptCache;
+    const uint32 engineID;
+    void prepareExecutionLimits() const noexcept;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JavascriptEngine)
 };
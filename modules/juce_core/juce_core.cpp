@@ -129,10 +129,14 @@
 #include "files/juce_FileSearchPath.cpp"
 #include "files/juce_TemporaryFile.cpp"
 #include "javascript/juce_JSON.cpp"
+#include "javascript/juce_JSONReader.cpp"
+#include "javascript/juce_JSONWriter.cpp"
+#include "javascript/juce_JSONDocument.cpp"
 #include "javascript/juce_Javascript.cpp"
 #include "containers/juce_DynamicObject.cpp"
 #include "logging/juce_FileLogger.cpp"
 #include "logging/juce_Logger.cpp"
+#include "logging/juce_RealtimeLogger.cpp"
 #include "maths/juce_BigInteger.cpp"
 #include "maths/juce_Expression.cpp"
 #include "maths/juce_Random.cpp"
@@ -151,6 +155,7 @@
 #include "streams/juce_MemoryInputStream.cpp"
 #include "streams/juce_MemoryOutputStream.cpp"
 #include "streams/juce_SubregionStream.cpp"
+#include "streams/juce_SlidingInputBuffer.cpp"
 #include "system/juce_SystemStats.cpp"
 #include "text/juce_CharacterFunctions.cpp"
 #include "text/juce_Identifier.cpp"
@@ -165,6 +170,7 @@
 #include "threads/juce_ReadWriteLock.cpp"
 #include "threads/juce_Thread.cpp"
 #include "threads/juce_ThreadPool.cpp"
+#include "threads/juce_ParallelAlgorithms.cpp"
 #include "threads/juce_TimeSliceThread.cpp"
 #include "time/juce_PerformanceCounter.cpp"
 #include "time/juce_RelativeTime.cpp"
@@ -172,11 +178,14 @@
 #include "unit_tests/juce_UnitTest.cpp"
 #include "xml/juce_XmlDocument.cpp"
 #include "xml/juce_XmlElement.cpp"
+#include "xml/juce_XmlReader.cpp"
+#include "xml/juce_CompactXmlDocument.cpp"
 #include "zip/juce_GZIPDecompressorInputStream.cpp"
 #include "zip/juce_GZIPCompressorOutputStream.cpp"
 #include "zip/juce_ZipFile.cpp"
 #include "files/juce_FileFilter.cpp"
 #include "files/juce_WildcardFileFilter.cpp"
+#include "files/juce_DirectoryScanner.cpp"
 
 //==============================================================================
 #if ! JUCE_WINDOWS
@@ -232,6 +241,7 @@
 //==============================================================================
 #if JUCE_UNIT_TESTS
 #include "containers/juce_HashMap_test.cpp"
+#include "containers/juce_LockFreeQueues_test.cpp"
 #endif
 
 //==============================================================================
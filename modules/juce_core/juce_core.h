@@ -219,6 +219,7 @@ namespace juce
 #include "memory/juce_LeakedObjectDetector.h"
 #include "memory/juce_ContainerDeletePolicy.h"
 #include "memory/juce_HeapBlock.h"
+#include "memory/juce_ArenaAllocator.h"
 #include "memory/juce_MemoryBlock.h"
 #include "memory/juce_ReferenceCountedObject.h"
 #include "memory/juce_ScopedPointer.h"
@@ -241,6 +242,8 @@ namespace juce
 #include "containers/juce_SortedSet.h"
 #include "containers/juce_SparseSet.h"
 #include "containers/juce_AbstractFifo.h"
+#include "containers/juce_SPSCQueue.h"
+#include "containers/juce_MPMCQueue.h"
 #include "text/juce_NewLine.h"
 #include "text/juce_StringPool.h"
 #include "text/juce_Identifier.h"
@@ -255,6 +258,7 @@ namespace juce
 #include "containers/juce_NamedValueSet.h"
 #include "containers/juce_DynamicObject.h"
 #include "containers/juce_HashMap.h"
+#include "containers/juce_FlatHashMap.h"
 #include "time/juce_RelativeTime.h"
 #include "time/juce_Time.h"
 #include "streams/juce_InputStream.h"
@@ -263,6 +267,7 @@ namespace juce
 #include "streams/juce_MemoryInputStream.h"
 #include "streams/juce_MemoryOutputStream.h"
 #include "streams/juce_SubregionStream.h"
+#include "streams/juce_SlidingInputBuffer.h"
 #include "streams/juce_InputSource.h"
 #include "files/juce_File.h"
 #include "files/juce_DirectoryIterator.h"
@@ -276,6 +281,9 @@ namespace juce
 #include "streams/juce_FileInputSource.h"
 #include "logging/juce_FileLogger.h"
 #include "javascript/juce_JSON.h"
+#include "javascript/juce_JSONReader.h"
+#include "javascript/juce_JSONWriter.h"
+#include "javascript/juce_JSONDocument.h"
 #include "javascript/juce_Javascript.h"
 #include "maths/juce_BigInteger.h"
 #include "maths/juce_Expression.h"
@@ -292,10 +300,12 @@ namespace juce
 #include "threads/juce_Thread.h"
 #include "threads/juce_ThreadLocalValue.h"
 #include "threads/juce_ThreadPool.h"
+#include "threads/juce_ParallelAlgorithms.h"
 #include "threads/juce_TimeSliceThread.h"
 #include "threads/juce_ReadWriteLock.h"
 #include "threads/juce_ScopedReadLock.h"
 #include "threads/juce_ScopedWriteLock.h"
+#include "logging/juce_RealtimeLogger.h"
 #include "network/juce_IPAddress.h"
 #include "network/juce_MACAddress.h"
 #include "network/juce_NamedPipe.h"
@@ -308,9 +318,12 @@ namespace juce
 #include "unit_tests/juce_UnitTest.h"
 #include "xml/juce_XmlDocument.h"
 #include "xml/juce_XmlElement.h"
+#include "xml/juce_XmlReader.h"
+#include "xml/juce_CompactXmlDocument.h"
 #include "zip/juce_GZIPCompressorOutputStream.h"
 #include "zip/juce_GZIPDecompressorInputStream.h"
 #include "zip/juce_ZipFile.h"
+#include "files/juce_DirectoryScanner.h"
 #include "containers/juce_PropertySet.h"
 #include "memory/juce_SharedResourcePointer.h"
 
@@ -27,6 +27,16 @@ namespace juce
 /**
     A simple implementation of a Logger that writes to a file.
 
+    Messages are written to the file by a background thread, so logMessage() only has
+    to add the message to a lock-free queue and can be called from many threads at
+    once without them blocking each other. The writer thread collects whatever messages
+    have arrived and writes them out as a single batch, either after a short delay or
+    when enough of them have built up - see setFlushPolicy(). Use flush() if you need
+    to be sure that everything has reached the file.
+
+    The logger can also keep the file below a given size by moving it aside and
+    starting a new one when it gets too big - see setMaximumFileSize().
+
     @see Logger
 
     @tags{Core}
@@ -49,7 +59,8 @@ public:
                                 at a new-line boundary. If this value is less than zero, no size limit
                                 will be imposed; if it's zero, the file will always be deleted. Note that
                                 the size is only checked once when this object is created - any logging
-                                that is done later will be appended without any checking
+                                that is done later will be appended without any checking, unless
+                                you also call setMaximumFileSize()
     */
     FileLogger (const File& fileToWriteTo,
                 const String& welcomeMessage,
@@ -62,6 +73,30 @@ public:
     /** Returns the file that this logger is writing to. */
     const File& getLogFile() const noexcept               { return logFile; }
 
+    /** Sets how the background thread batches up the messages that it writes.
+
+        @param maxDelayMilliseconds     the longest time that a message may wait in the queue
+                                        before the writer thread wakes up and writes it to the file.
+                                        Anything still in the queue when the app crashes is lost,
+                                        so keep this short if that matters to you
+        @param maxPendingMessages       the writer thread will also be woken as soon as this many
+                                        messages are waiting to be written
+    */
+    void setFlushPolicy (int maxDelayMilliseconds, int maxPendingMessages);
+
+    /** Makes the logger start a new file whenever the current one reaches a given size.
+
+        When the file grows beyond maxFileSizeBytes, it gets renamed to "name.1.ext", and
+        any older files are shuffled along to "name.2.ext", "name.3.ext", etc., keeping at
+        most maxNumOldFiles of them. A size of zero or less turns this off, which is the default.
+    */
+    void setMaximumFileSize (int64 maxFileSizeBytes, int maxNumOldFiles = 1);
+
+    /** Blocks until all the messages that were logged before this call have been
+        written to the file.
+    */
+    void flush();
+
     //==============================================================================
     /** Helper function to create a log file in the correct place for this platform.
 
@@ -125,7 +160,9 @@ public:
 private:
     //==============================================================================
     File logFile;
-    CriticalSection logLock;
+
+    struct Writer;
+    std::unique_ptr<Writer> writer;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FileLogger)
 };
@@ -85,6 +85,7 @@ protected:
     virtual void logMessage (const String& message) = 0;
 
 private:
+    friend class RealtimeLogger;
     static Logger* currentLogger;
 };
 
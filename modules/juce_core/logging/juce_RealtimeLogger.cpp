@@ -0,0 +1,307 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+RealtimeLogger::RealtimeLogger (Logger* dest, int pollIntervalMilliseconds)
+    : Thread ("RealtimeLogger"),
+      destination (dest),
+      pollInterval (jmax (1, pollIntervalMilliseconds)),
+      startTime (Time::getHighResolutionTicks())
+{
+    startThread();
+}
+
+RealtimeLogger::~RealtimeLogger()
+{
+    // All the channels must be deleted before the logger that they belong to!
+    jassert (channels.isEmpty());
+
+    stopThread (10000);
+    flush();
+}
+
+RealtimeLogger::Channel::Channel (RealtimeLogger& o, const String& channelName, int capacity)
+    : owner (o), name (channelName), queue (capacity)
+{
+    const ScopedLock sl (owner.lock);
+    owner.channels.add (this);
+}
+
+RealtimeLogger::Channel::~Channel()
+{
+    owner.collect (this);
+
+    const ScopedLock sl (owner.lock);
+    owner.channels.removeFirstMatchingValue (this);
+}
+
+//==============================================================================
+void RealtimeLogger::run()
+{
+    while (! threadShouldExit())
+    {
+        wait (pollInterval);
+        flush();
+    }
+}
+
+void RealtimeLogger::flush()
+{
+    collect (nullptr);
+}
+
+void RealtimeLogger::collect (Channel* channelToCollect)
+{
+    struct Item
+    {
+        const Channel* channel;
+        Record record;
+    };
+
+    const ScopedLock sl (lock);
+    Array<Item> items;
+    Record record;
+
+    for (auto* c : channels)
+    {
+        if (channelToCollect != nullptr && c != channelToCollect)
+            continue;
+
+        auto numDropped = c->numDropped.load();
+
+        if (numDropped != c->numDroppedReported)
+        {
+            write (*c, Time::getHighResolutionTicks(), String (numDropped - c->numDroppedReported) + " messages were dropped");
+
+            c->numDroppedReported = numDropped;
+        }
+
+        while (c->queue.pop (record))
+            items.add ({ c, record });
+    }
+
+    // Each channel's records are already in order, so a stable sort will keep them that way
+    std::stable_sort (items.begin(), items.end(),
+                      [] (const Item& a, const Item& b) { return a.record.time < b.record.time; });
+
+    for (auto& item : items)
+        write (*item.channel, item.record.time, formatMessage (item.record));
+}
+
+void RealtimeLogger::write (const Channel& channel, int64 time, const String& text)
+{
+    String message;
+    message << "[" << String (Time::highResolutionTicksToSeconds (time - startTime), 6) << "] ";
+
+    if (channel.name.isNotEmpty())
+        message << channel.name << ": ";
+
+    message << text;
+
+    if (destination != nullptr)
+        destination->logMessage (message);
+    else
+        Logger::writeToLog (message);
+}
+
+String RealtimeLogger::formatMessage (const Record& record)
+{
+    String result;
+    auto* start = record.format;
+    int argIndex = 0;
+
+    for (auto* p = start;; ++p)
+    {
+        if (*p == 0)
+        {
+            result += String (CharPointer_UTF8 (start), CharPointer_UTF8 (p));
+            return result;
+        }
+
+        if (p[0] == '{' && p[1] == '}' && argIndex < record.numArgs)
+        {
+            auto& arg = record.args[argIndex++];
+
+            result += String (CharPointer_UTF8 (start), CharPointer_UTF8 (p));
+            result += arg.isDouble ? String (arg.doubleValue) : String (arg.intValue);
+
+            start = ++p + 1;
+        }
+    }
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class RealtimeLoggerTests  : public UnitTest
+{
+public:
+    RealtimeLoggerTests() : UnitTest ("RealtimeLogger", "Logging") {}
+
+    struct TestLogger  : public Logger
+    {
+        void logMessage (const String& message) override
+        {
+            const ScopedLock sl (lock);
+            messages.add (message.fromFirstOccurrenceOf ("] ", false, false));
+        }
+
+        StringArray getMessages()
+        {
+            const ScopedLock sl (lock);
+            return messages;
+        }
+
+        CriticalSection lock;
+        StringArray messages;
+    };
+
+    struct Producer  : public Thread
+    {
+        Producer (RealtimeLogger& logger, int i)
+            : Thread ("RealtimeLogger test"), channel (logger, "thread " + String (i), 1024) {}
+
+        void run() override
+        {
+            for (int i = 0; i < 1000; ++i)
+            {
+                while (! channel.log ("message {}", i))
+                    Thread::yield();
+            }
+        }
+
+        RealtimeLogger::Channel channel;
+    };
+
+    void runTest() override
+    {
+        beginTest ("Formatting");
+        {
+            TestLogger testLogger;
+
+            {
+                RealtimeLogger logger (&testLogger, 100000);
+                RealtimeLogger::Channel channel (logger, "audio", 16);
+
+                expect (channel.log ("plain text"));
+                expect (channel.log ("{} {} {}", 1, -2.5, (uint8) 200));
+                expect (channel.log ("xrun: {} samples late {}", (int64) 12345678901234LL));
+                expect (channel.log ("{}{}", true, 0.125f));
+                logger.flush();
+            }
+
+            auto messages = testLogger.getMessages();
+            expectEquals (messages.size(), 4);
+            expectEquals (messages[0], String ("audio: plain text"));
+            expectEquals (messages[1], String ("audio: 1 -2.5 200"));
+            expectEquals (messages[2], String ("audio: xrun: 12345678901234 samples late {}"));
+            expectEquals (messages[3], String ("audio: 10.125"));
+        }
+
+        beginTest ("Dropped messages");
+        {
+            TestLogger testLogger;
+
+            {
+                RealtimeLogger logger (&testLogger, 100000);
+
+                {
+                    RealtimeLogger::Channel channel (logger, {}, 8);
+
+                    for (int i = 0; i < 20; ++i)
+                        channel.log ("{}", i);
+
+                    expectEquals (channel.getNumDropped(), 12);
+                }
+
+                expectEquals (testLogger.getMessages().size(), 9);
+            }
+
+            auto messages = testLogger.getMessages();
+            expectEquals (messages[0], String ("12 messages were dropped"));
+            expectEquals (messages[1], String ("0"));
+            expectEquals (messages[8], String ("7"));
+        }
+
+        beginTest ("Multiple channels");
+        {
+            TestLogger testLogger;
+
+            {
+                RealtimeLogger logger (&testLogger, 1);
+                OwnedArray<Producer> producers;
+
+                for (int i = 0; i < 4; ++i)
+                    producers.add (new Producer (logger, i));
+
+                for (auto* p : producers)
+                    p->startThread();
+
+                for (auto* p : producers)
+                    p->stopThread (-1);
+            }
+
+            auto messages = testLogger.getMessages();
+            expectEquals (messages.size(), 4000);
+
+            int nextIndex[4] = {};
+
+            for (auto& m : messages)
+            {
+                auto thread = m.fromFirstOccurrenceOf ("thread ", false, false).getIntValue();
+                expectEquals (m.fromLastOccurrenceOf (" ", false, false).getIntValue(), nextIndex[thread]++);
+            }
+        }
+
+        beginTest ("Performance");
+        {
+            TestLogger testLogger;
+            RealtimeLogger logger (&testLogger, 100000);
+            const int numMessages = 4096;
+
+            {
+                RealtimeLogger::Channel channel (logger, "audio", numMessages);
+
+                auto start = Time::getHighResolutionTicks();
+
+                for (int i = 0; i < numMessages; ++i)
+                    channel.log ("block {} took {} ms", i, 1.5);
+
+                auto elapsed = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+                expectEquals (channel.getNumDropped(), 0);
+
+                logMessage ("  " + String (elapsed * 1.0e9 / numMessages, 1) + " ns per message");
+            }
+
+            expectEquals (testLogger.getMessages().size(), numMessages);
+        }
+    }
+};
+
+static RealtimeLoggerTests realtimeLoggerTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,201 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Lets real-time threads log diagnostic messages without allocating or locking.
+
+    Each thread that wants to log gets its own RealtimeLogger::Channel, which holds a
+    fixed-size ring buffer of binary records. A record is just a pointer to a format
+    string plus a few numeric arguments, so posting one only involves copying a few
+    bytes into the buffer. A background thread collects the records from all the
+    channels every so often, puts them in time order, formats them into text and
+    passes them to a Logger.
+
+    The format string must be a string literal (or something else that will outlive the
+    logger) because only its address is stored. Each "{}" in it is replaced by the next
+    argument, and the arguments can be any integer or floating-point types.
+
+    E.g.
+    @code
+    RealtimeLogger rtLogger;                               // created on the message thread
+    RealtimeLogger::Channel audioLog (rtLogger, "audio");  // ..and so is this
+
+    void processBlock (AudioBuffer<float>& buffer, MidiBuffer&)
+    {
+        if (buffer.getNumSamples() > expectedBlockSize)
+            audioLog.log ("unexpected block size {} at sample {}", buffer.getNumSamples(), samplePosition);
+    }
+    @endcode
+
+    If a channel's buffer fills up, new records are dropped and the number of dropped
+    records is reported the next time the channel is collected.
+
+    @see Logger, FileLogger
+
+    @tags{Core}
+*/
+class JUCE_API  RealtimeLogger  : private Thread
+{
+public:
+    //==============================================================================
+    /** Creates a RealtimeLogger and starts its background thread.
+
+        @param destination              the logger that messages are sent to. If this is nullptr,
+                                        they'll be passed to Logger::writeToLog(). The logger must
+                                        stay alive for as long as this object does
+        @param pollIntervalMilliseconds how often the background thread looks for new records
+    */
+    explicit RealtimeLogger (Logger* destination = nullptr,
+                             int pollIntervalMilliseconds = 50);
+
+    /** Destructor. Any records that are still waiting will be written out before it returns,
+        but all the channels should have been deleted before this is called.
+    */
+    ~RealtimeLogger();
+
+    //==============================================================================
+    /** @internal */
+    struct Record
+    {
+        enum { maxNumArgs = 6 };
+
+        struct Arg
+        {
+            union
+            {
+                int64 intValue;
+                double doubleValue;
+            };
+
+            bool isDouble;
+        };
+
+        const char* format;
+        int64 time;
+        int numArgs;
+        Arg args[maxNumArgs];
+    };
+
+    //==============================================================================
+    /**
+        A source of log messages for a RealtimeLogger.
+
+        The channel must be created and deleted on a non-real-time thread, but in between,
+        one (and only one) thread at a time may call log() on it.
+    */
+    class JUCE_API  Channel
+    {
+    public:
+        /** Creates a channel that will hold up to the given number of records between
+            the times that the background thread collects them.
+            The name is used as a prefix for all the messages from this channel.
+        */
+        Channel (RealtimeLogger& owner, const String& name, int capacity = 256);
+
+        /** Destructor. Any records that are still waiting will be written out first. */
+        ~Channel();
+
+        /** Posts a message. This doesn't allocate, lock or make any system calls apart from
+            reading the high-resolution clock, so it's safe to use on the audio thread.
+
+            Returns false if the channel was full and the message has been dropped.
+        */
+        template <typename... Args>
+        bool log (const char* format, Args... args) noexcept
+        {
+            static_assert (sizeof... (args) <= Record::maxNumArgs, "Too many arguments for a real-time log message");
+
+            Record record;
+            record.format = format;
+            record.time = Time::getHighResolutionTicks();
+            record.numArgs = 0;
+            addArgs (record, args...);
+
+            if (queue.push (record))
+                return true;
+
+            numDropped.fetch_add (1, std::memory_order_relaxed);
+            return false;
+        }
+
+        /** Returns the total number of messages that have been dropped because the channel was full. */
+        int getNumDropped() const noexcept      { return (int) numDropped.load(); }
+
+    private:
+        friend class RealtimeLogger;
+
+        RealtimeLogger& owner;
+        const String name;
+        SPSCQueue<Record> queue;
+        std::atomic<uint32> numDropped { 0 };
+        uint32 numDroppedReported = 0;
+
+        static void addArgs (Record&) noexcept {}
+
+        template <typename Type, typename... OtherArgs>
+        static void addArgs (Record& record, Type arg, OtherArgs... otherArgs) noexcept
+        {
+            static_assert (std::is_arithmetic<Type>::value, "Only numbers can be passed to a real-time log message");
+
+            auto& a = record.args[record.numArgs++];
+            a.isDouble = std::is_floating_point<Type>::value;
+
+            if (a.isDouble)
+                a.doubleValue = static_cast<double> (arg);
+            else
+                a.intValue = static_cast<int64> (arg);
+
+            addArgs (record, otherArgs...);
+        }
+
+        JUCE_DECLARE_NON_COPYABLE (Channel)
+    };
+
+    //==============================================================================
+    /** Collects and writes out any waiting records on the calling thread, rather than
+        waiting for the background thread to do it.
+    */
+    void flush();
+
+    /** Returns the text that a record's format string and arguments produce. */
+    static String formatMessage (const Record& record);
+
+private:
+    //==============================================================================
+    Logger* const destination;
+    const int pollInterval;
+    const int64 startTime;
+    CriticalSection lock;
+    Array<Channel*> channels;
+
+    void run() override;
+    void collect (Channel*);
+    void write (const Channel&, int64 time, const String& text);
+
+    JUCE_DECLARE_NON_COPYABLE (RealtimeLogger)
+};
+
+} // namespace juce
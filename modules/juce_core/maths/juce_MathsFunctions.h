@@ -278,12 +278,12 @@ void ignoreUnused (Types&&...) noexcept {}
     int numElements = numElementsInArray (myArray) // returns 3
     @endcode
 */
-template <typename Type, int N>
+template <typename Type, size_t N>
 int numElementsInArray (Type (&array)[N])
 {
     (void) array;
     (void) sizeof (0[array]); // This line should cause an error if you pass an object with a user-defined subscript operator
-    return N;
+    return (int) N;
 }
 
 //==============================================================================
@@ -545,6 +545,23 @@ inline int nextPowerOfTwo (int n) noexcept
 */
 int findHighestSetBit (uint32 n) noexcept;
 
+/** Returns the index of the lowest set bit in a (non-zero) number.
+    So for n=12 this would return 2, for n=1 it returns 0, etc.
+    An input value of 0 is illegal!
+*/
+inline int findLowestSetBit (uint32 n) noexcept
+{
+    jassert (n != 0);
+
+   #if JUCE_MSVC
+    unsigned long index;
+    _BitScanForward (&index, n);
+    return (int) index;
+   #else
+    return __builtin_ctz (n);
+   #endif
+}
+
 /** Returns the number of bits in a 32-bit integer. */
 inline int countNumberOfBits (uint32 n) noexcept
 {
@@ -0,0 +1,162 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A simple bump-pointer allocator which hands out memory from a list of large
+    blocks, and frees it all in one go.
+
+    This is useful for building big read-only structures such as document trees,
+    where allocating each node separately would spend most of the time inside
+    malloc, and would scatter the nodes all over the heap.
+
+    Nothing that's allocated can be freed individually, and no destructors are
+    called, so it should only be used for trivially-destructible types.
+
+    This class isn't thread-safe.
+
+    @tags{Core}
+*/
+class JUCE_API  ArenaAllocator
+{
+public:
+    //==============================================================================
+    /** Creates an arena which will allocate its memory in blocks of the given size.
+        Allocations that are bigger than a quarter of this size get a block of their own.
+    */
+    explicit ArenaAllocator (size_t blockSizeToUse = 32768) noexcept
+        : blockSize (jmax ((size_t) 256, blockSizeToUse))
+    {
+    }
+
+    /** Destructor. This frees all the memory that was handed out. */
+    ~ArenaAllocator() noexcept
+    {
+        clear();
+    }
+
+    //==============================================================================
+    /** Returns a block of uninitialised memory with the given size and alignment. */
+    void* allocate (size_t numBytes, size_t alignment = alignof (double))
+    {
+        jassert (isPowerOfTwo (alignment) && alignment <= maxAlignment);
+
+        auto address = (reinterpret_cast<pointer_sized_uint> (next) + (alignment - 1)) & ~(pointer_sized_uint) (alignment - 1);
+
+        if (next != nullptr && address + numBytes <= reinterpret_cast<pointer_sized_uint> (end))
+        {
+            next = reinterpret_cast<char*> (address + numBytes);
+            return reinterpret_cast<void*> (address);
+        }
+
+        return allocateFromNewBlock (numBytes);
+    }
+
+    /** Returns space for an array of objects.
+        The memory is left uninitialised, and no destructors will be called for it.
+    */
+    template <typename ObjectType>
+    ObjectType* allocateArray (size_t numObjects)
+    {
+        static_assert (std::is_trivially_destructible<ObjectType>::value,
+                       "Objects in an ArenaAllocator never have their destructors called");
+
+        return static_cast<ObjectType*> (allocate (numObjects * sizeof (ObjectType), alignof (ObjectType)));
+    }
+
+    /** Makes a null-terminated copy of some bytes of text. */
+    char* copyString (const char* text, size_t numBytes)
+    {
+        auto* copy = static_cast<char*> (allocate (numBytes + 1, 1));
+        memcpy (copy, text, numBytes);
+        copy[numBytes] = 0;
+        return copy;
+    }
+
+    /** Frees all the memory that has been allocated. */
+    void clear() noexcept
+    {
+        while (auto* b = firstBlock)
+        {
+            firstBlock = b->previous;
+            std::free (b);
+        }
+
+        next = end = nullptr;
+        totalBytes = 0;
+    }
+
+    /** Returns the total number of bytes that the arena has taken from the heap. */
+    size_t getTotalSize() const noexcept        { return totalBytes; }
+
+private:
+    //==============================================================================
+    struct Block
+    {
+        Block* previous;
+    };
+
+    enum { maxAlignment = 16 };
+
+    static size_t getHeaderSize() noexcept      { return (sizeof (Block) + maxAlignment - 1) & ~(size_t) (maxAlignment - 1); }
+
+    void* allocateFromNewBlock (size_t numBytes)
+    {
+        const bool needsOwnBlock = numBytes > blockSize / 4;
+        auto size = getHeaderSize() + (needsOwnBlock ? numBytes : blockSize);
+        auto* b = static_cast<Block*> (std::malloc (size));
+
+       #if ! JUCE_EXCEPTIONS_DISABLED
+        if (b == nullptr)
+            throw std::bad_alloc();
+       #endif
+
+        totalBytes += size;
+        auto* data = reinterpret_cast<char*> (b) + getHeaderSize();
+
+        if (needsOwnBlock && firstBlock != nullptr)
+        {
+            // keep filling the current block, as it may still have plenty of space
+            b->previous = firstBlock->previous;
+            firstBlock->previous = b;
+            return data;
+        }
+
+        b->previous = firstBlock;
+        firstBlock = b;
+        next = data + numBytes;
+        end = data + (size - getHeaderSize());
+        return data;
+    }
+
+    Block* firstBlock = nullptr;
+    char* next = nullptr;
+    char* end = nullptr;
+    size_t blockSize, totalBytes = 0;
+
+    JUCE_DECLARE_NON_COPYABLE (ArenaAllocator)
+};
+
+} // namespace juce
@@ -227,6 +227,7 @@
  #include <sys/ptrace.h>
  #include <sys/socket.h>
  #include <sys/stat.h>
+ #include <sys/syscall.h>
  #include <sys/sysinfo.h>
  #include <sys/time.h>
  #include <sys/types.h>
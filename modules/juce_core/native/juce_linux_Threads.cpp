@@ -56,6 +56,213 @@ static bool swapUserAndEffectiveUser()
     return result1 == 0 && result2 == 0;
 }
 
+//==============================================================================
+namespace LinuxRealtimeHelpers
+{
+    // The kernel's policy number for SCHED_DEADLINE, which older headers don't define
+    static const int schedDeadline = 6;
+
+    // glibc doesn't have a wrapper for sched_setattr, so this mirrors the kernel's struct
+    struct SchedAttr
+    {
+        uint32 size, policy;
+        uint64 flags;
+        int32 nice;
+        uint32 priority;
+        uint64 runtime, deadline, period;
+    };
+
+    static int getMaxPermittedPriority()
+    {
+        auto maxPriority = sched_get_priority_max (SCHED_FIFO);
+
+        if (geteuid() == 0)
+            return maxPriority;
+
+        rlimit limit;
+
+        if (getrlimit (RLIMIT_RTPRIO, &limit) != 0)
+            return 0;
+
+        if (limit.rlim_cur == RLIM_INFINITY)
+            return maxPriority;
+
+        return (int) jmin ((rlim_t) maxPriority, limit.rlim_cur);
+    }
+
+    static String getErrorDescription (int error)
+    {
+        return String (strerror (error));
+    }
+}
+
+Thread::RealtimeStatus JUCE_CALLTYPE Thread::setCurrentThreadToRealtime (const RealtimeOptions& options)
+{
+    using namespace LinuxRealtimeHelpers;
+    StringArray problems;
+
+    if (options.policy == RealtimeOptions::Policy::fifo || options.policy == RealtimeOptions::Policy::roundRobin)
+    {
+        auto policy = options.policy == RealtimeOptions::Policy::fifo ? SCHED_FIFO : SCHED_RR;
+        auto requestedPriority = jlimit (sched_get_priority_min (policy), sched_get_priority_max (policy), options.priority);
+        auto maxPermittedPriority = getMaxPermittedPriority();
+
+        sched_param param;
+        zerostruct (param);
+        param.sched_priority = requestedPriority;
+        auto result = pthread_setschedparam (pthread_self(), policy, &param);
+
+        if (result == EPERM && maxPermittedPriority > 0 && maxPermittedPriority < requestedPriority)
+        {
+            param.sched_priority = maxPermittedPriority;
+            result = pthread_setschedparam (pthread_self(), policy, &param);
+
+            if (result == 0)
+                problems.add ("The priority was reduced from " + String (requestedPriority) + " to "
+                                + String (maxPermittedPriority) + " by the RLIMIT_RTPRIO limit");
+        }
+
+        if (result == EPERM && maxPermittedPriority == 0)
+            problems.add ("Real-time scheduling isn't permitted - add an rtprio entry for this user to "
+                          "/etc/security/limits.conf, or give the process the CAP_SYS_NICE capability");
+        else if (result != 0)
+            problems.add ("Couldn't set the scheduling policy: " + getErrorDescription (result));
+    }
+    else if (options.policy == RealtimeOptions::Policy::deadline)
+    {
+       #ifdef SYS_sched_setattr
+        SchedAttr attr;
+        zerostruct (attr);
+        attr.size     = sizeof (attr);
+        attr.policy   = (uint32) schedDeadline;
+        attr.runtime  = (uint64) options.runtimeNanoseconds;
+        attr.period   = (uint64) options.periodNanoseconds;
+        attr.deadline = (uint64) (options.deadlineNanoseconds > 0 ? options.deadlineNanoseconds
+                                                                  : options.periodNanoseconds);
+
+        if (syscall (SYS_sched_setattr, 0, &attr, 0) != 0)
+        {
+            auto error = errno;
+
+            if (error == EBUSY)
+                problems.add ("SCHED_DEADLINE was refused, as there isn't enough CPU bandwidth left for this runtime and period");
+            else if (error == EINVAL)
+                problems.add ("SCHED_DEADLINE needs a runtime that's no longer than the deadline, which must be no longer than the period");
+            else
+                problems.add ("Couldn't use SCHED_DEADLINE: " + getErrorDescription (error));
+        }
+       #else
+        problems.add ("SCHED_DEADLINE isn't supported by this build");
+       #endif
+    }
+
+    if (! options.cpus.isEmpty())
+    {
+        cpu_set_t cpuSet;
+        CPU_ZERO (&cpuSet);
+
+        for (auto cpu : options.cpus)
+        {
+            if (isPositiveAndBelow (cpu, CPU_SETSIZE))
+                CPU_SET ((size_t) cpu, &cpuSet);
+            else
+                problems.add ("CPU " + String (cpu) + " is out of range");
+        }
+
+        auto result = pthread_setaffinity_np (pthread_self(), sizeof (cpuSet), &cpuSet);
+
+        if (result != 0)
+            problems.add ("Couldn't set the CPU affinity: " + getErrorDescription (result));
+    }
+
+    if (options.lockMemory && mlockall (MCL_CURRENT | MCL_FUTURE) != 0)
+    {
+        auto error = errno;
+        String problem ("Couldn't lock the process's memory: " + getErrorDescription (error));
+        rlimit limit;
+
+        if (getrlimit (RLIMIT_MEMLOCK, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY)
+            problem << " (RLIMIT_MEMLOCK is " << (int64) (limit.rlim_cur / 1024) << " KB)";
+
+        problems.add (problem);
+    }
+
+    size_t stackBytesPrefaulted = options.stackBytesToPrefault;
+
+    if (stackBytesPrefaulted > 0)
+    {
+        pthread_attr_t attr;
+
+        if (pthread_getattr_np (pthread_self(), &attr) == 0)
+        {
+            void* stackStart = nullptr;
+            size_t stackSize = 0;
+
+            if (pthread_attr_getstack (&attr, &stackStart, &stackSize) == 0)
+            {
+                // the stack grows downwards, so this is how much of it is already in use,
+                // and a margin is left for the functions that the thread will call
+                auto bytesInUse = (size_t) (static_cast<char*> (stackStart) + stackSize - reinterpret_cast<char*> (&attr));
+                auto margin = (size_t) 65536;
+                auto bytesAvailable = stackSize > bytesInUse + margin ? stackSize - bytesInUse - margin : 0;
+
+                if (stackBytesPrefaulted > bytesAvailable)
+                {
+                    problems.add ("Only " + String ((int64) bytesAvailable) + " bytes of the stack could be prefaulted");
+                    stackBytesPrefaulted = bytesAvailable;
+                }
+            }
+
+            pthread_attr_destroy (&attr);
+        }
+
+        if (stackBytesPrefaulted > 0)
+            prefaultThreadStack (stackBytesPrefaulted);
+    }
+
+    auto status = getCurrentThreadRealtimeStatus();
+    status.stackBytesPrefaulted = stackBytesPrefaulted;
+    status.problems = problems;
+    return status;
+}
+
+Thread::RealtimeStatus JUCE_CALLTYPE Thread::getCurrentThreadRealtimeStatus()
+{
+    RealtimeStatus status;
+    int policy = SCHED_OTHER;
+    sched_param param;
+
+    if (pthread_getschedparam (pthread_self(), &policy, &param) == 0)
+    {
+        if (policy == SCHED_FIFO || policy == SCHED_RR)
+        {
+            status.policy = policy == SCHED_FIFO ? RealtimeOptions::Policy::fifo
+                                                 : RealtimeOptions::Policy::roundRobin;
+            status.priority = param.sched_priority;
+        }
+        else if (policy == LinuxRealtimeHelpers::schedDeadline)
+        {
+            status.policy = RealtimeOptions::Policy::deadline;
+        }
+    }
+
+    status.maxPermittedPriority = LinuxRealtimeHelpers::getMaxPermittedPriority();
+
+    cpu_set_t cpuSet;
+    CPU_ZERO (&cpuSet);
+
+    if (pthread_getaffinity_np (pthread_self(), sizeof (cpuSet), &cpuSet) == 0)
+        for (size_t i = 0; i < CPU_SETSIZE; ++i)
+            if (CPU_ISSET (i, &cpuSet))
+                status.cpus.add ((int) i);
+
+    for (auto& line : StringArray::fromLines (File ("/proc/self/status").loadFileAsString()))
+        if (line.startsWith ("VmLck:"))
+            status.memoryLocked = line.fromFirstOccurrenceOf (":", false, false).getLargeIntValue() > 0;
+
+    return status;
+}
+
 JUCE_API void JUCE_CALLTYPE Process::raisePrivilege()  { if (geteuid() != 0 && getuid() == 0) swapUserAndEffectiveUser(); }
 JUCE_API void JUCE_CALLTYPE Process::lowerPrivilege()  { if (geteuid() == 0 && getuid() != 0) swapUserAndEffectiveUser(); }
 
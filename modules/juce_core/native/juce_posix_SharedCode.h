@@ -245,10 +245,12 @@ namespace
 {
    #if JUCE_LINUX || (JUCE_IOS && ! __DARWIN_ONLY_64_BIT_INO_T) // (this iOS stuff is to avoid a simulator bug)
     using juce_statStruct = struct stat64;
-    #define JUCE_STAT  stat64
+    #define JUCE_STAT    stat64
+    #define JUCE_FSTATAT fstatat64
    #else
     using juce_statStruct = struct stat;
-    #define JUCE_STAT  stat
+    #define JUCE_STAT    stat
+    #define JUCE_FSTATAT fstatat
    #endif
 
     bool juce_stat (const String& fileName, juce_statStruct& info)
@@ -463,6 +465,91 @@ Result File::createDirectoryInternal (const String& fileName) const
     return getResultForReturnValue (mkdir (fileName.toUTF8(), 0777));
 }
 
+//==============================================================================
+class DirectoryScanner::NativeFolderReader::Pimpl
+{
+public:
+    Pimpl (const String& folderPath)
+    {
+        auto fd = open (folderPath.toUTF8(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+        if (fd >= 0)
+        {
+            dir = fdopendir (fd);
+
+            if (dir == nullptr)
+                close (fd);
+        }
+    }
+
+    ~Pimpl()
+    {
+        if (dir != nullptr)
+            closedir (dir); // (this also closes the file descriptor)
+    }
+
+    bool next (String& filenameFound, DirectoryScanner::Entry& entry)
+    {
+        if (dir == nullptr)
+            return false;
+
+        for (;;)
+        {
+            auto* de = readdir (dir);
+
+            if (de == nullptr)
+                return false;
+
+            auto* name = de->d_name;
+
+            if (name[0] == '.' && (name[1] == 0 || (name[1] == '.' && name[2] == 0)))
+                continue;
+
+            filenameFound = CharPointer_UTF8 (name);
+
+            // The details are read relative to the directory that's already open, so the
+            // file system doesn't have to look up the whole path again for each file.
+            juce_statStruct info;
+            auto statOk = JUCE_FSTATAT (dirfd (dir), name, &info, 0) == 0;
+
+            if (de->d_type == DT_UNKNOWN)
+            {
+                juce_statStruct linkInfo;
+                entry.isSymbolicLink = JUCE_FSTATAT (dirfd (dir), name, &linkInfo, AT_SYMLINK_NOFOLLOW) == 0
+                                         && S_ISLNK (linkInfo.st_mode);
+            }
+            else
+            {
+                entry.isSymbolicLink = (de->d_type == DT_LNK);
+            }
+
+            entry.isDirectory      = statOk && S_ISDIR (info.st_mode);
+            entry.isHidden         = (name[0] == '.');
+            entry.fileSize         = statOk ? (int64) info.st_size : 0;
+            entry.modificationTime = Time (statOk ? (int64) info.st_mtime  * 1000 : 0);
+            entry.creationTime     = Time (statOk ? getCreationTime (info) * 1000 : 0);
+            return true;
+        }
+    }
+
+private:
+    DIR* dir = nullptr;
+
+    JUCE_DECLARE_NON_COPYABLE (Pimpl)
+};
+
+DirectoryScanner::NativeFolderReader::NativeFolderReader (const String& folderPath)
+    : pimpl (new DirectoryScanner::NativeFolderReader::Pimpl (folderPath))
+{
+}
+
+DirectoryScanner::NativeFolderReader::~NativeFolderReader() {}
+
+bool DirectoryScanner::NativeFolderReader::next (String& filenameFound, Entry& entry)
+{
+    return pimpl->next (filenameFound, entry);
+}
+
 //==============================================================================
 int64 juce_fileSetPosition (void* handle, int64 pos)
 {
@@ -1049,16 +1136,9 @@ void JUCE_CALLTYPE Thread::yield()
  #define SUPPORT_AFFINITIES 1
 #endif
 
-void JUCE_CALLTYPE Thread::setCurrentThreadAffinityMask (uint32 affinityMask)
+#if SUPPORT_AFFINITIES
+static void setCurrentThreadAffinity (const cpu_set_t& affinity)
 {
-   #if SUPPORT_AFFINITIES
-    cpu_set_t affinity;
-    CPU_ZERO (&affinity);
-
-    for (int i = 0; i < 32; ++i)
-        if ((affinityMask & (1 << i)) != 0)
-            CPU_SET (i, &affinity);
-
    #if (! JUCE_ANDROID) && ((! JUCE_LINUX) || ((__GLIBC__ * 1000 + __GLIBC_MINOR__) >= 2004))
     pthread_setaffinity_np (pthread_self(), sizeof (cpu_set_t), &affinity);
    #elif JUCE_ANDROID
@@ -1071,6 +1151,20 @@ void JUCE_CALLTYPE Thread::setCurrentThreadAffinityMask (uint32 affinityMask)
    #endif
 
     sched_yield();
+}
+#endif
+
+void JUCE_CALLTYPE Thread::setCurrentThreadAffinityMask (uint32 affinityMask)
+{
+   #if SUPPORT_AFFINITIES
+    cpu_set_t affinity;
+    CPU_ZERO (&affinity);
+
+    for (int i = 0; i < 32; ++i)
+        if ((affinityMask & (1 << i)) != 0)
+            CPU_SET ((size_t) i, &affinity);
+
+    setCurrentThreadAffinity (affinity);
 
    #else
     // affinities aren't supported because either the appropriate header files weren't found,
@@ -1080,6 +1174,20 @@ void JUCE_CALLTYPE Thread::setCurrentThreadAffinityMask (uint32 affinityMask)
    #endif
 }
 
+// Lets the calling thread run on any of the CPUs, however many there are
+void juce_clearCurrentThreadAffinity()
+{
+   #if SUPPORT_AFFINITIES
+    cpu_set_t affinity;
+    CPU_ZERO (&affinity);
+
+    for (size_t i = 0; i < CPU_SETSIZE; ++i)
+        CPU_SET (i, &affinity);
+
+    setCurrentThreadAffinity (affinity);
+   #endif
+}
+
 //==============================================================================
 bool DynamicLibrary::open (const String& name)
 {
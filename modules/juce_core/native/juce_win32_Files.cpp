@@ -933,6 +933,81 @@ bool DirectoryIterator::NativeIterator::next (String& filenameFound,
     return pimpl->next (filenameFound, isDir, isHidden, fileSize, modTime, creationTime, isReadOnly);
 }
 
+//==============================================================================
+class DirectoryScanner::NativeFolderReader::Pimpl
+{
+public:
+    Pimpl (const String& folderPath)  : searchPath (folderPath + "*")
+    {
+    }
+
+    ~Pimpl()
+    {
+        if (handle != INVALID_HANDLE_VALUE)
+            FindClose (handle);
+    }
+
+    bool next (String& filenameFound, DirectoryScanner::Entry& entry)
+    {
+        using namespace WindowsFileHelpers;
+        WIN32_FIND_DATA findData;
+
+        for (;;)
+        {
+            if (handle == INVALID_HANDLE_VALUE)
+            {
+                // (the basic info level skips the short 8.3 names, and the large fetch
+                // flag lets each call get more of the directory at once)
+                handle = FindFirstFileEx (searchPath.toWideCharPointer(), FindExInfoBasic, &findData,
+                                          FindExSearchNameMatch, nullptr, FIND_FIRST_EX_LARGE_FETCH);
+
+                if (handle == INVALID_HANDLE_VALUE)
+                    return false;
+            }
+            else
+            {
+                if (FindNextFile (handle, &findData) == 0)
+                    return false;
+            }
+
+            auto* name = findData.cFileName;
+
+            if (! (name[0] == '.' && (name[1] == 0 || (name[1] == '.' && name[2] == 0))))
+                break;
+        }
+
+        filenameFound = findData.cFileName;
+
+        entry.isDirectory      = ((findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0);
+        entry.isHidden         = ((findData.dwFileAttributes & FILE_ATTRIBUTE_HIDDEN) != 0);
+        entry.isSymbolicLink   = ((findData.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0);
+        entry.fileSize         = findData.nFileSizeLow + (((int64) findData.nFileSizeHigh) << 32);
+        entry.modificationTime = Time (fileTimeToTime (&findData.ftLastWriteTime));
+        entry.creationTime     = Time (fileTimeToTime (&findData.ftCreationTime));
+        return true;
+    }
+
+private:
+    const String searchPath;
+    HANDLE handle = INVALID_HANDLE_VALUE;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Pimpl)
+};
+
+DirectoryScanner::NativeFolderReader::NativeFolderReader (const String& folderPath)
+    : pimpl (new DirectoryScanner::NativeFolderReader::Pimpl (folderPath))
+{
+}
+
+DirectoryScanner::NativeFolderReader::~NativeFolderReader()
+{
+}
+
+bool DirectoryScanner::NativeFolderReader::next (String& filenameFound, Entry& entry)
+{
+    return pimpl->next (filenameFound, entry);
+}
+
 
 //==============================================================================
 bool JUCE_CALLTYPE Process::openDocument (const String& fileName, const String& parameters)
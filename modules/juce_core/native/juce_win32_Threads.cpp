@@ -157,6 +157,15 @@ void JUCE_CALLTYPE Thread::setCurrentThreadAffinityMask (const uint32 affinityMa
     SetThreadAffinityMask (GetCurrentThread(), affinityMask);
 }
 
+// Lets the calling thread run on any of the CPUs that the process can use
+void juce_clearCurrentThreadAffinity()
+{
+    DWORD_PTR processMask, systemMask;
+
+    if (GetProcessAffinityMask (GetCurrentProcess(), &processMask, &systemMask))
+        SetThreadAffinityMask (GetCurrentThread(), processMask);
+}
+
 //==============================================================================
 struct SleepEvent
 {
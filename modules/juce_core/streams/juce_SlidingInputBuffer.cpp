@@ -0,0 +1,79 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+SlidingInputBuffer::SlidingInputBuffer (const void* sourceData, size_t numBytes) noexcept
+    : data (static_cast<const char*> (sourceData)), numBytesAvailable (numBytes)
+{
+}
+
+SlidingInputBuffer::SlidingInputBuffer (InputStream& source, size_t initialBufferSize)
+    : numBytesAvailable (0),
+      stream (&source),
+      streamBuffer (jmax ((size_t) 16, initialBufferSize)),
+      bufferSize (jmax ((size_t) 16, initialBufferSize))
+{
+    data = streamBuffer;
+}
+
+SlidingInputBuffer::~SlidingInputBuffer() {}
+
+bool SlidingInputBuffer::ensureAvailable (size_t numBytesNeeded)
+{
+    while (numBytesAvailable - position < numBytesNeeded)
+    {
+        if (stream == nullptr)
+            return false;
+
+        auto numLeft = numBytesAvailable - position;
+
+        if (position > 0)
+        {
+            memmove (streamBuffer, streamBuffer + position, numLeft);
+            bytesBeforeBuffer += (int64) position;
+            position = 0;
+            numBytesAvailable = numLeft;
+        }
+
+        if (numBytesAvailable == bufferSize)
+        {
+            // a single item is bigger than the buffer, so it'll have to grow
+            bufferSize *= 2;
+            streamBuffer.realloc (bufferSize);
+            data = streamBuffer;
+        }
+
+        auto numRead = stream->read (streamBuffer + numBytesAvailable,
+                                     (int) jmin (bufferSize - numBytesAvailable, (size_t) std::numeric_limits<int>::max()));
+
+        if (numRead <= 0)
+            return false;
+
+        numBytesAvailable += (size_t) numRead;
+    }
+
+    return true;
+}
+
+} // namespace juce
@@ -0,0 +1,77 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    The source text for an incremental parser such as JSONReader or XmlReader.
+
+    The text can either be a block of memory, or be pulled from an InputStream through
+    a buffer which slides along the stream, and which only grows if a single item turns
+    out to be bigger than it. Parsers derive from this and read data[position] onwards,
+    calling ensureAvailable() whenever they need to look further ahead.
+
+    @see JSONReader, XmlReader
+
+    @tags{Core}
+*/
+class JUCE_API  SlidingInputBuffer
+{
+protected:
+    //==============================================================================
+    /** Uses a block of memory, which must remain valid while the buffer is in use. */
+    SlidingInputBuffer (const void* sourceData, size_t numBytes) noexcept;
+
+    /** Reads from a stream, which must remain valid while the buffer is in use. */
+    SlidingInputBuffer (InputStream& source, size_t initialBufferSize);
+
+    /** Destructor. */
+    ~SlidingInputBuffer();
+
+    //==============================================================================
+    /** Makes sure that at least the given number of bytes are available in data from
+        the current position onwards, moving the unread bytes to the start of the buffer
+        and reading more from the stream if necessary.
+
+        This may change data, position and bytesBeforeBuffer, so any pointers into the
+        buffer must be recalculated afterwards.
+
+        @returns false if the end of the input is reached first
+    */
+    bool ensureAvailable (size_t numBytesNeeded);
+
+    const char* data;
+    size_t position = 0, numBytesAvailable;
+    int64 bytesBeforeBuffer = 0;
+
+private:
+    //==============================================================================
+    InputStream* stream = nullptr;
+    HeapBlock<char> streamBuffer;
+    size_t bufferSize = 0;
+
+    JUCE_DECLARE_NON_COPYABLE (SlidingInputBuffer)
+};
+
+} // namespace juce
@@ -269,6 +269,33 @@ public:
         return count;
     }
 
+    /** Returns the number of bytes that would be needed to represent the given
+        UTF-8 string in this encoding format.
+        The value returned does NOT include the terminating null character.
+    */
+    static size_t getBytesRequiredFor (CharPointer_UTF8 text) noexcept
+    {
+        auto* end = text.findTerminatingNull().getAddress();
+        size_t count = 0;
+
+        for (;;)
+        {
+            auto* s = text.getAddress();
+            auto* endOfRun = CharPointer_UTF8::findEndOfASCII (s, (size_t) (end - s));
+            count += sizeof (CharType) * (size_t) (endOfRun - s);
+
+            text = CharPointer_UTF8 (endOfRun);
+            auto n = text.getAndAdvance();
+
+            if (n == 0)
+                break;
+
+            count += getBytesRequiredFor (n);
+        }
+
+        return count;
+    }
+
     /** Returns a pointer to the null character that terminates this string. */
     CharPointer_UTF16 findTerminatingNull() const noexcept
     {
@@ -287,6 +314,33 @@ public:
         CharacterFunctions::copyAll (*this, src);
     }
 
+    /** Copies a source string to this pointer, advancing this pointer as it goes.
+        Runs of ASCII in the source are widened without being decoded character by character.
+    */
+    void writeAll (CharPointer_UTF8 src) noexcept
+    {
+        auto* end = src.findTerminatingNull().getAddress();
+
+        for (;;)
+        {
+            auto* s = src.getAddress();
+            auto* endOfRun = CharPointer_UTF8::findEndOfASCII (s, (size_t) (end - s));
+
+            while (s != endOfRun)
+                *data++ = (CharType) (uint8) *s++;
+
+            src = CharPointer_UTF8 (endOfRun);
+            auto c = src.getAndAdvance();
+
+            if (c == 0)
+                break;
+
+            write (c);
+        }
+
+        *data = 0;
+    }
+
     /** Copies a source string to this pointer, advancing this pointer as it goes. */
     void writeAll (CharPointer_UTF16 src) noexcept
     {
@@ -217,6 +217,33 @@ public:
         CharacterFunctions::copyAll (*this, src);
     }
 
+    /** Copies a source string to this pointer, advancing this pointer as it goes.
+        Runs of ASCII in the source are widened without being decoded character by character.
+    */
+    void writeAll (CharPointer_UTF8 src) noexcept
+    {
+        auto* end = src.findTerminatingNull().getAddress();
+
+        for (;;)
+        {
+            auto* s = src.getAddress();
+            auto* endOfRun = CharPointer_UTF8::findEndOfASCII (s, (size_t) (end - s));
+
+            while (s != endOfRun)
+                *data++ = (CharType) (uint8) *s++;
+
+            src = CharPointer_UTF8 (endOfRun);
+            auto c = src.getAndAdvance();
+
+            if (c == 0)
+                break;
+
+            write (c);
+        }
+
+        *data = 0;
+    }
+
     /** Copies a source string to this pointer, advancing this pointer as it goes. */
     void writeAll (CharPointer_UTF32 src) noexcept
     {
@@ -20,6 +20,13 @@
   ==============================================================================
 */
 
+#if JUCE_INTEL && (defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2))
+ #define JUCE_UTF8_USE_SSE2 1
+ #include <emmintrin.h>
+#else
+ #define JUCE_UTF8_USE_SSE2 0
+#endif
+
 namespace juce
 {
 
@@ -239,21 +246,22 @@ public:
     /** Returns the number of characters in this string. */
     size_t length() const noexcept
     {
-        auto* d = data;
+        const CharType* d = data;
+        auto* end = d + strlen (d);
         size_t count = 0;
 
         for (;;)
         {
-            auto n = (uint32) (uint8) *d++;
+            auto* endOfRun = findEndOfASCII (d, (size_t) (end - d));
+            count += (size_t) (endOfRun - d);
+            d = endOfRun;
 
-            if ((n & 0x80) != 0)
-            {
-                while ((*d & 0xc0) == 0x80)
-                    ++d;
-            }
-            else if (n == 0)
+            if (*d++ == 0)
                 break;
 
+            while ((*d & 0xc0) == 0x80)
+                ++d;
+
             ++count;
         }
 
@@ -318,6 +326,15 @@ public:
         return count;
     }
 
+    /** Returns the number of bytes that would be needed to represent the given
+        string in this encoding format.
+        The value returned does NOT include the terminating null character.
+    */
+    static size_t getBytesRequiredFor (CharPointer_UTF8 text) noexcept
+    {
+        return strlen (text.data);
+    }
+
     /** Returns a pointer to the null character that terminates this string. */
     CharPointer_UTF8 findTerminatingNull() const noexcept
     {
@@ -366,13 +383,9 @@ public:
     /** Copies a source string to this pointer, advancing this pointer as it goes. */
     void writeAll (const CharPointer_UTF8 src) noexcept
     {
-        auto* s = src.data;
-
-        while ((*data = *s) != 0)
-        {
-            ++data;
-            ++s;
-        }
+        auto numBytes = strlen (src.data);
+        memmove (data, src.data, numBytes + 1);
+        data += numBytes;
     }
 
     /** Copies a source string to this pointer, advancing this pointer as it goes.
@@ -495,39 +508,43 @@ public:
     /** Returns true if this data contains a valid string in this encoding. */
     static bool isValidString (const CharType* dataToTest, int maxBytesToRead)
     {
-        while (--maxBytesToRead >= 0 && *dataToTest != 0)
+        while (maxBytesToRead > 0)
         {
+            auto* endOfRun = findEndOfASCII (dataToTest, (size_t) maxBytesToRead);
+            maxBytesToRead -= (int) (endOfRun - dataToTest);
+            dataToTest = endOfRun;
+
+            if (--maxBytesToRead < 0 || *dataToTest == 0)
+                break;
+
             auto byte = (signed char) *dataToTest++;
 
-            if (byte < 0)
+            int bit = 0x40;
+            int numExtraValues = 0;
+
+            while ((byte & bit) != 0)
             {
-                int bit = 0x40;
-                int numExtraValues = 0;
+                if (bit < 8)
+                    return false;
 
-                while ((byte & bit) != 0)
-                {
-                    if (bit < 8)
-                        return false;
+                ++numExtraValues;
+                bit >>= 1;
 
-                    ++numExtraValues;
-                    bit >>= 1;
+                if (bit == 8 && (numExtraValues > maxBytesToRead
+                                   || *CharPointer_UTF8 (dataToTest - 1) > 0x10ffff))
+                    return false;
+            }
 
-                    if (bit == 8 && (numExtraValues > maxBytesToRead
-                                       || *CharPointer_UTF8 (dataToTest - 1) > 0x10ffff))
-                        return false;
-                }
+            if (numExtraValues == 0)
+                return false;
 
-                if (numExtraValues == 0)
-                    return false;
+            maxBytesToRead -= numExtraValues;
+            if (maxBytesToRead < 0)
+                return false;
 
-                maxBytesToRead -= numExtraValues;
-                if (maxBytesToRead < 0)
+            while (--numExtraValues >= 0)
+                if ((*dataToTest++ & 0xc0) != 0x80)
                     return false;
-
-                while (--numExtraValues >= 0)
-                    if ((*dataToTest++ & 0xc0) != 0x80)
-                        return false;
-            }
         }
 
         return true;
@@ -560,8 +577,118 @@ public:
             && c[2] == (uint8) byteOrderMark3;
     }
 
+    //==============================================================================
+    /** Returns the address of the first byte in a null-terminated string which is
+        either the terminator or part of a multi-byte character.
+
+        Runs of plain 7-bit ASCII are skipped a whole block at a time (16 bytes with
+        SSE2, or 8 bytes otherwise), which makes this a cheap way to get past the bulk
+        of most real-world text before doing any per-character decoding.
+    */
+    static const CharType* findEndOfASCII (const CharType* text) noexcept
+    {
+        return findEndOfASCII (text, 0, 0);
+    }
+
+    /** Like findEndOfASCII(), but also stops at the first occurrence of either of two
+        ASCII characters. Parsers can use this to skip to the next delimiter or escape.
+    */
+    static const CharType* findEndOfASCII (const CharType* text, CharType stop1, CharType stop2) noexcept
+    {
+        // The block scanner mustn't read past the terminator, so this checks how much of
+        // the string there is a chunk at a time, starting small for the sake of short runs.
+        for (size_t chunkSize = 64;; chunkSize = jmin (chunkSize * 2, (size_t) 4096))
+        {
+            auto numBytes = strnlen (text, chunkSize);
+            auto* end = findEndOfASCII (text, numBytes, stop1, stop2);
+
+            if (end != text + numBytes || numBytes < chunkSize)
+                return end;
+
+            text = end;
+        }
+    }
+
+    /** Returns the address of the first byte within the given number of bytes which is
+        either a null or part of a multi-byte character, or the address just beyond the
+        range if there is no such byte.
+
+        Nothing beyond the given range is read, so this is the one to use when the length
+        is already known.
+        @see findEndOfASCII
+    */
+    static const CharType* findEndOfASCII (const CharType* text, size_t maxBytes) noexcept
+    {
+        return findEndOfASCII (text, maxBytes, 0, 0);
+    }
+
+    /** Like findEndOfASCII (const CharType*, size_t), but also stops at the first
+        occurrence of either of two ASCII characters.
+    */
+    static const CharType* findEndOfASCII (const CharType* text, size_t maxBytes, CharType stop1, CharType stop2) noexcept
+    {
+        for (; maxBytes >= asciiBlockSize; text += asciiBlockSize, maxBytes -= asciiBlockSize)
+        {
+           #if JUCE_UTF8_USE_SSE2
+            auto mask = getStopMask (text, stop1, stop2);
+
+            if (mask != 0)
+                return text + findLowestSetBit (mask);
+           #else
+            if (! isPlainASCIIBlock (text, stop1, stop2))
+                break;
+           #endif
+        }
+
+        while (maxBytes > 0 && isPlainASCII (*text, stop1, stop2))
+        {
+            ++text;
+            --maxBytes;
+        }
+
+        return text;
+    }
+
 private:
     CharType* data;
+
+   #if JUCE_UTF8_USE_SSE2
+    static constexpr size_t asciiBlockSize = 16;
+
+    // returns a bit for each byte in a block which isn't plain ASCII
+    static uint32 getStopMask (const CharType* block, CharType stop1, CharType stop2) noexcept
+    {
+        auto bytes = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (block));
+        auto stops = _mm_or_si128 (_mm_cmpeq_epi8 (bytes, _mm_setzero_si128()),
+                                   _mm_or_si128 (_mm_cmpeq_epi8 (bytes, _mm_set1_epi8 (stop1)),
+                                                 _mm_cmpeq_epi8 (bytes, _mm_set1_epi8 (stop2))));
+
+        return (uint32) _mm_movemask_epi8 (_mm_or_si128 (bytes, stops));
+    }
+   #else
+    static constexpr size_t asciiBlockSize = 8;
+
+    static bool hasZeroOrHighByte (uint64 word) noexcept
+    {
+        // a byte's top bit ends up set if it was either zero (via the borrow) or >= 0x80
+        return (((word - 0x0101010101010101ULL) | word) & 0x8080808080808080ULL) != 0;
+    }
+
+    static bool isPlainASCIIBlock (const CharType* block, CharType stop1, CharType stop2) noexcept
+    {
+        uint64 word;
+        memcpy (&word, block, sizeof (word));
+
+        return ! (hasZeroOrHighByte (word)
+                   || hasZeroOrHighByte (word ^ (0x0101010101010101ULL * (uint8) stop1))
+                   || hasZeroOrHighByte (word ^ (0x0101010101010101ULL * (uint8) stop2)));
+    }
+   #endif
+
+    static bool isPlainASCII (CharType c, CharType stop1, CharType stop2) noexcept
+    {
+        return (uint8) (c - 1) < 0x7f && c != stop1 && c != stop2;
+    }
 };
 
 } // namespace juce
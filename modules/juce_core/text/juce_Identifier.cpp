@@ -63,12 +63,27 @@ Identifier::Identifier (String::CharPointerType start, String::CharPointerType e
     jassert (start < end);
 }
 
+Identifier::Identifier (PrehashedName nm)
+    : name (StringPool::getGlobalPool().getPooledString (nm.text, nm.hash))
+{
+    // An Identifier cannot be created from an empty string!
+    jassert (nm.text != nullptr && nm.text[0] != 0);
+}
+
 Identifier Identifier::null;
 
-bool Identifier::isValidIdentifier (const String& possibleIdentifier) noexcept
+bool Identifier::isValidIdentifier (StringRef possibleIdentifier) noexcept
 {
-    return possibleIdentifier.isNotEmpty()
-            && possibleIdentifier.containsOnly ("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_-:#@$%");
+    if (possibleIdentifier.isEmpty())
+        return false;
+
+    CharPointer_ASCII validChars ("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_-:#@$%");
+
+    for (auto t = possibleIdentifier.text; ! t.isEmpty();)
+        if (validChars.indexOf (t.getAndAdvance()) < 0)
+            return false;
+
+    return true;
 }
 
 } // namespace juce
@@ -59,6 +59,18 @@ public:
     */
     Identifier (String::CharPointerType nameStart, String::CharPointerType nameEnd);
 
+    /** A string literal together with its hash, as created by the JUCE_IDENTIFIER macro. */
+    struct PrehashedName
+    {
+        const char* text;
+        uint64 hash;
+    };
+
+    /** Creates an identifier from a string literal whose hash was calculated at compile-time.
+        You'd normally use the JUCE_IDENTIFIER macro rather than calling this directly.
+    */
+    explicit Identifier (PrehashedName name);
+
     /** Creates a copy of another identifier. */
     Identifier (const Identifier& other) noexcept;
 
@@ -123,10 +135,22 @@ public:
         Since Identifiers are used as a script variables and XML attributes, they should only contain
         alphanumeric characters, underscores, or the '-' and ':' characters.
     */
-    static bool isValidIdentifier (const String& possibleIdentifier) noexcept;
+    static bool isValidIdentifier (StringRef possibleIdentifier) noexcept;
 
 private:
     String name;
 };
 
+//==============================================================================
+/** Creates an Identifier from a string literal, hashing it at compile-time so that
+    only the lookup in the string pool needs to be done at runtime.
+
+    e.g. @code
+    static const Identifier widthId = JUCE_IDENTIFIER ("width");
+    @endcode
+*/
+#define JUCE_IDENTIFIER(stringLiteral) \
+    juce::Identifier (juce::Identifier::PrehashedName { stringLiteral, \
+                                                        std::integral_constant<juce::uint64, juce::StringPool::hashLiteral (stringLiteral)>::value })
+
 } // namespace juce
@@ -77,23 +77,31 @@ public:
         return CharPointerType (s->text);
     }
 
+    // These all fill in a string which must currently be empty
     template <class CharPointer>
-    static CharPointerType createFromCharPointer (const CharPointer text)
+    static void createFromCharPointer (String& dest, const CharPointer text)
     {
         if (text.getAddress() == nullptr || text.isEmpty())
-            return CharPointerType (&(emptyString.text));
+            return;
 
         auto bytesNeeded = sizeof (CharType) + CharPointerType::getBytesRequiredFor (text);
-        auto dest = createUninitialisedBytes (bytesNeeded);
-        CharPointerType (dest).writeAll (text);
-        return dest;
+        dest.allocate (bytesNeeded).writeAll (text);
     }
 
+   #if JUCE_STRING_UTF_TYPE == 8
+    static void createFromCharPointer (String& dest, const CharPointer_ASCII text)
+    {
+        // 7-bit ASCII is already valid UTF-8, so it can be copied verbatim
+        if (auto* t = text.getAddress())
+            createFromCharPointer (dest, CharPointerType (t), CharPointerType (t + strlen (t)));
+    }
+   #endif
+
     template <class CharPointer>
-    static CharPointerType createFromCharPointer (const CharPointer text, size_t maxChars)
+    static void createFromCharPointer (String& dest, const CharPointer text, size_t maxChars)
     {
         if (text.getAddress() == nullptr || text.isEmpty() || maxChars == 0)
-            return CharPointerType (&(emptyString.text));
+            return;
 
         auto end = text;
         size_t numChars = 0;
@@ -105,16 +113,14 @@ public:
             ++numChars;
         }
 
-        auto dest = createUninitialisedBytes (bytesNeeded);
-        CharPointerType (dest).writeWithCharLimit (text, (int) numChars + 1);
-        return dest;
+        dest.allocate (bytesNeeded).writeWithCharLimit (text, (int) numChars + 1);
     }
 
     template <class CharPointer>
-    static CharPointerType createFromCharPointer (const CharPointer start, const CharPointer end)
+    static void createFromCharPointer (String& dest, const CharPointer start, const CharPointer end)
     {
         if (start.getAddress() == nullptr || start.isEmpty())
-            return CharPointerType (&(emptyString.text));
+            return;
 
         auto e = start;
         int numChars = 0;
@@ -126,29 +132,30 @@ public:
             ++numChars;
         }
 
-        auto dest = createUninitialisedBytes (bytesNeeded);
-        CharPointerType (dest).writeWithCharLimit (start, numChars + 1);
-        return dest;
+        dest.allocate (bytesNeeded).writeWithCharLimit (start, numChars + 1);
     }
 
-    static CharPointerType createFromCharPointer (const CharPointerType start, const CharPointerType end)
+    static void createFromCharPointer (String& dest, const CharPointerType start, const CharPointerType end)
     {
         if (start.getAddress() == nullptr || start.isEmpty())
-            return CharPointerType (&(emptyString.text));
+            return;
 
         auto numBytes = (size_t) (reinterpret_cast<const char*> (end.getAddress())
                                    - reinterpret_cast<const char*> (start.getAddress()));
-        auto dest = createUninitialisedBytes (numBytes + sizeof (CharType));
-        memcpy (dest.getAddress(), start, numBytes);
-        dest.getAddress()[numBytes / sizeof (CharType)] = 0;
-        return dest;
+        auto text = dest.allocate (numBytes + sizeof (CharType));
+        memcpy (text.getAddress(), start, numBytes);
+        text.getAddress()[numBytes / sizeof (CharType)] = 0;
+    }
+
+    static void createFromFixedLength (String& dest, const char* const src, const size_t numChars)
+    {
+        dest.allocate (numChars * sizeof (CharType) + sizeof (CharType))
+            .writeWithCharLimit (CharPointer_UTF8 (src), (int) (numChars + 1));
     }
 
-    static CharPointerType createFromFixedLength (const char* const src, const size_t numChars)
+    static CharType* getEmptyText() noexcept
     {
-        auto dest = createUninitialisedBytes (numChars * sizeof (CharType) + sizeof (CharType));
-        CharPointerType (dest).writeWithCharLimit (CharPointer_UTF8 (src), (int) (numChars + 1));
-        return dest;
+        return const_cast<CharType*> (&(emptyString.text));
     }
 
     //==============================================================================
@@ -199,11 +206,6 @@ public:
         return newText;
     }
 
-    static size_t getAllocatedNumBytes (const CharPointerType text) noexcept
-    {
-        return bufferFromText (text)->allocatedNumBytes;
-    }
-
     //==============================================================================
     Atomic<int> refCount;
     size_t allocatedNumBytes;
@@ -238,70 +240,137 @@ private:
 JUCE_DECLARE_DEPRECATED_STATIC (const String String::empty;)
 
 //==============================================================================
-String::String() noexcept  : text (&(emptyString.text))
+String::String() noexcept
 {
+    setShared (StringHolder::getEmptyText());
 }
 
 String::~String() noexcept
 {
-    StringHolder::release (text);
+    if (! isLocal())
+        StringHolder::release (CharPointerType (sharedText));
 }
 
-String::String (const String& other) noexcept   : text (other.text)
+String::String (const String& other) noexcept
 {
-    StringHolder::retain (text);
+    memcpy (storage, other.storage, sizeof (storage));
+
+    if (! isLocal())
+        StringHolder::retain (CharPointerType (sharedText));
 }
 
 void String::swapWith (String& other) noexcept
 {
-    std::swap (text, other.text);
+    std::swap (storage, other.storage);
 }
 
 void String::clear() noexcept
 {
-    StringHolder::release (text);
-    text = &(emptyString.text);
+    if (! isLocal())
+        StringHolder::release (CharPointerType (sharedText));
+
+    setShared (StringHolder::getEmptyText());
 }
 
 String& String::operator= (const String& other) noexcept
 {
-    StringHolder::retain (other.text);
-    StringHolder::release (text.atomicSwap (other.text));
+    if (this != &other)
+    {
+        if (! other.isLocal())
+            StringHolder::retain (CharPointerType (other.sharedText));
+
+        if (! isLocal())
+            StringHolder::release (CharPointerType (sharedText));
+
+        memcpy (storage, other.storage, sizeof (storage));
+    }
+
     return *this;
 }
 
-String::String (String&& other) noexcept   : text (other.text)
+String::String (String&& other) noexcept
 {
-    other.text = &(emptyString.text);
+    memcpy (storage, other.storage, sizeof (storage));
+    other.setShared (StringHolder::getEmptyText());
 }
 
 String& String::operator= (String&& other) noexcept
 {
-    std::swap (text, other.text);
+    std::swap (storage, other.storage);
     return *this;
 }
 
+void String::setShared (CharPointerType::CharType* text) noexcept
+{
+    sharedText = text;
+    storage[storageSize - 1] = 1;
+}
+
+String::CharPointerType String::allocate (size_t numBytes)
+{
+    jassert (isEmpty() && ! isLocal());
+
+    if (numBytes <= sizeof (localText))
+    {
+        storage[storageSize - 1] = 0;
+        return CharPointerType (localText);
+    }
+
+    auto text = StringHolder::createUninitialisedBytes (numBytes);
+    setShared (text.getAddress());
+    return text;
+}
+
+void String::makeShared()
+{
+    if (isLocal())
+    {
+        auto text = StringHolder::createUninitialisedBytes (sizeof (localText));
+        memcpy (text.getAddress(), localText, sizeof (localText));
+        setShared (text.getAddress());
+    }
+}
+
 inline String::PreallocationBytes::PreallocationBytes (const size_t num) noexcept : numBytes (num) {}
 
-String::String (const PreallocationBytes& preallocationSize)
-    : text (StringHolder::createUninitialisedBytes (preallocationSize.numBytes + sizeof (CharPointerType::CharType)))
+String::String (const PreallocationBytes& preallocationSize)  : String()
 {
+    allocate (preallocationSize.numBytes + sizeof (CharPointerType::CharType));
 }
 
 void String::preallocateBytes (const size_t numBytesNeeded)
 {
-    text = StringHolder::makeUniqueWithByteSize (text, numBytesNeeded + sizeof (CharPointerType::CharType));
+    auto numBytes = numBytesNeeded + sizeof (CharPointerType::CharType);
+
+    if (isLocal())
+    {
+        if (numBytes > sizeof (localText))
+        {
+            auto text = StringHolder::createUninitialisedBytes (numBytes);
+            memcpy (text.getAddress(), localText, sizeof (localText));
+            setShared (text.getAddress());
+        }
+    }
+    else if (sharedText == StringHolder::getEmptyText())
+    {
+        allocate (numBytes).writeNull();
+    }
+    else
+    {
+        setShared (StringHolder::makeUniqueWithByteSize (CharPointerType (sharedText), numBytes).getAddress());
+    }
 }
 
 int String::getReferenceCount() const noexcept
 {
-    return StringHolder::getReferenceCount (text);
+    return isLocal() ? 1 : StringHolder::getReferenceCount (CharPointerType (sharedText));
 }
 
 //==============================================================================
-String::String (const char* const t)
-    : text (StringHolder::createFromCharPointer (CharPointer_ASCII (t)))
+String::String (const char* const t)  : String()
 {
+    StringHolder::createFromCharPointer (*this, CharPointer_ASCII (t));
+
     /*  If you get an assertion here, then you're trying to create a string from 8-bit data
         that contains values greater than 127. These can NOT be correctly converted to unicode
         because there's no way for the String class to know what encoding was used to
@@ -322,9 +391,10 @@ String::String (const char* const t)
     jassert (t == nullptr || CharPointer_ASCII::isValidString (t, std::numeric_limits<int>::max()));
 }
 
-String::String (const char* const t, const size_t maxChars)
-    : text (StringHolder::createFromCharPointer (CharPointer_ASCII (t), maxChars))
+String::String (const char* const t, const size_t maxChars)  : String()
 {
+    StringHolder::createFromCharPointer (*this, CharPointer_ASCII (t), maxChars);
+
     /*  If you get an assertion here, then you're trying to create a string from 8-bit data
         that contains values greater than 127. These can NOT be correctly converted to unicode
         because there's no way for the String class to know what encoding was used to
@@ -345,28 +415,28 @@ String::String (const char* const t, const size_t maxChars)
     jassert (t == nullptr || CharPointer_ASCII::isValidString (t, (int) maxChars));
 }
 
-String::String (const wchar_t* const t)      : text (StringHolder::createFromCharPointer (castToCharPointer_wchar_t (t))) {}
-String::String (const CharPointer_UTF8  t)   : text (StringHolder::createFromCharPointer (t)) {}
-String::String (const CharPointer_UTF16 t)   : text (StringHolder::createFromCharPointer (t)) {}
-String::String (const CharPointer_UTF32 t)   : text (StringHolder::createFromCharPointer (t)) {}
-String::String (const CharPointer_ASCII t)   : text (StringHolder::createFromCharPointer (t)) {}
+String::String (const wchar_t* const t)      : String() { StringHolder::createFromCharPointer (*this, castToCharPointer_wchar_t (t)); }
+String::String (const CharPointer_UTF8  t)   : String() { StringHolder::createFromCharPointer (*this, t); }
+String::String (const CharPointer_UTF16 t)   : String() { StringHolder::createFromCharPointer (*this, t); }
+String::String (const CharPointer_UTF32 t)   : String() { StringHolder::createFromCharPointer (*this, t); }
+String::String (const CharPointer_ASCII t)   : String() { StringHolder::createFromCharPointer (*this, t); }
 
-String::String (const CharPointer_UTF8  t, const size_t maxChars)   : text (StringHolder::createFromCharPointer (t, maxChars)) {}
-String::String (const CharPointer_UTF16 t, const size_t maxChars)   : text (StringHolder::createFromCharPointer (t, maxChars)) {}
-String::String (const CharPointer_UTF32 t, const size_t maxChars)   : text (StringHolder::createFromCharPointer (t, maxChars)) {}
-String::String (const wchar_t* const t, size_t maxChars)            : text (StringHolder::createFromCharPointer (castToCharPointer_wchar_t (t), maxChars)) {}
+String::String (const CharPointer_UTF8  t, const size_t maxChars)   : String() { StringHolder::createFromCharPointer (*this, t, maxChars); }
+String::String (const CharPointer_UTF16 t, const size_t maxChars)   : String() { StringHolder::createFromCharPointer (*this, t, maxChars); }
+String::String (const CharPointer_UTF32 t, const size_t maxChars)   : String() { StringHolder::createFromCharPointer (*this, t, maxChars); }
+String::String (const wchar_t* const t, size_t maxChars)            : String() { StringHolder::createFromCharPointer (*this, castToCharPointer_wchar_t (t), maxChars); }
 
-String::String (const CharPointer_UTF8  start, const CharPointer_UTF8  end)  : text (StringHolder::createFromCharPointer (start, end)) {}
-String::String (const CharPointer_UTF16 start, const CharPointer_UTF16 end)  : text (StringHolder::createFromCharPointer (start, end)) {}
-String::String (const CharPointer_UTF32 start, const CharPointer_UTF32 end)  : text (StringHolder::createFromCharPointer (start, end)) {}
+String::String (const CharPointer_UTF8  start, const CharPointer_UTF8  end)  : String() { StringHolder::createFromCharPointer (*this, start, end); }
+String::String (const CharPointer_UTF16 start, const CharPointer_UTF16 end)  : String() { StringHolder::createFromCharPointer (*this, start, end); }
+String::String (const CharPointer_UTF32 start, const CharPointer_UTF32 end)  : String() { StringHolder::createFromCharPointer (*this, start, end); }
 
-String::String (const std::string& s) : text (StringHolder::createFromFixedLength (s.data(), s.size())) {}
-String::String (StringRef s)          : text (StringHolder::createFromCharPointer (s.text)) {}
+String::String (const std::string& s) : String() { StringHolder::createFromFixedLength (*this, s.data(), s.size()); }
+String::String (StringRef s)          : String() { StringHolder::createFromCharPointer (*this, s.text); }
 
 String String::charToString (const juce_wchar character)
 {
     String result (PreallocationBytes (CharPointerType::getBytesRequiredFor (character)));
-    CharPointerType t (result.text);
+    CharPointerType t (result.getCharPointer());
     t.write (character);
     t.writeNull();
     return result;
@@ -507,42 +577,42 @@ namespace NumberToStringConverters
     }
 
     template <typename IntegerType>
-    static String::CharPointerType createFromInteger (const IntegerType number)
+    static void createFromInteger (String& dest, const IntegerType number)
     {
         char buffer [charsNeededForInt];
         auto* end = buffer + numElementsInArray (buffer);
         auto* start = numberToString (end, number);
-        return StringHolder::createFromFixedLength (start, (size_t) (end - start - 1));
+        StringHolder::createFromFixedLength (dest, start, (size_t) (end - start - 1));
     }
 
-    static String::CharPointerType createFromDouble (const double number, const int numberOfDecimalPlaces)
+    static void createFromDouble (String& dest, const double number, const int numberOfDecimalPlaces)
     {
         char buffer [charsNeededForDouble];
         size_t len;
         auto start = doubleToString (buffer, numElementsInArray (buffer), (double) number, numberOfDecimalPlaces, len);
-        return StringHolder::createFromFixedLength (start, len);
+        StringHolder::createFromFixedLength (dest, start, len);
     }
 }
 
 //==============================================================================
-String::String (int number)            : text (NumberToStringConverters::createFromInteger (number)) {}
-String::String (unsigned int number)   : text (NumberToStringConverters::createFromInteger (number)) {}
-String::String (short number)          : text (NumberToStringConverters::createFromInteger ((int) number)) {}
-String::String (unsigned short number) : text (NumberToStringConverters::createFromInteger ((unsigned int) number)) {}
-String::String (int64  number)         : text (NumberToStringConverters::createFromInteger (number)) {}
-String::String (uint64 number)         : text (NumberToStringConverters::createFromInteger (number)) {}
-String::String (long number)           : text (NumberToStringConverters::createFromInteger (number)) {}
-String::String (unsigned long number)  : text (NumberToStringConverters::createFromInteger (number)) {}
-
-String::String (float  number)         : text (NumberToStringConverters::createFromDouble ((double) number, 0)) {}
-String::String (double number)         : text (NumberToStringConverters::createFromDouble (number, 0)) {}
-String::String (float  number, int numberOfDecimalPlaces)  : text (NumberToStringConverters::createFromDouble ((double) number, numberOfDecimalPlaces)) {}
-String::String (double number, int numberOfDecimalPlaces)  : text (NumberToStringConverters::createFromDouble (number, numberOfDecimalPlaces)) {}
+String::String (int number)            : String() { NumberToStringConverters::createFromInteger (*this, number); }
+String::String (unsigned int number)   : String() { NumberToStringConverters::createFromInteger (*this, number); }
+String::String (short number)          : String() { NumberToStringConverters::createFromInteger (*this, (int) number); }
+String::String (unsigned short number) : String() { NumberToStringConverters::createFromInteger (*this, (unsigned int) number); }
+String::String (int64  number)         : String() { NumberToStringConverters::createFromInteger (*this, number); }
+String::String (uint64 number)         : String() { NumberToStringConverters::createFromInteger (*this, number); }
+String::String (long number)           : String() { NumberToStringConverters::createFromInteger (*this, number); }
+String::String (unsigned long number)  : String() { NumberToStringConverters::createFromInteger (*this, number); }
+
+String::String (float  number)         : String() { NumberToStringConverters::createFromDouble (*this, (double) number, 0); }
+String::String (double number)         : String() { NumberToStringConverters::createFromDouble (*this, number, 0); }
+String::String (float  number, int numberOfDecimalPlaces)  : String() { NumberToStringConverters::createFromDouble (*this, (double) number, numberOfDecimalPlaces); }
+String::String (double number, int numberOfDecimalPlaces)  : String() { NumberToStringConverters::createFromDouble (*this, number, numberOfDecimalPlaces); }
 
 //==============================================================================
 int String::length() const noexcept
 {
-    return (int) text.length();
+    return (int) getCharPointer().length();
 }
 
 static size_t findByteOffsetOfEnd (String::CharPointerType text) noexcept
@@ -552,13 +622,13 @@ static size_t findByteOffsetOfEnd (String::CharPointerType text) noexcept
 
 size_t String::getByteOffsetOfEnd() const noexcept
 {
-    return findByteOffsetOfEnd (text);
+    return findByteOffsetOfEnd (getCharPointer());
 }
 
 juce_wchar String::operator[] (int index) const noexcept
 {
-    jassert (index == 0 || (index > 0 && index <= (int) text.lengthUpTo ((size_t) index + 1)));
-    return text [index];
+    jassert (index == 0 || (index > 0 && index <= (int) getCharPointer().lengthUpTo ((size_t) index + 1)));
+    return getCharPointer() [index];
 }
 
 template <typename Type>
@@ -578,9 +648,9 @@ struct HashGenerator
     enum { multiplier = sizeof (Type) > 4 ? 101 : 31 };
 };
 
-int String::hashCode() const noexcept       { return (int) HashGenerator<uint32>    ::calculate (text); }
-int64 String::hashCode64() const noexcept   { return (int64) HashGenerator<uint64>  ::calculate (text); }
-size_t String::hash() const noexcept        { return HashGenerator<size_t>          ::calculate (text); }
+int String::hashCode() const noexcept       { return (int) HashGenerator<uint32>    ::calculate (getCharPointer()); }
+int64 String::hashCode64() const noexcept   { return (int64) HashGenerator<uint64>  ::calculate (getCharPointer()); }
+size_t String::hash() const noexcept        { return HashGenerator<size_t>          ::calculate (getCharPointer()); }
 
 //==============================================================================
 JUCE_API bool JUCE_CALLTYPE operator== (const String& s1, const String& s2) noexcept            { return s1.compare (s2) == 0; }
@@ -604,31 +674,41 @@ JUCE_API bool JUCE_CALLTYPE operator<= (const String& s1, const String& s2) noex
 
 bool String::equalsIgnoreCase (const wchar_t* const t) const noexcept
 {
-    return t != nullptr ? text.compareIgnoreCase (castToCharPointer_wchar_t (t)) == 0
+    return t != nullptr ? getCharPointer().compareIgnoreCase (castToCharPointer_wchar_t (t)) == 0
                         : isEmpty();
 }
 
 bool String::equalsIgnoreCase (const char* const t) const noexcept
 {
-    return t != nullptr ? text.compareIgnoreCase (CharPointer_UTF8 (t)) == 0
+    return t != nullptr ? getCharPointer().compareIgnoreCase (CharPointer_UTF8 (t)) == 0
                         : isEmpty();
 }
 
 bool String::equalsIgnoreCase (StringRef t) const noexcept
 {
-    return text.compareIgnoreCase (t.text) == 0;
+    return getCharPointer().compareIgnoreCase (t.text) == 0;
 }
 
 bool String::equalsIgnoreCase (const String& other) const noexcept
 {
-    return text == other.text
-            || text.compareIgnoreCase (other.text) == 0;
+    auto t = getCharPointer(), o = other.getCharPointer();
+    return t == o || t.compareIgnoreCase (o) == 0;
+}
+
+int String::compare (const String& other) const noexcept
+{
+    auto t = getCharPointer(), o = other.getCharPointer();
+    return t == o ? 0 : t.compare (o);
 }
 
-int String::compare (const String& other) const noexcept           { return (text == other.text) ? 0 : text.compare (other.text); }
-int String::compare (const char* const other) const noexcept       { return text.compare (CharPointer_UTF8 (other)); }
-int String::compare (const wchar_t* const other) const noexcept    { return text.compare (castToCharPointer_wchar_t (other)); }
-int String::compareIgnoreCase (const String& other) const noexcept { return (text == other.text) ? 0 : text.compareIgnoreCase (other.text); }
+int String::compare (const char* const other) const noexcept       { return getCharPointer().compare (CharPointer_UTF8 (other)); }
+int String::compare (const wchar_t* const other) const noexcept    { return getCharPointer().compare (castToCharPointer_wchar_t (other)); }
+
+int String::compareIgnoreCase (const String& other) const noexcept
+{
+    auto t = getCharPointer(), o = other.getCharPointer();
+    return t == o ? 0 : t.compareIgnoreCase (o);
+}
 
 static int stringCompareRight (String::CharPointerType s1, String::CharPointerType s2) noexcept
 {
@@ -737,8 +817,8 @@ int String::compareNatural (StringRef other, bool isCaseSensitive) const noexcep
 //==============================================================================
 void String::append (const String& textToAppend, size_t maxCharsToTake)
 {
-    appendCharPointer (this == &textToAppend ? String (textToAppend).text
-                                             : textToAppend.text, maxCharsToTake);
+    appendCharPointer (this == &textToAppend ? String (textToAppend).getCharPointer()
+                                             : textToAppend.getCharPointer(), maxCharsToTake);
 }
 
 void String::appendCharPointer (const CharPointerType textToAppend)
@@ -760,7 +840,7 @@ void String::appendCharPointer (const CharPointerType startOfTextToAppend,
         auto byteOffsetOfNull = getByteOffsetOfEnd();
         preallocateBytes (byteOffsetOfNull + (size_t) extraBytesNeeded);
 
-        auto* newStringStart = addBytesToPointer (text.getAddress(), (int) byteOffsetOfNull);
+        auto* newStringStart = addBytesToPointer (getCharPointer().getAddress(), (int) byteOffsetOfNull);
         memcpy (newStringStart, startOfTextToAppend.getAddress(), (size_t) extraBytesNeeded);
         CharPointerType (addBytesToPointer (newStringStart, extraBytesNeeded)).writeNull();
     }
@@ -786,7 +866,7 @@ String& String::operator+= (const String& other)
     if (this == &other)
         return operator+= (String (*this));
 
-    appendCharPointer (other.text);
+    appendCharPointer (other.getCharPointer());
     return *this;
 }
 
@@ -904,12 +984,12 @@ JUCE_API OutputStream& JUCE_CALLTYPE operator<< (OutputStream& stream, StringRef
 //==============================================================================
 int String::indexOfChar (juce_wchar character) const noexcept
 {
-    return text.indexOf (character);
+    return getCharPointer().indexOf (character);
 }
 
 int String::indexOfChar (int startIndex, juce_wchar character) const noexcept
 {
-    auto t = text;
+    auto t = getCharPointer();
 
     for (int i = 0; ! t.isEmpty(); ++i)
     {
@@ -929,7 +1009,7 @@ int String::indexOfChar (int startIndex, juce_wchar character) const noexcept
 
 int String::lastIndexOfChar (juce_wchar character) const noexcept
 {
-    auto t = text;
+    auto t = getCharPointer();
     int last = -1;
 
     for (int i = 0; ! t.isEmpty(); ++i)
@@ -941,7 +1021,7 @@ int String::lastIndexOfChar (juce_wchar character) const noexcept
 
 int String::indexOfAnyOf (StringRef charactersToLookFor, int startIndex, bool ignoreCase) const noexcept
 {
-    auto t = text;
+    auto t = getCharPointer();
 
     for (int i = 0; ! t.isEmpty(); ++i)
     {
@@ -961,12 +1041,12 @@ int String::indexOfAnyOf (StringRef charactersToLookFor, int startIndex, bool ig
 
 int String::indexOf (StringRef other) const noexcept
 {
-    return other.isEmpty() ? 0 : text.indexOf (other.text);
+    return other.isEmpty() ? 0 : getCharPointer().indexOf (other.text);
 }
 
 int String::indexOfIgnoreCase (StringRef other) const noexcept
 {
-    return other.isEmpty() ? 0 : CharacterFunctions::indexOfIgnoreCase (text, other.text);
+    return other.isEmpty() ? 0 : CharacterFunctions::indexOfIgnoreCase (getCharPointer(), other.text);
 }
 
 int String::indexOf (int startIndex, StringRef other) const noexcept
@@ -974,7 +1054,7 @@ int String::indexOf (int startIndex, StringRef other) const noexcept
     if (other.isEmpty())
         return -1;
 
-    auto t = text;
+    auto t = getCharPointer();
 
     for (int i = startIndex; --i >= 0;)
     {
@@ -993,7 +1073,7 @@ int String::indexOfIgnoreCase (const int startIndex, StringRef other) const noex
     if (other.isEmpty())
         return -1;
 
-    auto t = text;
+    auto t = getCharPointer();
 
     for (int i = startIndex; --i >= 0;)
     {
@@ -1016,7 +1096,7 @@ int String::lastIndexOf (StringRef other) const noexcept
 
         if (i >= 0)
         {
-            for (auto n = text + i; i >= 0; --i)
+            for (auto n = getCharPointer() + i; i >= 0; --i)
             {
                 if (n.compareUpTo (other.text, len) == 0)
                     return i;
@@ -1038,7 +1118,7 @@ int String::lastIndexOfIgnoreCase (StringRef other) const noexcept
 
         if (i >= 0)
         {
-            for (auto n = text + i; i >= 0; --i)
+            for (auto n = getCharPointer() + i; i >= 0; --i)
             {
                 if (n.compareIgnoreCaseUpTo (other.text, len) == 0)
                     return i;
@@ -1053,7 +1133,7 @@ int String::lastIndexOfIgnoreCase (StringRef other) const noexcept
 
 int String::lastIndexOfAnyOf (StringRef charactersToLookFor, const bool ignoreCase) const noexcept
 {
-    auto t = text;
+    auto t = getCharPointer();
     int last = -1;
 
     for (int i = 0; ! t.isEmpty(); ++i)
@@ -1070,7 +1150,7 @@ bool String::contains (StringRef other) const noexcept
 
 bool String::containsChar (const juce_wchar character) const noexcept
 {
-    return text.indexOf (character) >= 0;
+    return getCharPointer().indexOf (character) >= 0;
 }
 
 bool String::containsIgnoreCase (StringRef t) const noexcept
@@ -1082,7 +1162,7 @@ int String::indexOfWholeWord (StringRef word) const noexcept
 {
     if (word.isNotEmpty())
     {
-        auto t = text;
+        auto t = getCharPointer();
         auto wordLen = word.length();
         auto end = (int) t.length() - wordLen;
 
@@ -1104,7 +1184,7 @@ int String::indexOfWholeWordIgnoreCase (StringRef word) const noexcept
 {
     if (word.isNotEmpty())
     {
-        auto t = text;
+        auto t = getCharPointer();
         auto wordLen = word.length();
         auto end = (int) t.length() - wordLen;
 
@@ -1171,7 +1251,7 @@ struct WildCardMatcher
 
 bool String::matchesWildcard (StringRef wildcard, const bool ignoreCase) const noexcept
 {
-    return WildCardMatcher<CharPointerType>::matches (wildcard.text, text, ignoreCase);
+    return WildCardMatcher<CharPointerType>::matches (wildcard.text, getCharPointer(), ignoreCase);
 }
 
 //==============================================================================
@@ -1181,7 +1261,7 @@ String String::repeatedString (StringRef stringToRepeat, int numberOfTimesToRepe
         return {};
 
     String result (PreallocationBytes (findByteOffsetOfEnd (stringToRepeat) * (size_t) numberOfTimesToRepeat));
-    auto n = result.text;
+    auto n = result.getCharPointer();
 
     while (--numberOfTimesToRepeat >= 0)
         n.writeAll (stringToRepeat.text);
@@ -1194,7 +1274,7 @@ String String::paddedLeft (const juce_wchar padCharacter, int minimumLength) con
     jassert (padCharacter != 0);
 
     auto extraChars = minimumLength;
-    auto end = text;
+    auto end = getCharPointer();
 
     while (! end.isEmpty())
     {
@@ -1205,14 +1285,14 @@ String String::paddedLeft (const juce_wchar padCharacter, int minimumLength) con
     if (extraChars <= 0 || padCharacter == 0)
         return *this;
 
-    auto currentByteSize = (size_t) (((char*) end.getAddress()) - (char*) text.getAddress());
+    auto currentByteSize = (size_t) (((char*) end.getAddress()) - (char*) getCharPointer().getAddress());
     String result (PreallocationBytes (currentByteSize + (size_t) extraChars * CharPointerType::getBytesRequiredFor (padCharacter)));
-    auto n = result.text;
+    auto n = result.getCharPointer();
 
     while (--extraChars >= 0)
         n.write (padCharacter);
 
-    n.writeAll (text);
+    n.writeAll (getCharPointer());
     return result;
 }
 
@@ -1221,7 +1301,7 @@ String String::paddedRight (const juce_wchar padCharacter, int minimumLength) co
     jassert (padCharacter != 0);
 
     auto extraChars = minimumLength;
-    CharPointerType end (text);
+    CharPointerType end (getCharPointer());
 
     while (! end.isEmpty())
     {
@@ -1232,11 +1312,11 @@ String String::paddedRight (const juce_wchar padCharacter, int minimumLength) co
     if (extraChars <= 0 || padCharacter == 0)
         return *this;
 
-    auto currentByteSize = (size_t) (((char*) end.getAddress()) - (char*) text.getAddress());
+    auto currentByteSize = (size_t) (((char*) end.getAddress()) - (char*) getCharPointer().getAddress());
     String result (PreallocationBytes (currentByteSize + (size_t) extraChars * CharPointerType::getBytesRequiredFor (padCharacter)));
-    auto n = result.text;
+    auto n = result.getCharPointer();
 
-    n.writeAll (text);
+    n.writeAll (getCharPointer());
 
     while (--extraChars >= 0)
         n.write (padCharacter);
@@ -1262,7 +1342,7 @@ String String::replaceSection (int index, int numCharsToReplace, StringRef strin
         jassertfalse;
     }
 
-    auto insertPoint = text;
+    auto insertPoint = getCharPointer();
 
     for (int i = 0; i < index; ++i)
     {
@@ -1281,10 +1361,10 @@ String String::replaceSection (int index, int numCharsToReplace, StringRef strin
     for (int i = 0; i < numCharsToReplace && ! startOfRemainder.isEmpty(); ++i)
         ++startOfRemainder;
 
-    if (insertPoint == text && startOfRemainder.isEmpty())
+    if (insertPoint == getCharPointer() && startOfRemainder.isEmpty())
         return stringToInsert.text;
 
-    auto initialBytes = (size_t) (((char*) insertPoint.getAddress()) - (char*) text.getAddress());
+    auto initialBytes = (size_t) (((char*) insertPoint.getAddress()) - (char*) getCharPointer().getAddress());
     auto newStringBytes = findByteOffsetOfEnd (stringToInsert);
     auto remainderBytes = (size_t) (((char*) startOfRemainder.findTerminatingNull().getAddress()) - (char*) startOfRemainder.getAddress());
 
@@ -1295,8 +1375,8 @@ String String::replaceSection (int index, int numCharsToReplace, StringRef strin
 
     String result (PreallocationBytes ((size_t) newTotalBytes));
 
-    auto* dest = (char*) result.text.getAddress();
-    memcpy (dest, text.getAddress(), initialBytes);
+    auto* dest = (char*) result.getCharPointer().getAddress();
+    memcpy (dest, getCharPointer().getAddress(), initialBytes);
     dest += initialBytes;
     memcpy (dest, stringToInsert.text.getAddress(), newStringBytes);
     dest += newStringBytes;
@@ -1346,7 +1426,7 @@ struct StringCreationHelper
     }
 
     StringCreationHelper (const String::CharPointerType s)
-        : source (s), allocatedBytes (StringHolder::getAllocatedNumBytes (s))
+        : source (s), allocatedBytes (findByteOffsetOfEnd (s) + sizeof (String::CharPointerType::CharType))
     {
         result.preallocateBytes (allocatedBytes);
         dest = result.getCharPointer();
@@ -1377,7 +1457,7 @@ String String::replaceCharacter (const juce_wchar charToReplace, const juce_wcha
     if (! containsChar (charToReplace))
         return *this;
 
-    StringCreationHelper builder (text);
+    StringCreationHelper builder (getCharPointer());
 
     for (;;)
     {
@@ -1401,7 +1481,7 @@ String String::replaceCharacters (StringRef charactersToReplace, StringRef chara
     // second, so the two strings must be the same length.
     jassert (charactersToReplace.length() == charactersToInsertInstead.length());
 
-    StringCreationHelper builder (text);
+    StringCreationHelper builder (getCharPointer());
 
     for (;;)
     {
@@ -1423,38 +1503,39 @@ String String::replaceCharacters (StringRef charactersToReplace, StringRef chara
 //==============================================================================
 bool String::startsWith (StringRef other) const noexcept
 {
-    return text.compareUpTo (other.text, other.length()) == 0;
+    return getCharPointer().compareUpTo (other.text, other.length()) == 0;
 }
 
 bool String::startsWithIgnoreCase (StringRef other) const noexcept
 {
-    return text.compareIgnoreCaseUpTo (other.text, other.length()) == 0;
+    return getCharPointer().compareIgnoreCaseUpTo (other.text, other.length()) == 0;
 }
 
 bool String::startsWithChar (const juce_wchar character) const noexcept
 {
     jassert (character != 0); // strings can't contain a null character!
 
-    return *text == character;
+    return *getCharPointer() == character;
 }
 
 bool String::endsWithChar (const juce_wchar character) const noexcept
 {
     jassert (character != 0); // strings can't contain a null character!
 
-    if (text.isEmpty())
+    if (getCharPointer().isEmpty())
         return false;
 
-    auto t = text.findTerminatingNull();
+    auto t = getCharPointer().findTerminatingNull();
     return *--t == character;
 }
 
 bool String::endsWith (StringRef other) const noexcept
 {
-    auto end = text.findTerminatingNull();
+    auto start = getCharPointer();
+    auto end = start.findTerminatingNull();
     auto otherEnd = other.text.findTerminatingNull();
 
-    while (end > text && otherEnd > other.text)
+    while (end > start && otherEnd > other.text)
     {
         --end;
         --otherEnd;
@@ -1468,10 +1549,11 @@ bool String::endsWith (StringRef other) const noexcept
 
 bool String::endsWithIgnoreCase (StringRef other) const noexcept
 {
-    auto end = text.findTerminatingNull();
+    auto start = getCharPointer();
+    auto end = start.findTerminatingNull();
     auto otherEnd = other.text.findTerminatingNull();
 
-    while (end > text && otherEnd > other.text)
+    while (end > start && otherEnd > other.text)
     {
         --end;
         --otherEnd;
@@ -1486,7 +1568,7 @@ bool String::endsWithIgnoreCase (StringRef other) const noexcept
 //==============================================================================
 String String::toUpperCase() const
 {
-    StringCreationHelper builder (text);
+    StringCreationHelper builder (getCharPointer());
 
     for (;;)
     {
@@ -1504,7 +1586,7 @@ String String::toUpperCase() const
 
 String String::toLowerCase() const
 {
-    StringCreationHelper builder (text);
+    StringCreationHelper builder (getCharPointer());
 
     for (;;)
     {
@@ -1523,7 +1605,7 @@ String String::toLowerCase() const
 //==============================================================================
 juce_wchar String::getLastCharacter() const noexcept
 {
-    return isEmpty() ? juce_wchar() : text [length() - 1];
+    return isEmpty() ? juce_wchar() : getCharPointer() [length() - 1];
 }
 
 String String::substring (int start, const int end) const
@@ -1535,7 +1617,7 @@ String String::substring (int start, const int end) const
         return {};
 
     int i = 0;
-    auto t1 = text;
+    auto t1 = getCharPointer();
 
     while (i < start)
     {
@@ -1570,7 +1652,7 @@ String String::substring (int start) const
     if (start <= 0)
         return *this;
 
-    auto t = text;
+    auto t = getCharPointer();
 
     while (--start >= 0)
     {
@@ -1585,12 +1667,12 @@ String String::substring (int start) const
 
 String String::dropLastCharacters (const int numberToDrop) const
 {
-    return String (text, (size_t) jmax (0, length() - numberToDrop));
+    return String (getCharPointer(), (size_t) jmax (0, length() - numberToDrop));
 }
 
 String String::getLastCharacters (const int numCharacters) const
 {
-    return String (text + jmax (0, length() - jmax (0, numCharacters)));
+    return String (getCharPointer() + jmax (0, length() - jmax (0, numCharacters)));
 }
 
 String String::fromFirstOccurrenceOf (StringRef sub, bool includeSubString, bool ignoreCase) const
@@ -1640,16 +1722,16 @@ static bool isQuoteCharacter (juce_wchar c) noexcept
 
 bool String::isQuotedString() const
 {
-    return isQuoteCharacter (*text.findEndOfWhitespace());
+    return isQuoteCharacter (*getCharPointer().findEndOfWhitespace());
 }
 
 String String::unquoted() const
 {
-    if (! isQuoteCharacter (*text))
+    if (! isQuoteCharacter (*getCharPointer()))
         return *this;
 
     auto len = length();
-    return substring (1, len - (isQuoteCharacter (text[len - 1]) ? 1 : 0));
+    return substring (1, len - (isQuoteCharacter (getCharPointer()[len - 1]) ? 1 : 0));
 }
 
 String String::quoted (juce_wchar quoteCharacter) const
@@ -1688,14 +1770,14 @@ String String::trim() const
 {
     if (isNotEmpty())
     {
-        auto start = text.findEndOfWhitespace();
+        auto start = getCharPointer().findEndOfWhitespace();
         auto end = start.findTerminatingNull();
         auto trimmedEnd = findTrimmedEnd (start, end);
 
         if (trimmedEnd <= start)
             return {};
 
-        if (text < start || trimmedEnd < end)
+        if (getCharPointer() < start || trimmedEnd < end)
             return String (start, trimmedEnd);
     }
 
@@ -1706,9 +1788,9 @@ String String::trimStart() const
 {
     if (isNotEmpty())
     {
-        auto t = text.findEndOfWhitespace();
+        auto t = getCharPointer().findEndOfWhitespace();
 
-        if (t != text)
+        if (t != getCharPointer())
             return String (t);
     }
 
@@ -1719,11 +1801,11 @@ String String::trimEnd() const
 {
     if (isNotEmpty())
     {
-        auto end = text.findTerminatingNull();
-        auto trimmedEnd = findTrimmedEnd (text, end);
+        auto end = getCharPointer().findTerminatingNull();
+        auto trimmedEnd = findTrimmedEnd (getCharPointer(), end);
 
         if (trimmedEnd < end)
-            return String (text, trimmedEnd);
+            return String (getCharPointer(), trimmedEnd);
     }
 
     return *this;
@@ -1731,22 +1813,23 @@ String String::trimEnd() const
 
 String String::trimCharactersAtStart (StringRef charactersToTrim) const
 {
-    auto t = text;
+    auto t = getCharPointer();
 
     while (charactersToTrim.text.indexOf (*t) >= 0)
         ++t;
 
-    return t == text ? *this : String (t);
+    return t == getCharPointer() ? *this : String (t);
 }
 
 String String::trimCharactersAtEnd (StringRef charactersToTrim) const
 {
     if (isNotEmpty())
     {
-        auto end = text.findTerminatingNull();
+        auto start = getCharPointer();
+        auto end = start.findTerminatingNull();
         auto trimmedEnd = end;
 
-        while (trimmedEnd > text)
+        while (trimmedEnd > start)
         {
             if (charactersToTrim.text.indexOf (*--trimmedEnd) < 0)
             {
@@ -1756,7 +1839,7 @@ String String::trimCharactersAtEnd (StringRef charactersToTrim) const
         }
 
         if (trimmedEnd < end)
-            return String (text, trimmedEnd);
+            return String (start, trimmedEnd);
     }
 
     return *this;
@@ -1768,7 +1851,7 @@ String String::retainCharacters (StringRef charactersToRetain) const
     if (isEmpty())
         return {};
 
-    StringCreationHelper builder (text);
+    StringCreationHelper builder (getCharPointer());
 
     for (;;)
     {
@@ -1790,7 +1873,7 @@ String String::removeCharacters (StringRef charactersToRemove) const
     if (isEmpty())
         return {};
 
-    StringCreationHelper builder (text);
+    StringCreationHelper builder (getCharPointer());
 
     for (;;)
     {
@@ -1808,25 +1891,25 @@ String String::removeCharacters (StringRef charactersToRemove) const
 
 String String::initialSectionContainingOnly (StringRef permittedCharacters) const
 {
-    for (auto t = text; ! t.isEmpty(); ++t)
+    for (auto t = getCharPointer(); ! t.isEmpty(); ++t)
         if (permittedCharacters.text.indexOf (*t) < 0)
-            return String (text, t);
+            return String (getCharPointer(), t);
 
     return *this;
 }
 
 String String::initialSectionNotContaining (StringRef charactersToStopAt) const
 {
-    for (auto t = text; ! t.isEmpty(); ++t)
+    for (auto t = getCharPointer(); ! t.isEmpty(); ++t)
         if (charactersToStopAt.text.indexOf (*t) >= 0)
-            return String (text, t);
+            return String (getCharPointer(), t);
 
     return *this;
 }
 
 bool String::containsOnly (StringRef chars) const noexcept
 {
-    for (auto t = text; ! t.isEmpty();)
+    for (auto t = getCharPointer(); ! t.isEmpty();)
         if (chars.text.indexOf (t.getAndAdvance()) < 0)
             return false;
 
@@ -1835,7 +1918,7 @@ bool String::containsOnly (StringRef chars) const noexcept
 
 bool String::containsAnyOf (StringRef chars) const noexcept
 {
-    for (auto t = text; ! t.isEmpty();)
+    for (auto t = getCharPointer(); ! t.isEmpty();)
         if (chars.text.indexOf (t.getAndAdvance()) >= 0)
             return true;
 
@@ -1844,7 +1927,7 @@ bool String::containsAnyOf (StringRef chars) const noexcept
 
 bool String::containsNonWhitespaceChars() const noexcept
 {
-    for (auto t = text; ! t.isEmpty(); ++t)
+    for (auto t = getCharPointer(); ! t.isEmpty(); ++t)
         if (! t.isWhitespace())
             return true;
 
@@ -1891,18 +1974,18 @@ String String::formattedRaw (const char* pf, ...)
 }
 
 //==============================================================================
-int String::getIntValue() const noexcept            { return text.getIntValue32(); }
-int64 String::getLargeIntValue() const noexcept     { return text.getIntValue64(); }
+int String::getIntValue() const noexcept            { return getCharPointer().getIntValue32(); }
+int64 String::getLargeIntValue() const noexcept     { return getCharPointer().getIntValue64(); }
 float String::getFloatValue() const noexcept        { return (float) getDoubleValue(); }
-double String::getDoubleValue() const noexcept      { return text.getDoubleValue(); }
+double String::getDoubleValue() const noexcept      { return getCharPointer().getDoubleValue(); }
 
 int String::getTrailingIntValue() const noexcept
 {
     int n = 0;
     int mult = 1;
-    auto t = text.findTerminatingNull();
+    auto t = getCharPointer().findTerminatingNull();
 
-    while (--t >= text)
+    while (--t >= getCharPointer())
     {
         if (! t.isDigit())
         {
@@ -1957,7 +2040,7 @@ String String::toHexString (const void* const d, const int size, const int group
     String s (PreallocationBytes (sizeof (CharPointerType::CharType) * (size_t) numChars));
 
     auto* data = static_cast<const unsigned char*> (d);
-    auto dest = s.text;
+    auto dest = s.getCharPointer();
 
     for (int i = 0; i < size; ++i)
     {
@@ -1973,8 +2056,8 @@ String String::toHexString (const void* const d, const int size, const int group
     return s;
 }
 
-int   String::getHexValue32() const noexcept    { return CharacterFunctions::HexParser<int>  ::parse (text); }
-int64 String::getHexValue64() const noexcept    { return CharacterFunctions::HexParser<int64>::parse (text); }
+int   String::getHexValue32() const noexcept    { return CharacterFunctions::HexParser<int>  ::parse (getCharPointer()); }
+int64 String::getHexValue64() const noexcept    { return CharacterFunctions::HexParser<int64>::parse (getCharPointer()); }
 
 //==============================================================================
 static String getStringFromWindows1252Codepage (const char* data, size_t num)
@@ -2126,23 +2209,23 @@ struct StringCopier
 
 size_t String::copyToUTF8 (CharPointer_UTF8::CharType* const buffer, size_t maxBufferSizeBytes) const noexcept
 {
-    return StringCopier<CharPointerType, CharPointer_UTF8>::copyToBuffer (text, buffer, maxBufferSizeBytes);
+    return StringCopier<CharPointerType, CharPointer_UTF8>::copyToBuffer (getCharPointer(), buffer, maxBufferSizeBytes);
 }
 
 size_t String::copyToUTF16 (CharPointer_UTF16::CharType* const buffer, size_t maxBufferSizeBytes) const noexcept
 {
-    return StringCopier<CharPointerType, CharPointer_UTF16>::copyToBuffer (text, buffer, maxBufferSizeBytes);
+    return StringCopier<CharPointerType, CharPointer_UTF16>::copyToBuffer (getCharPointer(), buffer, maxBufferSizeBytes);
 }
 
 size_t String::copyToUTF32 (CharPointer_UTF32::CharType* const buffer, size_t maxBufferSizeBytes) const noexcept
 {
-    return StringCopier<CharPointerType, CharPointer_UTF32>::copyToBuffer (text, buffer, maxBufferSizeBytes);
+    return StringCopier<CharPointerType, CharPointer_UTF32>::copyToBuffer (getCharPointer(), buffer, maxBufferSizeBytes);
 }
 
 //==============================================================================
 size_t String::getNumBytesAsUTF8() const noexcept
 {
-    return CharPointer_UTF8::getBytesRequiredFor (text);
+    return CharPointer_UTF8::getBytesRequiredFor (getCharPointer());
 }
 
 String String::fromUTF8 (const char* const buffer, int bufferSizeBytes)
@@ -2179,6 +2262,7 @@ StringRef::StringRef (const char* stringLiteral) noexcept
    #endif
 {
    #if JUCE_STRING_UTF_TYPE != 8
+    stringCopy.makeShared();  // the text must stay put if this StringRef is moved
     text = stringCopy.getCharPointer();
    #endif
 
@@ -2631,6 +2715,212 @@ public:
             TestUTFConversion <CharPointer_UTF16>::test (*this, r);
         }
 
+        {
+            beginTest ("UTF-8 ASCII runs");
+
+            for (int i = 0; i < 500; ++i)
+            {
+                // mostly-ASCII text with the odd multi-byte character, at every alignment
+                juce_wchar chars[120] = { 0 };
+                auto numChars = r.nextInt (numElementsInArray (chars) - 1);
+
+                for (int j = 0; j < numChars; ++j)
+                    chars[j] = r.nextInt (8) == 0 ? (juce_wchar) (0x80 + r.nextInt (0xd800 - 0x80))
+                                                  : (juce_wchar) (1 + r.nextInt (0x7f));
+
+                auto original = String (CharPointer_UTF32 (chars));
+                char buffer[600];
+                auto offset = r.nextInt (32);
+                auto numBytes = (int) original.copyToUTF8 (buffer + offset, sizeof (buffer) - 32) - 1;
+                auto* text = buffer + offset;
+
+                expectEquals ((int) CharPointer_UTF8 (text).length(), numChars);
+                expectEquals (String::fromUTF8 (text, numBytes), original);
+                expectEquals (String (CharPointer_UTF32 (String (CharPointer_UTF8 (text)).toUTF32())), original);
+                expectEquals (String (CharPointer_UTF16 (original.toUTF16())), original);
+                expect (CharPointer_UTF8::isValidString (text, numBytes));
+
+                auto* firstNonASCII = text;
+
+                while ((uint8) (*firstNonASCII - 1) < 0x7f)
+                    ++firstNonASCII;
+
+                expect (CharPointer_UTF8::findEndOfASCII (text) == firstNonASCII);
+                expect (CharPointer_UTF8::findEndOfASCII (text, (size_t) numBytes) == firstNonASCII);
+
+                if (numBytes > 0)
+                {
+                    auto corruptPos = r.nextInt (numBytes);
+                    auto oldByte = text[corruptPos];
+                    text[corruptPos] = (char) 0xff;
+                    expect (! CharPointer_UTF8::isValidString (text, numBytes));
+                    text[corruptPos] = oldByte;
+                }
+
+                if (firstNonASCII != text + numBytes)
+                    expect (! CharPointer_UTF8::isValidString (text, (int) (firstNonASCII - text) + 1));
+            }
+
+            const char* delimited = "abcdefghijklmnopqrstuvwxyz\"abc\\def";
+            expect (CharPointer_UTF8::findEndOfASCII (delimited, '"', '\\') == delimited + 26);
+            expect (CharPointer_UTF8::findEndOfASCII (delimited + 27, '"', '\\') == delimited + 30);
+            expect (CharPointer_UTF8::findEndOfASCII (delimited + 31, '"', '\\') == delimited + 34);
+            expect (CharPointer_UTF8::findEndOfASCII (delimited, 20, '"', '\\') == delimited + 20);
+            expect (CharPointer_UTF8::findEndOfASCII (delimited, 30, '"', '\\') == delimited + 26);
+
+            auto longRun = String::repeatedString ("abc", 1000) + "\"";
+            expect (CharPointer_UTF8::findEndOfASCII (longRun.toRawUTF8(), '"', '\\') == longRun.toRawUTF8() + 3000);
+
+            // the bounded versions mustn't look beyond the range they're given
+            char unterminated[37];
+            std::fill (std::begin (unterminated), std::end (unterminated), 'x');
+            expect (CharPointer_UTF8::findEndOfASCII (unterminated, sizeof (unterminated)) == std::end (unterminated));
+            expect (CharPointer_UTF8::isValidString (unterminated, (int) sizeof (unterminated)));
+        }
+
+        {
+            beginTest ("UTF-8 throughput");
+
+            auto createText = [&r] (int numBytes, int percentNonASCII)
+            {
+                MemoryOutputStream mo;
+
+                while ((int) mo.getDataSize() < numBytes)
+                {
+                    if (r.nextInt (100) < percentNonASCII)
+                        mo.appendUTF8Char ((juce_wchar) (0xa0 + r.nextInt (0x3000)));
+                    else
+                        mo.writeByte ("abcdefghijklmnopqrstuvwxyz ABCDEFGHIJKLMNOPQRSTUVWXYZ.,:;0123456789+-=()[]{}"[r.nextInt (76)]);
+                }
+
+                return mo.toUTF8();
+            };
+
+            auto measure = [this] (const String& text, const char* description, int numRuns, std::function<size_t()> fn)
+            {
+                size_t total = 0;
+                auto start = Time::getMillisecondCounterHiRes();
+
+                for (int i = 0; i < numRuns; ++i)
+                    total += fn();
+
+                auto seconds = (Time::getMillisecondCounterHiRes() - start) / 1000.0;
+                auto megabytes = (double) text.getNumBytesAsUTF8() * numRuns / (1024.0 * 1024.0);
+
+                logMessage ("  " + String (description).paddedRight (' ', 26)
+                             + String (megabytes / jmax (seconds, 0.000001), 1) + " MB/s");
+                expect (total > 0);
+            };
+
+            for (auto percentNonASCII : { 0, 2, 30 })
+            {
+                logMessage ("  " + String (percentNonASCII) + "% non-ASCII text:");
+                auto text = createText (1024 * 1024, percentNonASCII);
+                auto* utf8 = text.toRawUTF8();
+                auto numBytes = (int) text.getNumBytesAsUTF8();
+                auto numChars = text.length();
+
+                measure (text, "per-character length", 20, [=] { return CharacterFunctions::lengthUpTo (CharPointer_UTF8 (utf8), (size_t) -1); });
+                measure (text, "CharPointer_UTF8::length", 20, [=] { return CharPointer_UTF8 (utf8).length(); });
+                measure (text, "isValidString", 20, [=] { return (size_t) CharPointer_UTF8::isValidString (utf8, numBytes); });
+                measure (text, "String::fromUTF8", 20, [=] { return (size_t) String::fromUTF8 (utf8, numBytes).getNumBytesAsUTF8(); });
+                measure (text, "toUTF16", 20, [=] { return (size_t) String (text).toUTF16()[numChars / 2]; });
+                measure (text, "toUTF32", 20, [=] { return (size_t) String (text).toUTF32()[numChars / 2]; });
+
+                auto json = "[\"" + text + "\"]";
+                measure (json, "JSON::parse", 5, [=] { return (size_t) JSON::parse (json)[0].toString().length(); });
+
+                auto xml = "<a b=\"" + text + "\">" + text + "</a>";
+                measure (xml, "XmlDocument::parse", 5, [=] { return (size_t) std::unique_ptr<XmlElement> (XmlDocument::parse (xml))->getAllSubText().length(); });
+            }
+        }
+
+        {
+            beginTest ("Small strings");
+
+            String shortString ("short"), longString ("a string that's too long to fit inside the object");
+            String shortCopy (shortString), longCopy (longString);
+
+            expect (shortCopy == shortString && shortCopy.getCharPointer() != shortString.getCharPointer());
+            expect (longCopy == longString && longCopy.getCharPointer() == longString.getCharPointer());
+            expectEquals (shortCopy.getReferenceCount(), 1);
+            expectEquals (longCopy.getReferenceCount(), 2);
+
+            expect (Identifier ("short").toString().getCharPointer() == Identifier (String ("short")).toString().getCharPointer());
+
+            for (int i = 0; i < 200; ++i)
+            {
+                auto numChars = r.nextInt (40);
+                juce_wchar buffer[41] = { 0 };
+
+                for (int j = 0; j < numChars; ++j)
+                    buffer[j] = (juce_wchar) (r.nextBool() ? 32 + r.nextInt (95) : 0xa0 + r.nextInt (0x3000));
+
+                const String original = CharPointer_UTF32 (buffer);
+                String built;
+
+                for (int j = 0; j < numChars; ++j)
+                    built += buffer[j];
+
+                expectEquals (built, original);
+                expectEquals (original.length(), numChars);
+
+                String moved (std::move (built)), assigned, swapped;
+                assigned = moved;
+                swapped.swapWith (assigned);
+                expect (assigned.isEmpty());
+                expectEquals (swapped, original);
+
+                moved.preallocateBytes ((size_t) r.nextInt (64));
+                expectEquals (moved, original);
+                expect (String (moved.toUTF16()) == original);
+                expect (String (moved.toUTF32()) == original);
+                expectEquals (moved + moved, String (moved.toWideCharPointer()) + original);
+
+                auto split = r.nextInt (numChars + 1);
+                expectEquals (original.substring (0, split) + original.substring (split), original);
+            }
+
+            auto measure = [this] (const char* description, std::function<int(int)> fn)
+            {
+                const int numRuns = 200000;
+                int total = 0;
+                auto start = Time::getMillisecondCounterHiRes();
+
+                for (int i = 0; i < numRuns; ++i)
+                    total += fn (i);
+
+                auto seconds = (Time::getMillisecondCounterHiRes() - start) / 1000.0;
+
+                logMessage ("  " + String (description).paddedRight (' ', 26)
+                             + String (numRuns / jmax (seconds, 0.000001) / 1000000.0, 2) + "M ops/s");
+                expect (total > 0);
+            };
+
+            measure ("integer to String", [] (int i) { return String (i).length(); });
+            measure ("literal copy", [] (int) { String s ("width"); return String (s).length(); });
+            measure ("short concatenation", [] (int i) { return ("item_" + String (i & 255)).length(); });
+            measure ("substring", [&] (int i) { return longString.substring (i & 7, (i & 7) + 12).length(); });
+            measure ("StringArray::addTokens", [] (int) { StringArray a; a.addTokens ("one two three four", false); return a.size(); });
+
+            StringArray typicalStrings;
+            typicalStrings.addTokens ("x y width height name id value gain 0 1 -1 3.5 true false "
+                                      "/usr/local/lib/libsomething.so some longer sentence-like bit of text", false);
+
+            for (int i = 0; i < 100; ++i)
+                typicalStrings.add (String (r.nextInt (100000)));
+
+            int numOnHeap = 0;
+
+            for (auto& s : typicalStrings)
+                if (String (s).getCharPointer() == s.getCharPointer())
+                    ++numOnHeap;
+
+            logMessage ("  heap-allocated fraction of typical short strings: "
+                         + String (numOnHeap) + "/" + String (typicalStrings.size()));
+            expect (numOnHeap < typicalStrings.size() / 10);
+        }
+
         {
             beginTest ("StringArray");
 
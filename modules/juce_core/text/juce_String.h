@@ -27,9 +27,14 @@ namespace juce
 /**
     The JUCE String class!
 
-    Using a reference-counted internal representation, these strings are fast
-    and efficient, and there are methods to do just about any operation you'll ever
-    dream of.
+    Short strings are stored inside the String object itself, and longer ones use a
+    reference-counted internal representation, so these strings are fast and efficient,
+    and there are methods to do just about any operation you'll ever dream of.
+
+    Because of the inline storage, a String is 16 bytes rather than the size of a single
+    pointer. It also means that a pointer returned by getCharPointer(), toRawUTF8() and
+    similar methods for a short string points into that String object, so it becomes
+    invalid when that object is deleted, even if copies of the string are still around.
 
     @see StringArray, StringPairArray
 
@@ -245,7 +250,7 @@ public:
             auto byteOffsetOfNull = getByteOffsetOfEnd();
 
             preallocateBytes (byteOffsetOfNull + extraBytesNeeded);
-            CharPointerType (addBytesToPointer (text.getAddress(), (int) byteOffsetOfNull))
+            CharPointerType (addBytesToPointer (getCharPointer().getAddress(), (int) byteOffsetOfNull))
                 .writeWithCharLimit (startOfTextToAppend, (int) numChars);
         }
     }
@@ -273,7 +278,7 @@ public:
                 auto byteOffsetOfNull = getByteOffsetOfEnd();
 
                 preallocateBytes (byteOffsetOfNull + extraBytesNeeded);
-                CharPointerType (addBytesToPointer (text.getAddress(), (int) byteOffsetOfNull))
+                CharPointerType (addBytesToPointer (getCharPointer().getAddress(), (int) byteOffsetOfNull))
                     .writeWithCharLimit (textToAppend, (int) numChars);
             }
         }
@@ -293,13 +298,13 @@ public:
         Note that there's also an isNotEmpty() method to help write readable code.
         @see containsNonWhitespaceChars()
     */
-    inline bool isEmpty() const noexcept                    { return text.isEmpty(); }
+    inline bool isEmpty() const noexcept                    { return getCharPointer().isEmpty(); }
 
     /** Returns true if the string contains at least one character.
         Note that there's also an isEmpty() method to help write readable code.
         @see containsNonWhitespaceChars()
     */
-    inline bool isNotEmpty() const noexcept                 { return ! text.isEmpty(); }
+    inline bool isNotEmpty() const noexcept                 { return ! getCharPointer().isEmpty(); }
 
     /** Resets this string to be empty. */
     void clear() noexcept;
@@ -1061,9 +1066,10 @@ public:
 
         Because it returns a reference to the string's internal data, the pointer
         that is returned must not be stored anywhere, as it can be deleted whenever the
-        string changes.
+        string changes. Short strings keep their characters inside the String object
+        itself, so the pointer also mustn't outlive this particular String object.
     */
-    inline CharPointerType getCharPointer() const noexcept      { return text; }
+    inline CharPointerType getCharPointer() const noexcept      { return CharPointerType (isLocal() ? localText : sharedText); }
 
     /** Returns a pointer to a UTF-8 version of this string.
 
@@ -1251,7 +1257,26 @@ public:
 
 private:
     //==============================================================================
-    CharPointerType text;
+    enum { storageSize = 16 };
+
+    // Strings that fit are stored in localText, so need no heap allocation. Longer ones
+    // live in a ref-counted, copy-on-write buffer that's shared by all copies of the string.
+    // The last byte of the storage is zero for a local string, and non-zero for a shared one.
+    union
+    {
+        CharPointerType::CharType* sharedText;
+        CharPointerType::CharType localText[(storageSize - 1) / sizeof (CharPointerType::CharType)];
+        uint8 storage[storageSize];
+    };
+
+    bool isLocal() const noexcept       { return storage[storageSize - 1] == 0; }
+    void setShared (CharPointerType::CharType*) noexcept;
+    CharPointerType allocate (size_t numBytes);
+    void makeShared();
+
+    friend class StringHolder;
+    friend class StringPool;
+    friend class StringRef;
 
     //==============================================================================
     struct PreallocationBytes
@@ -23,13 +23,11 @@
 namespace juce
 {
 
-static const int minNumberOfStringsForGarbageCollection = 300;
+static const int numShards = 16;
+static const int minNumberOfStringsForGarbageCollection = 300 / numShards;
 static const uint32 garbageCollectionInterval = 30000;
 
-
-StringPool::StringPool() noexcept  : lastGarbageCollectionTime (0) {}
-StringPool::~StringPool() {}
-
+//==============================================================================
 struct StartEndString
 {
     StartEndString (String::CharPointerType s, String::CharPointerType e) noexcept : start (s), end (e) {}
@@ -58,44 +56,99 @@ static int compareStrings (const StartEndString& string1, const String& string2)
     return 0;
 }
 
+// This must produce the same results as StringPool::hashLiteral() for ASCII strings
+static uint64 addToHash (uint64 hash, juce_wchar c) noexcept    { return (hash ^ (uint64) c) * 1099511628211ULL; }
+static const uint64 initialHash = 14695981039346656037ULL;
+
+template <typename CharPointerType>
+static uint64 hashString (CharPointerType text) noexcept
+{
+    auto hash = initialHash;
+
+    while (! text.isEmpty())
+        hash = addToHash (hash, text.getAndAdvance());
+
+    return hash;
+}
+
+static uint64 hashString (const String& text) noexcept          { return hashString (text.getCharPointer()); }
+
+static uint64 hashString (const StartEndString& text) noexcept
+{
+    auto hash = initialHash;
+
+    for (auto t = text.start; t < text.end && ! t.isEmpty();)
+        hash = addToHash (hash, t.getAndAdvance());
+
+    return hash;
+}
+
+//==============================================================================
+// Wraps a string that's being looked up along with its hash, so that it only gets hashed once
 template <typename NewStringType>
-static String addPooledString (Array<String>& strings, const NewStringType& newString)
+struct PoolKey
 {
-    int start = 0;
-    int end = strings.size();
+    operator String() const                 { return String (text); }
 
-    while (start < end)
+    friend bool operator== (const String& pooled, const PoolKey& key) noexcept
     {
-        const String& startString = strings.getReference (start);
-        const int startComp = compareStrings (newString, startString);
-
-        if (startComp == 0)
-            return startString;
+        return compareStrings (key.text, pooled) == 0;
+    }
 
-        const int halfway = (start + end) / 2;
+    const NewStringType& text;
+    uint64 hash;
+};
 
-        if (halfway == start)
-        {
-            if (startComp > 0)
-                ++start;
+struct PoolHashFunctions
+{
+    static uint64 generateHash (const String& s) noexcept          { return hashString (s); }
 
-            break;
-        }
+    template <typename NewStringType>
+    static uint64 generateHash (const PoolKey<NewStringType>& key) noexcept  { return key.hash; }
+};
 
-        const String& halfwayString = strings.getReference (halfway);
-        const int halfwayComp = compareStrings (newString, halfwayString);
+struct StringPool::Shard
+{
+    CriticalSection lock;
+    FlatHashSet<String, PoolHashFunctions> strings;
+    uint32 lastGarbageCollectionTime = 0;
 
-        if (halfwayComp == 0)
-            return halfwayString;
+    void garbageCollect()
+    {
+        // a string that's only referenced by the pool can't be in use anywhere else, and
+        // nobody can get hold of it again without going through this lock
+        strings.removeIf ([] (const String& s) { return s.getReferenceCount() == 1; });
+        lastGarbageCollectionTime = Time::getApproximateMillisecondCounter();
+    }
 
-        if (halfwayComp > 0)
-            start = halfway;
-        else
-            end = halfway;
+    void garbageCollectIfNeeded()
+    {
+        if (strings.size() > minNumberOfStringsForGarbageCollection
+             && Time::getApproximateMillisecondCounter() > lastGarbageCollectionTime + garbageCollectionInterval)
+            garbageCollect();
     }
+};
+
+//==============================================================================
+StringPool::StringPool() noexcept  : shards (new Shard[numShards]) {}
+StringPool::~StringPool() {}
+
+template <typename NewStringType>
+String StringPool::addPooledString (const NewStringType& newString, uint64 hash)
+{
+    // the top bits choose the shard, as the hash table uses the bottom ones
+    auto& shard = shards[(int) (hash >> 60) & (numShards - 1)];
+
+    const ScopedLock sl (shard.lock);
+    shard.garbageCollectIfNeeded();
+    auto& pooled = shard.strings.getOrAdd (PoolKey<NewStringType> { newString, hash });
 
-    strings.insert (start, newString);
-    return strings.getReference (start);
+    // pooled strings must live on the heap, even if they're short enough to be stored
+    // inline, so that every copy shares the same character pointer
+    if (pooled.isLocal())
+        const_cast<String&> (pooled).makeShared();
+
+    return pooled;
 }
 
 String StringPool::getPooledString (const char* const newString)
@@ -103,9 +156,19 @@ String StringPool::getPooledString (const char* const newString)
     if (newString == nullptr || *newString == 0)
         return {};
 
-    const ScopedLock sl (lock);
-    garbageCollectIfNeeded();
-    return addPooledString (strings, CharPointer_UTF8 (newString));
+    CharPointer_UTF8 text (newString);
+    return addPooledString (text, hashString (text));
+}
+
+String StringPool::getPooledString (const char* const newString, uint64 precalculatedHash)
+{
+    if (newString == nullptr || *newString == 0)
+        return {};
+
+    CharPointer_UTF8 text (newString);
+    jassert (precalculatedHash == 0 || precalculatedHash == hashString (text));
+
+    return addPooledString (text, precalculatedHash != 0 ? precalculatedHash : hashString (text));
 }
 
 String StringPool::getPooledString (String::CharPointerType start, String::CharPointerType end)
@@ -113,9 +176,8 @@ String StringPool::getPooledString (String::CharPointerType start, String::CharP
     if (start.isEmpty() || start == end)
         return {};
 
-    const ScopedLock sl (lock);
-    garbageCollectIfNeeded();
-    return addPooledString (strings, StartEndString (start, end));
+    StartEndString text (start, end);
+    return addPooledString (text, hashString (text));
 }
 
 String StringPool::getPooledString (StringRef newString)
@@ -123,9 +185,7 @@ String StringPool::getPooledString (StringRef newString)
     if (newString.isEmpty())
         return {};
 
-    const ScopedLock sl (lock);
-    garbageCollectIfNeeded();
-    return addPooledString (strings, newString.text);
+    return addPooledString (newString.text, hashString (newString.text));
 }
 
 String StringPool::getPooledString (const String& newString)
@@ -133,27 +193,16 @@ String StringPool::getPooledString (const String& newString)
     if (newString.isEmpty())
         return {};
 
-    const ScopedLock sl (lock);
-    garbageCollectIfNeeded();
-    return addPooledString (strings, newString);
-}
-
-void StringPool::garbageCollectIfNeeded()
-{
-    if (strings.size() > minNumberOfStringsForGarbageCollection
-         && Time::getApproximateMillisecondCounter() > lastGarbageCollectionTime + garbageCollectionInterval)
-        garbageCollect();
+    return addPooledString (newString, hashString (newString));
 }
 
 void StringPool::garbageCollect()
 {
-    const ScopedLock sl (lock);
-
-    for (int i = strings.size(); --i >= 0;)
-        if (strings.getReference(i).getReferenceCount() == 1)
-            strings.remove (i);
-
-    lastGarbageCollectionTime = Time::getApproximateMillisecondCounter();
+    for (size_t i = 0; i < (size_t) numShards; ++i)
+    {
+        const ScopedLock sl (shards[i].lock);
+        shards[i].garbageCollect();
+    }
 }
 
 StringPool& StringPool::getGlobalPool() noexcept
@@ -162,4 +211,139 @@ StringPool& StringPool::getGlobalPool() noexcept
     return pool;
 }
 
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class StringPoolTests  : public UnitTest
+{
+public:
+    StringPoolTests() : UnitTest ("StringPool", "Text") {}
+
+    struct PoolingThread  : public Thread
+    {
+        PoolingThread (std::function<void()> f) : Thread ("StringPool test"), function (std::move (f)) {}
+        ~PoolingThread() override   { stopThread (-1); }
+
+        void run() override         { function(); }
+
+        std::function<void()> function;
+    };
+
+    static void runOnThreads (int numThreads, std::function<void (int)> function)
+    {
+        OwnedArray<PoolingThread> threads;
+
+        for (int i = 0; i < numThreads; ++i)
+            threads.add (new PoolingThread ([=] { function (i); }));
+
+        for (auto* t : threads)
+            t->startThread();
+
+        for (auto* t : threads)
+            t->waitForThreadToExit (-1);
+    }
+
+    void runTest() override
+    {
+        beginTest ("Pooling");
+        {
+            StringPool pool;
+            String text ("abc_def");
+            auto pooled = pool.getPooledString (text);
+
+            expect (pooled == text);
+            expect (pooled.getCharPointer() == pool.getPooledString ("abc_def").getCharPointer());
+            expect (pooled.getCharPointer() == pool.getPooledString (StringRef ("abc_def")).getCharPointer());
+            expect (pooled.getCharPointer() == pool.getPooledString ("abc_def", StringPool::hashLiteral ("abc_def")).getCharPointer());
+            expect (pooled.getCharPointer() == pool.getPooledString (String ("abc_def")).getCharPointer());
+
+            String longer ("abc_def_ghi");
+            auto start = longer.getCharPointer();
+            expect (pooled.getCharPointer() == pool.getPooledString (start, start + 7).getCharPointer());
+            expect (pool.getPooledString (start, start + 3) == "abc");
+
+            expect (pool.getPooledString (String()).isEmpty());
+            expect (pool.getPooledString ("").isEmpty());
+
+            auto unicode = CharPointer_UTF8 ("\xc3\xa9t\xc3\xa9");
+            expectEquals (StringPool::hashLiteral ("\xc3\xa9t\xc3\xa9"), (uint64) 0);
+            expect (pool.getPooledString (String (unicode)).getCharPointer()
+                      == pool.getPooledString ("\xc3\xa9t\xc3\xa9", 0).getCharPointer());
+
+            pool.garbageCollect();
+            expect (pooled.getCharPointer() == pool.getPooledString (text).getCharPointer());
+        }
+
+        beginTest ("Identifiers");
+        {
+            static_assert (StringPool::hashLiteral ("width") != 0, "literal hashes should be calculated at compile-time");
+
+            Identifier a ("width"), b (String ("width"));
+            auto c = JUCE_IDENTIFIER ("width");
+
+            expect (a == b);
+            expect (a == c);
+            expect (c != JUCE_IDENTIFIER ("height"));
+            expect (c.toString() == "width");
+        }
+
+        beginTest ("Pooling from multiple threads");
+        {
+            StringPool pool;
+            const int numThreads = 4, numNames = 2000;
+            Array<String> results[numThreads];
+
+            runOnThreads (numThreads, [&] (int threadIndex)
+            {
+                for (int i = 0; i < numNames; ++i)
+                {
+                    auto text = "name" + String ((i * (threadIndex + 1) * 7919) % numNames);
+                    results[threadIndex].add (pool.getPooledString (text));
+                }
+            });
+
+            int numMismatches = 0;
+
+            for (int t = 0; t < numThreads; ++t)
+                for (int i = 0; i < numNames; ++i)
+                    if (results[t][i].getCharPointer() != pool.getPooledString ("name" + String ((i * (t + 1) * 7919) % numNames)).getCharPointer())
+                        ++numMismatches;
+
+            expectEquals (numMismatches, 0);
+        }
+
+        beginTest ("Benchmark");
+        {
+            StringArray names;
+
+            for (int i = 0; i < 1000; ++i)
+                names.add ("identifier_" + String (i));
+
+            for (auto numThreads : { 1, 2, 4 })
+            {
+                const int numPerThread = 400000 / numThreads;
+                auto start = Time::getMillisecondCounterHiRes();
+
+                runOnThreads (numThreads, [&] (int threadIndex)
+                {
+                    for (int i = 0; i < numPerThread; ++i)
+                    {
+                        Identifier id (names[(i + threadIndex * 97) % names.size()]);
+                        ignoreUnused (id);
+                    }
+                });
+
+                auto seconds = (Time::getMillisecondCounterHiRes() - start) / 1000.0;
+
+                logMessage ("  " + String (numThreads) + " thread(s): "
+                              + String (roundToInt (numPerThread * numThreads / seconds)) + " Identifiers/sec");
+            }
+        }
+    }
+};
+
+static StringPoolTests stringPoolTests;
+
+#endif
+
 } // namespace juce
@@ -34,6 +34,10 @@ namespace juce
     compare two pooled strings for equality, as you can simply compare their pointers. It
     also cuts down on storage if you're using many copies of the same string.
 
+    The strings are held in a number of separately-locked hash tables, chosen by the hash
+    of each string, so that threads which are pooling strings at the same time will rarely
+    have to wait for each other.
+
     @tags{Core}
 */
 class JUCE_API  StringPool
@@ -67,6 +71,23 @@ public:
     */
     String getPooledString (String::CharPointerType start, String::CharPointerType end);
 
+    /** Returns a pointer to a copy of the string that is passed in, using a hash of it which
+        has already been calculated with hashLiteral().
+        The pool will always return the same String object when asked for a string that matches it.
+    */
+    String getPooledString (const char* original, uint64 precalculatedHash);
+
+    /** Calculates the hash that the pool uses for a string literal, so that it can be done at
+        compile-time. If the string contains any non-ASCII characters, this returns 0, which
+        tells the pool to calculate the hash itself.
+        @see JUCE_IDENTIFIER
+    */
+    static constexpr uint64 hashLiteral (const char* text, uint64 hash = 14695981039346656037ULL) noexcept
+    {
+        return *text == 0 ? hash
+                          : ((uint8) *text >= 0x80 ? 0 : hashLiteral (text + 1, (hash ^ (uint8) *text) * 1099511628211ULL));
+    }
+
     //==============================================================================
     /** Scans the pool, and removes any strings that are unreferenced.
         You don't generally need to call this - it'll be called automatically when the pool grows
@@ -78,11 +99,11 @@ public:
     static StringPool& getGlobalPool() noexcept;
 
 private:
-    Array<String> strings;
-    CriticalSection lock;
-    uint32 lastGarbageCollectionTime;
+    struct Shard;
+    std::unique_ptr<Shard[]> shards;
 
-    void garbageCollectIfNeeded();
+    template <typename NewStringType>
+    String addPooledString (const NewStringType&, uint64 hash);
 
     JUCE_DECLARE_NON_COPYABLE (StringPool)
 };
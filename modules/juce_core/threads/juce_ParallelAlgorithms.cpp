@@ -0,0 +1,340 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 5 End-User License
+   Agreement and JUCE 5 Privacy Policy (both updated and effective as of the
+   27th April 2017).
+
+   End User License Agreement: www.juce.com/juce-5-licence
+   Privacy Policy: www.juce.com/juce-5-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+namespace ParallelAlgorithmHelpers
+{
+    int getNumChunks (int64 numItems, int minItemsPerChunk, ThreadPool* pool) noexcept
+    {
+        if (numItems <= 0)
+            return 0;
+
+        auto numThreads = (pool != nullptr ? pool->getNumThreads()
+                                           : jmax (1, SystemStats::getNumCpus())) + 1;
+
+        // a few chunks per thread lets the faster threads pick up the slack
+        // if some of the chunks take longer than others
+        auto maxChunks = (int64) numThreads * 4;
+
+        return (int) jlimit ((int64) 1, maxChunks, numItems / jmax (1, minItemsPerChunk));
+    }
+
+    struct ChunkRunner
+    {
+        ChunkRunner (const std::function<void (int)>& f, int num)  : function (&f), numChunks (num) {}
+
+        void run()
+        {
+            for (;;)
+            {
+                auto chunk = nextChunk++;
+
+                if (chunk >= numChunks)
+                    return;
+
+                try
+                {
+                    (*function) (chunk);
+                }
+                catch (...)
+                {
+                    const SpinLock::ScopedLockType sl (exceptionLock);
+
+                    if (exception == nullptr)
+                        exception = std::current_exception();
+                }
+
+                if (++numChunksFinished == numChunks)
+                    finished.signal();
+            }
+        }
+
+        // this is only used by threads that have claimed a chunk, which the caller waits for
+        const std::function<void (int)>* function;
+        const int numChunks;
+        std::atomic<int> nextChunk { 0 }, numChunksFinished { 0 };
+        WaitableEvent finished;
+
+        SpinLock exceptionLock;
+        std::exception_ptr exception;
+
+        JUCE_DECLARE_NON_COPYABLE (ChunkRunner)
+    };
+
+    void runChunks (int numChunks, const std::function<void (int)>& chunkFunction, ThreadPool* pool)
+    {
+        if (numChunks <= 0)
+            return;
+
+        if (numChunks == 1)
+        {
+            chunkFunction (0);
+            return;
+        }
+
+        if (pool == nullptr)
+        {
+            SharedResourcePointer<DefaultParallelThreadPool> defaultPool;
+            runChunks (numChunks, chunkFunction, defaultPool);
+            return;
+        }
+
+        // The pool's jobs keep the runner alive, as they might not start until after all
+        // the chunks have been done and this function has returned.
+        auto runner = std::make_shared<ChunkRunner> (chunkFunction, numChunks);
+
+        for (int i = jmin (numChunks - 1, pool->getNumThreads()); --i >= 0;)
+            pool->addTask ([runner] { runner->run(); });
+
+        runner->run();
+        runner->finished.wait();
+
+        if (runner->exception != nullptr)
+            std::rethrow_exception (runner->exception);
+    }
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ParallelAlgorithmsTests  : public UnitTest
+{
+public:
+    ParallelAlgorithmsTests()  : UnitTest ("ParallelAlgorithms", "Threads") {}
+
+    void runTest() override
+    {
+        auto random = getRandom();
+        ThreadPool pool (4);
+
+        beginTest ("parallelFor");
+        {
+            for (auto numItems : { 0, 1, 7, 1000, 100000 })
+            {
+                std::vector<std::atomic<int>> counts ((size_t) numItems);
+
+                for (auto& c : counts)
+                    c = 0;
+
+                parallelFor (0, numItems, [&] (int i) { ++counts[(size_t) i]; }, 1, &pool);
+
+                expect (std::all_of (counts.begin(), counts.end(), [] (const std::atomic<int>& c) { return c.load() == 1; }));
+            }
+
+            std::atomic<int64> total { 0 };
+            parallelForChunks ((int64) 10, (int64) 10010, [&] (int64 start, int64 end)
+            {
+                int64 sum = 0;
+
+                for (auto i = start; i < end; ++i)
+                    sum += i;
+
+                total += sum;
+            }, 100, &pool);
+
+            expectEquals (total.load(), (int64) 50095000);
+        }
+
+        beginTest ("Nested calls");
+        {
+            std::atomic<int> count { 0 };
+
+            parallelFor (0, 16, [&] (int)
+            {
+                parallelFor (0, 16, [&] (int) { ++count; }, 1, &pool);
+            }, 1, &pool);
+
+            expectEquals (count.load(), 256);
+        }
+
+        beginTest ("Exceptions");
+        {
+            bool caught = false;
+
+            try
+            {
+                parallelFor (0, 100, [&] (int i)
+                {
+                    if (i == 50)
+                        throw std::runtime_error ("fail");
+                }, 1, &pool);
+            }
+            catch (std::runtime_error&)
+            {
+                caught = true;
+            }
+
+            expect (caught);
+        }
+
+        beginTest ("parallelReduce");
+        {
+            Array<int> values;
+
+            for (int i = 0; i < 50000; ++i)
+                values.add (random.nextInt (1000) - 500);
+
+            int64 expectedSum = 0;
+
+            for (auto v : values)
+                expectedSum += v;
+
+            auto sum = parallelReduce (0, values.size(), (int64) 0,
+                                       [&] (int i) { return (int64) values.getUnchecked (i); },
+                                       [] (int64 a, int64 b) { return a + b; }, 16, &pool);
+
+            expectEquals (sum, expectedSum);
+
+            auto maxValue = parallelReduce (0, values.size(), -1000,
+                                            [&] (int i) { return values.getUnchecked (i); },
+                                            [] (int a, int b) { return jmax (a, b); }, 1, &pool);
+
+            expectEquals (maxValue, *std::max_element (values.begin(), values.end()));
+
+            auto empty = parallelReduce (5, 5, String ("x"),
+                                         [] (int i) { return String (i); },
+                                         [] (const String& a, const String& b) { return a + b; }, 1, &pool);
+
+            expectEquals (empty, String ("x"));
+
+            // the chunks are combined in order, so non-commutative combiners work too
+            auto joined = parallelReduce (0, 200, String(),
+                                          [] (int i) { return String (i % 10); },
+                                          [] (const String& a, const String& b) { return a + b; }, 1, &pool);
+
+            expectEquals (joined, String::repeatedString ("0123456789", 20));
+        }
+
+        beginTest ("parallelTransform");
+        {
+            const int numItems = 10000;
+            HeapBlock<float> source (numItems), dest (numItems);
+
+            for (int i = 0; i < numItems; ++i)
+                source[i] = (float) i;
+
+            parallelTransform (source.get(), dest.get(), numItems, [] (float x) { return x * 2.0f; }, 64, &pool);
+
+            bool allOk = true;
+
+            for (int i = 0; i < numItems; ++i)
+                allOk = allOk && dest[i] == (float) i * 2.0f;
+
+            expect (allOk);
+
+            parallelTransform (source.get(), source.get(), numItems, [] (float x) { return -x; }, 64, &pool);
+            expectEquals (source[123], -123.0f);
+        }
+
+        beginTest ("parallelSort");
+        {
+            for (auto numItems : { 0, 1, 100, 10000, 100000, 123457 })
+            {
+                Array<int> values, expected;
+
+                for (int i = 0; i < numItems; ++i)
+                    values.add (random.nextInt (numItems / 2 + 1));
+
+                expected = values;
+                expected.sort();
+
+                parallelSort (values, comparator, false, &pool);
+                expect (values == expected);
+            }
+
+            // check that equivalent items stay in order when asked
+            Array<int64> pairs;
+
+            for (int i = 0; i < 100000; ++i)
+                pairs.add (((int64) random.nextInt (100) << 32) | i);
+
+            HighWordComparator highWords;
+            auto expected = pairs;
+            expected.sort (highWords, true);
+
+            parallelSort (pairs, highWords, true, &pool);
+            expect (pairs == expected);
+
+            Array<int> partial;
+
+            for (int i = 0; i < 50000; ++i)
+                partial.add (50000 - i);
+
+            parallelSortArray (comparator, partial.begin(), 10000, 39999, false, &pool);
+
+            expectEquals (partial[0], 50000);
+            expectEquals (partial[9999], 40001);
+            expectEquals (partial[10000], 10001);
+            expectEquals (partial[39999], 40000);
+            expectEquals (partial[40000], 10000);
+        }
+
+        beginTest ("Benchmark");
+        {
+            SharedResourcePointer<DefaultParallelThreadPool> defaultPool;
+            Array<int> values;
+
+            for (int i = 0; i < 1000000; ++i)
+                values.add (random.nextInt());
+
+            auto copy = values;
+
+            auto start = Time::getHighResolutionTicks();
+            copy.sort();
+            auto serialTime = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+
+            start = Time::getHighResolutionTicks();
+            parallelSort (values, comparator);
+            auto parallelTime = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+
+            expect (values == copy);
+
+            logMessage ("  sorting 1000000 ints: serial " + String (serialTime * 1000.0, 1) + " ms, parallel "
+                          + String (parallelTime * 1000.0, 1) + " ms with "
+                          + String (defaultPool->getNumThreads()) + " threads");
+        }
+    }
+
+private:
+    struct HighWordComparator
+    {
+        static int compareElements (int64 a, int64 b) noexcept
+        {
+            return (int) (a >> 32) - (int) (b >> 32);
+        }
+    };
+
+    DefaultElementComparator<int> comparator;
+};
+
+static ParallelAlgorithmsTests parallelAlgorithmsTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,315 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 5 End-User License
+   Agreement and JUCE 5 Privacy Policy (both updated and effective as of the
+   27th April 2017).
+
+   End User License Agreement: www.juce.com/juce-5-licence
+   Privacy Policy: www.juce.com/juce-5-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    The ThreadPool that the parallel algorithms use when they aren't given one.
+
+    It has one thread per CPU core. Get hold of it with a
+    SharedResourcePointer<DefaultParallelThreadPool>: it's created when the first of
+    these is made, and deleted when the last one goes away, so its threads are stopped
+    before JUCE shuts down rather than during static destruction.
+
+    An algorithm that's called without a pool only keeps it alive while it runs, so if
+    you call them often, keep a SharedResourcePointer to it somewhere long-lived (e.g. in
+    your application or plug-in object) to avoid starting new threads each time. It can
+    also be shared by any other code that needs somewhere to run short jobs.
+
+    @see parallelFor, parallelReduce, parallelTransform, parallelSortArray
+
+    @tags{Core}
+*/
+class JUCE_API DefaultParallelThreadPool  : public ThreadPool
+{
+public:
+    DefaultParallelThreadPool() = default;
+};
+
+#ifndef DOXYGEN
+/** This is an internal helper for the parallel algorithms. */
+namespace ParallelAlgorithmHelpers
+{
+    /** Returns the number of chunks to split a range into, so that each thread gets a few
+        of them, but none of them has fewer than minItemsPerChunk items.
+    */
+    JUCE_API int getNumChunks (int64 numItems, int minItemsPerChunk, ThreadPool* pool) noexcept;
+
+    /** Calls chunkFunction once for each chunk index, using the pool's threads and the
+        calling thread, and returns once they've all finished.
+    */
+    JUCE_API void runChunks (int numChunks, const std::function<void (int)>& chunkFunction, ThreadPool* pool);
+
+    template <typename IndexType>
+    IndexType getChunkStart (IndexType start, IndexType end, int chunk, int numChunks) noexcept
+    {
+        return (IndexType) (start + (IndexType) ((int64) (end - start) * chunk / numChunks));
+    }
+}
+#endif
+
+//==============================================================================
+/**
+    Calls a function for each index in a range, spreading the calls across several threads.
+
+    The range is split into chunks of consecutive indexes, which are handed out to the
+    pool's threads. The calling thread also works on them, so it's safe to call this
+    from inside one of the pool's own jobs. The function returns when all the calls have
+    finished. If a call throws an exception, the rest of its chunk is skipped, and the
+    exception is rethrown once the other chunks are done.
+
+    e.g. @code
+    parallelFor (0, buffer.getNumChannels(), [&] (int channel)
+    {
+        analyseChannel (buffer.getReadPointer (channel), buffer.getNumSamples());
+    });
+    @endcode
+
+    @param start             the first index
+    @param end               the index after the last one to use
+    @param function          a function that takes an index, which will be called concurrently
+    @param minItemsPerChunk  the smallest number of indexes that a thread should be given at
+                             a time. If the function is very quick, set this high enough that
+                             each chunk takes at least a few microseconds.
+    @param pool              the pool to use, or nullptr for the DefaultParallelThreadPool
+
+    @see parallelForChunks, parallelReduce
+*/
+template <typename IndexType, typename FunctionType>
+void parallelFor (IndexType start, IndexType end, FunctionType&& function,
+                  int minItemsPerChunk = 1, ThreadPool* pool = nullptr)
+{
+    parallelForChunks (start, end, [&function] (IndexType chunkStart, IndexType chunkEnd)
+                       {
+                           for (auto i = chunkStart; i < chunkEnd; ++i)
+                               function (i);
+                       },
+                       minItemsPerChunk, pool);
+}
+
+/**
+    Splits a range of indexes into chunks, and calls a function for each chunk on
+    several threads.
+
+    This works like parallelFor(), but the function is given the start and end of each
+    chunk, so that it can handle the items more efficiently than one at a time.
+
+    @see parallelFor
+*/
+template <typename IndexType, typename FunctionType>
+void parallelForChunks (IndexType start, IndexType end, FunctionType&& function,
+                        int minItemsPerChunk = 1, ThreadPool* pool = nullptr)
+{
+    if (end <= start)
+        return;
+
+    auto numChunks = ParallelAlgorithmHelpers::getNumChunks ((int64) (end - start), minItemsPerChunk, pool);
+
+    ParallelAlgorithmHelpers::runChunks (numChunks, [&] (int chunk)
+    {
+        function (ParallelAlgorithmHelpers::getChunkStart (start, end, chunk, numChunks),
+                  ParallelAlgorithmHelpers::getChunkStart (start, end, chunk + 1, numChunks));
+    }, pool);
+}
+
+/**
+    Calls a function for each index in a range on several threads, and combines the
+    values that it returns.
+
+    Each thread combines the values from its own chunk of the range, and then the
+    results of the chunks are combined in order, starting with initialValue. As the
+    chunks depend on the number of threads, the combining function should be associative,
+    and if it works on floating-point values, the result may vary slightly between
+    machines.
+
+    e.g. @code
+    auto peak = parallelReduce (0, numSamples, 0.0f,
+                                [=] (int i) { return std::abs (samples[i]); },
+                                [] (float a, float b) { return jmax (a, b); }, 4096);
+    @endcode
+
+    @param start             the first index
+    @param end               the index after the last one to use
+    @param initialValue      the value that the results are combined with. This is returned
+                             if the range is empty.
+    @param itemFunction      a function that takes an index and returns a value
+    @param combiner          a function that takes two values and returns their combination
+    @param minItemsPerChunk  the smallest number of indexes that a thread should be given at a time
+    @param pool              the pool to use, or nullptr for the DefaultParallelThreadPool
+*/
+template <typename ValueType, typename IndexType, typename FunctionType, typename CombinerType>
+ValueType parallelReduce (IndexType start, IndexType end, ValueType initialValue,
+                          FunctionType&& itemFunction, CombinerType&& combiner,
+                          int minItemsPerChunk = 1, ThreadPool* pool = nullptr)
+{
+    if (end <= start)
+        return initialValue;
+
+    auto numChunks = ParallelAlgorithmHelpers::getNumChunks ((int64) (end - start), minItemsPerChunk, pool);
+    std::vector<ValueType> chunkResults ((size_t) numChunks, initialValue);
+
+    ParallelAlgorithmHelpers::runChunks (numChunks, [&] (int chunk)
+    {
+        auto chunkStart = ParallelAlgorithmHelpers::getChunkStart (start, end, chunk, numChunks);
+        auto chunkEnd   = ParallelAlgorithmHelpers::getChunkStart (start, end, chunk + 1, numChunks);
+
+        ValueType result (itemFunction (chunkStart));
+
+        for (auto i = chunkStart + 1; i < chunkEnd; ++i)
+            result = combiner (result, itemFunction (i));
+
+        chunkResults[(size_t) chunk] = std::move (result);
+    }, pool);
+
+    for (auto& r : chunkResults)
+        initialValue = combiner (initialValue, r);
+
+    return initialValue;
+}
+
+/**
+    Calls a function on each item of an array, writing the results into another array,
+    and spreading the work across several threads.
+
+    The source and destination can be the same array.
+
+    @param source            the items to read
+    @param destination       where to write the results - this must have space for numItems items
+    @param numItems          the number of items to transform
+    @param function          a function that takes a source item and returns a destination item
+    @param minItemsPerChunk  the smallest number of items that a thread should be given at a time
+    @param pool              the pool to use, or nullptr for the DefaultParallelThreadPool
+*/
+template <typename SourceType, typename DestType, typename FunctionType>
+void parallelTransform (const SourceType* source, DestType* destination, int numItems,
+                        FunctionType&& function, int minItemsPerChunk = 1, ThreadPool* pool = nullptr)
+{
+    parallelForChunks (0, numItems, [=, &function] (int chunkStart, int chunkEnd)
+                       {
+                           for (int i = chunkStart; i < chunkEnd; ++i)
+                               destination[i] = function (source[i]);
+                       },
+                       minItemsPerChunk, pool);
+}
+
+//==============================================================================
+/**
+    Sorts a range of elements in an array, using several threads.
+
+    This takes the same arguments as sortArray(), and gives the same results. The range
+    is split into chunks which are sorted concurrently, and then merged together, so
+    the comparator's compareElements() method must be safe to call from several threads
+    at once.
+
+    Small ranges are just sorted on the calling thread, as it's not worth the overhead of
+    splitting them up.
+
+    @param comparator       an object which defines a compareElements() method
+    @param array            the array to sort
+    @param firstElement     the index of the first element of the range to be sorted
+    @param lastElement      the index of the last element in the range that needs
+                            sorting (this is inclusive)
+    @param retainOrderOfEquivalentItems     if true, the order of items that the
+                            comparator deems the same will be maintained
+    @param pool             the pool to use, or nullptr for the DefaultParallelThreadPool
+
+    @see sortArray, parallelSort
+*/
+template <class ElementType, class ElementComparator>
+void parallelSortArray (ElementComparator& comparator,
+                        ElementType* const array,
+                        int firstElement,
+                        int lastElement,
+                        const bool retainOrderOfEquivalentItems,
+                        ThreadPool* pool = nullptr)
+{
+    jassert (firstElement >= 0);
+
+    auto numItems = lastElement + 1 - firstElement;
+    auto numChunks = ParallelAlgorithmHelpers::getNumChunks (numItems, 8192, pool);
+
+    if (numChunks <= 1)
+    {
+        sortArray (comparator, array, firstElement, lastElement, retainOrderOfEquivalentItems);
+        return;
+    }
+
+    auto getBoundary = [=] (int chunk)
+    {
+        return array + ParallelAlgorithmHelpers::getChunkStart (firstElement, lastElement + 1, jmin (chunk, numChunks), numChunks);
+    };
+
+    ParallelAlgorithmHelpers::runChunks (numChunks, [&] (int chunk)
+    {
+        SortFunctionConverter<ElementComparator> converter (comparator);
+
+        if (retainOrderOfEquivalentItems)
+            std::stable_sort (getBoundary (chunk), getBoundary (chunk + 1), converter);
+        else
+            std::sort        (getBoundary (chunk), getBoundary (chunk + 1), converter);
+    }, pool);
+
+    // merge neighbouring pairs of sorted chunks, doubling their size each time round
+    for (int width = 1; width < numChunks; width *= 2)
+    {
+        auto numMerges = (numChunks + 2 * width - 1) / (2 * width);
+
+        ParallelAlgorithmHelpers::runChunks (numMerges, [&] (int merge)
+        {
+            auto first = merge * 2 * width;
+
+            if (first + width < numChunks)
+            {
+                SortFunctionConverter<ElementComparator> converter (comparator);
+                std::inplace_merge (getBoundary (first), getBoundary (first + width),
+                                    getBoundary (first + 2 * width), converter);
+            }
+        }, pool);
+    }
+}
+
+/**
+    Sorts the contents of an Array, or any of the other array classes, using several threads.
+
+    This works like the array's sort() method, and locks the array while it's sorting it.
+
+    @see parallelSortArray, Array::sort
+*/
+template <typename ArrayType, typename ElementComparator>
+void parallelSort (ArrayType& arrayToSort, ElementComparator& comparator,
+                   bool retainOrderOfEquivalentItems = false, ThreadPool* pool = nullptr)
+{
+    const typename ArrayType::ScopedLockType lock (arrayToSort.getLock());
+    ignoreUnused (comparator); // if you pass in an object with a static compareElements() method, this
+                               // avoids getting warning messages about the parameter being unused
+
+    parallelSortArray (comparator, arrayToSort.begin(), 0, arrayToSort.size() - 1,
+                       retainOrderOfEquivalentItems, pool);
+}
+
+} // namespace juce
@@ -296,6 +296,168 @@ void Thread::setAffinityMask (const uint32 newAffinityMask)
     affinityMask = newAffinityMask;
 }
 
+//==============================================================================
+String Thread::RealtimeStatus::toString() const
+{
+    String s;
+
+    switch (policy)
+    {
+        case RealtimeOptions::Policy::fifo:         s << "SCHED_FIFO, priority " << priority; break;
+        case RealtimeOptions::Policy::roundRobin:   s << "SCHED_RR, priority " << priority; break;
+        case RealtimeOptions::Policy::deadline:     s << "SCHED_DEADLINE"; break;
+        case RealtimeOptions::Policy::unchanged:
+        default:                                    s << "not real-time"; break;
+    }
+
+    s << " (max permitted priority " << maxPermittedPriority << ")";
+
+    if (! cpus.isEmpty())
+    {
+        StringArray cpuNames;
+
+        for (auto cpu : cpus)
+            cpuNames.add (String (cpu));
+
+        s << ", cpus " << cpuNames.joinIntoString (",");
+    }
+
+    s << (memoryLocked ? ", memory locked" : ", memory not locked");
+
+    if (stackBytesPrefaulted > 0)
+        s << ", " << (int64) stackBytesPrefaulted << " stack bytes prefaulted";
+
+    for (auto& p : problems)
+        s << newLine << "  " << p;
+
+    return s;
+}
+
+// Touches each page of the next numBytes of the stack, by recursing through a chain of
+// stack frames. Using the result after each call stops it being turned into a loop.
+static int prefaultThreadStack (size_t numBytes)
+{
+    volatile char block[4096];
+
+    for (size_t i = 0; i < sizeof (block); i += 256)
+        block[i] = 0;
+
+    if (numBytes > sizeof (block))
+        return prefaultThreadStack (numBytes - sizeof (block)) + block[0];
+
+    return block[0];
+}
+
+struct AudioThreadRealtimeSettings
+{
+    SpinLock lock;
+    Thread::RealtimeOptions options;
+    Thread::RealtimeStatus lastStatus;
+    bool isEnabled = false;
+
+    static AudioThreadRealtimeSettings& get()
+    {
+        static AudioThreadRealtimeSettings settings;
+        return settings;
+    }
+};
+
+void JUCE_CALLTYPE Thread::setAudioThreadRealtimeOptions (const RealtimeOptions& options)
+{
+    auto& settings = AudioThreadRealtimeSettings::get();
+    const SpinLock::ScopedLockType sl (settings.lock);
+    settings.options = options;
+    settings.isEnabled = true;
+}
+
+void JUCE_CALLTYPE Thread::resetAudioThreadRealtimeOptions()
+{
+    auto& settings = AudioThreadRealtimeSettings::get();
+    const SpinLock::ScopedLockType sl (settings.lock);
+    settings.isEnabled = false;
+}
+
+bool JUCE_CALLTYPE Thread::applyAudioThreadRealtimeOptions()
+{
+    auto& settings = AudioThreadRealtimeSettings::get();
+    RealtimeOptions options;
+
+    {
+        const SpinLock::ScopedLockType sl (settings.lock);
+
+        if (! settings.isEnabled)
+            return false;
+
+        options = settings.options;
+    }
+
+    auto status = setCurrentThreadToRealtime (options);
+
+    const SpinLock::ScopedLockType sl (settings.lock);
+    settings.lastStatus = status;
+    return true;
+}
+
+Thread::RealtimeStatus JUCE_CALLTYPE Thread::getLastAudioThreadRealtimeStatus()
+{
+    auto& settings = AudioThreadRealtimeSettings::get();
+    const SpinLock::ScopedLockType sl (settings.lock);
+    return settings.lastStatus;
+}
+
+#if ! JUCE_LINUX
+Thread::RealtimeStatus JUCE_CALLTYPE Thread::setCurrentThreadToRealtime (const RealtimeOptions& options)
+{
+    RealtimeStatus status;
+
+    if (options.policy == RealtimeOptions::Policy::deadline)
+    {
+        status.problems.add ("The deadline policy isn't supported on this platform");
+    }
+    else if (options.policy != RealtimeOptions::Policy::unchanged)
+    {
+        if (setCurrentThreadPriority (9))
+            status.policy = options.policy;
+        else
+            status.problems.add ("Couldn't raise the thread's priority");
+    }
+
+    if (! options.cpus.isEmpty())
+    {
+        uint32 mask = 0;
+
+        for (auto cpu : options.cpus)
+        {
+            if (isPositiveAndBelow (cpu, 32))
+                mask |= (1u << cpu);
+            else
+                status.problems.add ("CPU " + String (cpu) + " can't be used in an affinity mask");
+        }
+
+        if (mask != 0)
+            setCurrentThreadAffinityMask (mask);
+    }
+
+    if (options.lockMemory)
+        status.problems.add ("Memory locking isn't supported on this platform");
+
+    if (options.stackBytesToPrefault > 0)
+    {
+        // the stack size can't be checked here, so stay within the smallest common default
+        status.stackBytesPrefaulted = jmin (options.stackBytesToPrefault, (size_t) 256 * 1024);
+        prefaultThreadStack (status.stackBytesPrefaulted);
+    }
+
+    return status;
+}
+
+Thread::RealtimeStatus JUCE_CALLTYPE Thread::getCurrentThreadRealtimeStatus()
+{
+    // the real-time configuration can only be queried on Linux
+    return {};
+}
+#endif
+
 //==============================================================================
 bool Thread::wait (const int timeOutMilliseconds) const
 {
@@ -531,6 +693,112 @@ private:
 
 ThreadLocalValueUnitTest threadLocalValueUnitTest;
 
+//==============================================================================
+class RealtimeThreadUnitTest  : public UnitTest
+{
+public:
+    RealtimeThreadUnitTest()  : UnitTest ("Real-time threads", "Threads") {}
+
+    void runTest() override
+    {
+        beginTest ("A thread with priority 0 isn't real-time");
+        {
+            auto status = runOnNewThread ([] { return Thread::getCurrentThreadRealtimeStatus(); });
+
+            expect (! status.isRealtime());
+            expectEquals (status.priority, 0);
+            expect (status.succeeded());
+        }
+
+        beginTest ("Requested policy is either applied or explained");
+        {
+            for (auto policy : { Thread::RealtimeOptions::Policy::fifo, Thread::RealtimeOptions::Policy::roundRobin })
+            {
+                Thread::RealtimeOptions options;
+                options.policy = policy;
+                options.priority = 10;
+
+                auto status = runOnNewThread ([&] { return Thread::setCurrentThreadToRealtime (options); });
+
+                if (status.policy == policy)
+                    expect (status.priority > 0 && status.priority <= 10);
+                else
+                    expect (! status.succeeded());
+            }
+        }
+
+       #if JUCE_LINUX
+        beginTest ("Affinity and stack prefaulting");
+        {
+            auto cpus = runOnNewThread ([] { return Thread::getCurrentThreadRealtimeStatus(); }).cpus;
+            expect (! cpus.isEmpty());
+
+            Thread::RealtimeOptions options;
+            options.policy = Thread::RealtimeOptions::Policy::unchanged;
+            options.cpus.add (cpus.getLast());
+            options.stackBytesToPrefault = 128 * 1024;
+
+            auto status = runOnNewThread ([&] { return Thread::setCurrentThreadToRealtime (options); });
+
+            expect (status.succeeded(), status.toString());
+            expect (status.cpus == options.cpus);
+            expect (status.stackBytesPrefaulted == options.stackBytesToPrefault);
+            expect (! status.isRealtime());
+
+            options.stackBytesToPrefault = (size_t) 1 << 40;
+            status = runOnNewThread ([&] { return Thread::setCurrentThreadToRealtime (options); });
+
+            expect (! status.succeeded());
+            expect (status.stackBytesPrefaulted < options.stackBytesToPrefault);
+        }
+       #endif
+
+        beginTest ("Audio thread options");
+        {
+            expect (! runOnNewThread ([] { return Thread::applyAudioThreadRealtimeOptions(); }));
+
+            Thread::RealtimeOptions options;
+            options.policy = Thread::RealtimeOptions::Policy::unchanged;
+            options.stackBytesToPrefault = 4096;
+            Thread::setAudioThreadRealtimeOptions (options);
+
+            expect (runOnNewThread ([] { return Thread::applyAudioThreadRealtimeOptions(); }));
+            expect (Thread::getLastAudioThreadRealtimeStatus().stackBytesPrefaulted == 4096);
+
+            Thread::resetAudioThreadRealtimeOptions();
+            expect (! runOnNewThread ([] { return Thread::applyAudioThreadRealtimeOptions(); }));
+        }
+    }
+
+private:
+    template <typename FunctionType>
+    static auto runOnNewThread (FunctionType&& function) -> decltype (function())
+    {
+        decltype (function()) result {};
+
+        FunctionThread thread ([&]
+        {
+            // start from a normal thread, as the default priority can be a real-time one on some platforms
+            Thread::setCurrentThreadPriority (0);
+            result = function();
+        });
+
+        thread.startThread();
+        thread.waitForThreadToExit (-1);
+        return result;
+    }
+
+    struct FunctionThread  : public Thread
+    {
+        FunctionThread (std::function<void()> f)  : Thread ("Real-time test"), function (f) {}
+        void run() override     { function(); }
+
+        std::function<void()> function;
+    };
+};
+
+static RealtimeThreadUnitTest realtimeThreadUnitTest;
+
 #endif
 
 } // namespace juce
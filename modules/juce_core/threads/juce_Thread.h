@@ -257,6 +257,147 @@ public:
     */
     static void JUCE_CALLTYPE setCurrentThreadAffinityMask (uint32 affinityMask);
 
+    //==============================================================================
+    /** A set of options for setCurrentThreadToRealtime().
+
+        @see setCurrentThreadToRealtime, RealtimeStatus
+    */
+    struct JUCE_API  RealtimeOptions
+    {
+        /** The scheduling policies that can be requested. */
+        enum class Policy
+        {
+            unchanged,      /**< leaves the thread's scheduling policy and priority alone. */
+            fifo,           /**< SCHED_FIFO: the thread runs until it blocks or yields, and pre-empts
+                                 any thread with a lower priority. */
+            roundRobin,     /**< SCHED_RR: like fifo, but threads with the same priority take turns. */
+            deadline        /**< SCHED_DEADLINE: the thread is guaranteed runtimeNanoseconds of CPU
+                                 time in every period. This is only available on Linux. */
+        };
+
+        /** The scheduling policy to use. */
+        Policy policy = Policy::fifo;
+
+        /** The real-time priority for the fifo and roundRobin policies, from 1 to 99.
+            On Linux, a user without the CAP_SYS_NICE capability is limited by the
+            RLIMIT_RTPRIO resource limit, and if the priority is higher than this, the
+            highest permitted priority is used instead.
+        */
+        int priority = 80;
+
+        /** The CPU time needed in each period for the deadline policy. */
+        int64 runtimeNanoseconds = 0;
+
+        /** The time after the start of each period by which the runtime must have been
+            provided, for the deadline policy. If this is 0, the period is used.
+        */
+        int64 deadlineNanoseconds = 0;
+
+        /** The period for the deadline policy, e.g. the duration of an audio block. */
+        int64 periodNanoseconds = 0;
+
+        /** The indexes of the CPU cores that the thread may run on. If this is empty, the
+            thread's affinity is left unchanged.
+        */
+        Array<int> cpus;
+
+        /** If true, all of the process's current and future memory is locked into RAM, so
+            that the thread can't be held up by page faults. Note that this affects the whole
+            process, not just the calling thread.
+        */
+        bool lockMemory = false;
+
+        /** The number of bytes of the thread's stack to touch, so that its pages are already
+            mapped before any time-critical work starts. This is clipped to the size of the stack.
+        */
+        size_t stackBytesToPrefault = 0;
+    };
+
+    /** Describes the real-time configuration of a thread, and anything that couldn't be
+        applied when setCurrentThreadToRealtime() was called.
+
+        @see setCurrentThreadToRealtime, getCurrentThreadRealtimeStatus
+    */
+    struct JUCE_API  RealtimeStatus
+    {
+        /** The policy that the thread is actually using. */
+        RealtimeOptions::Policy policy = RealtimeOptions::Policy::unchanged;
+
+        /** The thread's actual real-time priority, or 0 if it's not a real-time thread. */
+        int priority = 0;
+
+        /** The highest real-time priority that the process is allowed to use, or 0 if it
+            isn't allowed to use real-time scheduling at all.
+        */
+        int maxPermittedPriority = 0;
+
+        /** The cores that the thread is allowed to run on. */
+        Array<int> cpus;
+
+        /** True if the process's memory is locked into RAM. */
+        bool memoryLocked = false;
+
+        /** The number of bytes of stack that were prefaulted. */
+        size_t stackBytesPrefaulted = 0;
+
+        /** Descriptions of anything that was requested but couldn't be done. */
+        StringArray problems;
+
+        /** Returns true if the thread is using a real-time scheduling policy. */
+        bool isRealtime() const noexcept            { return policy != RealtimeOptions::Policy::unchanged; }
+
+        /** Returns true if everything that was requested took effect. */
+        bool succeeded() const noexcept             { return problems.isEmpty(); }
+
+        /** Returns a description of the status, for logging. */
+        String toString() const;
+    };
+
+    /** Configures the calling thread for real-time work.
+
+        This can change the thread's scheduling policy, priority and CPU affinity, lock the
+        process's memory, and prefault the thread's stack, all of which the OS may refuse to do
+        without the right permissions. The status that's returned describes the thread's
+        configuration afterwards, and lists anything that couldn't be applied, so it can be
+        used to tell the user why the real-time mode didn't take effect.
+
+        On platforms other than Linux, the fifo and roundRobin policies just set the thread's
+        priority to 9, and the deadline policy and memory locking aren't supported.
+
+        @see getCurrentThreadRealtimeStatus, setAudioThreadRealtimeOptions
+    */
+    static RealtimeStatus JUCE_CALLTYPE setCurrentThreadToRealtime (const RealtimeOptions& options);
+
+    /** Returns the real-time configuration of the calling thread. */
+    static RealtimeStatus JUCE_CALLTYPE getCurrentThreadRealtimeStatus();
+
+    /** Sets the options that JUCE's audio device threads will pass to setCurrentThreadToRealtime()
+        when they start.
+
+        This currently applies to the ALSA and JACK devices on Linux, and only to devices that
+        are opened after this is called.
+
+        @see resetAudioThreadRealtimeOptions, getLastAudioThreadRealtimeStatus
+    */
+    static void JUCE_CALLTYPE setAudioThreadRealtimeOptions (const RealtimeOptions& options);
+
+    /** Clears any options set with setAudioThreadRealtimeOptions(), so that the audio device
+        threads go back to their default priorities.
+    */
+    static void JUCE_CALLTYPE resetAudioThreadRealtimeOptions();
+
+    /** Applies the options set with setAudioThreadRealtimeOptions() to the calling thread.
+
+        This is called by JUCE's audio device threads, but you can also call it from any audio
+        threads of your own. It returns false if no options have been set.
+    */
+    static bool JUCE_CALLTYPE applyAudioThreadRealtimeOptions();
+
+    /** Returns the status from the last time that an audio thread called
+        applyAudioThreadRealtimeOptions().
+    */
+    static RealtimeStatus JUCE_CALLTYPE getLastAudioThreadRealtimeStatus();
+
     //==============================================================================
     // this can be called from any thread that needs to pause..
     static void JUCE_CALLTYPE sleep (int milliseconds);
@@ -23,22 +23,224 @@
 namespace juce
 {
 
+void juce_clearCurrentThreadAffinity();
+
+struct ThreadPool::Task
+{
+    std::function<void()> function;
+};
+
+//==============================================================================
+/*  A Chase-Lev work-stealing deque. Only the thread that owns it can push and pop at
+    the bottom end, but any thread can steal from the top. When it fills up, the owner
+    copies it into a bigger array, and keeps the old ones until it's deleted, so that
+    a thief that's still looking at an old array doesn't read freed memory.
+*/
+template <typename Task>
+struct WorkStealingDeque
+{
+    WorkStealingDeque()
+    {
+        arrays.add (new TaskArray (256));
+        array = arrays.getLast();
+    }
+
+    ~WorkStealingDeque()
+    {
+        while (auto* task = steal())
+            delete task;
+    }
+
+    void push (Task* task)
+    {
+        auto b = bottom.load();
+        auto t = top.load();
+        auto* a = array.load();
+
+        if (b - t >= a->size)
+        {
+            auto* bigger = new TaskArray (a->size * 2);
+
+            for (auto i = t; i < b; ++i)
+                bigger->set (i, a->get (i));
+
+            arrays.add (bigger);
+            array = a = bigger;
+        }
+
+        a->set (b, task);
+        bottom = b + 1;
+    }
+
+    Task* pop()
+    {
+        auto b = bottom.load() - 1;
+        bottom = b;
+        auto t = top.load();
+
+        if (t > b)
+        {
+            bottom = b + 1;
+            return nullptr;
+        }
+
+        auto* task = array.load()->get (b);
+
+        if (t == b)
+        {
+            // this is the last item, so we're racing against any thieves for it..
+            if (! top.compare_exchange_strong (t, t + 1))
+                task = nullptr;
+
+            bottom = b + 1;
+        }
+
+        return task;
+    }
+
+    Task* steal()
+    {
+        auto t = top.load();
+        auto b = bottom.load();
+
+        if (t >= b)
+            return nullptr;
+
+        auto* task = array.load()->get (t);
+
+        if (! top.compare_exchange_strong (t, t + 1))
+            return nullptr;
+
+        return task;
+    }
+
+private:
+    struct TaskArray
+    {
+        TaskArray (int64 numItems)  : size (numItems), items (new std::atomic<Task*>[(size_t) numItems]) {}
+
+        Task* get (int64 index) const noexcept          { return items[(size_t) (index & (size - 1))].load (std::memory_order_relaxed); }
+        void set (int64 index, Task* t) noexcept        { items[(size_t) (index & (size - 1))].store (t, std::memory_order_relaxed); }
+
+        const int64 size;
+        std::unique_ptr<std::atomic<Task*>[]> items;
+    };
+
+    std::atomic<int64> top { 0 }, bottom { 0 };
+    std::atomic<TaskArray*> array { nullptr };
+    OwnedArray<TaskArray> arrays;
+
+    JUCE_DECLARE_NON_COPYABLE (WorkStealingDeque)
+};
+
+//==============================================================================
+/*  The queue that receives tasks added from threads that aren't part of the pool. It's a
+    bounded lock-free queue, with a locked list to catch anything that doesn't fit.
+*/
+struct ThreadPool::TaskQueue
+{
+    TaskQueue() {}
+
+    ~TaskQueue()
+    {
+        while (auto* task = pop())
+            delete task;
+    }
+
+    void push (Task* task)
+    {
+        if (queue.push (task))
+            return;
+
+        const ScopedLock sl (overflowLock);
+        overflow.add (task);
+        ++numOverflowTasks;
+    }
+
+    Task* pop()
+    {
+        Task* task = nullptr;
+
+        if (queue.pop (task))
+            return task;
+
+        if (numOverflowTasks.load() > 0)
+        {
+            const ScopedLock sl (overflowLock);
+
+            if (overflowStart < overflow.size())
+            {
+                task = overflow.getUnchecked (overflowStart++);
+                --numOverflowTasks;
+
+                if (overflowStart > overflow.size() / 2)
+                {
+                    overflow.removeRange (0, overflowStart);
+                    overflowStart = 0;
+                }
+
+                return task;
+            }
+        }
+
+        return nullptr;
+    }
+
+private:
+    MPMCQueue<Task*> queue { 8192 };
+
+    CriticalSection overflowLock;
+    Array<Task*> overflow;
+    int overflowStart = 0;
+    std::atomic<int> numOverflowTasks { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE (TaskQueue)
+};
+
+//==============================================================================
 struct ThreadPool::ThreadPoolThread  : public Thread
 {
-    ThreadPoolThread (ThreadPool& p, size_t stackSize)
-       : Thread ("Pool", stackSize), pool (p)
+    ThreadPoolThread (ThreadPool& p, size_t stackSize, int threadIndex)
+       : Thread ("Pool", stackSize), pool (p), index (threadIndex),
+         randomState ((uint32) threadIndex * 0x9e3779b9u + 1)
     {
     }
 
     void run() override
     {
         while (! threadShouldExit())
-            if (! pool.runNextJob (*this))
-                wait (500);
+        {
+            if (appliedSettingsVersion != pool.threadSettingsVersion.load())
+                pool.applyThreadSettings (*this);
+
+            jobListVersionSeen = pool.jobListVersion.load();
+
+            auto ranTask = pool.runNextTask (*this);
+            auto ranJob  = pool.runNextJob (*this);
+
+            if (! (ranTask || ranJob))
+                pool.waitForWork (*this);
+        }
+    }
+
+    uint32 nextRandom() noexcept
+    {
+        randomState ^= randomState << 13;
+        randomState ^= randomState >> 17;
+        randomState ^= randomState << 5;
+        return randomState;
     }
 
     std::atomic<ThreadPoolJob*> currentJob { nullptr };
     ThreadPool& pool;
+    WorkStealingDeque<Task> tasks;
+    std::atomic<bool> isIdle { false };
+    uint32 jobListVersionSeen = 0;
+    int appliedSettingsVersion = 0;
+    bool hasAffinityMask = false, isRunningTask = false;
+    Thread::RealtimeStatus realtimeStatus;
+    const int index;
+    uint32 randomState;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ThreadPoolThread)
 };
@@ -91,6 +293,7 @@ ThreadPoolJob* ThreadPoolJob::getCurrentThreadPoolJob()
 
 //==============================================================================
 ThreadPool::ThreadPool (const int numThreads, size_t threadStackSize)
+    : sharedTasks (new TaskQueue())
 {
     jassert (numThreads > 0); // not much point having a pool without any threads!
 
@@ -98,6 +301,7 @@ ThreadPool::ThreadPool (const int numThreads, size_t threadStackSize)
 }
 
 ThreadPool::ThreadPool()
+    : sharedTasks (new TaskQueue())
 {
     createThreads (SystemStats::getNumCpus());
 }
@@ -106,12 +310,13 @@ ThreadPool::~ThreadPool()
 {
     removeAllJobs (true, 5000);
     stopThreads();
+    discardQueuedTasks();
 }
 
 void ThreadPool::createThreads (int numThreads, size_t threadStackSize)
 {
-    for (int i = jmax (1, numThreads); --i >= 0;)
-        threads.add (new ThreadPoolThread (*this, threadStackSize));
+    for (int i = 0; i < jmax (1, numThreads); ++i)
+        threads.add (new ThreadPoolThread (*this, threadStackSize, i));
 
     for (auto* t : threads)
         t->startThread();
@@ -141,10 +346,11 @@ void ThreadPool::addJob (ThreadPoolJob* const job, const bool deleteJobWhenFinis
         {
             const ScopedLock sl (lock);
             jobs.add (job);
+            numJobsInList = jobs.size();
+            ++jobListVersion;
         }
 
-        for (auto* t : threads)
-            t->notify();
+        wakeIdleThread();
     }
 }
 
@@ -161,22 +367,26 @@ void ThreadPool::addJob (std::function<ThreadPoolJob::JobStatus()> jobToRun)
     addJob (new LambdaJobWrapper (jobToRun), true);
 }
 
-void ThreadPool::addJob (std::function<void()> jobToRun)
+void ThreadPool::addTask (std::function<void()> taskToRun)
 {
-    struct LambdaJobWrapper  : public ThreadPoolJob
-    {
-        LambdaJobWrapper (std::function<void()> j) : ThreadPoolJob ("lambda"), job (j) {}
-        JobStatus runJob() override      { job(); return ThreadPoolJob::jobHasFinished; }
+    jassert (taskToRun != nullptr);
 
-        std::function<void()> job;
-    };
+    auto* task = new Task { std::move (taskToRun) };
+    ++numQueuedTasks;
 
-    addJob (new LambdaJobWrapper (jobToRun), true);
+    auto* poolThread = dynamic_cast<ThreadPoolThread*> (Thread::getCurrentThread());
+
+    if (poolThread != nullptr && &(poolThread->pool) == this)
+        poolThread->tasks.push (task);
+    else
+        sharedTasks->push (task);
+
+    wakeIdleThread();
 }
 
 int ThreadPool::getNumJobs() const noexcept
 {
-    return jobs.size();
+    return numJobsInList.load() + jmax (0, numQueuedTasks.load()) + numRunningTasks.load();
 }
 
 int ThreadPool::getNumThreads() const noexcept
@@ -253,6 +463,7 @@ bool ThreadPool::removeJob (ThreadPoolJob* const job,
             else
             {
                 jobs.removeFirstMatchingValue (job);
+                numJobsInList = jobs.size();
                 addToDeleteList (deletionList, job);
             }
         }
@@ -292,9 +503,19 @@ bool ThreadPool::removeAllJobs (const bool interruptRunningJobs, const int timeO
                     }
                 }
             }
+
+            numJobsInList = jobs.size();
         }
     }
 
+    if (selectedJobsToRemove == nullptr)
+        discardQueuedTasks();
+
+    // a task can't wait for itself to finish
+    auto* callingThread = dynamic_cast<ThreadPoolThread*> (Thread::getCurrentThread());
+    auto numTasksToIgnore = (callingThread != nullptr && &(callingThread->pool) == this
+                                && callingThread->isRunningTask) ? 1 : 0;
+
     auto start = Time::getMillisecondCounter();
 
     for (;;)
@@ -307,7 +528,8 @@ bool ThreadPool::removeAllJobs (const bool interruptRunningJobs, const int timeO
                 jobsToWaitFor.remove (i);
         }
 
-        if (jobsToWaitFor.size() == 0)
+        if (jobsToWaitFor.size() == 0
+             && (selectedJobsToRemove != nullptr || numRunningTasks.load() <= numTasksToIgnore))
             break;
 
         if (timeOutMs >= 0 && Time::getMillisecondCounter() >= start + (uint32) timeOutMs)
@@ -342,6 +564,202 @@ bool ThreadPool::setThreadPriorities (const int newPriority)
     return ok;
 }
 
+void ThreadPool::setThreadAffinityMask (uint32 coresToUse, bool pinEachThreadToOneCore)
+{
+    {
+        const ScopedLock sl (lock);
+        affinityMask = coresToUse;
+        pinThreadsToCores = pinEachThreadToOneCore;
+        ++threadSettingsVersion;
+    }
+
+    for (auto* t : threads)
+        t->notify();
+}
+
+void ThreadPool::setThreadRealtimeOptions (const Thread::RealtimeOptions& options)
+{
+    {
+        const ScopedLock sl (lock);
+        realtimeOptions.reset (new Thread::RealtimeOptions (options));
+        ++threadSettingsVersion;
+    }
+
+    for (auto* t : threads)
+        t->notify();
+}
+
+Thread::RealtimeStatus ThreadPool::getThreadRealtimeStatus (int threadIndex) const
+{
+    const ScopedLock sl (lock);
+
+    if (auto* t = threads[threadIndex])
+        return t->realtimeStatus;
+
+    return {};
+}
+
+void ThreadPool::applyThreadSettings (ThreadPoolThread& thread)
+{
+    uint32 mask;
+    bool pin;
+    std::unique_ptr<Thread::RealtimeOptions> options;
+
+    {
+        const ScopedLock sl (lock);
+        thread.appliedSettingsVersion = threadSettingsVersion.load();
+        mask = affinityMask;
+        pin = pinThreadsToCores;
+
+        if (realtimeOptions != nullptr)
+            options.reset (new Thread::RealtimeOptions (*realtimeOptions));
+    }
+
+    if (mask != 0 && pin)
+    {
+        auto numCores = countNumberOfBits (mask);
+        auto coreToUse = thread.index % numCores;
+
+        for (uint32 bit = 1; bit != 0; bit <<= 1)
+        {
+            if ((mask & bit) != 0 && coreToUse-- == 0)
+            {
+                mask = bit;
+                break;
+            }
+        }
+    }
+
+    // A thread that has never been given a mask is left alone, as the 32 bits of a mask
+    // can't describe all the CPUs of a larger machine
+    if (mask != 0)
+        Thread::setCurrentThreadAffinityMask (mask);
+    else if (thread.hasAffinityMask)
+        juce_clearCurrentThreadAffinity();
+
+    thread.hasAffinityMask = (mask != 0) || (options != nullptr && ! options->cpus.isEmpty());
+
+    if (options != nullptr)
+    {
+        auto status = Thread::setCurrentThreadToRealtime (*options);
+
+        const ScopedLock sl (lock);
+        thread.realtimeStatus = status;
+    }
+}
+
+//==============================================================================
+ThreadPool::Task* ThreadPool::findNextTask (ThreadPoolThread& thread)
+{
+    if (numQueuedTasks.load() <= 0)
+        return nullptr;
+
+    auto* task = thread.tasks.pop();
+
+    if (task == nullptr)
+        task = sharedTasks->pop();
+
+    if (task == nullptr)
+    {
+        // nothing to do locally, so try stealing from the other threads, starting at a random one
+        auto numThreads = threads.size();
+        auto start = (int) (thread.nextRandom() % (uint32) numThreads);
+
+        for (int i = 0; i < numThreads && task == nullptr; ++i)
+        {
+            auto* victim = threads.getUnchecked ((start + i) % numThreads);
+
+            if (victim != &thread)
+                task = victim->tasks.steal();
+        }
+    }
+
+    if (task != nullptr)
+    {
+        ++numRunningTasks;
+        --numQueuedTasks;
+    }
+
+    return task;
+}
+
+bool ThreadPool::runNextTask (ThreadPoolThread& thread)
+{
+    if (auto* task = findNextTask (thread))
+    {
+        thread.isRunningTask = true;
+
+        try
+        {
+            task->function();
+        }
+        catch (...)
+        {
+            jassertfalse; // Your job function mustn't throw any exceptions!
+        }
+
+        thread.isRunningTask = false;
+        delete task;
+
+        if (--numRunningTasks == 0)
+            jobFinishedSignal.signal();
+
+        return true;
+    }
+
+    return false;
+}
+
+void ThreadPool::discardQueuedTasks()
+{
+    // Only the thread that owns a deque can pop from it, but anyone can steal..
+    for (bool foundAny = true; foundAny;)
+    {
+        foundAny = false;
+
+        while (auto* task = sharedTasks->pop())
+        {
+            --numQueuedTasks;
+            delete task;
+            foundAny = true;
+        }
+
+        for (auto* t : threads)
+        {
+            while (auto* task = t->tasks.steal())
+            {
+                --numQueuedTasks;
+                delete task;
+                foundAny = true;
+            }
+        }
+    }
+}
+
+void ThreadPool::waitForWork (ThreadPoolThread& thread)
+{
+    // Once the thread has flagged itself as idle, anything that adds work will wake it, so it
+    // only needs to check for anything that arrived before that, and then it can sleep.
+    thread.isIdle = true;
+
+    if (numQueuedTasks.load() <= 0 && jobListVersion.load() == thread.jobListVersionSeen)
+        thread.wait (500);
+
+    thread.isIdle = false;
+}
+
+void ThreadPool::wakeIdleThread()
+{
+    for (auto* t : threads)
+    {
+        if (t->isIdle.load() && t->isIdle.exchange (false))
+        {
+            t->notify();
+            return;
+        }
+    }
+}
+
 ThreadPoolJob* ThreadPool::pickNextJobToRun()
 {
     OwnedArray<ThreadPoolJob> deletionList;
@@ -358,6 +776,7 @@ ThreadPoolJob* ThreadPool::pickNextJobToRun()
                     if (job->shouldStop)
                     {
                         jobs.remove (i);
+                        numJobsInList = jobs.size();
                         addToDeleteList (deletionList, job);
                         --i;
                         continue;
@@ -375,6 +794,9 @@ ThreadPoolJob* ThreadPool::pickNextJobToRun()
 
 bool ThreadPool::runNextJob (ThreadPoolThread& thread)
 {
+    if (numJobsInList.load() == 0)
+        return false;
+
     if (auto* job = pickNextJobToRun())
     {
         auto result = ThreadPoolJob::jobHasFinished;
@@ -403,6 +825,7 @@ bool ThreadPool::runNextJob (ThreadPoolThread& thread)
                 if (result != ThreadPoolJob::jobNeedsRunningAgain || job->shouldStop)
                 {
                     jobs.removeFirstMatchingValue (job);
+                    numJobsInList = jobs.size();
                     addToDeleteList (deletionList, job);
 
                     jobFinishedSignal.signal();
@@ -430,4 +853,244 @@ void ThreadPool::addToDeleteList (OwnedArray<ThreadPoolJob>& deletionList, Threa
         deletionList.add (job);
 }
 
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ThreadPoolTests  : public UnitTest
+{
+public:
+    ThreadPoolTests()  : UnitTest ("ThreadPool", "Threads") {}
+
+    void runTest() override
+    {
+        beginTest ("Lambda jobs");
+        {
+            ThreadPool pool (4);
+            std::atomic<int> count { 0 };
+            const int numJobs = 20000;
+
+            for (int i = 0; i < numJobs; ++i)
+                pool.addTask ([&count] { ++count; });
+
+            expect (waitFor ([&] { return count.load() == numJobs; }));
+            expect (waitFor ([&] { return pool.getNumJobs() == 0; }));
+        }
+
+        beginTest ("Jobs added from inside other jobs");
+        {
+            ThreadPool pool (4);
+            std::atomic<int> count { 0 };
+
+            std::function<void (int)> spawn = [&] (int depth)
+            {
+                ++count;
+
+                if (depth > 0)
+                    for (int i = 0; i < 4; ++i)
+                        pool.addTask ([&spawn, depth] { spawn (depth - 1); });
+            };
+
+            pool.addTask ([&spawn] { spawn (6); });
+
+            const int expected = (1 << 14) / 3; // 1 + 4 + 16 + ... + 4^6
+            expect (waitFor ([&] { return count.load() == expected; }));
+            expect (waitFor ([&] { return pool.getNumJobs() == 0; }));
+        }
+
+        beginTest ("Futures");
+        {
+            ThreadPool pool (2);
+
+            std::vector<std::future<int>> results;
+
+            for (int i = 0; i < 100; ++i)
+                results.push_back (pool.submit ([i] { return i * i; }));
+
+            int total = 0;
+
+            for (auto& r : results)
+                total += r.get();
+
+            expectEquals (total, 328350);
+
+            auto failed = pool.submit ([]() -> String { throw std::runtime_error ("oops"); });
+            expect (throwsException ([&] { failed.get(); }));
+
+            auto nothing = pool.submit ([] {});
+            nothing.wait();
+            expect (nothing.valid());
+        }
+
+        beginTest ("Unstarted jobs are discarded by removeAllJobs");
+        {
+            ThreadPool pool (1);
+            WaitableEvent started, release;
+
+            pool.addTask ([&] { started.signal(); release.wait(); });
+            expect (started.wait (5000));
+
+            std::atomic<int> count { 0 };
+            auto queued = pool.submit ([&count] { ++count; });
+
+            expectEquals (pool.getNumJobs(), 2);
+            expect (! pool.removeAllJobs (true, 0));
+            expectEquals (pool.getNumJobs(), 1);
+
+            release.signal();
+            expect (pool.removeAllJobs (true, 5000));
+            expectEquals (pool.getNumJobs(), 0);
+            expectEquals (count.load(), 0);
+            expect (throwsException ([&] { queued.get(); }));
+        }
+
+        beginTest ("removeAllJobs can be called from a task");
+        {
+            ThreadPool pool (2);
+            std::atomic<bool> removed { false };
+            WaitableEvent done;
+
+            pool.addTask ([&] { removed = pool.removeAllJobs (true, -1); done.signal(); });
+
+            expect (done.wait (5000));
+            expect (removed.load());
+        }
+
+        beginTest ("ThreadPoolJob objects");
+        {
+            ThreadPool pool (3);
+            std::atomic<int> count { 0 };
+            OwnedArray<CountingJob> jobList;
+
+            for (int i = 0; i < 10; ++i)
+                pool.addJob (jobList.add (new CountingJob (count, 5)), false);
+
+            for (auto* job : jobList)
+                expect (pool.waitForJobToFinish (job, 5000));
+
+            expectEquals (count.load(), 50);
+            expectEquals (pool.getNumJobs(), 0);
+
+            std::atomic<int> lambdaCount { 0 };
+            pool.addJob ([&lambdaCount] { ++lambdaCount; return ThreadPoolJob::jobHasFinished; });
+            expect (waitFor ([&] { return lambdaCount.load() == 1 && pool.getNumJobs() == 0; }));
+        }
+
+        beginTest ("Thread affinity");
+        {
+            ThreadPool pool (2);
+            std::atomic<int> count { 0 };
+
+            pool.setThreadAffinityMask (1, true);
+
+            for (int i = 0; i < 100; ++i)
+                pool.addTask ([&count] { ++count; });
+
+            expect (waitFor ([&] { return count.load() == 100; }));
+
+            pool.setThreadAffinityMask (0);
+        }
+
+        beginTest ("Benchmark");
+        {
+            auto maxThreads = jmax (4, SystemStats::getNumCpus());
+
+            for (int numThreads = 1;; numThreads = jmin (numThreads * 2, maxThreads))
+            {
+                logMessage ("  " + String (numThreads) + " thread(s): "
+                              + String (roundToInt (measureJobsPerSecond (numThreads, BenchmarkMode::lambdas))) + " lambda jobs/sec, "
+                              + String (roundToInt (measureJobsPerSecond (numThreads, BenchmarkMode::nestedLambdas))) + " nested lambda jobs/sec, "
+                              + String (roundToInt (measureJobsPerSecond (numThreads, BenchmarkMode::threadPoolJobs))) + " ThreadPoolJobs/sec");
+
+                if (numThreads == maxThreads)
+                    break;
+            }
+        }
+    }
+
+private:
+    struct CountingJob  : public ThreadPoolJob
+    {
+        CountingJob (std::atomic<int>& c, int runs)  : ThreadPoolJob ("counting"), count (c), runsLeft (runs) {}
+
+        JobStatus runJob() override
+        {
+            ++count;
+            return --runsLeft > 0 ? jobNeedsRunningAgain : jobHasFinished;
+        }
+
+        std::atomic<int>& count;
+        int runsLeft;
+    };
+
+    template <typename Condition>
+    static bool waitFor (Condition&& condition)
+    {
+        auto start = Time::getMillisecondCounter();
+
+        while (! condition())
+        {
+            if (Time::getMillisecondCounter() > start + 10000)
+                return false;
+
+            Thread::sleep (1);
+        }
+
+        return true;
+    }
+
+    template <typename Function>
+    static bool throwsException (Function&& f)
+    {
+        try { f(); }
+        catch (...) { return true; }
+
+        return false;
+    }
+
+    enum class BenchmarkMode
+    {
+        lambdas,
+        nestedLambdas,
+        threadPoolJobs
+    };
+
+    static double measureJobsPerSecond (int numThreads, BenchmarkMode mode)
+    {
+        ThreadPool pool (numThreads);
+        std::atomic<int> count { 0 };
+        const int numJobs = mode == BenchmarkMode::threadPoolJobs ? 20000 : 200000;
+
+        auto start = Time::getHighResolutionTicks();
+
+        if (mode == BenchmarkMode::nestedLambdas)
+        {
+            pool.addTask ([&]
+            {
+                for (int i = 0; i < numJobs; ++i)
+                    pool.addTask ([&count] { ++count; });
+            });
+        }
+        else
+        {
+            for (int i = 0; i < numJobs; ++i)
+            {
+                if (mode == BenchmarkMode::threadPoolJobs)
+                    pool.addJob ([&count] { ++count; return ThreadPoolJob::jobHasFinished; });
+                else
+                    pool.addTask ([&count] { ++count; });
+            }
+        }
+
+        waitFor ([&] { return count.load() == numJobs; });
+
+        auto seconds = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+        return numJobs / jmax (seconds, 1.0e-6);
+    }
+};
+
+static ThreadPoolTests threadPoolTests;
+
+#endif
+
 } // namespace juce
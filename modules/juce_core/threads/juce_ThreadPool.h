@@ -20,6 +20,8 @@
   ==============================================================================
 */
 
+#include <future>
+
 namespace juce
 {
 
@@ -148,6 +150,11 @@ private:
     When a ThreadPoolJob object is added to the ThreadPool's list, its runJob() method
     will be called by the next pooled thread that becomes free.
 
+    Functions that are added with addTask() or submit() don't go through that list,
+    but are handed out by a lightweight scheduler instead: each thread has its own queue of
+    functions, which the other threads steal from when they run out of work, so that adding
+    large numbers of short jobs doesn't make the threads contend for a lock.
+
     @see ThreadPoolJob, Thread
 
     @tags{Core}
@@ -226,9 +233,44 @@ public:
     void addJob (std::function<ThreadPoolJob::JobStatus()> job);
 
     /** Adds a lambda function to be called as a job.
-        This will create an internal ThreadPoolJob object to encapsulate and call the lambda.
+
+        This is much cheaper than adding a ThreadPoolJob, and can be called from any thread
+        without blocking. If it's called from inside one of the pool's own jobs, the function
+        goes into the queue of the calling thread, so it's likely to run with the same data
+        still in the cache, unless another idle thread steals it first.
+
+        These functions are counted by getNumJobs(), but as they don't have a ThreadPoolJob
+        object, they can't be found by the other methods that look for jobs. If the pool is
+        deleted, or removeAllJobs() is called without a JobSelector, any functions that
+        haven't started yet are discarded.
+
+        @see submit
+    */
+    void addTask (std::function<void()> task);
+
+    /** Adds a function to be called as a job, and returns a std::future that will receive
+        its result, or any exception that it throws.
+
+        This uses the same scheduler as addTask(). If the function is
+        discarded before it has run, the future will throw a std::future_error with the
+        broken_promise code.
+
+        e.g. @code
+        auto result = pool.submit ([] { return calculateSomething(); });
+        doSomethingElse();
+        auto value = result.get();
+        @endcode
     */
-    void addJob (std::function<void()> job);
+    template <typename FunctionType>
+    auto submit (FunctionType&& function) -> std::future<decltype (function())>
+    {
+        using ResultType = decltype (function());
+
+        auto task = std::make_shared<std::packaged_task<ResultType()>> (std::forward<FunctionType> (function));
+        auto result = task->get_future();
+        addTask ([task] { (*task)(); });
+        return result;
+    }
 
     /** Tries to remove a job from the pool.
 
@@ -261,6 +303,10 @@ public:
                                     which jobs should be removed. If it is a nullptr, all jobs are removed
         @returns    true if all jobs are successfully stopped and removed; false if the timeout period
                     expires while waiting for one or more jobs to stop
+
+        If there's no JobSelector, any functions added with addTask() or submit() that haven't
+        started are discarded, and this also waits for the ones that are running to finish.
+        When it's called from inside one of those functions, it doesn't wait for that one.
     */
     bool removeAllJobs (bool interruptRunningJobs,
                         int timeOutMilliseconds,
@@ -315,6 +361,33 @@ public:
     */
     bool setThreadPriorities (int newPriority);
 
+    /** Restricts the pool's threads to a set of CPU cores.
+
+        Each bit in the mask represents a core. If pinEachThreadToOneCore is true, each thread
+        is locked to a single core from the mask, taking them in turn, which helps to keep each
+        thread's data in its own cache; otherwise every thread can run on any of the cores in
+        the mask. A mask of 0 removes the restriction. The threads apply the change before
+        running their next job.
+
+        @see Thread::setAffinityMask
+    */
+    void setThreadAffinityMask (uint32 coresToUse, bool pinEachThreadToOneCore = false);
+
+    /** Makes the pool's threads call Thread::setCurrentThreadToRealtime() with these options.
+
+        The threads apply them before running their next job, and each thread's result can be
+        checked with getThreadRealtimeStatus(). If the options contain a list of CPUs, it's
+        applied after any mask that was set with setThreadAffinityMask().
+
+        @see Thread::RealtimeOptions
+    */
+    void setThreadRealtimeOptions (const Thread::RealtimeOptions& options);
+
+    /** Returns the status that one of the pool's threads got when it last applied the options
+        from setThreadRealtimeOptions().
+    */
+    Thread::RealtimeStatus getThreadRealtimeStatus (int threadIndex) const;
+
 
 private:
     //==============================================================================
@@ -329,6 +402,25 @@ private:
     CriticalSection lock;
     WaitableEvent jobFinishedSignal;
 
+    struct Task;
+    struct TaskQueue;
+    std::unique_ptr<TaskQueue> sharedTasks;
+    std::atomic<int> numQueuedTasks { 0 }, numRunningTasks { 0 }, numJobsInList { 0 };
+    std::atomic<uint32> jobListVersion { 0 };
+
+    uint32 affinityMask = 0;
+    bool pinThreadsToCores = false;
+    std::unique_ptr<Thread::RealtimeOptions> realtimeOptions;
+    std::atomic<int> threadSettingsVersion { 0 };
+
+    void applyThreadSettings (ThreadPoolThread&);
+
+    bool runNextTask (ThreadPoolThread&);
+    Task* findNextTask (ThreadPoolThread&);
+    void discardQueuedTasks();
+    void waitForWork (ThreadPoolThread&);
+    void wakeIdleThread();
+
     bool runNextJob (ThreadPoolThread&);
     ThreadPoolJob* pickNextJobToRun();
     void addToDeleteList (OwnedArray<ThreadPoolJob>&, ThreadPoolJob*) const;
@@ -0,0 +1,628 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+// Collects the children of each element in a single array until the element is
+// complete, and then moves them into one contiguous block in the arena
+struct CompactXmlDocument::Builder
+{
+    using CharType = String::CharPointerType::CharType;
+
+    Builder (ArenaAllocator& a) : arena (a) {}
+
+    static Result build (CompactXmlDocument& doc, XmlReader& reader)
+    {
+        doc.root = nullptr;
+        doc.arena.clear();
+        reader.setEmptyTextIgnored (doc.ignoreEmptyText);
+
+        Builder builder (doc.arena);
+
+        for (;;)
+        {
+            switch (reader.next())
+            {
+                case XmlReader::Token::startElement:    builder.startElement (reader); break;
+                case XmlReader::Token::endElement:      builder.endElement(); break;
+                case XmlReader::Token::text:            builder.addElement (nullptr).text = builder.copyText (reader.getText()); break;
+
+                case XmlReader::Token::endOfDocument:
+                {
+                    auto* root = doc.arena.allocateArray<ElementData> (1);
+                    *root = builder.pending.getReference (0);
+                    doc.root = root;
+                    return Result::ok();
+                }
+
+                case XmlReader::Token::error:
+                case XmlReader::Token::none:
+                default:
+                    doc.arena.clear();
+                    return Result::fail (reader.getLastError());
+            }
+        }
+    }
+
+private:
+    ArenaAllocator& arena;
+    Array<ElementData> pending;
+    Array<int> childStarts;
+
+    struct CachedName
+    {
+        const CharType* text;
+        size_t numBytes;
+    };
+
+    CachedName nameCache[256] = {};
+
+    // Tag and attribute names tend to be repeated many times, so this only stores one copy
+    // of each of the most recently-seen names
+    const CharType* copyName (XmlReader::TextRange name)
+    {
+       #if JUCE_STRING_UTF_TYPE == 8
+        auto* text = name.start.getAddress();
+        auto numBytes = name.getNumBytes();
+        auto hash = (uint32) numBytes;
+
+        for (size_t i = 0; i < numBytes; ++i)
+            hash = hash * 31 + (uint32) (uint8) text[i];
+
+        auto& cached = nameCache[hash & (uint32) (numElementsInArray (nameCache) - 1)];
+
+        if (cached.text == nullptr || cached.numBytes != numBytes || memcmp (cached.text, text, numBytes) != 0)
+        {
+            cached.text = copyText (name);
+            cached.numBytes = numBytes;
+        }
+
+        return cached.text;
+       #else
+        return copyText (name);
+       #endif
+    }
+
+    const CharType* copyText (XmlReader::TextRange text)
+    {
+       #if JUCE_STRING_UTF_TYPE == 8
+        return arena.copyString (text.start.getAddress(), text.getNumBytes());
+       #else
+        auto s = text.toString();
+        auto numBytes = s.getCharPointer().sizeInBytes();
+        auto* copy = arena.allocate (numBytes, alignof (CharType));
+        memcpy (copy, s.getCharPointer().getAddress(), numBytes);
+        return static_cast<const CharType*> (copy);
+       #endif
+    }
+
+    ElementData& addElement (const CharType* name)
+    {
+        ElementData e;
+        e.name = name;
+        e.attributes = nullptr;
+        e.children = nullptr;
+        e.numAttributes = 0;
+        e.numChildren = 0;
+
+        pending.add (e);
+        return pending.getReference (pending.size() - 1);
+    }
+
+    void startElement (const XmlReader& reader)
+    {
+        auto& e = addElement (copyName (reader.getName()));
+        auto numAttributes = reader.getNumAttributes();
+
+        if (numAttributes > 0)
+        {
+            auto* attributes = arena.allocateArray<AttributeData> ((size_t) numAttributes);
+
+            for (int i = 0; i < numAttributes; ++i)
+            {
+                attributes[i].name  = copyName (reader.getAttributeName (i));
+                attributes[i].value = copyText (reader.getAttributeValue (i));
+            }
+
+            e.attributes = attributes;
+            e.numAttributes = (uint32) numAttributes;
+        }
+
+        childStarts.add (pending.size());
+    }
+
+    void endElement()
+    {
+        auto start = childStarts.removeAndReturn (childStarts.size() - 1);
+        auto numChildren = pending.size() - start;
+
+        if (numChildren > 0)
+        {
+            auto& parent = pending.getReference (start - 1);
+            auto* children = arena.allocateArray<ElementData> ((size_t) numChildren);
+            memcpy (children, pending.begin() + start, (size_t) numChildren * sizeof (ElementData));
+            parent.children = children;
+            parent.numChildren = (uint32) numChildren;
+            pending.removeRange (start, numChildren);
+        }
+    }
+};
+
+//==============================================================================
+CompactXmlDocument::CompactXmlDocument() : arena (65536) {}
+CompactXmlDocument::~CompactXmlDocument() {}
+
+Result CompactXmlDocument::parse (const void* data, size_t numBytes)
+{
+    XmlReader reader (data, numBytes);
+    return Builder::build (*this, reader);
+}
+
+Result CompactXmlDocument::parse (const String& text)
+{
+    auto utf8 = text.toUTF8();
+    return parse (utf8.getAddress(), utf8.sizeInBytes() - 1);
+}
+
+Result CompactXmlDocument::parse (InputStream& input)
+{
+    XmlReader reader (input);
+    return Builder::build (*this, reader);
+}
+
+Result CompactXmlDocument::parse (const File& file)
+{
+    {
+        MemoryMappedFile mappedFile (file, MemoryMappedFile::readOnly);
+
+        // all the strings get copied into the document, so the file needn't stay mapped
+        if (mappedFile.getData() != nullptr)
+            return parse (mappedFile.getData(), mappedFile.getSize());
+    }
+
+    FileInputStream in (file);
+
+    if (in.failedToOpen())
+        return Result::fail ("Couldn't open " + file.getFullPathName());
+
+    return parse (in);
+}
+
+XmlElement* CompactXmlDocument::createXmlElement (const ElementData& e)
+{
+    if (e.name == nullptr)
+        return XmlElement::createTextElement (String (String::CharPointerType (e.text)));
+
+    auto* xml = new XmlElement (String::CharPointerType (e.name), String::CharPointerType (e.name).findTerminatingNull());
+
+    {
+        LinkedListPointer<XmlElement::XmlAttributeNode>::Appender attributeAppender (xml->attributes);
+
+        for (uint32 i = 0; i < e.numAttributes; ++i)
+        {
+            auto& a = e.attributes[i];
+            String::CharPointerType attributeName (a.name);
+
+            auto* node = new XmlElement::XmlAttributeNode (attributeName, attributeName.findTerminatingNull());
+            node->value = String (String::CharPointerType (a.value));
+            attributeAppender.append (node);
+        }
+    }
+
+    LinkedListPointer<XmlElement>::Appender childAppender (xml->firstChildElement);
+
+    for (uint32 i = 0; i < e.numChildren; ++i)
+        childAppender.append (createXmlElement (e.children[i]));
+
+    return xml;
+}
+
+//==============================================================================
+StringRef CompactXmlDocument::Element::getTagName() const noexcept
+{
+    return element != nullptr && element->name != nullptr ? StringRef (String::CharPointerType (element->name)) : StringRef();
+}
+
+bool CompactXmlDocument::Element::hasTagName (StringRef possibleTagName) const noexcept
+{
+    return element != nullptr && element->name != nullptr
+            && String::CharPointerType (element->name).compare (possibleTagName.text) == 0;
+}
+
+StringRef CompactXmlDocument::Element::getText() const noexcept
+{
+    return isTextElement() ? StringRef (String::CharPointerType (element->text)) : StringRef();
+}
+
+String CompactXmlDocument::Element::getAllSubText() const
+{
+    if (isTextElement())
+        return String (String::CharPointerType (element->text));
+
+    if (getNumChildElements() == 1)
+        return getChildElement (0).getAllSubText();
+
+    MemoryOutputStream mem (1024);
+
+    for (auto child : *this)
+        mem << child.getAllSubText();
+
+    return mem.toUTF8();
+}
+
+int CompactXmlDocument::Element::getNumAttributes() const noexcept
+{
+    return element != nullptr ? (int) element->numAttributes : 0;
+}
+
+StringRef CompactXmlDocument::Element::getAttributeName (int index) const noexcept
+{
+    return isPositiveAndBelow (index, getNumAttributes()) ? StringRef (String::CharPointerType (element->attributes[index].name)) : StringRef();
+}
+
+StringRef CompactXmlDocument::Element::getAttributeValue (int index) const noexcept
+{
+    return isPositiveAndBelow (index, getNumAttributes()) ? StringRef (String::CharPointerType (element->attributes[index].value)) : StringRef();
+}
+
+bool CompactXmlDocument::Element::hasAttribute (StringRef attributeName) const noexcept
+{
+    for (int i = getNumAttributes(); --i >= 0;)
+        if (String::CharPointerType (element->attributes[i].name).compare (attributeName.text) == 0)
+            return true;
+
+    return false;
+}
+
+StringRef CompactXmlDocument::Element::getStringAttribute (StringRef attributeName) const noexcept
+{
+    for (int i = 0; i < getNumAttributes(); ++i)
+        if (String::CharPointerType (element->attributes[i].name).compare (attributeName.text) == 0)
+            return String::CharPointerType (element->attributes[i].value);
+
+    return {};
+}
+
+int CompactXmlDocument::Element::getIntAttribute (StringRef attributeName, int defaultReturnValue) const
+{
+    if (hasAttribute (attributeName))
+        return getStringAttribute (attributeName).text.getIntValue32();
+
+    return defaultReturnValue;
+}
+
+double CompactXmlDocument::Element::getDoubleAttribute (StringRef attributeName, double defaultReturnValue) const
+{
+    if (hasAttribute (attributeName))
+        return getStringAttribute (attributeName).text.getDoubleValue();
+
+    return defaultReturnValue;
+}
+
+bool CompactXmlDocument::Element::getBoolAttribute (StringRef attributeName, bool defaultReturnValue) const
+{
+    if (hasAttribute (attributeName))
+    {
+        auto firstChar = *(getStringAttribute (attributeName).text.findEndOfWhitespace());
+
+        return firstChar == '1'
+            || firstChar == 't'
+            || firstChar == 'y'
+            || firstChar == 'T'
+            || firstChar == 'Y';
+    }
+
+    return defaultReturnValue;
+}
+
+int CompactXmlDocument::Element::getNumChildElements() const noexcept
+{
+    return element != nullptr ? (int) element->numChildren : 0;
+}
+
+CompactXmlDocument::Element CompactXmlDocument::Element::getChildElement (int index) const noexcept
+{
+    return isPositiveAndBelow (index, getNumChildElements()) ? Element (element->children + index) : Element();
+}
+
+CompactXmlDocument::Element CompactXmlDocument::Element::getChildByName (StringRef tagNameToLookFor) const noexcept
+{
+    for (auto child : *this)
+        if (child.hasTagName (tagNameToLookFor))
+            return child;
+
+    return {};
+}
+
+CompactXmlDocument::Element::Iterator CompactXmlDocument::Element::begin() const noexcept
+{
+    return { getNumChildElements() > 0 ? element->children : nullptr };
+}
+
+CompactXmlDocument::Element::Iterator CompactXmlDocument::Element::end() const noexcept
+{
+    return { getNumChildElements() > 0 ? element->children + element->numChildren : nullptr };
+}
+
+XmlElement* CompactXmlDocument::Element::createXmlElement() const
+{
+    return element != nullptr ? CompactXmlDocument::createXmlElement (*element) : nullptr;
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class XmlReaderTests  : public UnitTest
+{
+public:
+    XmlReaderTests() : UnitTest ("XmlReader", "XML") {}
+
+    static String createRandomText (Random& r)
+    {
+        static const juce_wchar chars[] = { 'a', 'b', 'Z', '0', ' ', ' ', '&', '<', '>', '"', '\'', '\n', '\r', '\t', ';', '#',
+                                            0xe9, 0x20ac, 0x1f600 };
+        String s;
+
+        for (int i = r.nextInt (20) + 1; --i >= 0;)
+            s << String::charToString (chars[r.nextInt (numElementsInArray (chars))]);
+
+        return s;
+    }
+
+    static XmlElement* createRandomElement (Random& r, int depth)
+    {
+        auto* e = new XmlElement ("e" + String (r.nextInt (5)) + (r.nextBool() ? "-x.y" : ""));
+
+        for (int i = r.nextInt (4); --i >= 0;)
+            e->setAttribute ("a" + String (i), createRandomText (r));
+
+        if (depth < 5)
+        {
+            bool lastWasText = false;
+
+            for (int i = r.nextInt (5); --i >= 0;)
+            {
+                if (! lastWasText && r.nextInt (3) == 0)
+                {
+                    e->addTextElement ("t" + createRandomText (r));
+                    lastWasText = true;
+                }
+                else
+                {
+                    e->addChildElement (createRandomElement (r, depth + 1));
+                    lastWasText = false;
+                }
+            }
+        }
+
+        return e;
+    }
+
+    void expectSameAsXmlDocument (const String& text, Random& r)
+    {
+        std::unique_ptr<XmlElement> expected (XmlDocument::parse (text));
+        expect (expected != nullptr);
+
+        CompactXmlDocument doc;
+        expect (doc.parse (text).wasOk());
+        std::unique_ptr<XmlElement> fromMemory (doc.getDocumentElement().createXmlElement());
+
+        if (expected != nullptr && fromMemory != nullptr)
+        {
+            expect (expected->isEquivalentTo (fromMemory.get(), false));
+            expectEquals (fromMemory->createDocument ({}), expected->createDocument ({}));
+        }
+
+        // a stream read through a tiny buffer must produce exactly the same tokens
+        auto utf8 = text.toUTF8();
+        auto numBytes = utf8.sizeInBytes() - 1;
+        MemoryInputStream in (utf8.getAddress(), numBytes, false);
+        XmlReader memoryReader (utf8.getAddress(), numBytes);
+        XmlReader streamReader (in, (size_t) (16 + r.nextInt (64)));
+
+        for (;;)
+        {
+            auto token = memoryReader.next();
+            expect (streamReader.next() == token);
+            expect (streamReader.getName().toString() == memoryReader.getName().toString());
+            expect (streamReader.getText().toString() == memoryReader.getText().toString());
+            expectEquals (streamReader.getNumAttributes(), memoryReader.getNumAttributes());
+
+            for (int i = 0; i < memoryReader.getNumAttributes(); ++i)
+                expect (streamReader.getAttributeValue (i).toString() == memoryReader.getAttributeValue (i).toString());
+
+            if (token != XmlReader::Token::startElement && token != XmlReader::Token::endElement && token != XmlReader::Token::text)
+            {
+                expect (token == XmlReader::Token::endOfDocument);
+                break;
+            }
+        }
+    }
+
+    static Result parseWithReader (const char* text, int bufferSize)
+    {
+        std::unique_ptr<XmlReader> reader;
+        MemoryInputStream in (text, strlen (text), false);
+
+        if (bufferSize > 0)
+            reader.reset (new XmlReader (in, (size_t) bufferSize));
+        else
+            reader.reset (new XmlReader (text, strlen (text)));
+
+        for (;;)
+        {
+            auto token = reader->next();
+
+            if (token == XmlReader::Token::endOfDocument)
+                return Result::ok();
+
+            if (token == XmlReader::Token::error)
+                return Result::fail (reader->getLastError());
+        }
+    }
+
+    void runTest() override
+    {
+        auto r = getRandom();
+
+        beginTest ("Same results as XmlDocument");
+        {
+            for (int i = 0; i < 100; ++i)
+            {
+                std::unique_ptr<XmlElement> xml (createRandomElement (r, 0));
+                expectSameAsXmlDocument (xml->createDocument ({}, r.nextBool()), r);
+            }
+
+            expectSameAsXmlDocument ("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\r\n"
+                                     "<!DOCTYPE foo [ <!ELEMENT foo ANY> ]>\r\n"
+                                     "<!-- comment -->\r\n"
+                                     "<foo a='x > y' b=\"&lt;&amp;&#x41;&#66;&quot;&unknown;\">\r\n"
+                                     "  text &amp; more\r\n  text <!-- comment --> after comment\r\n"
+                                     "  <bar/><bar />\r\n"
+                                     "  <![CDATA[ <not a tag> & ]]>\r\n"
+                                     "  <?pi stuff?>\r\n"
+                                     "  <baz>  </baz>\r\n"
+                                     "</foo>\r\n", r);
+        }
+
+        beginTest ("Pull reader");
+        {
+            const char* text = "<root version=\"2\"><a x=\"1\"/><b><c>hello</c><d/></b>tail</root>";
+            XmlReader reader (text, strlen (text));
+
+            expect (reader.next() == XmlReader::Token::startElement);
+            expect (reader.getName() == "root" && reader.getDepth() == 1);
+            expect (reader.getAttribute ("version") == "2" && ! reader.hasAttribute ("x"));
+
+            expect (reader.next() == XmlReader::Token::startElement);
+            expect (reader.getName() == "a" && reader.isEmptyElement());
+            expect (reader.getAttributeName (0) == "x" && reader.getAttributeValue (0) == "1");
+            expect (reader.getAttributeValue (1).isEmpty());
+            expect (reader.next() == XmlReader::Token::endElement);
+            expect (reader.getName() == "a");
+
+            expect (reader.next() == XmlReader::Token::startElement);
+            expect (reader.getName() == "b");
+            expect (reader.skipCurrentElement());
+            expect (reader.getName() == "b" && reader.getDepth() == 2);
+
+            expect (reader.next() == XmlReader::Token::text);
+            expectEquals (reader.getText().toString(), String ("tail"));
+            expect (reader.next() == XmlReader::Token::endElement);
+            expect (reader.next() == XmlReader::Token::endOfDocument);
+            expect (reader.next() == XmlReader::Token::endOfDocument);
+        }
+
+        beginTest ("Errors");
+        {
+            for (auto* bad : { "", "   ", "text", "<", "<a>", "<a></b>", "<a x></a>", "<a x=1></a>", "<a x=\"1></a>",
+                               "<a><!-- </a>", "<a><![CDATA[ </a>", "<a><b></a></b>", "<?xml", "<!DOCTYPE <a></a>", "<a>&amp;" })
+            {
+                expect (parseWithReader (bad, 0).failed(), bad);
+                expect (parseWithReader (bad, 16).failed(), bad);
+            }
+
+            for (auto* good : { "<a/>", "<a></a>", " <a x='1' y = \"2\" >text</a> trailing junk", "<a><b/>&amp;</a>", "\xef\xbb\xbf<a/>" })
+            {
+                expect (parseWithReader (good, 0).wasOk(), String::fromUTF8 (good));
+                expect (parseWithReader (good, 16).wasOk(), String::fromUTF8 (good));
+            }
+
+            CompactXmlDocument doc;
+            expect (doc.parse (String ("<a><b></a>")).failed());
+            expect (! doc.getDocumentElement().isValid());
+        }
+
+        beginTest ("Throughput");
+        {
+            MemoryOutputStream out;
+            out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<SESSION>\n";
+
+            for (int i = 0; i < 20000; ++i)
+            {
+                out << "  <TRACK name=\"Track " << i << "\" id=\"" << r.nextInt64() << "\" colour=\"ff00ff00\" volume=\""
+                    << r.nextDouble() << "\" muted=\"0\">\n";
+
+                for (int j = 0; j < 4; ++j)
+                    out << "    <PLUGIN name=\"EQ &amp; Compressor\" state=\"" << String::toHexString (r.nextInt64()) << "\"/>\n";
+
+                out << "    <NOTES>Some notes about this track</NOTES>\n  </TRACK>\n";
+            }
+
+            out << "</SESSION>\n";
+
+            auto text = out.toUTF8();
+            auto* utf8 = text.toRawUTF8();
+            auto numBytes = text.getNumBytesAsUTF8();
+
+            auto measure = [&] (const char* description, std::function<bool()> fn)
+            {
+                auto start = Time::getMillisecondCounterHiRes();
+                expect (fn());
+                auto seconds = (Time::getMillisecondCounterHiRes() - start) / 1000.0;
+
+                logMessage ("  " + String (description).paddedRight (' ', 28)
+                             + String ((double) numBytes / (1024.0 * 1024.0) / jmax (seconds, 0.000001), 1) + " MB/s");
+            };
+
+            auto readAll = [] (XmlReader& reader)
+            {
+                int numElements = 0;
+
+                for (;;)
+                {
+                    auto token = reader.next();
+
+                    if (token == XmlReader::Token::startElement)
+                        ++numElements;
+                    else if (token != XmlReader::Token::endElement && token != XmlReader::Token::text)
+                        return token == XmlReader::Token::endOfDocument ? numElements : -1;
+                }
+            };
+
+            logMessage ("  " + String ((double) numBytes / (1024.0 * 1024.0), 1) + " MB document:");
+
+            measure ("XmlDocument::parse", [&] { std::unique_ptr<XmlElement> xml (XmlDocument::parse (text)); return xml != nullptr; });
+            measure ("XmlReader (memory)", [&] { XmlReader reader (utf8, numBytes); return readAll (reader) == 120001; });
+
+            measure ("XmlReader (stream)", [&]
+            {
+                MemoryInputStream in (utf8, numBytes, false);
+                XmlReader reader (in);
+                return readAll (reader) == 120001;
+            });
+
+            CompactXmlDocument doc;
+            measure ("CompactXmlDocument::parse", [&] { return doc.parse (utf8, numBytes).wasOk() && doc.getDocumentElement().getNumChildElements() == 20000; });
+
+            logMessage ("  CompactXmlDocument memory use: " + String ((double) doc.getMemoryUsage() / (1024.0 * 1024.0), 1) + " MB");
+        }
+    }
+};
+
+static XmlReaderTests xmlReaderTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,222 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A read-only, in-memory XML document.
+
+    This is an alternative to XmlDocument for when you need random access to a large
+    document. Instead of a separate heap object for every element, attribute and
+    name, all the elements and strings are packed into a few big blocks of memory
+    owned by the CompactXmlDocument, so it's much quicker to build and takes up a
+    fraction of the space of the equivalent XmlElement tree.
+
+    Elements are accessed through lightweight Element handles, which only remain valid
+    while the document that they came from is alive and hasn't been re-parsed. The
+    elements, attributes and text are the same as XmlDocument would produce for the
+    same input.
+
+    E.g.
+    @code
+    CompactXmlDocument doc;
+
+    if (doc.parse (sessionFile).wasOk())
+        for (auto track : doc.getDocumentElement().getChildByName ("TRACKS"))
+            DBG (track.getStringAttribute ("name"));
+    @endcode
+
+    @see XmlReader, XmlDocument
+
+    @tags{Core}
+*/
+class JUCE_API  CompactXmlDocument
+{
+public:
+    //==============================================================================
+    /** Creates an empty document. */
+    CompactXmlDocument();
+
+    /** Destructor. */
+    ~CompactXmlDocument();
+
+    //==============================================================================
+    /** Replaces the contents of this document by parsing some UTF-8 XML text. */
+    Result parse (const void* data, size_t numBytes);
+
+    /** Replaces the contents of this document by parsing some XML text. */
+    Result parse (const String& text);
+
+    /** Replaces the contents of this document by parsing the text from a stream. */
+    Result parse (InputStream& input);
+
+    /** Replaces the contents of this document by parsing a file, which is memory-mapped
+        rather than loaded if possible.
+    */
+    Result parse (const File& file);
+
+    /** Sets whether blocks of text that only contain whitespace are left out of the
+        document (which is the default, as it is for XmlDocument).
+    */
+    void setEmptyTextElementsIgnored (bool shouldBeIgnored) noexcept    { ignoreEmptyText = shouldBeIgnored; }
+
+    //==============================================================================
+    /** @internal */
+    struct AttributeData
+    {
+        const String::CharPointerType::CharType* name;
+        const String::CharPointerType::CharType* value;
+    };
+
+    /** @internal */
+    struct ElementData
+    {
+        const String::CharPointerType::CharType* name;  // (null for a text element)
+
+        union
+        {
+            const String::CharPointerType::CharType* text;
+            const AttributeData* attributes;
+        };
+
+        const ElementData* children;
+        uint32 numAttributes, numChildren;
+    };
+
+    /**
+        A reference to one of the elements in a CompactXmlDocument.
+
+        An Element that doesn't refer to anything (e.g. one that's returned when you ask
+        for a non-existent child) has no name, attributes or children.
+    */
+    class JUCE_API  Element
+    {
+    public:
+        /** Creates an Element that doesn't refer to anything. */
+        Element() noexcept {}
+
+        /** Returns true if this refers to an element in a document. */
+        bool isValid() const noexcept                   { return element != nullptr; }
+
+        /** Returns true if this is a block of text rather than a tagged element. */
+        bool isTextElement() const noexcept             { return element != nullptr && element->name == nullptr; }
+
+        /** Returns the element's tag name. */
+        StringRef getTagName() const noexcept;
+
+        /** Returns true if the element has the given tag name. */
+        bool hasTagName (StringRef possibleTagName) const noexcept;
+
+        /** For a text element, returns its text. */
+        StringRef getText() const noexcept;
+
+        /** Returns all the text inside this element and its children, joined together. */
+        String getAllSubText() const;
+
+        //==============================================================================
+        /** Returns the number of attributes the element has. */
+        int getNumAttributes() const noexcept;
+
+        /** Returns the name of one of the element's attributes. */
+        StringRef getAttributeName (int index) const noexcept;
+
+        /** Returns the value of one of the element's attributes. */
+        StringRef getAttributeValue (int index) const noexcept;
+
+        /** Returns true if the element has an attribute with the given name. */
+        bool hasAttribute (StringRef attributeName) const noexcept;
+
+        /** Returns the value of the named attribute, or an empty string if there isn't one. */
+        StringRef getStringAttribute (StringRef attributeName) const noexcept;
+
+        /** Returns the value of the named attribute as an integer, in the same way as
+            XmlElement::getIntAttribute().
+        */
+        int getIntAttribute (StringRef attributeName, int defaultReturnValue = 0) const;
+
+        /** Returns the value of the named attribute as a double, in the same way as
+            XmlElement::getDoubleAttribute().
+        */
+        double getDoubleAttribute (StringRef attributeName, double defaultReturnValue = 0.0) const;
+
+        /** Returns the value of the named attribute as a bool, in the same way as
+            XmlElement::getBoolAttribute().
+        */
+        bool getBoolAttribute (StringRef attributeName, bool defaultReturnValue = false) const;
+
+        //==============================================================================
+        /** Returns the number of child elements, including text elements. */
+        int getNumChildElements() const noexcept;
+
+        /** Returns one of the element's children. */
+        Element getChildElement (int index) const noexcept;
+
+        /** Returns the first child element with the given tag name. */
+        Element getChildByName (StringRef tagNameToLookFor) const noexcept;
+
+        /** Creates an XmlElement tree which is a copy of this element and all its children.
+            The caller is responsible for deleting the object that is returned.
+        */
+        XmlElement* createXmlElement() const;
+
+        /** Iterates the element's children. */
+        struct Iterator
+        {
+            Element operator*() const noexcept                      { return Element (element); }
+            Iterator& operator++() noexcept                         { ++element; return *this; }
+            bool operator!= (const Iterator& other) const noexcept  { return element != other.element; }
+
+            const ElementData* element;
+        };
+
+        Iterator begin() const noexcept;
+        Iterator end() const noexcept;
+
+        /** @internal */
+        explicit Element (const ElementData* e) noexcept  : element (e) {}
+
+    private:
+        const ElementData* element = nullptr;
+    };
+
+    /** Returns the document's outer element. */
+    Element getDocumentElement() const noexcept     { return Element (root); }
+
+    /** Returns the number of bytes of memory the document is using. */
+    size_t getMemoryUsage() const noexcept          { return arena.getTotalSize(); }
+
+private:
+    //==============================================================================
+    struct Builder;
+
+    ArenaAllocator arena;
+    const ElementData* root = nullptr;
+    bool ignoreEmptyText = true;
+
+    static XmlElement* createXmlElement (const ElementData&);
+
+    JUCE_DECLARE_NON_COPYABLE (CompactXmlDocument)
+};
+
+} // namespace juce
@@ -89,6 +89,39 @@ namespace XmlIdentifierChars
     }
 }
 
+#if JUCE_STRING_UTF_TYPE == 8
+// Copies the run of plain ASCII text starting at the given position, stopping at
+// anything that needs individual attention, and converting CR and CRLF to LF.
+static String::CharPointerType copyPlainTextBlock (String::CharPointerType input, MemoryOutputStream& out, bool& containsNonWhitespace)
+{
+    auto* start = input.getAddress();
+    auto* end = CharPointer_UTF8::findEndOfASCII (start, '<', '&');
+
+    if (! containsNonWhitespace)
+        for (auto* p = start; p < end && ! containsNonWhitespace; ++p)
+            containsNonWhitespace = ! CharacterFunctions::isWhitespace (*p);
+
+    for (const char* p = start; p < end;)
+    {
+        auto* cr = static_cast<const char*> (std::memchr (p, '\r', (size_t) (end - p)));
+
+        if (cr == nullptr)
+        {
+            out.write (p, (size_t) (end - p));
+            break;
+        }
+
+        out.write (p, (size_t) (cr - p));
+        p = cr + 1;
+
+        if (p == end || *p != '\n')
+            out.writeByte ('\n');
+    }
+
+    return String::CharPointerType (end);
+}
+#endif
+
 XmlElement* XmlDocument::getDocumentElement (const bool onlyReadOuterDocumentElement)
 {
     if (originalText.isEmpty() && inputSource != nullptr)
@@ -334,6 +367,10 @@ void XmlDocument::readQuotedString (String& result)
 
             for (;;)
             {
+               #if JUCE_STRING_UTF_TYPE == 8
+                input = String::CharPointerType (CharPointer_UTF8::findEndOfASCII (input.getAddress(), (char) quote, '&'));
+               #endif
+
                 auto character = *input;
 
                 if (character == quote)
@@ -593,6 +630,10 @@ void XmlDocument::readChildElements (XmlElement& parent)
                 {
                     for (;; ++input)
                     {
+                       #if JUCE_STRING_UTF_TYPE == 8
+                        input = copyPlainTextBlock (input, textElementContent, contentShouldBeUsed);
+                       #endif
+
                         auto nextChar = *input;
 
                         if (nextChar == '\r')
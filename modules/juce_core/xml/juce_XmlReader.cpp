@@ -0,0 +1,668 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+namespace XmlReaderHelpers
+{
+    static bool isNameChar (char c) noexcept
+    {
+        return (uint8) c >= 0x80 || XmlIdentifierChars::isIdentifierChar ((juce_wchar) (uint8) c);
+    }
+
+    static const char* findEndOfName (const char* p, const char* end) noexcept
+    {
+        while (p < end && isNameChar (*p))
+            ++p;
+
+        return p;
+    }
+
+    static const char* skipWhitespace (const char* p, const char* end) noexcept
+    {
+        while (p < end && CharacterFunctions::isWhitespace (*p))
+            ++p;
+
+        return p;
+    }
+
+    static bool isEntity (const char* p, size_t length, const char* entity) noexcept
+    {
+        for (size_t i = 0; i < length; ++i)
+            if (entity[i] == 0 || CharacterFunctions::toLowerCase ((juce_wchar) p[i]) != (juce_wchar) entity[i])
+                return false;
+
+        return entity[length] == 0;
+    }
+}
+
+//==============================================================================
+XmlReader::XmlReader (const void* sourceData, size_t numBytes)
+    : SlidingInputBuffer (sourceData, numBytes)
+{
+}
+
+XmlReader::XmlReader (InputStream& source, size_t bufferSizeToUse)
+    : SlidingInputBuffer (source, bufferSizeToUse)
+{
+}
+
+XmlReader::~XmlReader() {}
+
+//==============================================================================
+bool XmlReader::find (char character, size_t& offset)
+{
+    for (;;)
+    {
+        if (position + offset < numBytesAvailable)
+        {
+            if (auto* found = static_cast<const char*> (std::memchr (data + position + offset, character,
+                                                                      numBytesAvailable - position - offset)))
+            {
+                offset = (size_t) (found - (data + position));
+                return true;
+            }
+        }
+
+        offset = numBytesAvailable - position;
+
+        if (! ensureAvailable (offset + 1))
+            return false;
+    }
+}
+
+bool XmlReader::find (const char* sequence, size_t& offset)
+{
+    auto length = strlen (sequence);
+
+    for (;; ++offset)
+    {
+        if (! (find (sequence[0], offset) && ensureAvailable (offset + length)))
+            return false;
+
+        if (memcmp (data + position + offset, sequence, length) == 0)
+            return true;
+    }
+}
+
+bool XmlReader::lookingAt (const char* textToMatch)
+{
+    auto length = strlen (textToMatch);
+    return ensureAvailable (length) && memcmp (data + position, textToMatch, length) == 0;
+}
+
+bool XmlReader::skipWhitespace()
+{
+    for (;;)
+    {
+        while (position < numBytesAvailable)
+        {
+            if (! CharacterFunctions::isWhitespace (data[position]))
+                return true;
+
+            ++position;
+        }
+
+        if (! ensureAvailable (1))
+            return false;
+    }
+}
+
+XmlReader::Token XmlReader::fail (const String& message)
+{
+    lastError = message + " (at byte " + String (getPosition()) + ")";
+    return currentToken = Token::error;
+}
+
+XmlReader::Token XmlReader::setToken (Token newToken) noexcept
+{
+    return currentToken = newToken;
+}
+
+//==============================================================================
+XmlReader::Token XmlReader::next()
+{
+    if (currentToken == Token::endOfDocument || currentToken == Token::error)
+        return currentToken;
+
+    if (currentToken == Token::endElement)
+    {
+        openElementNames.resize (openElementStarts.getLast());
+        openElementStarts.removeLast();
+
+        if (openElementStarts.isEmpty())
+            return setToken (Token::endOfDocument);
+    }
+
+    name = {};
+    text = {};
+    attributes.clearQuick();
+    decoded.reset();
+
+    if (emptyElementPending)
+    {
+        emptyElementPending = false;
+        name = { CharPointer_UTF8 (openElementNames.begin() + openElementStarts.getLast()),
+                 CharPointer_UTF8 (openElementNames.end()) };
+
+        return setToken (Token::endElement);
+    }
+
+    if (currentToken == Token::none)
+        return readDocumentStart() ? setToken (Token::startElement) : currentToken;
+
+    for (;;)
+    {
+        if (! ensureAvailable (2))
+            return fail ("unmatched tags");
+
+        if (data[position] != '<')
+        {
+            bool wasIgnored = false;
+
+            if (! readText (wasIgnored))
+                return currentToken;
+
+            if (! wasIgnored)
+                return setToken (Token::text);
+
+            continue;
+        }
+
+        if (data[position + 1] == '/')
+            return readEndTag() ? setToken (Token::endElement) : currentToken;
+
+        if (lookingAt ("<![CDATA["))
+            return readCDATA() ? setToken (Token::text) : currentToken;
+
+        bool wasSkipped = false;
+
+        if (! skipMarkup (wasSkipped))
+            return currentToken;
+
+        if (! wasSkipped)
+            return readStartTag() ? setToken (Token::startElement) : currentToken;
+    }
+}
+
+bool XmlReader::skipCurrentElement()
+{
+    // This can only be called straight after next() has returned startElement
+    jassert (currentToken == Token::startElement);
+
+    for (auto depth = getDepth();;)
+    {
+        auto token = next();
+
+        if (token == Token::endElement && getDepth() == depth)
+            return true;
+
+        if (token == Token::error || token == Token::endOfDocument)
+            return false;
+    }
+}
+
+//==============================================================================
+bool XmlReader::readDocumentStart()
+{
+    if (lookingAt ("\xef\xbb\xbf"))
+        position += 3;
+
+    for (;;)
+    {
+        if (! skipWhitespace())
+        {
+            fail ("not enough input");
+            return false;
+        }
+
+        if (data[position] != '<')
+        {
+            fail ("no document element");
+            return false;
+        }
+
+        bool wasSkipped = false;
+
+        if (! skipMarkup (wasSkipped))
+            return false;
+
+        if (! wasSkipped)
+            return readStartTag();
+    }
+}
+
+bool XmlReader::skipMarkup (bool& wasSkipped)
+{
+    wasSkipped = true;
+
+    if (lookingAt ("<!--"))
+    {
+        size_t end = 4;
+
+        if (! find ("-->", end))
+        {
+            fail ("unterminated comment");
+            return false;
+        }
+
+        position += end + 3;
+        return true;
+    }
+
+    if (lookingAt ("<?"))
+    {
+        size_t end = 2;
+
+        if (! find ("?>", end))
+        {
+            fail ("malformed header");
+            return false;
+        }
+
+        position += end + 2;
+        return true;
+    }
+
+    if (lookingAt ("<!DOCTYPE"))
+    {
+        for (size_t i = 9, depth = 1;; ++i)
+        {
+            if (! ensureAvailable (i + 1))
+            {
+                fail ("malformed DTD");
+                return false;
+            }
+
+            auto c = data[position + i];
+
+            if (c == '<')
+            {
+                ++depth;
+            }
+            else if (c == '>' && --depth == 0)
+            {
+                position += i + 1;
+                return true;
+            }
+        }
+    }
+
+    wasSkipped = false;
+    return true;
+}
+
+bool XmlReader::readStartTag()
+{
+    using namespace XmlReaderHelpers;
+
+    // find the end of the tag, ignoring any '>' characters inside attribute values
+    size_t end = 1;
+
+    for (;; ++end)
+    {
+        if (position + end >= numBytesAvailable && ! ensureAvailable (end + 1))
+        {
+            fail ("unmatched tags");
+            return false;
+        }
+
+        auto c = data[position + end];
+
+        if (c == '>')
+            break;
+
+        if (c == '"' || c == '\'')
+        {
+            ++end;
+
+            if (! find (c, end))
+            {
+                fail ("unmatched quotes");
+                return false;
+            }
+        }
+    }
+
+    auto* tagEnd = data + position + end;
+    auto* p = XmlReaderHelpers::skipWhitespace (data + position + 1, tagEnd);
+    auto* nameEnd = findEndOfName (p, tagEnd);
+
+    if (nameEnd == p)
+    {
+        fail ("tag name missing");
+        return false;
+    }
+
+    name = { CharPointer_UTF8 (p), CharPointer_UTF8 (nameEnd) };
+    p = nameEnd;
+
+    for (;;)
+    {
+        p = XmlReaderHelpers::skipWhitespace (p, tagEnd);
+
+        if (p == tagEnd)
+            break;
+
+        if (*p == '/' && p + 1 == tagEnd)
+        {
+            emptyElementPending = true;
+            break;
+        }
+
+        auto* attributeNameEnd = findEndOfName (p, tagEnd);
+
+        if (attributeNameEnd == p)
+        {
+            fail ("illegal character found in " + name.toString() + ": '" + String::charToString ((juce_wchar) (uint8) *p) + "'");
+            return false;
+        }
+
+        Attribute attribute;
+        attribute.name = { CharPointer_UTF8 (p), CharPointer_UTF8 (attributeNameEnd) };
+        attribute.decodedStart = -1;
+        attribute.decodedEnd = -1;
+
+        p = XmlReaderHelpers::skipWhitespace (attributeNameEnd, tagEnd);
+
+        if (p != tagEnd && *p == '=')
+            p = XmlReaderHelpers::skipWhitespace (p + 1, tagEnd);
+        else
+            p = tagEnd;
+
+        if (p == tagEnd || (*p != '"' && *p != '\''))
+        {
+            fail ("expected '=' after attribute '" + attribute.name.toString() + "'");
+            return false;
+        }
+
+        auto quote = *p++;
+
+        // (the scan for the end of the tag has already checked that there's a closing quote)
+        auto* valueEnd = static_cast<const char*> (std::memchr (p, quote, (size_t) (tagEnd - p)));
+        attribute.value = { CharPointer_UTF8 (p), CharPointer_UTF8 (valueEnd) };
+
+        if (std::memchr (p, '&', (size_t) (valueEnd - p)) != nullptr)
+        {
+            attribute.decodedStart = (int) decoded.getDataSize();
+            decode (p, valueEnd, false);
+            attribute.decodedEnd = (int) decoded.getDataSize();
+        }
+
+        attributes.add (attribute);
+        p = valueEnd + 1;
+    }
+
+    // now that all the values have been decoded, the decoded block won't move any more
+    auto* decodedData = static_cast<const char*> (decoded.getData());
+
+    for (auto& a : attributes)
+        if (a.decodedStart >= 0)
+            a.value = { CharPointer_UTF8 (decodedData + a.decodedStart), CharPointer_UTF8 (decodedData + a.decodedEnd) };
+
+    openElementStarts.add (openElementNames.size());
+    openElementNames.addArray (static_cast<const char*> (name.start.getAddress()), (int) name.getNumBytes());
+
+    position += end + 1;
+    return true;
+}
+
+bool XmlReader::readEndTag()
+{
+    using namespace XmlReaderHelpers;
+
+    size_t end = 2;
+
+    if (! find ('>', end))
+    {
+        fail ("unmatched tags");
+        return false;
+    }
+
+    auto* tagEnd = data + position + end;
+    auto* p = XmlReaderHelpers::skipWhitespace (data + position + 2, tagEnd);
+    auto* nameEnd = findEndOfName (p, tagEnd);
+    auto* openName = openElementNames.begin() + openElementStarts.getLast();
+    auto openNameLength = (size_t) (openElementNames.end() - openName);
+
+    if ((size_t) (nameEnd - p) != openNameLength || memcmp (p, openName, openNameLength) != 0)
+    {
+        fail ("mismatched closing tag for " + String (CharPointer_UTF8 (openName), CharPointer_UTF8 (openElementNames.end())));
+        return false;
+    }
+
+    name = { CharPointer_UTF8 (p), CharPointer_UTF8 (nameEnd) };
+    position += end + 1;
+    return true;
+}
+
+bool XmlReader::readCDATA()
+{
+    size_t end = 9;
+
+    if (! find ("]]>", end))
+    {
+        fail ("unterminated CDATA section");
+        return false;
+    }
+
+    text = { CharPointer_UTF8 (data + position + 9), CharPointer_UTF8 (data + position + end) };
+    position += end + 3;
+    return true;
+}
+
+bool XmlReader::readText (bool& wasIgnored)
+{
+    size_t end = 0;
+
+    if (! find ('<', end))
+    {
+        fail ("unmatched tags");
+        return false;
+    }
+
+    auto isFollowedByComment = ensureAvailable (end + 4) && memcmp (data + position + end, "<!--", 4) == 0;
+
+    if (! isFollowedByComment
+         && std::memchr (data + position, '&', end) == nullptr
+         && std::memchr (data + position, '\r', end) == nullptr)
+    {
+        // the common case, where the text can be used without copying it
+        text = { CharPointer_UTF8 (data + position), CharPointer_UTF8 (data + position + end) };
+        position += end;
+    }
+    else
+    {
+        // comments don't interrupt a block of text, so join up the pieces on either side of them
+        for (;;)
+        {
+            decode (data + position, data + position + end, true);
+            position += end;
+
+            if (! lookingAt ("<!--"))
+                break;
+
+            end = 4;
+
+            if (! find ("-->", end))
+            {
+                fail ("unterminated comment");
+                return false;
+            }
+
+            position += end + 3;
+            end = 0;
+
+            if (! find ('<', end))
+            {
+                fail ("unmatched tags");
+                return false;
+            }
+        }
+
+        auto* decodedData = static_cast<const char*> (decoded.getData());
+        text = { CharPointer_UTF8 (decodedData), CharPointer_UTF8 (decodedData + decoded.getDataSize()) };
+    }
+
+    wasIgnored = false;
+
+    if (ignoreEmptyText)
+    {
+        wasIgnored = true;
+
+        for (auto* p = text.start.getAddress(); p != text.end.getAddress(); ++p)
+        {
+            if (! CharacterFunctions::isWhitespace (*p))
+            {
+                wasIgnored = false;
+                break;
+            }
+        }
+    }
+
+    return true;
+}
+
+void XmlReader::decode (const char* p, const char* end, bool convertCarriageReturns)
+{
+    using namespace XmlReaderHelpers;
+
+    while (p < end)
+    {
+        auto* runEnd = p;
+
+        while (runEnd < end && *runEnd != '&' && ! (*runEnd == '\r' && convertCarriageReturns))
+            ++runEnd;
+
+        decoded.write (p, (size_t) (runEnd - p));
+        p = runEnd;
+
+        if (p == end)
+            break;
+
+        if (*p == '\r')
+        {
+            if (++p == end || *p != '\n')
+                decoded.writeByte ('\n');
+
+            continue;
+        }
+
+        auto* semiColon = static_cast<const char*> (std::memchr (p, ';', (size_t) jmin ((int) (end - p), 16)));
+
+        if (semiColon == nullptr)
+        {
+            decoded.writeByte ('&');
+            ++p;
+            continue;
+        }
+
+        auto* entity = p + 1;
+        auto length = (size_t) (semiColon - entity);
+
+        if      (isEntity (entity, length, "amp"))    decoded.writeByte ('&');
+        else if (isEntity (entity, length, "quot"))   decoded.writeByte ('"');
+        else if (isEntity (entity, length, "apos"))   decoded.writeByte ('\'');
+        else if (isEntity (entity, length, "lt"))     decoded.writeByte ('<');
+        else if (isEntity (entity, length, "gt"))     decoded.writeByte ('>');
+        else if (length > 1 && *entity == '#')
+        {
+            auto isHex = (entity[1] == 'x' || entity[1] == 'X');
+            auto* digit = entity + (isHex ? 2 : 1);
+            uint32 charCode = 0;
+            bool isValid = digit < semiColon;
+
+            for (; digit < semiColon && isValid; ++digit)
+            {
+                auto value = isHex ? CharacterFunctions::getHexDigitValue ((juce_wchar) *digit)
+                                   : (*digit >= '0' && *digit <= '9' ? *digit - '0' : -1);
+
+                isValid = value >= 0;
+                charCode = charCode * (isHex ? 16u : 10u) + (uint32) value;
+            }
+
+            if (! isValid)
+            {
+                decoded.writeByte ('&');
+                ++p;
+                continue;
+            }
+
+            if (charCode != 0)
+                decoded.appendUTF8Char ((juce_wchar) charCode);
+        }
+        else
+        {
+            // an unknown entity is replaced by its name, as XmlDocument does
+            decoded.write (entity, length);
+        }
+
+        p = semiColon + 1;
+    }
+}
+
+//==============================================================================
+XmlReader::TextRange XmlReader::getAttributeName (int index) const noexcept
+{
+    return isPositiveAndBelow (index, attributes.size()) ? attributes.getReference (index).name : TextRange();
+}
+
+XmlReader::TextRange XmlReader::getAttributeValue (int index) const noexcept
+{
+    return isPositiveAndBelow (index, attributes.size()) ? attributes.getReference (index).value : TextRange();
+}
+
+XmlReader::TextRange XmlReader::getAttribute (StringRef attributeName) const noexcept
+{
+    for (auto& a : attributes)
+        if (a.name == attributeName)
+            return a.value;
+
+    return {};
+}
+
+bool XmlReader::hasAttribute (StringRef attributeName) const noexcept
+{
+    for (auto& a : attributes)
+        if (a.name == attributeName)
+            return true;
+
+    return false;
+}
+
+bool XmlReader::TextRange::operator== (StringRef other) const noexcept
+{
+   #if JUCE_STRING_UTF_TYPE == 8
+    auto* o = other.text.getAddress();
+
+    for (auto* p = start.getAddress(); p != end.getAddress(); ++p, ++o)
+        if (*o != *p)
+            return false;
+
+    return *o == 0;
+   #else
+    return toString() == other;
+   #endif
+}
+
+} // namespace juce
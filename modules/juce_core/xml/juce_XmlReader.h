@@ -0,0 +1,203 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A pull-style XML parser, which steps through a document one token at a time
+    rather than building a tree of XmlElement objects.
+
+    The reader can either work on a block of memory (e.g. the contents of a
+    MemoryMappedFile), or pull its data from an InputStream through a buffer, so
+    a document of any size can be processed without loading it all at once.
+
+    Tag names, attributes and text are returned as TextRange objects that point
+    directly into the input data wherever possible. Only text that contains entities
+    or carriage-returns needs to be copied, so nothing gets allocated for each
+    element that's parsed. The ranges are only valid until the next call to next().
+
+    E.g.
+    @code
+    XmlReader reader (mappedFile.getData(), mappedFile.getSize());
+
+    for (auto token = reader.next(); token == XmlReader::Token::startElement
+                                       || token == XmlReader::Token::endElement
+                                       || token == XmlReader::Token::text; token = reader.next())
+    {
+        if (token == XmlReader::Token::startElement && reader.getName() == "PLUGIN")
+            names.add (reader.getAttribute ("name").toString());
+    }
+
+    if (reader.getCurrentToken() == XmlReader::Token::error)
+        DBG (reader.getLastError());
+    @endcode
+
+    The parser only understands UTF-8. It skips over comments, processing instructions
+    and DTDs, and doesn't expand any entities apart from the standard ones and character
+    references - any others are replaced by their names. Apart from that, the rules for
+    text are the same as XmlDocument's, so a reader will see the same elements and text
+    that an XmlDocument would produce.
+
+    @see XmlDocument, CompactXmlDocument
+
+    @tags{Core}
+*/
+class JUCE_API  XmlReader  : private SlidingInputBuffer
+{
+public:
+    //==============================================================================
+    /** Creates a reader for a block of UTF-8 XML text.
+        The data must remain valid for as long as the reader is in use.
+    */
+    XmlReader (const void* data, size_t numBytes);
+
+    /** Creates a reader which pulls its UTF-8 XML text from a stream.
+
+        The stream is read in chunks of the given size, which will only be increased
+        if a single tag or block of text turns out to be longer than that. The stream
+        must remain valid for as long as the reader is in use.
+    */
+    XmlReader (InputStream& source, size_t bufferSize = 65536);
+
+    /** Destructor. */
+    ~XmlReader();
+
+    //==============================================================================
+    /** The kinds of token that next() can return. */
+    enum class Token
+    {
+        none,           /**< next() hasn't been called yet. */
+        startElement,   /**< An opening tag. getName() and the attribute methods describe it. */
+        endElement,     /**< A closing tag. An empty tag such as <foo/> produces a startElement and an endElement. */
+        text,           /**< A block of text or CDATA. getText() returns it. */
+        endOfDocument,  /**< The outer element has been closed. */
+        error           /**< The document was malformed. getLastError() describes the problem. */
+    };
+
+    /** Reads the next token from the document.
+        Once this has returned endOfDocument or error, it will keep doing so.
+    */
+    Token next();
+
+    /** Returns the token that was last returned by next(). */
+    Token getCurrentToken() const noexcept          { return currentToken; }
+
+    /** After next() has returned startElement, this reads and discards everything up to
+        and including the matching endElement. Returns false if there was an error.
+    */
+    bool skipCurrentElement();
+
+    /** Sets whether blocks of text that only contain whitespace are skipped (which is
+        the default, as it is for XmlDocument).
+    */
+    void setEmptyTextIgnored (bool shouldBeIgnored) noexcept    { ignoreEmptyText = shouldBeIgnored; }
+
+    //==============================================================================
+    /** A non-owning reference to a section of UTF-8 text. */
+    struct JUCE_API  TextRange
+    {
+        TextRange() noexcept {}
+        TextRange (CharPointer_UTF8 s, CharPointer_UTF8 e) noexcept  : start (s), end (e) {}
+
+        CharPointer_UTF8 start { nullptr }, end { nullptr };
+
+        bool isEmpty() const noexcept                   { return start.getAddress() == end.getAddress(); }
+        bool isNotEmpty() const noexcept                { return ! isEmpty(); }
+        size_t getNumBytes() const noexcept             { return (size_t) (end.getAddress() - start.getAddress()); }
+        String toString() const                         { return String (start, end); }
+
+        bool operator== (StringRef other) const noexcept;
+        bool operator!= (StringRef other) const noexcept    { return ! operator== (other); }
+    };
+
+    /** For a startElement or endElement token, returns the element's tag name. */
+    TextRange getName() const noexcept              { return name; }
+
+    /** For a text token, returns the text. */
+    TextRange getText() const noexcept              { return text; }
+
+    /** Returns true if the last startElement was an empty tag such as <foo/>. */
+    bool isEmptyElement() const noexcept            { return emptyElementPending; }
+
+    /** For a startElement token, returns the number of attributes the element has. */
+    int getNumAttributes() const noexcept           { return attributes.size(); }
+
+    /** For a startElement token, returns the name of one of its attributes. */
+    TextRange getAttributeName (int index) const noexcept;
+
+    /** For a startElement token, returns the value of one of its attributes. */
+    TextRange getAttributeValue (int index) const noexcept;
+
+    /** For a startElement token, returns the value of the attribute with the given
+        name, or an empty range if there isn't one.
+    */
+    TextRange getAttribute (StringRef attributeName) const noexcept;
+
+    /** For a startElement token, returns true if the element has the given attribute. */
+    bool hasAttribute (StringRef attributeName) const noexcept;
+
+    /** Returns the number of elements that are currently open. */
+    int getDepth() const noexcept                   { return openElementStarts.size(); }
+
+    /** If next() has returned an error, this describes it. */
+    const String& getLastError() const noexcept     { return lastError; }
+
+    /** Returns the number of bytes of input that have been consumed so far. */
+    int64 getPosition() const noexcept              { return bytesBeforeBuffer + (int64) position; }
+
+private:
+    //==============================================================================
+    struct Attribute
+    {
+        TextRange name, value;
+        int decodedStart, decodedEnd;
+    };
+
+    Token currentToken = Token::none;
+    TextRange name, text;
+    Array<Attribute> attributes;
+    MemoryOutputStream decoded;
+    Array<char> openElementNames;
+    Array<int> openElementStarts;
+    String lastError;
+    bool ignoreEmptyText = true, emptyElementPending = false;
+
+    bool find (char character, size_t& offset);
+    bool find (const char* sequence, size_t& offset);
+    bool skipWhitespace();
+    bool lookingAt (const char* text);
+    void decode (const char* start, const char* end, bool convertCarriageReturns);
+    bool skipMarkup (bool& wasSkipped);
+    bool readDocumentStart();
+    bool readStartTag();
+    bool readEndTag();
+    bool readCDATA();
+    bool readText (bool& wasIgnored);
+    Token fail (const String& message);
+    Token setToken (Token) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE (XmlReader)
+};
+
+} // namespace juce
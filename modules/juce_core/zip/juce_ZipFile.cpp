@@ -122,6 +122,38 @@ static int64 findCentralDirectoryFileHeader (InputStream& input, int& numEntries
     return 0;
 }
 
+//==============================================================================
+// Calls a function for each index on several threads. Rather than splitting the range into
+// chunks, the indexes are handed out one at a time, so that a few items which take much longer
+// than the others don't leave the rest of the threads with nothing to do.
+template <typename FunctionType>
+static void runZipTasksInParallel (int numItems, ThreadPool& pool, FunctionType&& function)
+{
+    std::atomic<int> nextItem { 0 };
+
+    parallelFor (0, jmin (numItems, pool.getNumThreads() + 1), [&] (int)
+    {
+        for (;;)
+        {
+            auto item = nextItem++;
+
+            if (item >= numItems)
+                break;
+
+            function (item);
+        }
+    }, 1, &pool);
+}
+
+static String getEntryPath (const ZipFile::ZipEntry& entry)
+{
+   #if JUCE_WINDOWS
+    return entry.filename;
+   #else
+    return entry.filename.replaceCharacter ('\\', '/');
+   #endif
+}
+
 //==============================================================================
 struct ZipFile::ZipInputStream  : public InputStream
 {
@@ -238,7 +270,7 @@ ZipFile::ZipFile (InputStream& stream)  : inputStream (&stream)
     init();
 }
 
-ZipFile::ZipFile (const File& file)  : inputSource (new FileInputSource (file))
+ZipFile::ZipFile (const File& file)  : inputSource (new FileInputSource (file)), sourceFile (file)
 {
     init();
 }
@@ -279,7 +311,7 @@ const ZipFile::ZipEntry* ZipFile::getEntry (const int index) const noexcept
     return nullptr;
 }
 
-int ZipFile::getIndexOfFileName (const String& fileName, bool ignoreCase) const noexcept
+int ZipFile::getIndexOfFileName (StringRef fileName, bool ignoreCase) const noexcept
 {
     for (int i = 0; i < entries.size(); ++i)
     {
@@ -329,6 +361,47 @@ InputStream* ZipFile::createStreamForEntry (const ZipEntry& entry)
     return nullptr;
 }
 
+const void* ZipFile::getMappedDataForEntry (int index)
+{
+    auto* zei = entries[index];
+
+    if (zei == nullptr || zei->isCompressed || zei->compressedSize != zei->entry.uncompressedSize)
+        return nullptr;
+
+    const ScopedLock sl (lock);
+
+    if (! hasTriedToMapFile)
+    {
+        hasTriedToMapFile = true;
+
+        if (sourceFile != File())
+        {
+            mappedFile.reset (new MemoryMappedFile (sourceFile, MemoryMappedFile::readOnly));
+
+            if (mappedFile->getData() == nullptr)
+                mappedFile.reset();
+        }
+    }
+
+    if (mappedFile == nullptr)
+        return nullptr;
+
+    auto* data = static_cast<const char*> (mappedFile->getData());
+    auto size = (int64) mappedFile->getSize();
+    auto headerStart = zei->streamOffset;
+
+    if (headerStart + 30 > size || readUnalignedLittleEndianInt (data + headerStart) != 0x04034b50)
+        return nullptr;
+
+    auto dataStart = headerStart + 30 + readUnalignedLittleEndianShort (data + headerStart + 26)
+                                      + readUnalignedLittleEndianShort (data + headerStart + 28);
+
+    if (dataStart + zei->compressedSize > size)
+        return nullptr;
+
+    return data + dataStart;
+}
+
 void ZipFile::sortEntriesByFilename()
 {
     std::sort (entries.begin(), entries.end(),
@@ -376,9 +449,9 @@ void ZipFile::init()
 
                     entries.add (new ZipEntryHolder (buffer, fileNameLen));
 
-                    pos += 46 + fileNameLen
-                            + readUnalignedLittleEndianShort (buffer + 30)
-                            + readUnalignedLittleEndianShort (buffer + 32);
+                    pos += (size_t) (46 + fileNameLen
+                                      + readUnalignedLittleEndianShort (buffer + 30)
+                                      + readUnalignedLittleEndianShort (buffer + 32));
                 }
             }
         }
@@ -399,15 +472,90 @@ Result ZipFile::uncompressTo (const File& targetDirectory,
     return Result::ok();
 }
 
+Result ZipFile::uncompressTo (const File& targetDirectory, bool shouldOverwriteFiles, ThreadPool& threadPool)
+{
+    // Entries that write to the same file have to be uncompressed in order, so they're
+    // grouped together, and each group is handled by a single thread.
+    HashMap<String, int> groupIndexes;
+    HashMap<String, File> parentFolders;
+    Array<Array<int>> groups;
+    Array<int64> groupSizes;
+
+    for (int i = 0; i < entries.size(); ++i)
+    {
+        auto& entry = entries.getUnchecked (i)->entry;
+        auto entryPath = getEntryPath (entry);
+
+        if (entryPath.isEmpty())
+            continue;
+
+        auto targetFile = targetDirectory.getChildFile (entryPath);
+        auto key = targetFile.getFullPathName();
+
+        if (! File::areFileNamesCaseSensitive())
+            key = key.toLowerCase();
+
+        if (! groupIndexes.contains (key))
+        {
+            groupIndexes.set (key, groups.size());
+            groups.add ({});
+            groupSizes.add (0);
+        }
+
+        auto group = groupIndexes[key];
+        groups.getReference (group).add (i);
+        groupSizes.getReference (group) += entry.uncompressedSize;
+
+        auto parent = targetFile.getParentDirectory();
+        parentFolders.set (parent.getFullPathName(), parent);
+    }
+
+    // Creating the folders first stops the threads from racing to create the same ones. Any
+    // that fail will be reported when the entries inside them are uncompressed.
+    for (HashMap<String, File>::Iterator i (parentFolders); i.next();)
+        i.getValue().createDirectory();
+
+    // Starting with the biggest groups means that the small ones can fill in the gaps at the end
+    Array<int> order;
+
+    for (int i = 0; i < groups.size(); ++i)
+        order.add (i);
+
+    std::stable_sort (order.begin(), order.end(),
+                      [&] (int a, int b) { return groupSizes.getUnchecked (a) > groupSizes.getUnchecked (b); });
+
+    CriticalSection failureLock;
+    auto firstFailedEntry = entries.size();
+    auto firstFailure = Result::ok();
+
+    runZipTasksInParallel (order.size(), threadPool, [&] (int task)
+    {
+        for (auto index : groups.getReference (order.getUnchecked (task)))
+        {
+            auto result = uncompressEntry (index, targetDirectory, shouldOverwriteFiles);
+
+            if (result.failed())
+            {
+                const ScopedLock sl (failureLock);
+
+                if (index < firstFailedEntry)
+                {
+                    firstFailedEntry = index;
+                    firstFailure = result;
+                }
+
+                break;
+            }
+        }
+    });
+
+    return firstFailure;
+}
+
 Result ZipFile::uncompressEntry (int index, const File& targetDirectory, bool shouldOverwriteFiles)
 {
     auto* zei = entries.getUnchecked (index);
-
-   #if JUCE_WINDOWS
-    auto entryPath = zei->entry.filename;
-   #else
-    auto entryPath = zei->entry.filename.replaceCharacter ('\\', '/');
-   #endif
+    auto entryPath = getEntryPath (zei->entry);
 
     if (entryPath.isEmpty())
         return Result::ok();
@@ -417,9 +565,11 @@ Result ZipFile::uncompressEntry (int index, const File& targetDirectory, bool sh
     if (entryPath.endsWithChar ('/') || entryPath.endsWithChar ('\\'))
         return targetFile.createDirectory(); // (entry is a directory, not a file)
 
-    std::unique_ptr<InputStream> in (createStreamForEntry (index));
+    // stored entries can be written straight from the memory-mapped zip file, if it's available
+    auto* mappedData = zei->entry.isSymbolicLink ? nullptr : getMappedDataForEntry (index);
+    std::unique_ptr<InputStream> in (mappedData != nullptr ? nullptr : createStreamForEntry (index));
 
-    if (in == nullptr)
+    if (mappedData == nullptr && in == nullptr)
         return Result::fail ("Failed to open the zip file for reading");
 
     if (targetFile.exists())
@@ -449,7 +599,10 @@ Result ZipFile::uncompressEntry (int index, const File& targetDirectory, bool sh
         if (out.failedToOpen())
             return Result::fail ("Failed to write to target file: " + targetFile.getFullPathName());
 
-        out << *in;
+        if (mappedData != nullptr)
+            out.write (mappedData, (size_t) zei->entry.uncompressedSize);
+        else
+            out << *in;
     }
 
     targetFile.setCreationTime (zei->entry.fileTime);
@@ -471,7 +624,14 @@ struct ZipFile::Builder::Item
 
     bool writeData (OutputStream& target, const int64 overallStartPosition)
     {
-        MemoryOutputStream compressedData ((size_t) file.getSize());
+        return compressData() && writeCompressedData (target, overallStartPosition);
+    }
+
+    // Reads and compresses the item's data, keeping it in memory until writeCompressedData()
+    // is called. Different items can do this on different threads.
+    bool compressData()
+    {
+        compressedData.reset (new MemoryOutputStream ((size_t) file.getSize()));
 
         if (symbolicLink)
         {
@@ -480,32 +640,46 @@ struct ZipFile::Builder::Item
             uncompressedSize = relativePath.length();
 
             checksum = zlibNamespace::crc32 (0, (uint8_t*) relativePath.toRawUTF8(), (unsigned int) uncompressedSize);
-            compressedData << relativePath;
+            *compressedData << relativePath;
         }
         else if (compressionLevel > 0)
         {
-            GZIPCompressorOutputStream compressor (compressedData, compressionLevel,
+            GZIPCompressorOutputStream compressor (*compressedData, compressionLevel,
                                                    GZIPCompressorOutputStream::windowBitsRaw);
             if (! writeSource (compressor))
                 return false;
         }
         else
         {
-            if (! writeSource (compressedData))
+            if (! writeSource (*compressedData))
                 return false;
         }
 
-        compressedSize = (int64) compressedData.getDataSize();
+        compressedSize = (int64) compressedData->getDataSize();
+        return true;
+    }
+
+    bool writeCompressedData (OutputStream& target, const int64 overallStartPosition)
+    {
+        jassert (compressedData != nullptr);
+
         headerStart = target.getPosition() - overallStartPosition;
 
         target.writeInt (0x04034b50);
         writeFlagsAndSizes (target);
         target << storedPathname
-               << compressedData;
+               << *compressedData;
 
+        compressedData.reset();
         return true;
     }
 
+    int64 getSourceSize() const
+    {
+        return stream != nullptr ? jmax ((int64) 0, stream->getTotalLength())
+                                 : file.getSize();
+    }
+
     bool writeDirectoryEntry (OutputStream& target)
     {
         target.writeInt (0x02014b50);
@@ -524,6 +698,7 @@ struct ZipFile::Builder::Item
 private:
     const File file;
     std::unique_ptr<InputStream> stream;
+    std::unique_ptr<MemoryOutputStream> compressedData;
     String storedPathname;
     Time fileTime;
     int64 compressedSize = 0, uncompressedSize = 0, headerStart = 0;
@@ -615,6 +790,69 @@ bool ZipFile::Builder::writeToStream (OutputStream& target, double* const progre
             return false;
     }
 
+    return writeDirectory (target, fileStart, progress);
+}
+
+bool ZipFile::Builder::writeToStream (OutputStream& target, double* const progress, ThreadPool& threadPool) const
+{
+    const int64 maxBytesPerBatch = 64 * 1024 * 1024;
+    auto fileStart = target.getPosition();
+
+    for (int batchStart = 0; batchStart < items.size();)
+    {
+        if (progress != nullptr)
+            *progress = (batchStart + 0.5) / items.size();
+
+        // The compressed data for a whole batch is kept in memory until it's all been written,
+        // so the batch stops before its items get too big (but always has at least one item).
+        Array<Item*> batch;
+        Array<int64> sizes;
+        int64 batchSize = 0;
+
+        for (int i = batchStart; i < items.size(); ++i)
+        {
+            auto* item = items.getUnchecked (i);
+            auto size = item->getSourceSize();
+
+            if (batch.size() > 0 && batchSize + size > maxBytesPerBatch)
+                break;
+
+            batch.add (item);
+            sizes.add (size);
+            batchSize += size;
+        }
+
+        Array<int> order;
+
+        for (int i = 0; i < batch.size(); ++i)
+            order.add (i);
+
+        std::stable_sort (order.begin(), order.end(),
+                          [&] (int a, int b) { return sizes.getUnchecked (a) > sizes.getUnchecked (b); });
+
+        std::atomic<bool> failed { false };
+
+        runZipTasksInParallel (order.size(), threadPool, [&] (int task)
+        {
+            if (! batch.getUnchecked (order.getUnchecked (task))->compressData())
+                failed = true;
+        });
+
+        if (failed)
+            return false;
+
+        for (auto* item : batch)
+            if (! item->writeCompressedData (target, fileStart))
+                return false;
+
+        batchStart += batch.size();
+    }
+
+    return writeDirectory (target, fileStart, progress);
+}
+
+bool ZipFile::Builder::writeDirectory (OutputStream& target, int64 fileStart, double* progress) const
+{
     auto directoryStart = target.getPosition();
 
     for (auto* item : items)
@@ -677,6 +915,183 @@ struct ZIPTests   : public UnitTest
             std::unique_ptr<InputStream> input (zip.createStreamForEntry (*entry));
             expectEquals (input->readEntireStreamAsString(), entryName);
         }
+
+        SharedResourcePointer<DefaultParallelThreadPool> defaultPool;
+        ThreadPool& pool = defaultPool.get();
+        auto r = getRandom();
+
+        beginTest ("Parallel compression");
+        {
+            auto contents = createContents (r, 300, 2, 1 << 20);
+            auto serialData = buildZip (contents, nullptr);
+            auto parallelData = buildZip (contents, &pool);
+
+            expect (serialData == parallelData);
+
+            MemoryInputStream zipStream (parallelData, false);
+            ZipFile parsedZip (zipStream);
+            expectEquals (parsedZip.getNumEntries(), contents.size());
+
+            for (int i = 0; i < contents.size(); ++i)
+            {
+                std::unique_ptr<InputStream> input (parsedZip.createStreamForEntry (i));
+                MemoryBlock block;
+                input->readIntoMemoryBlock (block);
+                expect (block == contents.getReference (i).data);
+            }
+        }
+
+        beginTest ("Parallel extraction");
+        {
+            auto contents = createContents (r, 200, 2, 1 << 19);
+            contents.add ({ "sub/dup.txt", MemoryBlock ("first", 5), 9 });
+            contents.add ({ "sub/dup.txt", MemoryBlock ("second", 6), 0 });
+
+            auto zipData = buildZip (contents, nullptr);
+            TemporaryFile zipFile (".zip");
+            zipFile.getFile().replaceWithData (zipData.getData(), zipData.getSize());
+
+            auto serialFolder = File::getSpecialLocation (File::tempDirectory).getNonexistentChildFile ("ZipTestSerial", {});
+            auto parallelFolder = File::getSpecialLocation (File::tempDirectory).getNonexistentChildFile ("ZipTestParallel", {});
+
+            ZipFile parsedZip (zipFile.getFile());
+            expect (parsedZip.uncompressTo (serialFolder).wasOk());
+            expect (parsedZip.uncompressTo (parallelFolder, true, pool).wasOk());
+
+            for (int i = 0; i < contents.size() - 2; ++i)
+            {
+                MemoryBlock block;
+                expect (parallelFolder.getChildFile (contents.getReference (i).name).loadFileAsData (block));
+                expect (block == contents.getReference (i).data);
+            }
+
+            expectEquals (serialFolder.getChildFile ("sub/dup.txt").loadFileAsString(), String ("second"));
+            expectEquals (parallelFolder.getChildFile ("sub/dup.txt").loadFileAsString(), String ("second"));
+
+            parallelFolder.getChildFile ("sub/dup.txt").replaceWithText ("existing");
+            expect (parsedZip.uncompressTo (parallelFolder, false, pool).wasOk());
+            expectEquals (parallelFolder.getChildFile ("sub/dup.txt").loadFileAsString(), String ("existing"));
+
+            serialFolder.deleteRecursively();
+            parallelFolder.deleteRecursively();
+        }
+
+        beginTest ("Memory-mapped entries");
+        {
+            auto contents = createContents (r, 20, 0, 0);
+            auto zipData = buildZip (contents, nullptr);
+
+            TemporaryFile zipFile (".zip");
+            zipFile.getFile().replaceWithData (zipData.getData(), zipData.getSize());
+
+            ZipFile parsedZip (zipFile.getFile());
+            MemoryInputStream zipStream (zipData, false);
+            ZipFile unmappedZip (zipStream);
+
+            for (int i = 0; i < contents.size(); ++i)
+            {
+                auto& item = contents.getReference (i);
+                auto* mapped = parsedZip.getMappedDataForEntry (i);
+
+                if (item.compressionLevel > 0)
+                {
+                    expect (mapped == nullptr);
+                }
+                else
+                {
+                    expect (mapped != nullptr);
+                    expectEquals ((int64) item.data.getSize(), parsedZip.getEntry (i)->uncompressedSize);
+                    expect (mapped != nullptr && memcmp (mapped, item.data.getData(), item.data.getSize()) == 0);
+                }
+
+                expect (unmappedZip.getMappedDataForEntry (i) == nullptr);
+            }
+
+            expect (parsedZip.getMappedDataForEntry (contents.size()) == nullptr);
+        }
+
+        beginTest ("Benchmark");
+        {
+            auto contents = createContents (r, 2000, 4, 4 << 20);
+            int64 totalSize = 0;
+
+            for (auto& item : contents)
+                totalSize += (int64) item.data.getSize();
+
+            for (auto* threadPool : { (ThreadPool*) nullptr, &pool })
+            {
+                auto start = Time::getMillisecondCounterHiRes();
+                auto zipData = buildZip (contents, threadPool);
+                auto compressionTime = Time::getMillisecondCounterHiRes() - start;
+
+                TemporaryFile zipFile (".zip");
+                zipFile.getFile().replaceWithData (zipData.getData(), zipData.getSize());
+                auto folder = File::getSpecialLocation (File::tempDirectory).getNonexistentChildFile ("ZipTestBenchmark", {});
+
+                ZipFile parsedZip (zipFile.getFile());
+                start = Time::getMillisecondCounterHiRes();
+                auto result = threadPool != nullptr ? parsedZip.uncompressTo (folder, true, *threadPool)
+                                                    : parsedZip.uncompressTo (folder);
+                auto extractionTime = Time::getMillisecondCounterHiRes() - start;
+
+                expect (result.wasOk());
+                folder.deleteRecursively();
+
+                logMessage (String ("  ") + (threadPool != nullptr ? "Parallel" : "Serial") + ": "
+                              + String (contents.size()) + " items, "
+                              + String ((double) totalSize / (1024.0 * 1024.0), 1) + " MB: compressed in "
+                              + String (compressionTime, 1) + " ms, extracted in "
+                              + String (extractionTime, 1) + " ms");
+            }
+        }
+    }
+
+    struct Content
+    {
+        String name;
+        MemoryBlock data;
+        int compressionLevel;
+    };
+
+    // Creates lots of small items and a few big ones, with a mixture of compression levels
+    static Array<Content> createContents (Random& r, int numSmallItems, int numLargeItems, int largeItemSize)
+    {
+        static const char* const words[] = { "preset", "gain", "cutoff", "resonance", "attack", "release", "<value>", "0.5", "\n" };
+        Array<Content> contents;
+
+        for (int i = 0; i < numSmallItems + numLargeItems; ++i)
+        {
+            auto size = i < numSmallItems ? r.nextInt (4000) : largeItemSize;
+            MemoryOutputStream mo;
+
+            while ((int) mo.getDataSize() < size)
+                mo << words[r.nextInt (numElementsInArray (words))] << ' ';
+
+            contents.add ({ "folder" + String (i % 7) + "/item" + String (i) + ".txt",
+                            mo.getMemoryBlock(), (i % 3) == 0 ? 0 : 6 });
+        }
+
+        return contents;
+    }
+
+    static MemoryBlock buildZip (const Array<Content>& contents, ThreadPool* pool)
+    {
+        ZipFile::Builder builder;
+        Time time (2020, 1, 2, 3, 4, 6);
+
+        for (auto& item : contents)
+            builder.addEntry (new MemoryInputStream (item.data, false), item.compressionLevel, item.name, time);
+
+        MemoryBlock data;
+        MemoryOutputStream mo (data, false);
+
+        if (pool != nullptr)
+            builder.writeToStream (mo, nullptr, *pool);
+        else
+            builder.writeToStream (mo, nullptr);
+
+        mo.flush();
+        return data;
     }
 };
 
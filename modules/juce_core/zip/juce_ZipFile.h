@@ -100,7 +100,7 @@ public:
 
         @see ZipFile::ZipEntry
     */
-    int getIndexOfFileName (const String& fileName, bool ignoreCase = false) const noexcept;
+    int getIndexOfFileName (StringRef fileName, bool ignoreCase = false) const noexcept;
 
     /** Returns a structure that describes one of the entries in the zip file.
 
@@ -145,6 +145,18 @@ public:
     */
     InputStream* createStreamForEntry (const ZipEntry& entry);
 
+    /** Returns a pointer to the data of an entry which was stored without compression,
+        so that it can be read without being copied.
+
+        This works by memory-mapping the zip file, so it's only possible if the ZipFile was
+        created from a File. If the entry is compressed, or the file can't be mapped, this
+        returns nullptr, and you'll need to use createStreamForEntry() instead.
+
+        The size of the data is the entry's uncompressedSize, and it remains valid until
+        the ZipFile is deleted. It's safe to call this from multiple threads.
+    */
+    const void* getMappedDataForEntry (int index);
+
     //==============================================================================
     /** Uncompresses all of the files in the zip file.
 
@@ -158,6 +170,27 @@ public:
     Result uncompressTo (const File& targetDirectory,
                          bool shouldOverwriteFiles = true);
 
+    /** Uncompresses all of the files in the zip file, using several threads.
+
+        This does the same job as the other version of uncompressTo(), but the entries are
+        shared out between the pool's threads and the calling thread, starting with the
+        largest ones. If the ZipFile was created from a File or an InputSource, each thread
+        reads from its own stream. If it was created from an InputStream, the threads take
+        turns to read from it, but still decompress the data concurrently.
+
+        Unlike the single-threaded version, this doesn't stop at the first entry that
+        fails, but carries on with the others, and then returns the error from the
+        earliest failed entry.
+
+        @param targetDirectory      the root folder to uncompress to
+        @param shouldOverwriteFiles whether to overwrite existing files with similarly-named ones
+        @param threadPool           the pool to use, e.g. a DefaultParallelThreadPool
+        @returns success if all the files are successfully unzipped
+    */
+    Result uncompressTo (const File& targetDirectory,
+                         bool shouldOverwriteFiles,
+                         ThreadPool& threadPool);
+
     /** Uncompresses one of the entries from the zip file.
 
         This will expand the entry and write it in a target directory. The entry's path is used to
@@ -221,12 +254,27 @@ public:
         */
         bool writeToStream (OutputStream& target, double* progress) const;
 
+        /** Generates the zip file, compressing its items on several threads.
+
+            This produces exactly the same data as the other version of writeToStream(),
+            but the items are compressed concurrently by the pool's threads and the calling
+            thread, and then written to the target in order. To limit the amount of memory
+            that this needs, the items are handled in batches of up to about 64MB of source
+            data at a time.
+
+            As the items are read on different threads, any streams that were passed to
+            addEntry() mustn't depend on each other.
+        */
+        bool writeToStream (OutputStream& target, double* progress, ThreadPool& threadPool) const;
+
         //==============================================================================
     private:
         struct Item;
         friend struct ContainerDeletePolicy<Item>;
         OwnedArray<Item> items;
 
+        bool writeDirectory (OutputStream&, int64 fileStart, double* progress) const;
+
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Builder)
     };
 
@@ -240,6 +288,9 @@ private:
     InputStream* inputStream = nullptr;
     std::unique_ptr<InputStream> streamToDelete;
     std::unique_ptr<InputSource> inputSource;
+    File sourceFile;
+    std::unique_ptr<MemoryMappedFile> mappedFile;
+    bool hasTriedToMapFile = false;
 
    #if JUCE_DEBUG
     struct OpenStreamCounter
@@ -247,7 +298,7 @@ private:
         OpenStreamCounter() {}
         ~OpenStreamCounter();
 
-        int numOpenStreams = 0;
+        std::atomic<int> numOpenStreams { 0 };
     };
 
     OpenStreamCounter streamCounter;
@@ -58,6 +58,7 @@
 #include "undomanager/juce_UndoManager.h"
 #include "values/juce_Value.h"
 #include "values/juce_ValueTree.h"
+#include "values/juce_BinaryValueTree.h"
 #include "values/juce_ValueTreeSynchroniser.h"
 #include "values/juce_CachedValue.h"
 #include "values/juce_ValueWithDefault.h"
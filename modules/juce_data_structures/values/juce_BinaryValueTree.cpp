@@ -0,0 +1,826 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 5 End-User License
+   Agreement and JUCE 5 Privacy Policy (both updated and effective as of the
+   27th April 2017).
+
+   End User License Agreement: www.juce.com/juce-5-licence
+   Privacy Policy: www.juce.com/juce-5-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+namespace BinaryValueTreeFormat
+{
+    /*  The data is laid out as:
+
+        header:             magic, version, numIdentifiers, numNodes, numProperties, dataSize
+        identifier table:   (offset, length) of each identifier's UTF-8 text in the data area
+        node table:         type, firstProperty, numProperties, firstChild, numChildren
+        property table:     name, type, 64-bit value
+        data area:          UTF-8 strings and any values that need to be streamed
+
+        All the numbers are little-endian uint32s, apart from the property values. The
+        nodes are stored breadth-first, so each node's children are contiguous, and the
+        root is node 0. String values hold their (offset, length) in the data area.
+    */
+    static const uint32 magic = ByteOrder::littleEndianInt ("JVTB");
+    static const uint32 version = 1;
+
+    enum
+    {
+        headerSize = 24,
+        identifierSize = 8,
+        nodeSize = 20,
+        propertySize = 16
+    };
+
+    // Nodes are materialised recursively, so files with deeper trees than this are
+    // rejected rather than being allowed to overflow the stack
+    enum { maxDepth = 1000 };
+
+    enum PropertyType
+    {
+        typeVoid = 0,
+        typeInt,
+        typeInt64,
+        typeDouble,
+        typeFalse,
+        typeTrue,
+        typeString,
+        typeStreamedVar
+    };
+
+    static uint32 read32 (const uint8* p) noexcept     { return ByteOrder::littleEndianInt (p); }
+    static uint64 read64 (const uint8* p) noexcept     { return ByteOrder::littleEndianInt64 (p); }
+
+    static uint64 makeRange (uint64 offset, uint64 length) noexcept  { return offset | (length << 32); }
+}
+
+//==============================================================================
+struct BinaryValueTree::Writer
+{
+    Writer (const ValueTree& tree)
+    {
+        nodes.add (tree.object.get());
+        int depth = 0, endOfLevel = 1;
+
+        for (int i = 0; i < nodes.size(); ++i)
+        {
+            if (i == endOfLevel)
+            {
+                ++depth;
+                endOfLevel = nodes.size();
+            }
+
+            // This tree is too deep to be read back by a BinaryValueTree!
+            jassert (depth <= BinaryValueTreeFormat::maxDepth);
+
+            auto& n = *nodes.getUnchecked (i);
+
+            nodeRecords.add ({ getIdentifierIndex (n.type),
+                               (uint32) propertyRecords.size(), (uint32) n.properties.size(),
+                               (uint32) nodes.size(), (uint32) n.children.size() });
+
+            for (auto& p : n.properties)
+                addProperty (p.name, p.value);
+
+            for (auto* c : n.children)
+                nodes.add (c);
+        }
+    }
+
+    void write (OutputStream& out) const
+    {
+        using namespace BinaryValueTreeFormat;
+
+        // This format uses 32-bit offsets, so is limited to 4GB of string data!
+        jassert (data.getDataSize() <= 0xffffffffu);
+
+        out.writeInt ((int) magic);
+        out.writeInt ((int) version);
+        out.writeInt (identifierRanges.size());
+        out.writeInt (nodeRecords.size());
+        out.writeInt (propertyRecords.size());
+        out.writeInt ((int) data.getDataSize());
+
+        for (auto r : identifierRanges)
+            out.writeInt64 ((int64) r);
+
+        for (auto& n : nodeRecords)
+            for (auto v : n.values)
+                out.writeInt ((int) v);
+
+        for (auto& p : propertyRecords)
+        {
+            out.writeInt ((int) p.name);
+            out.writeInt ((int) p.type);
+            out.writeInt64 ((int64) p.value);
+        }
+
+        out.write (data.getData(), data.getDataSize());
+    }
+
+private:
+    struct NodeRecord       { uint32 values[5]; };
+    struct PropertyRecord   { uint32 name, type; uint64 value; };
+
+    Array<const ValueTree::SharedObject*> nodes;
+    Array<NodeRecord> nodeRecords;
+    Array<PropertyRecord> propertyRecords;
+    Array<uint64> identifierRanges;
+    FlatHashMap<Identifier, uint32> identifierIndexes;
+    FlatHashMap<String, uint64> stringRanges;
+    MemoryOutputStream data;
+
+    uint32 getIdentifierIndex (const Identifier& name)
+    {
+        if (auto* index = identifierIndexes.find (name))
+            return *index;
+
+        auto index = (uint32) identifierRanges.size();
+        identifierRanges.add (addString (name.toString()));
+        identifierIndexes.set (name, index);
+        return index;
+    }
+
+    uint64 addString (const String& text)
+    {
+        if (auto* existing = stringRanges.find (text))
+            return *existing;
+
+        auto range = addData (text.toRawUTF8(), text.getNumBytesAsUTF8());
+        stringRanges.set (text, range);
+        return range;
+    }
+
+    uint64 addData (const void* source, size_t numBytes)
+    {
+        auto offset = (uint64) data.getDataSize();
+        data.write (source, numBytes);
+        return BinaryValueTreeFormat::makeRange (offset, numBytes);
+    }
+
+    void addProperty (const Identifier& name, const var& value)
+    {
+        using namespace BinaryValueTreeFormat;
+
+        PropertyRecord p { getIdentifierIndex (name), typeVoid, 0 };
+
+        if (value.isVoid())
+        {
+        }
+        else if (value.isInt())
+        {
+            p.type = typeInt;
+            p.value = (uint32) (int) value;
+        }
+        else if (value.isInt64())
+        {
+            p.type = typeInt64;
+            p.value = (uint64) (int64) value;
+        }
+        else if (value.isDouble())
+        {
+            p.type = typeDouble;
+            auto d = (double) value;
+            memcpy (&p.value, &d, sizeof (d));
+        }
+        else if (value.isBool())
+        {
+            p.type = (bool) value ? typeTrue : typeFalse;
+        }
+        else if (value.isString())
+        {
+            p.type = typeString;
+            p.value = addString (value.toString());
+        }
+        else
+        {
+            MemoryOutputStream streamed;
+            value.writeToStream (streamed);
+
+            p.type = typeStreamedVar;
+            p.value = addData (streamed.getData(), streamed.getDataSize());
+        }
+
+        propertyRecords.add (p);
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (Writer)
+};
+
+//==============================================================================
+BinaryValueTree::BinaryValueTree (const void* data, size_t numBytes, bool keepInternalCopyOfData)
+{
+    if (keepInternalCopyOfData)
+    {
+        internalCopy.replaceWith (data, numBytes);
+        data = internalCopy.getData();
+    }
+
+    open (data, numBytes);
+}
+
+BinaryValueTree::BinaryValueTree (const File& file)
+{
+    mappedFile.reset (new MemoryMappedFile (file, MemoryMappedFile::readOnly));
+
+    if (mappedFile->getData() != nullptr)
+    {
+        open (mappedFile->getData(), mappedFile->getSize());
+        return;
+    }
+
+    mappedFile.reset();
+
+    if (file.loadFileAsData (internalCopy))
+        open (internalCopy.getData(), internalCopy.getSize());
+}
+
+BinaryValueTree::~BinaryValueTree() {}
+
+void BinaryValueTree::writeToStream (const ValueTree& tree, OutputStream& output)
+{
+    // You can't save an invalid tree!
+    jassert (tree.isValid());
+
+    if (tree.isValid())
+        Writer (tree).write (output);
+}
+
+bool BinaryValueTree::isBinaryValueTree (const void* data, size_t numBytes) noexcept
+{
+    using namespace BinaryValueTreeFormat;
+
+    auto* d = static_cast<const uint8*> (data);
+
+    return numBytes >= (size_t) headerSize
+            && read32 (d) == magic
+            && read32 (d + 4) == version;
+}
+
+//==============================================================================
+void BinaryValueTree::open (const void* data, size_t numBytes)
+{
+    using namespace BinaryValueTreeFormat;
+
+    if (! isBinaryValueTree (data, numBytes))
+        return;
+
+    auto* d = static_cast<const uint8*> (data);
+    auto numIds   = read32 (d + 8);
+    auto nodes    = read32 (d + 12);
+    auto props    = read32 (d + 16);
+    auto dataLen  = read32 (d + 20);
+
+    auto totalSize = (uint64) headerSize + (uint64) numIds * identifierSize + (uint64) nodes * nodeSize
+                       + (uint64) props * propertySize + dataLen;
+
+    if (nodes == 0 || totalSize > (uint64) numBytes)
+        return;
+
+    auto* identifierTable = d + headerSize;
+    nodeTable = identifierTable + (size_t) numIds * identifierSize;
+    propertyTable = nodeTable + (size_t) nodes * nodeSize;
+    dataArea = propertyTable + (size_t) props * propertySize;
+    dataSize = dataLen;
+
+    identifiers.ensureStorageAllocated ((int) numIds);
+
+    for (uint32 i = 0; i < numIds; ++i)
+    {
+        auto* entry = identifierTable + i * identifierSize;
+        auto offset = read32 (entry);
+        auto length = read32 (entry + 4);
+
+        if (length == 0 || (uint64) offset + length > dataLen
+             || ! CharPointer_UTF8::isValidString (reinterpret_cast<const char*> (dataArea + offset), (int) length))
+        {
+            identifiers.clear();
+            return;
+        }
+
+        auto start = CharPointer_UTF8 (reinterpret_cast<const char*> (dataArea + offset));
+        identifiers.add (Identifier (start, start + (int) length));
+    }
+
+    // Each node's properties and children must directly follow those of the previous node,
+    // so that nothing can be shared or refer back to one of its parents. That also means
+    // that each level of the tree starts where the children of the previous one did.
+    uint64 nextProperty = 0, nextChild = 1, endOfLevel = 1;
+    int depth = 0;
+
+    for (uint32 i = 0; i < nodes; ++i)
+    {
+        auto* n = nodeTable + i * nodeSize;
+
+        if (i == endOfLevel)
+        {
+            ++depth;
+            endOfLevel = nextChild;
+        }
+
+        if (read32 (n) >= numIds
+             || depth > maxDepth
+             || read32 (n + 4) != nextProperty
+             || read32 (n + 12) != nextChild)
+        {
+            identifiers.clear();
+            return;
+        }
+
+        nextProperty += read32 (n + 8);
+        nextChild += read32 (n + 16);
+    }
+
+    if (nextProperty != props || nextChild != nodes)
+    {
+        identifiers.clear();
+        return;
+    }
+
+    numNodes = nodes;
+    numProperties = props;
+}
+
+const uint8* BinaryValueTree::getNode (uint32 index) const noexcept
+{
+    return nodeTable + index * (size_t) BinaryValueTreeFormat::nodeSize;
+}
+
+const uint8* BinaryValueTree::getProperty (uint32 index) const noexcept
+{
+    return propertyTable + index * (size_t) BinaryValueTreeFormat::propertySize;
+}
+
+var BinaryValueTree::getValue (const uint8* property) const
+{
+    using namespace BinaryValueTreeFormat;
+
+    auto value = read64 (property + 8);
+
+    switch (read32 (property + 4))
+    {
+        case typeVoid:      return {};
+        case typeInt:       return (int) (uint32) value;
+        case typeInt64:     return (int64) value;
+        case typeFalse:     return false;
+        case typeTrue:      return true;
+
+        case typeDouble:
+        {
+            double d;
+            memcpy (&d, &value, sizeof (d));
+            return d;
+        }
+
+        case typeString:
+        case typeStreamedVar:
+        {
+            auto offset = (uint32) value;
+            auto length = (uint32) (value >> 32);
+
+            if ((uint64) offset + length > dataSize)
+                break;
+
+            auto* start = reinterpret_cast<const char*> (dataArea + offset);
+
+            if (read32 (property + 4) == typeStreamedVar)
+            {
+                MemoryInputStream in (start, length, false);
+                return var::readFromStream (in);
+            }
+
+            if (length == 0)
+                return String();
+
+            if (! CharPointer_UTF8::isValidString (start, (int) length))
+                break;
+
+            return String (CharPointer_UTF8 (start), CharPointer_UTF8 (start + length));
+        }
+
+        default:
+            break;
+    }
+
+    jassertfalse;  // trying to read corrupted data!
+    return {};
+}
+
+ValueTree BinaryValueTree::createValueTree (uint32 index) const
+{
+    using namespace BinaryValueTreeFormat;
+
+    auto* n = getNode (index);
+    ValueTree v (identifiers.getReference ((int) read32 (n)));
+
+    auto firstProperty = read32 (n + 4);
+    auto numProps = read32 (n + 8);
+
+    for (uint32 i = 0; i < numProps; ++i)
+    {
+        auto* p = getProperty (firstProperty + i);
+        auto name = read32 (p);
+
+        if (name < (uint32) identifiers.size())
+            v.object->properties.set (identifiers.getReference ((int) name), getValue (p));
+        else
+            jassertfalse;  // trying to read corrupted data!
+    }
+
+    auto firstChild = read32 (n + 12);
+    auto numChildren = read32 (n + 16);
+    v.object->children.ensureStorageAllocated ((int) numChildren);
+
+    for (uint32 i = 0; i < numChildren; ++i)
+    {
+        auto child = createValueTree (firstChild + i);
+        v.object->children.add (child.object);
+        child.object->parent = v.object;
+    }
+
+    return v;
+}
+
+BinaryValueTree::Node BinaryValueTree::getRoot() const noexcept
+{
+    return isValid() ? Node (this, 0) : Node();
+}
+
+ValueTree BinaryValueTree::createValueTree() const
+{
+    return getRoot().createValueTree();
+}
+
+//==============================================================================
+Identifier BinaryValueTree::Node::getType() const noexcept
+{
+    if (owner == nullptr)
+        return {};
+
+    return owner->identifiers.getReference ((int) BinaryValueTreeFormat::read32 (owner->getNode (index)));
+}
+
+int BinaryValueTree::Node::getNumProperties() const noexcept
+{
+    return owner != nullptr ? (int) BinaryValueTreeFormat::read32 (owner->getNode (index) + 8) : 0;
+}
+
+Identifier BinaryValueTree::Node::getPropertyName (int propertyIndex) const noexcept
+{
+    if (isPositiveAndBelow (propertyIndex, getNumProperties()))
+    {
+        auto* n = owner->getNode (index);
+        auto name = BinaryValueTreeFormat::read32 (owner->getProperty (BinaryValueTreeFormat::read32 (n + 4) + (uint32) propertyIndex));
+        return owner->identifiers[(int) name];
+    }
+
+    return {};
+}
+
+var BinaryValueTree::Node::getPropertyValue (int propertyIndex) const
+{
+    if (isPositiveAndBelow (propertyIndex, getNumProperties()))
+    {
+        auto* n = owner->getNode (index);
+        return owner->getValue (owner->getProperty (BinaryValueTreeFormat::read32 (n + 4) + (uint32) propertyIndex));
+    }
+
+    return {};
+}
+
+var BinaryValueTree::Node::getProperty (const Identifier& name, const var& defaultReturnValue) const
+{
+    for (int i = 0; i < getNumProperties(); ++i)
+        if (getPropertyName (i) == name)
+            return getPropertyValue (i);
+
+    return defaultReturnValue;
+}
+
+bool BinaryValueTree::Node::hasProperty (const Identifier& name) const noexcept
+{
+    for (int i = 0; i < getNumProperties(); ++i)
+        if (getPropertyName (i) == name)
+            return true;
+
+    return false;
+}
+
+int BinaryValueTree::Node::getNumChildren() const noexcept
+{
+    return owner != nullptr ? (int) BinaryValueTreeFormat::read32 (owner->getNode (index) + 16) : 0;
+}
+
+BinaryValueTree::Node BinaryValueTree::Node::getChild (int childIndex) const noexcept
+{
+    if (isPositiveAndBelow (childIndex, getNumChildren()))
+        return Node (owner, BinaryValueTreeFormat::read32 (owner->getNode (index) + 12) + (uint32) childIndex);
+
+    return {};
+}
+
+BinaryValueTree::Node BinaryValueTree::Node::getChildWithName (const Identifier& type) const noexcept
+{
+    for (auto child : *this)
+        if (child.getType() == type)
+            return child;
+
+    return {};
+}
+
+ValueTree BinaryValueTree::Node::createValueTree() const
+{
+    return owner != nullptr ? owner->createValueTree (index) : ValueTree();
+}
+
+BinaryValueTree::Node::Iterator BinaryValueTree::Node::begin() const noexcept
+{
+    if (owner == nullptr)
+        return { nullptr, 0 };
+
+    return { owner, BinaryValueTreeFormat::read32 (owner->getNode (index) + 12) };
+}
+
+BinaryValueTree::Node::Iterator BinaryValueTree::Node::end() const noexcept
+{
+    auto i = begin();
+    i.index += (uint32) getNumChildren();
+    return i;
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class BinaryValueTreeTests  : public UnitTest
+{
+public:
+    BinaryValueTreeTests() : UnitTest ("BinaryValueTree", "Values") {}
+
+    static MemoryBlock write (const ValueTree& v)
+    {
+        MemoryOutputStream out;
+        BinaryValueTree::writeToStream (v, out);
+        return out.getMemoryBlock();
+    }
+
+    void expectNodeMatches (const BinaryValueTree::Node& node, const ValueTree& v)
+    {
+        expect (node.getType() == v.getType());
+        expectEquals (node.getNumProperties(), v.getNumProperties());
+        expectEquals (node.getNumChildren(), v.getNumChildren());
+
+        for (int i = 0; i < v.getNumProperties(); ++i)
+        {
+            auto propertyName = v.getPropertyName (i);
+            expect (node.getPropertyName (i) == propertyName);
+            expect (node.hasProperty (propertyName));
+            expect (node.getProperty (propertyName).equalsWithSameType (v[propertyName]));
+        }
+
+        int index = 0;
+
+        for (auto child : node)
+            expectNodeMatches (child, v.getChild (index++));
+
+        expectEquals (index, v.getNumChildren());
+    }
+
+    static ValueTree createPluginState (int numPlugins, int numParameters)
+    {
+        ValueTree state ("STATE");
+
+        for (int i = 0; i < numPlugins; ++i)
+        {
+            ValueTree plugin ("PLUGIN");
+            plugin.setProperty ("name", "Plugin " + String (i), nullptr);
+            plugin.setProperty ("uid", (int64) i * 0x100000001LL, nullptr);
+            plugin.setProperty ("bypassed", (i & 1) != 0, nullptr);
+
+            for (int j = 0; j < numParameters; ++j)
+            {
+                ValueTree param ("PARAM");
+                param.setProperty ("id", "param" + String (j), nullptr);
+                param.setProperty ("value", j / (double) numParameters, nullptr);
+                param.setProperty ("min", 0.0, nullptr);
+                param.setProperty ("max", 1.0, nullptr);
+                param.setProperty ("steps", j, nullptr);
+                param.setProperty ("automatable", true, nullptr);
+                param.setProperty ("label", "Parameter " + String (j), nullptr);
+                param.setProperty ("text", String (j * 100 / numParameters) + "%", nullptr);
+                plugin.appendChild (param, nullptr);
+            }
+
+            state.appendChild (plugin, nullptr);
+        }
+
+        return state;
+    }
+
+    void runTest() override
+    {
+        auto r = getRandom();
+
+        beginTest ("Round trip");
+
+        for (int i = 0; i < 20; ++i)
+        {
+            auto v = ValueTreeTests::createRandomTree (nullptr, 0, r);
+            v.setProperty ("array", Array<var> { 1, "two", 3.0 }, nullptr);
+            v.setProperty ("binary", MemoryBlock ("abc", 3), nullptr);
+            v.setProperty ("empty", String(), nullptr);
+            v.setProperty ("int64", (int64) r.nextInt64(), nullptr);
+
+            auto data = write (v);
+            BinaryValueTree binary (data.getData(), data.getSize(), false);
+
+            expect (binary.isValid());
+            expect (binary.createValueTree().isEquivalentTo (v));
+            expect (ValueTree::readFromData (data.getData(), data.getSize()).isEquivalentTo (v));
+            expectNodeMatches (binary.getRoot(), v);
+        }
+
+        beginTest ("Node access");
+        {
+            auto v = createPluginState (3, 4);
+            auto data = write (v);
+            BinaryValueTree binary (data.getData(), data.getSize(), true);
+            data.fillWith (0);
+
+            expectEquals (binary.getNumNodes(), 16);
+
+            auto plugin = binary.getRoot().getChild (2);
+            expect (plugin.getProperty ("name") == var ("Plugin 2"));
+            expect (plugin.getProperty ("missing", 42) == var (42));
+            expect (! plugin.getChild (4).isValid());
+            expect (plugin.getChildWithName ("PARAM").getProperty ("id") == var ("param0"));
+            expect (! plugin.getChildWithName ("FOO").isValid());
+            expect (plugin.getChild (3).createValueTree().isEquivalentTo (v.getChild (2).getChild (3)));
+            expect (plugin.getChild (3).createValueTree().getParent() == ValueTree());
+
+            BinaryValueTree::Node invalid;
+            expect (! invalid.isValid());
+            expectEquals (invalid.getNumChildren(), 0);
+            expect (! invalid.createValueTree().isValid());
+            expect (! (invalid.begin() != invalid.end()));
+        }
+
+        beginTest ("Files");
+        {
+            auto v = createPluginState (5, 10);
+            TemporaryFile temp;
+
+            {
+                FileOutputStream out (temp.getFile());
+                BinaryValueTree::writeToStream (v, out);
+            }
+
+            BinaryValueTree binary (temp.getFile());
+            expect (binary.isValid());
+            expect (binary.createValueTree().isEquivalentTo (v));
+
+            expect (! BinaryValueTree (temp.getFile().getSiblingFile ("nonexistent")).isValid());
+        }
+
+        beginTest ("Invalid data");
+        {
+            auto v = createPluginState (4, 3);
+            auto data = write (v);
+
+            for (size_t size = 0; size < data.getSize(); ++size)
+                expect (! BinaryValueTree (data.getData(), size, false).isValid());
+
+            MemoryOutputStream oldFormat;
+            v.writeToStream (oldFormat);
+            expect (! BinaryValueTree::isBinaryValueTree (oldFormat.getData(), oldFormat.getDataSize()));
+            expect (! BinaryValueTree (oldFormat.getData(), oldFormat.getDataSize(), false).isValid());
+
+            // The identifier and node tables are checked when the data is opened, so
+            // damage there should never produce a tree that can't be safely read
+            auto* header = static_cast<const uint8*> (data.getData());
+            auto tablesSize = (int) (BinaryValueTreeFormat::headerSize
+                                      + BinaryValueTreeFormat::read32 (header + 8) * BinaryValueTreeFormat::identifierSize
+                                      + BinaryValueTreeFormat::read32 (header + 12) * BinaryValueTreeFormat::nodeSize);
+
+            for (int i = 0; i < 1000; ++i)
+            {
+                MemoryBlock damaged (data);
+                auto* bytes = static_cast<uint8*> (damaged.getData());
+                bytes[BinaryValueTreeFormat::headerSize + r.nextInt (tablesSize - BinaryValueTreeFormat::headerSize)] ^= (uint8) (1 << r.nextInt (8));
+
+                BinaryValueTree binary (damaged.getData(), damaged.getSize(), false);
+
+                if (binary.isValid())
+                    expectEquals (binary.createValueTree().getNumChildren(), binary.getRoot().getNumChildren());
+            }
+        }
+
+        beginTest ("Deep trees");
+        {
+            // The writer won't produce a tree that's too deep to load, so these files
+            // are put together by hand, as a single chain of nodes
+            auto createChain = [] (int numNodes)
+            {
+                MemoryOutputStream out;
+                out.writeInt ((int) BinaryValueTreeFormat::magic);
+                out.writeInt ((int) BinaryValueTreeFormat::version);
+
+                for (auto value : { 1, numNodes, 0, 1 })
+                    out.writeInt (value);
+
+                out.writeInt64 ((int64) BinaryValueTreeFormat::makeRange (0, 1));
+
+                for (int i = 0; i < numNodes; ++i)
+                    for (auto value : { 0, 0, 0, i + 1, i < numNodes - 1 ? 1 : 0 })
+                        out.writeInt (value);
+
+                out.writeByte ('a');
+                return out.getMemoryBlock();
+            };
+
+            auto maxNodes = (int) BinaryValueTreeFormat::maxDepth + 1;
+
+            auto deepest = createChain (maxNodes);
+            BinaryValueTree binary (deepest.getData(), deepest.getSize(), false);
+            expectEquals (binary.getNumNodes(), maxNodes);
+            expectEquals (binary.createValueTree().getNumChildren(), 1);
+
+            auto tooDeep = createChain (maxNodes + 1);
+            expect (! BinaryValueTree (tooDeep.getData(), tooDeep.getSize(), false).isValid());
+        }
+
+        beginTest ("Loading benchmark");
+        {
+            auto state = createPluginState (200, 50);
+
+            auto time = [] (std::function<void()> f)
+            {
+                auto start = Time::getMillisecondCounterHiRes();
+                f();
+                return Time::getMillisecondCounterHiRes() - start;
+            };
+
+            auto logResult = [this] (const String& description, size_t size, double writeTime, double readTime)
+            {
+                logMessage ("  " + description.paddedRight (' ', 24) + String ((double) size / (1024.0 * 1024.0), 2) + " MB, write "
+                              + String (writeTime, 1) + " ms, read " + String (readTime, 1) + " ms");
+            };
+
+            {
+                String text;
+                std::unique_ptr<XmlElement> xml;
+                auto writeTime = time ([&] { text = state.toXmlString(); });
+                auto readTime = time ([&] { xml.reset (XmlDocument::parse (text)); expect (ValueTree::fromXml (*xml).isEquivalentTo (state)); });
+                logResult ("XML", text.getNumBytesAsUTF8(), writeTime, readTime);
+            }
+
+            {
+                MemoryOutputStream out;
+                auto writeTime = time ([&] { state.writeToStream (out); });
+                auto readTime = time ([&] { expect (ValueTree::readFromData (out.getData(), out.getDataSize()).isEquivalentTo (state)); });
+                logResult ("writeToStream", out.getDataSize(), writeTime, readTime);
+            }
+
+            {
+                MemoryOutputStream out;
+                auto writeTime = time ([&] { BinaryValueTree::writeToStream (state, out); });
+                auto readTime = time ([&] { expect (BinaryValueTree (out.getData(), out.getDataSize(), false).createValueTree().isEquivalentTo (state)); });
+                logResult ("BinaryValueTree", out.getDataSize(), writeTime, readTime);
+
+                auto openTime = time ([&]
+                {
+                    BinaryValueTree binary (out.getData(), out.getDataSize(), false);
+                    expect (binary.getRoot().getChild (199).getChild (49).getProperty ("id") == var ("param49"));
+                });
+
+                logMessage ("  opening and reading one property: " + String (openTime, 3) + " ms");
+            }
+        }
+    }
+};
+
+static BinaryValueTreeTests binaryValueTreeTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,199 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 5 End-User License
+   Agreement and JUCE 5 Privacy Policy (both updated and effective as of the
+   27th April 2017).
+
+   End User License Agreement: www.juce.com/juce-5-licence
+   Privacy Policy: www.juce.com/juce-5-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A read-only view of a ValueTree that was saved in an indexed binary format.
+
+    ValueTree::writeToStream() produces a format that has to be read sequentially,
+    so loading a tree means rebuilding the whole thing before any of it can be
+    used. The format written by BinaryValueTree::writeToStream() keeps all the
+    identifiers in a shared table, stores each node's properties as an array of
+    fixed-size typed records and lays the nodes out so that their children can be
+    found directly, which means a BinaryValueTree can be opened in place (e.g.
+    from a memory-mapped file) without copying or parsing anything except the
+    identifier table.
+
+    You can then browse the data through lightweight Node handles, and call
+    Node::createValueTree() to materialise just the parts of it that you need as
+    real ValueTree objects. Node handles are only valid while the BinaryValueTree
+    that they came from is alive.
+
+    E.g.
+    @code
+    BinaryValueTree data (stateFile);
+
+    if (data.isValid())
+        for (auto child : data.getRoot())
+            if (child.getType() == Identifier ("PARAM"))
+                loadParameter (child.createValueTree());
+    @endcode
+
+    ValueTree::readFromData() will also recognise data in this format.
+
+    @see ValueTree::writeToStream
+
+    @tags{DataStructures}
+*/
+class JUCE_API  BinaryValueTree
+{
+public:
+    //==============================================================================
+    /** Opens some data that was written by writeToStream().
+
+        If keepInternalCopyOfData is false, the data isn't copied, and must remain
+        valid for the lifetime of this object (and any Nodes that it returns).
+        If the data isn't in the correct format, or it holds a tree that's nested more
+        than 1000 levels deep, isValid() will return false.
+    */
+    BinaryValueTree (const void* data, size_t numBytes, bool keepInternalCopyOfData);
+
+    /** Opens a file that was written by writeToStream().
+        The file is memory-mapped if possible, rather than being loaded.
+    */
+    explicit BinaryValueTree (const File& file);
+
+    /** Destructor. */
+    ~BinaryValueTree();
+
+    //==============================================================================
+    /** Writes a ValueTree to a stream in the format that this class reads. */
+    static void writeToStream (const ValueTree& tree, OutputStream& output);
+
+    /** Returns true if a block of data looks like it was written by writeToStream().
+        This only checks the header, so it's a quick test.
+    */
+    static bool isBinaryValueTree (const void* data, size_t numBytes) noexcept;
+
+    //==============================================================================
+    /** Returns true if the data was successfully opened. */
+    bool isValid() const noexcept                   { return numNodes > 0; }
+
+    /** Returns the total number of nodes in the tree. */
+    int getNumNodes() const noexcept                { return (int) numNodes; }
+
+    //==============================================================================
+    /**
+        A reference to one of the nodes in a BinaryValueTree.
+
+        A Node that doesn't refer to anything behaves like an invalid ValueTree.
+    */
+    class JUCE_API  Node
+    {
+    public:
+        /** Creates a Node that doesn't refer to anything. */
+        Node() noexcept {}
+
+        /** Returns true if this refers to a node in a BinaryValueTree. */
+        bool isValid() const noexcept               { return owner != nullptr; }
+
+        /** Returns the node's type. */
+        Identifier getType() const noexcept;
+
+        /** Returns the number of properties that the node has. */
+        int getNumProperties() const noexcept;
+
+        /** Returns the name of one of the node's properties. */
+        Identifier getPropertyName (int index) const noexcept;
+
+        /** Returns the value of one of the node's properties, by index. */
+        var getPropertyValue (int index) const;
+
+        /** Returns the value of a named property, or defaultReturnValue if there's no
+            such property. Note that this is a linear search through the node's properties.
+        */
+        var getProperty (const Identifier& name, const var& defaultReturnValue = {}) const;
+
+        /** Returns true if the node has a property with the given name. */
+        bool hasProperty (const Identifier& name) const noexcept;
+
+        /** Returns the number of children that the node has. */
+        int getNumChildren() const noexcept;
+
+        /** Returns one of the node's children, or an invalid Node if the index is out of range. */
+        Node getChild (int index) const noexcept;
+
+        /** Returns the first child with the given type, or an invalid Node if there isn't one. */
+        Node getChildWithName (const Identifier& type) const noexcept;
+
+        /** Creates a ValueTree that contains a copy of this node and all its children. */
+        ValueTree createValueTree() const;
+
+        /** Iterates the node's children. */
+        struct Iterator
+        {
+            Node operator*() const noexcept                         { return Node (owner, index); }
+            Iterator& operator++() noexcept                         { ++index; return *this; }
+            bool operator!= (const Iterator& other) const noexcept  { return index != other.index; }
+
+            const BinaryValueTree* owner;
+            uint32 index;
+        };
+
+        Iterator begin() const noexcept;
+        Iterator end() const noexcept;
+
+    private:
+        friend class BinaryValueTree;
+
+        Node (const BinaryValueTree* o, uint32 i) noexcept  : owner (o), index (i) {}
+
+        const BinaryValueTree* owner = nullptr;
+        uint32 index = 0;
+    };
+
+    /** Returns the root node of the tree, or an invalid Node if the data couldn't be opened. */
+    Node getRoot() const noexcept;
+
+    /** Creates a ValueTree that contains a copy of the whole tree. */
+    ValueTree createValueTree() const;
+
+private:
+    //==============================================================================
+    struct Writer;
+
+    MemoryBlock internalCopy;
+    std::unique_ptr<MemoryMappedFile> mappedFile;
+    Array<Identifier> identifiers;
+    const uint8* nodeTable = nullptr;
+    const uint8* propertyTable = nullptr;
+    const uint8* dataArea = nullptr;
+    uint32 numNodes = 0, numProperties = 0, dataSize = 0;
+
+    void open (const void*, size_t);
+    const uint8* getNode (uint32) const noexcept;
+    const uint8* getProperty (uint32) const noexcept;
+    var getValue (const uint8*) const;
+    ValueTree createValueTree (uint32) const;
+
+    JUCE_DECLARE_NON_COPYABLE (BinaryValueTree)
+};
+
+} // namespace juce
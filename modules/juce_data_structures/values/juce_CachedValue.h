@@ -212,7 +212,7 @@ inline CachedValue<Type>::CachedValue (ValueTree& v, const Identifier& i, UndoMa
     : targetTree (v), targetProperty (i), undoManager (um),
       defaultValue(), cachedValue (getTypedValue())
 {
-    targetTree.addListener (this);
+    targetTree.addPropertyListener (this, targetProperty);
 }
 
 template <typename Type>
@@ -220,7 +220,7 @@ inline CachedValue<Type>::CachedValue (ValueTree& v, const Identifier& i, UndoMa
     : targetTree (v), targetProperty (i), undoManager (um),
       defaultValue (defaultToUse), cachedValue (getTypedValue())
 {
-    targetTree.addListener (this);
+    targetTree.addPropertyListener (this, targetProperty);
 }
 
 template <typename Type>
@@ -292,7 +292,7 @@ inline void CachedValue<Type>::referToWithDefault (ValueTree& v, const Identifie
     undoManager = um;
     defaultValue = defaultVal;
     cachedValue = getTypedValue();
-    targetTree.addListener (this);
+    targetTree.addPropertyListener (this, targetProperty);
 }
 
 template <typename Type>
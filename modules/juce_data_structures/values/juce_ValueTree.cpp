@@ -27,6 +27,48 @@
 namespace juce
 {
 
+struct ValueTree::PropertyListeners
+{
+    ListenerList<Listener>* find (const Identifier& property) const noexcept
+    {
+        if (auto* list = lists.find (property))
+            return list->get();
+
+        return nullptr;
+    }
+
+    void add (Listener* listener, const Identifier& property)
+    {
+        auto& list = lists.getReference (property);
+
+        if (list == nullptr)
+            list.reset (new ListenerList<Listener>());
+
+        if (! list->contains (listener))
+        {
+            list->add (listener);
+            ++numListeners;
+        }
+    }
+
+    void remove (Listener* listener)
+    {
+        // (empty lists are kept, in case this happens during one of their callbacks)
+        for (auto i = lists.begin(); i != lists.end(); ++i)
+        {
+            if (i.getValue()->contains (listener))
+            {
+                i.getValue()->remove (listener);
+                --numListeners;
+            }
+        }
+    }
+
+    FlatHashMap<Identifier, std::unique_ptr<ListenerList<Listener>>> lists;
+    int numListeners = 0;
+};
+
+//==============================================================================
 class ValueTree::SharedObject  : public ReferenceCountedObject
 {
 public:
@@ -95,32 +137,69 @@ public:
             t->callListeners (listenerToExclude, fn);
     }
 
+    template <typename Function>
+    void callPropertyListeners (const Identifier& property, ValueTree::Listener* listenerToExclude, Function fn) const
+    {
+        auto numListeners = valueTreesWithListeners.size();
+
+        if (numListeners == 0)
+            return;
+
+        auto listenersCopy = valueTreesWithListeners;
+
+        for (int i = 0; i < numListeners; ++i)
+        {
+            auto* v = listenersCopy.getUnchecked(i);
+
+            if (v->propertyListeners != nullptr && (i == 0 || valueTreesWithListeners.contains (v)))
+                if (auto* list = v->propertyListeners->find (property))
+                    list->callExcluding (listenerToExclude, fn);
+        }
+    }
+
     void sendPropertyChangeMessage (const Identifier& property, ValueTree::Listener* listenerToExclude = nullptr)
     {
+        if (auto* batch = findBatch())
+            return batch->addPropertyChange (this, property, listenerToExclude);
+
         ValueTree tree (this);
-        callListenersForAllParents (listenerToExclude, [&] (Listener& l) { l.valueTreePropertyChanged (tree, property); });
+        auto fn = [&] (Listener& l) { l.valueTreePropertyChanged (tree, property); };
+        callPropertyListeners (property, listenerToExclude, fn);
+        callListenersForAllParents (listenerToExclude, fn);
     }
 
     void sendChildAddedMessage (ValueTree child)
     {
+        if (auto* batch = findBatch())
+            return batch->add ({ Notification::childAdded, this, {}, child.object, 0, 0, nullptr, -1 });
+
         ValueTree tree (this);
         callListenersForAllParents (nullptr, [&] (Listener& l) { l.valueTreeChildAdded (tree, child); });
     }
 
     void sendChildRemovedMessage (ValueTree child, int index)
     {
+        if (auto* batch = findBatch())
+            return batch->add ({ Notification::childRemoved, this, {}, child.object, index, 0, nullptr, -1 });
+
         ValueTree tree (this);
         callListenersForAllParents (nullptr, [=, &tree, &child] (Listener& l) { l.valueTreeChildRemoved (tree, child, index); });
     }
 
     void sendChildOrderChangedMessage (int oldIndex, int newIndex)
     {
+        if (auto* batch = findBatch())
+            return batch->add ({ Notification::childOrderChanged, this, {}, nullptr, oldIndex, newIndex, nullptr, -1 });
+
         ValueTree tree (this);
         callListenersForAllParents (nullptr, [=, &tree] (Listener& l) { l.valueTreeChildOrderChanged (tree, oldIndex, newIndex); });
     }
 
     void sendParentChangeMessage()
     {
+        if (auto* batch = findBatch())
+            return batch->addParentChange (this);
+
         ValueTree tree (this);
 
         for (int j = children.size(); --j >= 0;)
@@ -130,6 +209,166 @@ public:
         callListeners (nullptr, [&] (Listener& l) { l.valueTreeParentChanged (tree); });
     }
 
+    //==============================================================================
+    struct Notification
+    {
+        enum Type { propertyChanged, childAdded, childRemoved, childOrderChanged, parentChanged };
+
+        Type type;
+        Ptr target;
+        Identifier property;
+        Ptr child;
+        int index1, index2;
+        ValueTree::Listener* listenerToExclude;
+        int nextPropertyChange;
+    };
+
+    struct PendingNotifications
+    {
+        void add (Notification&& n)
+        {
+            notifications.add (std::move (n));
+        }
+
+        // Each node remembers where its pending property changes are, so that they
+        // can be found again without needing to look anything up
+        bool isPending (const SharedObject& target, int index, Notification::Type type) const noexcept
+        {
+            return target.pendingBatch == this
+                    && isPositiveAndBelow (index, notifications.size())
+                    && notifications.getReference (index).target == &target
+                    && notifications.getReference (index).type == type;
+        }
+
+        void addPropertyChange (SharedObject* target, const Identifier& property, ValueTree::Listener* listenerToExclude)
+        {
+            auto* next = &(target->firstPendingPropertyChange);
+
+            if (isPending (*target, *next, Notification::propertyChanged))
+            {
+                for (;;)
+                {
+                    auto& existing = notifications.getReference (*next);
+
+                    if (existing.property == property)
+                    {
+                        if (existing.listenerToExclude != listenerToExclude)
+                            existing.listenerToExclude = nullptr;
+
+                        return;
+                    }
+
+                    next = &(existing.nextPropertyChange);
+
+                    if (*next < 0)
+                        break;
+                }
+            }
+            else if (target->pendingBatch != this)
+            {
+                target->pendingBatch = this;
+                target->pendingParentChange = -1;
+            }
+
+            *next = notifications.size();
+            add ({ Notification::propertyChanged, target, property, nullptr, 0, 0, listenerToExclude, -1 });
+        }
+
+        void addParentChange (SharedObject* target)
+        {
+            for (auto* c : target->children)
+                addParentChange (c);
+
+            // (only the listeners that are attached to the tree itself need to know about this)
+            if (target->valueTreesWithListeners.isEmpty()
+                 || isPending (*target, target->pendingParentChange, Notification::parentChanged))
+                return;
+
+            if (target->pendingBatch != this)
+            {
+                target->pendingBatch = this;
+                target->firstPendingPropertyChange = -1;
+            }
+
+            target->pendingParentChange = notifications.size();
+            add ({ Notification::parentChanged, target, {}, nullptr, 0, 0, nullptr, -1 });
+        }
+
+        void moveTo (PendingNotifications& other)
+        {
+            for (auto& n : notifications)
+            {
+                if (n.type == Notification::propertyChanged)
+                    other.addPropertyChange (n.target.get(), n.property, n.listenerToExclude);
+                else if (n.type == Notification::parentChanged)
+                    other.addParentChange (n.target.get());
+                else
+                    other.add (std::move (n));
+            }
+        }
+
+        void deliver()
+        {
+            for (auto& n : notifications)
+            {
+                auto& target = *n.target;
+                ValueTree tree (n.target.get()), child (n.child.get());
+
+                switch (n.type)
+                {
+                    case Notification::propertyChanged:     target.sendPropertyChangeMessage (n.property, n.listenerToExclude); break;
+                    case Notification::childAdded:          target.sendChildAddedMessage (child); break;
+                    case Notification::childRemoved:        target.sendChildRemovedMessage (child, n.index1); break;
+                    case Notification::childOrderChanged:   target.sendChildOrderChangedMessage (n.index1, n.index2); break;
+                    case Notification::parentChanged:       target.callListeners (nullptr, [&] (Listener& l) { l.valueTreeParentChanged (tree); }); break;
+                    default: jassertfalse; break;
+                }
+            }
+        }
+
+        Array<Notification> notifications;
+        int numBatches = 0;
+    };
+
+    PendingNotifications* findBatch() const noexcept
+    {
+        PendingNotifications* outermost = nullptr;
+
+        if (numActiveBatches.load() > 0)
+            for (auto* t = this; t != nullptr; t = t->parent)
+                if (t->pendingNotifications != nullptr)
+                    outermost = t->pendingNotifications.get();
+
+        return outermost;
+    }
+
+    void beginBatch()
+    {
+        if (pendingNotifications == nullptr)
+        {
+            pendingNotifications.reset (new PendingNotifications());
+            ++numActiveBatches;
+        }
+
+        ++(pendingNotifications->numBatches);
+    }
+
+    void endBatch()
+    {
+        jassert (pendingNotifications != nullptr);
+
+        if (--(pendingNotifications->numBatches) > 0)
+            return;
+
+        std::unique_ptr<PendingNotifications> pending (pendingNotifications.release());
+        --numActiveBatches;
+
+        if (auto* outerBatch = findBatch())
+            pending->moveTo (*outerBatch);
+        else
+            pending->deliver();
+    }
+
     void setProperty (const Identifier& name, const var& newValue, UndoManager* undoManager,
                       ValueTree::Listener* listenerToExclude = nullptr)
     {
@@ -292,10 +531,17 @@ public:
         {
             if (undoManager == nullptr)
             {
+                // (the child's callback belongs to any batch that this tree is part of)
+                auto* batch = findBatch();
+
                 children.remove (childIndex);
                 child->parent = nullptr;
                 sendChildRemovedMessage (ValueTree (child), childIndex);
-                child->sendParentChangeMessage();
+
+                if (batch != nullptr)
+                    batch->addParentChange (child.get());
+                else
+                    child->sendParentChangeMessage();
             }
             else
             {
@@ -570,10 +816,17 @@ public:
     ReferenceCountedArray<SharedObject> children;
     SortedSet<ValueTree*> valueTreesWithListeners;
     SharedObject* parent = nullptr;
+    std::unique_ptr<PendingNotifications> pendingNotifications;
+    const PendingNotifications* pendingBatch = nullptr;
+    int firstPendingPropertyChange = -1, pendingParentChange = -1;
+
+    static std::atomic<int> numActiveBatches;
 
     JUCE_LEAK_DETECTOR (SharedObject)
 };
 
+std::atomic<int> ValueTree::SharedObject::numActiveBatches { 0 };
+
 //==============================================================================
 ValueTree::ValueTree() noexcept
 {
@@ -610,7 +863,7 @@ ValueTree& ValueTree::operator= (const ValueTree& other)
 {
     if (object != other.object)
     {
-        if (listeners.isEmpty())
+        if (! hasListeners())
         {
             object = other.object;
         }
@@ -640,7 +893,7 @@ ValueTree::ValueTree (ValueTree&& other) noexcept
 
 ValueTree::~ValueTree()
 {
-    if (! listeners.isEmpty() && object != nullptr)
+    if (hasListeners() && object != nullptr)
         object->valueTreesWithListeners.removeValue (this);
 }
 
@@ -792,7 +1045,7 @@ struct ValueTreePropertyValueSource  : public Value::ValueSource,
     ValueTreePropertyValueSource (const ValueTree& vt, const Identifier& prop, UndoManager* um, bool sync)
         : tree (vt), property (prop), undoManager (um), updateSynchronously (sync)
     {
-        tree.addListener (this);
+        tree.addPropertyListener (this, property);
     }
 
     ~ValueTreePropertyValueSource()
@@ -942,22 +1195,44 @@ void ValueTree::reorderChildren (const OwnedArray<ValueTree>& newOrder, UndoMana
 }
 
 //==============================================================================
+bool ValueTree::hasListeners() const noexcept
+{
+    return ! listeners.isEmpty() || (propertyListeners != nullptr && propertyListeners->numListeners > 0);
+}
+
 void ValueTree::addListener (Listener* listener)
 {
     if (listener != nullptr)
     {
-        if (listeners.isEmpty() && object != nullptr)
+        if (! hasListeners() && object != nullptr)
             object->valueTreesWithListeners.add (this);
 
         listeners.add (listener);
     }
 }
 
+void ValueTree::addPropertyListener (Listener* listener, const Identifier& property)
+{
+    if (listener != nullptr)
+    {
+        if (! hasListeners() && object != nullptr)
+            object->valueTreesWithListeners.add (this);
+
+        if (propertyListeners == nullptr)
+            propertyListeners.reset (new PropertyListeners());
+
+        propertyListeners->add (listener, property);
+    }
+}
+
 void ValueTree::removeListener (Listener* listener)
 {
     listeners.remove (listener);
 
-    if (listeners.isEmpty() && object != nullptr)
+    if (propertyListeners != nullptr)
+        propertyListeners->remove (listener);
+
+    if (! hasListeners() && object != nullptr)
         object->valueTreesWithListeners.removeValue (this);
 }
 
@@ -1053,6 +1328,9 @@ ValueTree ValueTree::readFromStream (InputStream& input)
 
 ValueTree ValueTree::readFromData (const void* data, size_t numBytes)
 {
+    if (BinaryValueTree::isBinaryValueTree (data, numBytes))
+        return BinaryValueTree (data, numBytes, false).createValueTree();
+
     MemoryInputStream in (data, numBytes, false);
     return readFromStream (in);
 }
@@ -1066,6 +1344,20 @@ ValueTree ValueTree::readFromGZIPData (const void* data, size_t numBytes)
 
 void ValueTree::Listener::valueTreeRedirected (ValueTree&) {}
 
+//==============================================================================
+ValueTree::ScopedNotificationBatch::ScopedNotificationBatch (const ValueTree& treeToBatch)
+    : object (treeToBatch.object)
+{
+    if (object != nullptr)
+        object->beginBatch();
+}
+
+ValueTree::ScopedNotificationBatch::~ScopedNotificationBatch()
+{
+    if (object != nullptr)
+        object->endBatch();
+}
+
 //==============================================================================
 #if JUCE_UNIT_TESTS
 
@@ -1131,6 +1423,37 @@ public:
         return v;
     }
 
+    struct Recorder  : public ValueTree::Listener
+    {
+        void valueTreePropertyChanged (ValueTree& v, const Identifier& p) override  { log.add ("prop:" + v.getType() + "." + p); }
+        void valueTreeChildAdded (ValueTree& v, ValueTree& c) override              { log.add ("added:" + v.getType() + "." + c.getType()); }
+        void valueTreeChildRemoved (ValueTree& v, ValueTree& c, int) override       { log.add ("removed:" + v.getType() + "." + c.getType()); }
+        void valueTreeChildOrderChanged (ValueTree& v, int, int) override           { log.add ("order:" + v.getType()); }
+        void valueTreeParentChanged (ValueTree& v) override                         { log.add ("parent:" + v.getType()); }
+
+        StringArray log;
+    };
+
+    // (this does a little bit of work for each change, as a typical listener would)
+    struct Counter  : public ValueTree::Listener
+    {
+        void valueTreePropertyChanged (ValueTree& v, const Identifier& p) override  { if (property.isNull() || p == property) update (v[p]); }
+        void valueTreeChildAdded (ValueTree&, ValueTree& c) override                { update (c.getType().toString()); }
+        void valueTreeChildRemoved (ValueTree&, ValueTree& c, int) override         { update (c.getType().toString()); }
+        void valueTreeChildOrderChanged (ValueTree& v, int, int) override           { update (v.getType().toString()); }
+        void valueTreeParentChanged (ValueTree& v) override                         { update (v.getType().toString()); }
+
+        void update (const var& value)
+        {
+            lastValue = value.toString();
+            ++count;
+        }
+
+        Identifier property;
+        String lastValue;
+        int count = 0;
+    };
+
     void runTest() override
     {
         beginTest ("ValueTree");
@@ -1160,6 +1483,243 @@ public:
             auto v4 = v2.createCopy();
             expect (v1.isEquivalentTo (v4));
         }
+
+        beginTest ("Notification batches");
+        {
+            ValueTree root ("root"), a ("a"), b ("b"), c ("c"), d ("d");
+            root.appendChild (a, nullptr);
+            root.appendChild (c, nullptr);
+            root.appendChild (d, nullptr);
+
+            Recorder rootRecorder, dRecorder;
+            root.addListener (&rootRecorder);
+            ValueTree dListened (d);
+            dListened.addListener (&dRecorder);
+
+            {
+                ValueTree::ScopedNotificationBatch batch (root);
+
+                for (int i = 0; i < 3; ++i)
+                    root.setProperty ("x", i, nullptr);
+
+                a.setProperty ("y", 1, nullptr);
+                root.appendChild (b, nullptr);
+                b.setProperty ("z", 1, nullptr);
+                root.moveChild (0, 1, nullptr);
+                root.removeChild (c, nullptr);
+
+                for (int i = 0; i < 3; ++i)
+                {
+                    root.removeChild (d, nullptr);
+                    root.appendChild (d, nullptr);
+                }
+
+                expect (rootRecorder.log.isEmpty());
+                expect (dRecorder.log.isEmpty());
+            }
+
+            expectEquals (rootRecorder.log.joinIntoString (" "),
+                          String ("prop:root.x prop:a.y added:root.b prop:b.z order:root removed:root.c "
+                                  "removed:root.d added:root.d removed:root.d added:root.d removed:root.d added:root.d"));
+            expectEquals (dRecorder.log.joinIntoString (" "), String ("parent:d"));
+
+            rootRecorder.log.clear();
+
+            {
+                ValueTree::ScopedNotificationBatch outer (root);
+
+                {
+                    ValueTree::ScopedNotificationBatch inner (a);
+                    ValueTree::ScopedNotificationBatch inner2 (a);
+                    a.setProperty ("y", 2, nullptr);
+                }
+
+                a.setProperty ("y", 3, nullptr);
+                root.setProperty ("x", 5, nullptr);
+                expect (rootRecorder.log.isEmpty());
+            }
+
+            expectEquals (rootRecorder.log.joinIntoString (" "), String ("prop:a.y prop:root.x"));
+
+            // changes to a tree outside the batch aren't held back
+            rootRecorder.log.clear();
+            ValueTree::ScopedNotificationBatch batch (a);
+            root.setProperty ("x", 6, nullptr);
+            expectEquals (rootRecorder.log.joinIntoString (" "), String ("prop:root.x"));
+        }
+
+        beginTest ("Property listeners");
+        {
+            ValueTree root ("root"), child ("child");
+            root.appendChild (child, nullptr);
+
+            Recorder x, y;
+            root.addPropertyListener (&x, "x");
+            root.addPropertyListener (&y, "y");
+            root.addPropertyListener (&y, "y");
+
+            root.setProperty ("x", 1, nullptr);
+            root.setProperty ("y", 1, nullptr);
+            root.setProperty ("z", 1, nullptr);
+            child.setProperty ("x", 1, nullptr);
+            root.appendChild (ValueTree ("other"), nullptr);
+            root.setPropertyExcludingListener (&x, "x", 2, nullptr);
+
+            expectEquals (x.log.joinIntoString (" "), String ("prop:root.x"));
+            expectEquals (y.log.joinIntoString (" "), String ("prop:root.y"));
+
+            root.removeListener (&x);
+            root.setProperty ("x", 3, nullptr);
+            root.setProperty ("y", 3, nullptr);
+            expectEquals (x.log.size(), 1);
+            expectEquals (y.log.size(), 2);
+
+            root.removeListener (&y);
+            root.setProperty ("y", 4, nullptr);
+            expectEquals (y.log.size(), 2);
+
+            CachedValue<int> cached (root, "x", nullptr);
+            root.setProperty ("x", 42, nullptr);
+            expectEquals (cached.get(), 42);
+
+            // property listeners are called first, even if they were added after the
+            // tree's ordinary listeners, so a CachedValue is already up to date for those
+            struct CachedValueChecker  : public Recorder
+            {
+                CachedValueChecker (CachedValue<int>& v) : value (v) {}
+                void valueTreePropertyChanged (ValueTree&, const Identifier&) override  { log.add (String (value.get())); }
+                CachedValue<int>& value;
+            };
+
+            CachedValue<int> laterValue;
+            CachedValueChecker checker (laterValue);
+            root.addListener (&checker);
+            laterValue.referTo (root, "y", nullptr);
+            root.setProperty ("y", 5, nullptr);
+            expectEquals (checker.log.joinIntoString (" "), String ("5"));
+            root.removeListener (&checker);
+        }
+
+        beginTest ("Bulk mutation benchmark");
+        {
+            const int numChildren = 20000, numListeners = 4;
+
+            auto time = [] (std::function<void()> f)
+            {
+                auto start = Time::getMillisecondCounterHiRes();
+                f();
+                return Time::getMillisecondCounterHiRes() - start;
+            };
+
+            for (auto batched : { false, true })
+            {
+                ValueTree root ("root");
+                Counter counters[numListeners];
+
+                for (auto& c : counters)
+                    root.addListener (&c);
+
+                auto& counter = counters[0];
+
+                auto importTime = time ([&]
+                {
+                    std::unique_ptr<ValueTree::ScopedNotificationBatch> batch (batched ? new ValueTree::ScopedNotificationBatch (root) : nullptr);
+
+                    for (int i = 0; i < numChildren; ++i)
+                        root.appendChild (ValueTree ("item", { { "index", i }, { "name", "item" + String (i) } }), nullptr);
+                });
+
+                auto importCallbacks = counter.count;
+                counter.count = 0;
+
+                auto editTime = time ([&]
+                {
+                    std::unique_ptr<ValueTree::ScopedNotificationBatch> batch (batched ? new ValueTree::ScopedNotificationBatch (root) : nullptr);
+
+                    for (int pass = 0; pass < 5; ++pass)
+                        for (auto child : root)
+                            child.setProperty ("value", pass, nullptr);
+                });
+
+                expectEquals (root.getNumChildren(), numChildren);
+                expectEquals (counter.count, batched ? numChildren : numChildren * 5);
+
+                logMessage (String ("  ") + (batched ? "batched:   " : "unbatched: ")
+                              + "import " + String (importTime, 1) + " ms (" + String (importCallbacks * numListeners) + " callbacks), "
+                              + "edit " + String (editTime, 1) + " ms (" + String (counter.count * numListeners) + " callbacks)");
+            }
+
+            const int numProperties = 200, numChanges = 20000;
+            Array<Identifier> names;
+
+            for (int i = 0; i < numProperties; ++i)
+                names.add ("p" + String (i));
+
+            for (auto indexed : { false, true })
+            {
+                ValueTree tree ("tree");
+                OwnedArray<Counter> counters;
+
+                for (auto& propertyName : names)
+                {
+                    auto* c = counters.add (new Counter());
+                    c->property = propertyName;
+
+                    if (indexed)
+                        tree.addPropertyListener (c, propertyName);
+                    else
+                        tree.addListener (c);
+                }
+
+                auto changeTime = time ([&]
+                {
+                    for (int i = 0; i < numChanges; ++i)
+                        tree.setProperty (names.getReference (i % numProperties), i, nullptr);
+                });
+
+                int total = 0;
+
+                for (auto* c : counters)
+                    total += c->count;
+
+                expectEquals (total, numChanges);
+
+                logMessage (String ("  ") + String (numProperties) + (indexed ? " property listeners: " : " listeners:          ")
+                              + String (changeTime * 1.0e6 / numChanges, 1) + " ns per change");
+            }
+        }
+
+        beginTest ("Property access benchmark");
+
+        for (auto numProperties : { 10, 100, 1000, 5000 })
+        {
+            Array<Identifier> names;
+
+            for (int i = 0; i < numProperties; ++i)
+                names.add ("property" + String (i));
+
+            ValueTree v ("Test");
+            auto start = Time::getMillisecondCounterHiRes();
+
+            for (int i = 0; i < numProperties; ++i)
+                v.setProperty (names.getReference (i), i, nullptr);
+
+            auto setTime = Time::getMillisecondCounterHiRes() - start;
+
+            auto numLookups = numProperties * (500000 / numProperties);
+            int64 total = 0;
+            start = Time::getMillisecondCounterHiRes();
+
+            for (int i = 0; i < numLookups; ++i)
+                total += (int) v.getProperty (names.getReference (i % numProperties));
+
+            auto lookupTime = Time::getMillisecondCounterHiRes() - start;
+            expectEquals (total, (int64) (numLookups / numProperties) * numProperties * (numProperties - 1) / 2);
+
+            logMessage ("  " + String (numProperties).paddedLeft (' ', 5) + " properties: "
+                          + "setting all " + String (setTime, 2) + " ms, "
+                          + "lookup " + String (lookupTime * 1.0e6 / numLookups, 1) + " ns");
+        }
     }
 };
 
@@ -444,7 +444,9 @@ public:
     /** Reloads a tree from a stream that was written with writeToStream(). */
     static ValueTree readFromStream (InputStream& input);
 
-    /** Reloads a tree from a data block that was written with writeToStream(). */
+    /** Reloads a tree from a data block that was written with writeToStream().
+        This will also load data that was written by BinaryValueTree::writeToStream().
+    */
     static ValueTree readFromData (const void* data, size_t numBytes);
 
     /** Reloads a tree from a data block that was written with writeToStream() and
@@ -534,7 +536,29 @@ public:
     */
     void addListener (Listener* listener);
 
-    /** Removes a listener that was previously added with addListener(). */
+    /** Adds a listener that only needs to know when one particular property of this
+        tree changes.
+
+        The listener's valueTreePropertyChanged() method will only be called when the
+        given property of this tree itself is changed (not those of its sub-trees), and
+        none of its other callbacks will be made. Listeners that are added like this are
+        indexed by property name, so a tree can have a large number of them (e.g. one
+        for each of its properties) without all of them being called for every change.
+
+        When a property changes, the listeners that were added for it with this method
+        are called before any that were added with addListener(), to this tree or to any
+        of its parents, regardless of the order in which they were added. CachedValue and
+        the Value objects returned by getPropertyAsValue() use this method, so they'll
+        already have been updated by the time an ordinary listener hears about the change.
+
+        The same rules about the lifetime of this ValueTree object apply as they do for
+        addListener().
+
+        @see addListener, removeListener
+    */
+    void addPropertyListener (Listener* listener, const Identifier& property);
+
+    /** Removes a listener that was previously added with addListener() or addPropertyListener(). */
     void removeListener (Listener* listener);
 
     /** Changes a named property of the tree, but will not notify a specified listener of the change.
@@ -549,6 +573,9 @@ public:
     */
     void sendPropertyChangeMessage (const Identifier& property);
 
+    //==============================================================================
+    class ScopedNotificationBatch;
+
     //==============================================================================
     /** This method uses a comparator object to sort the tree's children into order.
 
@@ -598,9 +625,14 @@ private:
     //==============================================================================
     JUCE_PUBLIC_IN_DLL_BUILD (class SharedObject)
     friend class SharedObject;
+    friend class BinaryValueTree;
+    friend class ValueTreeSynchroniser;
+
+    struct PropertyListeners;
 
     ReferenceCountedObjectPtr<SharedObject> object;
     ListenerList<Listener> listeners;
+    std::unique_ptr<PropertyListeners> propertyListeners;
 
     template <typename ElementComparator>
     struct ComparatorAdapter
@@ -617,10 +649,53 @@ private:
         JUCE_DECLARE_NON_COPYABLE (ComparatorAdapter)
     };
 
+    bool hasListeners() const noexcept;
     void createListOfChildren (OwnedArray<ValueTree>&) const;
     void reorderChildren (const OwnedArray<ValueTree>&, UndoManager*);
 
     explicit ValueTree (SharedObject*) noexcept;
 };
 
+//==============================================================================
+/**
+    Holds back the change callbacks for a tree while it's being modified, and then
+    delivers them all at once.
+
+    While one of these objects exists, the listener callbacks for any changes made to
+    the tree (or any of its sub-trees) are deferred. When the last ScopedNotificationBatch
+    for the tree is deleted, they're delivered in the order that the changes happened,
+    except that each property of each tree is only reported once, however many times it
+    was changed, and each tree gets at most one valueTreeParentChanged() callback.
+
+    This makes bulk edits much cheaper when there are listeners attached, but bear in
+    mind that the listeners will see the tree in its final state rather than as it was
+    when each change was made.
+
+    E.g.
+    @code
+    {
+        ValueTree::ScopedNotificationBatch batch (state);
+
+        for (auto& preset : presetsToImport)
+            state.appendChild (createPresetTree (preset), nullptr);
+    }   // the listeners are called here
+    @endcode
+
+    @tags{DataStructures}
+*/
+class JUCE_API  ValueTree::ScopedNotificationBatch
+{
+public:
+    /** Starts deferring the callbacks for a tree. */
+    explicit ScopedNotificationBatch (const ValueTree& treeToBatch);
+
+    /** Delivers the deferred callbacks, if this is the last batch for the tree. */
+    ~ScopedNotificationBatch();
+
+private:
+    ReferenceCountedObjectPtr<ValueTree::SharedObject> object;
+
+    JUCE_DECLARE_NON_COPYABLE (ScopedNotificationBatch)
+};
+
 } // namespace juce
@@ -36,9 +36,34 @@ namespace ValueTreeSynchroniserHelpers
         childAdded       = 3,
         childRemoved     = 4,
         childMoved       = 5,
-        propertyRemoved  = 6
+        propertyRemoved  = 6,
+        batch            = 7,
+        compressed       = 8
     };
 
+    // Compressed messages can expand enormously, so the size of a decompressed one is
+    // limited, to stop a small message from a peer making us allocate any amount of memory
+    static const size_t maxDecompressedSize = 64 * 1024 * 1024;
+
+    static bool decompressMessage (InputStream& input, MemoryOutputStream& message)
+    {
+        GZIPDecompressorInputStream unzipper (input);
+        char buffer[8192];
+
+        for (;;)
+        {
+            auto numRead = unzipper.read (buffer, (int) sizeof (buffer));
+
+            if (numRead <= 0)
+                return true;
+
+            if (message.getDataSize() + (size_t) numRead > maxDecompressedSize)
+                return false;
+
+            message.write (buffer, (size_t) numRead);
+        }
+    }
+
     static void getValueTreePath (ValueTree v, const ValueTree& topLevelTree, Array<int>& path)
     {
         while (v != topLevelTree)
@@ -91,8 +116,246 @@ namespace ValueTreeSynchroniserHelpers
 
         return v;
     }
+
+    /*  In a batch, each change's path is written as the number of levels that it shares
+        with the previous change's path, followed by the levels that are different.
+    */
+    static void writeBatchedPath (MemoryOutputStream& stream, Array<int>& previousPath, const Array<int>& reversedPath)
+    {
+        auto numLevels = reversedPath.size();
+        int numShared = 0;
+
+        while (numShared < numLevels && numShared < previousPath.size()
+                && previousPath.getUnchecked (numShared) == reversedPath.getUnchecked (numLevels - 1 - numShared))
+            ++numShared;
+
+        stream.writeCompressedInt (numShared);
+        stream.writeCompressedInt (numLevels - numShared);
+        previousPath.resize (numShared);
+
+        for (int i = numShared; i < numLevels; ++i)
+        {
+            auto index = reversedPath.getUnchecked (numLevels - 1 - i);
+            stream.writeCompressedInt (index);
+            previousPath.add (index);
+        }
+    }
+
+    static ValueTree readBatchedPath (MemoryInputStream& input, const ValueTree& root, Array<int>& previousPath)
+    {
+        auto numShared = input.readCompressedInt();
+        auto numNew = input.readCompressedInt();
+
+        if (! (isPositiveAndNotGreaterThan (numShared, previousPath.size()) && isPositiveAndBelow (numNew, 65536)))
+            return {};
+
+        previousPath.resize (numShared);
+
+        for (int i = 0; i < numNew; ++i)
+            previousPath.add (input.readCompressedInt());
+
+        auto v = root;
+
+        for (auto index : previousPath)
+        {
+            if (! isPositiveAndBelow (index, v.getNumChildren()))
+                return {};
+
+            v = v.getChild (index);
+        }
+
+        return v;
+    }
+
+    static bool applyChangeToTree (ChangeType type, MemoryInputStream& input, ValueTree& v,
+                                   const Array<Identifier>* identifiers, UndoManager* undoManager)
+    {
+        auto readPropertyName = [&] () -> Identifier
+        {
+            if (identifiers == nullptr)
+                return input.readString();
+
+            return (*identifiers)[input.readCompressedInt()];
+        };
+
+        switch (type)
+        {
+            case propertyChanged:
+            {
+                Identifier property (readPropertyName());
+
+                if (property.isNull())
+                    break;
+
+                v.setProperty (property, var::readFromStream (input), undoManager);
+                return true;
+            }
+
+            case propertyRemoved:
+            {
+                Identifier property (readPropertyName());
+
+                if (property.isNull())
+                    break;
+
+                v.removeProperty (property, undoManager);
+                return true;
+            }
+
+            case childAdded:
+            {
+                const int index = input.readCompressedInt();
+                v.addChild (ValueTree::readFromStream (input), index, undoManager);
+                return true;
+            }
+
+            case childRemoved:
+            {
+                const int index = input.readCompressedInt();
+
+                if (isPositiveAndBelow (index, v.getNumChildren()))
+                {
+                    v.removeChild (index, undoManager);
+                    return true;
+                }
+
+                jassertfalse; // Either received some corrupt data, or the trees have drifted out of sync
+                return false;
+            }
+
+            case childMoved:
+            {
+                const int oldIndex = input.readCompressedInt();
+                const int newIndex = input.readCompressedInt();
+
+                if (isPositiveAndBelow (oldIndex, v.getNumChildren())
+                     && isPositiveAndBelow (newIndex, v.getNumChildren()))
+                {
+                    v.moveChild (oldIndex, newIndex, undoManager);
+                    return true;
+                }
+
+                jassertfalse; // Either received some corrupt data, or the trees have drifted out of sync
+                return false;
+            }
+
+            case fullSync:
+            case batch:
+            case compressed:
+            default:
+                break;
+        }
+
+        jassertfalse; // Seem to have received some corrupt data?
+        return false;
+    }
 }
 
+//==============================================================================
+struct ValueTreeSynchroniser::PendingChanges
+{
+    // The structural changes are encoded as they happen, because the paths in later
+    // changes depend on them, but property changes are just noted, and their final
+    // values get added to the end of the batch when it's sent.
+    MemoryOutputStream structuralChanges;
+    int numStructuralChanges = 0;
+    Array<int> previousPath;
+
+    struct ChangedTree
+    {
+        ValueTree tree;
+        Array<Identifier> properties;
+    };
+
+    Array<ChangedTree> changedTrees;
+    FlatHashMap<const void*, int> changedTreeIndexes;
+
+    bool isEmpty() const noexcept
+    {
+        return numStructuralChanges == 0 && changedTrees.isEmpty();
+    }
+
+    void addPropertyChange (ValueTree& tree, const Identifier& property)
+    {
+        auto& index = changedTreeIndexes.getReference (tree.object.get());
+
+        if (index == 0)
+        {
+            changedTrees.add ({ tree, {} });
+            index = changedTrees.size();
+        }
+
+        changedTrees.getReference (index - 1).properties.addIfNotAlreadyThere (property);
+    }
+
+    MemoryOutputStream& startStructuralChange (ValueTreeSynchroniserHelpers::ChangeType type,
+                                               const ValueTree& tree, const ValueTree& root)
+    {
+        Array<int> path;
+        ValueTreeSynchroniserHelpers::getValueTreePath (tree, root, path);
+
+        structuralChanges.writeByte ((char) type);
+        ValueTreeSynchroniserHelpers::writeBatchedPath (structuralChanges, previousPath, path);
+        ++numStructuralChanges;
+        return structuralChanges;
+    }
+
+    void write (MemoryOutputStream& out, const ValueTree& root)
+    {
+        using namespace ValueTreeSynchroniserHelpers;
+
+        MemoryOutputStream changes;
+        changes << structuralChanges;
+        auto numChanges = numStructuralChanges;
+
+        Array<Identifier> identifiers;
+        FlatHashMap<Identifier, int> identifierIndexes;
+
+        for (auto& changed : changedTrees)
+        {
+            auto& tree = changed.tree;
+
+            // (if it's no longer part of the tree, then its removal will already have been sent)
+            if (tree != root && ! tree.isAChildOf (root))
+                continue;
+
+            Array<int> path;
+            getValueTreePath (tree, root, path);
+
+            for (auto& property : changed.properties)
+            {
+                auto& identifierIndex = identifierIndexes.getReference (property);
+
+                if (identifierIndex == 0)
+                {
+                    identifiers.add (property);
+                    identifierIndex = identifiers.size();
+                }
+
+                auto* value = tree.getPropertyPointer (property);
+                changes.writeByte ((char) (value != nullptr ? propertyChanged : propertyRemoved));
+                writeBatchedPath (changes, previousPath, path);
+                changes.writeCompressedInt (identifierIndex - 1);
+
+                if (value != nullptr)
+                    value->writeToStream (changes);
+
+                ++numChanges;
+            }
+        }
+
+        writeHeader (out, batch);
+        out.writeCompressedInt (identifiers.size());
+
+        for (auto& identifier : identifiers)
+            out.writeString (identifier.toString());
+
+        out.writeCompressedInt (numChanges);
+        out << changes;
+    }
+};
+
+//==============================================================================
 ValueTreeSynchroniser::ValueTreeSynchroniser (const ValueTree& tree)  : valueTree (tree)
 {
     valueTree.addListener (this);
@@ -105,14 +368,91 @@ ValueTreeSynchroniser::~ValueTreeSynchroniser()
 
 void ValueTreeSynchroniser::sendFullSyncCallback()
 {
+    // (the full state supersedes any changes that haven't been sent yet)
+    pendingChanges.reset();
+    stopTimer();
+
     MemoryOutputStream m;
     writeHeader (m, ValueTreeSynchroniserHelpers::fullSync);
     valueTree.writeToStream (m);
-    stateChanged (m.getData(), m.getDataSize());
+    send (m);
+}
+
+//==============================================================================
+void ValueTreeSynchroniser::setBatchInterval (int intervalMilliseconds)
+{
+    jassert (intervalMilliseconds >= 0);
+    batchInterval = jmax (0, intervalMilliseconds);
+
+    if (batchInterval == 0)
+        flush();
 }
 
+void ValueTreeSynchroniser::flush()
+{
+    stopTimer();
+
+    if (pendingChanges == nullptr)
+        return;
+
+    std::unique_ptr<PendingChanges> changes (pendingChanges.release());
+
+    if (! changes->isEmpty())
+    {
+        MemoryOutputStream m;
+        changes->write (m, valueTree);
+        send (m);
+    }
+}
+
+void ValueTreeSynchroniser::setCompressionEnabled (bool shouldCompress, size_t minimumSizeToCompress)
+{
+    compressionEnabled = shouldCompress;
+    compressionThreshold = minimumSizeToCompress;
+}
+
+void ValueTreeSynchroniser::send (const MemoryOutputStream& message)
+{
+    if (compressionEnabled && message.getDataSize() >= compressionThreshold)
+    {
+        MemoryOutputStream m;
+        writeHeader (m, ValueTreeSynchroniserHelpers::compressed);
+
+        {
+            GZIPCompressorOutputStream zipper (m);
+            zipper.write (message.getData(), message.getDataSize());
+        }
+
+        if (m.getDataSize() < message.getDataSize())
+        {
+            stateChanged (m.getData(), m.getDataSize());
+            return;
+        }
+    }
+
+    stateChanged (message.getData(), message.getDataSize());
+}
+
+void ValueTreeSynchroniser::timerCallback()
+{
+    flush();
+}
+
+//==============================================================================
 void ValueTreeSynchroniser::valueTreePropertyChanged (ValueTree& vt, const Identifier& property)
 {
+    if (batchInterval > 0)
+    {
+        if (pendingChanges == nullptr)
+        {
+            pendingChanges.reset (new PendingChanges());
+            startTimer (batchInterval);
+        }
+
+        pendingChanges->addPropertyChange (vt, property);
+        return;
+    }
+
     MemoryOutputStream m;
 
     if (auto* value = vt.getPropertyPointer (property))
@@ -127,7 +467,7 @@ void ValueTreeSynchroniser::valueTreePropertyChanged (ValueTree& vt, const Ident
         m.writeString (property.toString());
     }
 
-    stateChanged (m.getData(), m.getDataSize());
+    send (m);
 }
 
 void ValueTreeSynchroniser::valueTreeChildAdded (ValueTree& parentTree, ValueTree& childTree)
@@ -136,107 +476,355 @@ void ValueTreeSynchroniser::valueTreeChildAdded (ValueTree& parentTree, ValueTre
     jassert (index >= 0);
 
     MemoryOutputStream m;
-    ValueTreeSynchroniserHelpers::writeHeader (*this, m, ValueTreeSynchroniserHelpers::childAdded, parentTree);
-    m.writeCompressedInt (index);
-    childTree.writeToStream (m);
-    stateChanged (m.getData(), m.getDataSize());
+    auto& out = startStructuralChange (m, ValueTreeSynchroniserHelpers::childAdded, parentTree);
+    out.writeCompressedInt (index);
+    childTree.writeToStream (out);
+    finishStructuralChange (m);
 }
 
 void ValueTreeSynchroniser::valueTreeChildRemoved (ValueTree& parentTree, ValueTree&, int oldIndex)
 {
     MemoryOutputStream m;
-    ValueTreeSynchroniserHelpers::writeHeader (*this, m, ValueTreeSynchroniserHelpers::childRemoved, parentTree);
-    m.writeCompressedInt (oldIndex);
-    stateChanged (m.getData(), m.getDataSize());
+    auto& out = startStructuralChange (m, ValueTreeSynchroniserHelpers::childRemoved, parentTree);
+    out.writeCompressedInt (oldIndex);
+    finishStructuralChange (m);
 }
 
 void ValueTreeSynchroniser::valueTreeChildOrderChanged (ValueTree& parent, int oldIndex, int newIndex)
 {
     MemoryOutputStream m;
-    ValueTreeSynchroniserHelpers::writeHeader (*this, m, ValueTreeSynchroniserHelpers::childMoved, parent);
-    m.writeCompressedInt (oldIndex);
-    m.writeCompressedInt (newIndex);
-    stateChanged (m.getData(), m.getDataSize());
+    auto& out = startStructuralChange (m, ValueTreeSynchroniserHelpers::childMoved, parent);
+    out.writeCompressedInt (oldIndex);
+    out.writeCompressedInt (newIndex);
+    finishStructuralChange (m);
 }
 
 void ValueTreeSynchroniser::valueTreeParentChanged (ValueTree&)  {} // (No action needed here)
 
+MemoryOutputStream& ValueTreeSynchroniser::startStructuralChange (MemoryOutputStream& message,
+                                                                  int type, ValueTree& tree)
+{
+    auto changeType = (ValueTreeSynchroniserHelpers::ChangeType) type;
+
+    if (batchInterval > 0)
+    {
+        if (pendingChanges == nullptr)
+        {
+            pendingChanges.reset (new PendingChanges());
+            startTimer (batchInterval);
+        }
+
+        return pendingChanges->startStructuralChange (changeType, tree, valueTree);
+    }
+
+    ValueTreeSynchroniserHelpers::writeHeader (*this, message, changeType, tree);
+    return message;
+}
+
+void ValueTreeSynchroniser::finishStructuralChange (const MemoryOutputStream& message)
+{
+    if (message.getDataSize() > 0)
+        send (message);
+}
+
+//==============================================================================
 bool ValueTreeSynchroniser::applyChange (ValueTree& root, const void* data, size_t dataSize, UndoManager* undoManager)
 {
+    using namespace ValueTreeSynchroniserHelpers;
+
     MemoryInputStream input (data, dataSize, false);
 
-    const ValueTreeSynchroniserHelpers::ChangeType type = (ValueTreeSynchroniserHelpers::ChangeType) input.readByte();
+    const ChangeType type = (ChangeType) input.readByte();
 
-    if (type == ValueTreeSynchroniserHelpers::fullSync)
+    if (type == fullSync)
     {
         root = ValueTree::readFromStream (input);
         return true;
     }
 
-    ValueTree v (ValueTreeSynchroniserHelpers::readSubTreeLocation (input, root));
+    if (type == compressed)
+    {
+        MemoryOutputStream message;
+
+        if (! decompressMessage (input, message) || message.getDataSize() == 0
+             || *static_cast<const char*> (message.getData()) == (char) compressed)
+            return false;
+
+        return applyChange (root, message.getData(), message.getDataSize(), undoManager);
+    }
+
+    if (type == batch)
+    {
+        auto numIdentifiers = input.readCompressedInt();
+
+        if (! isPositiveAndBelow (numIdentifiers, 65536)) // sanity-check
+            return false;
+
+        Array<Identifier> identifiers;
+
+        for (int i = 0; i < numIdentifiers; ++i)
+        {
+            auto name = input.readString();
+
+            if (name.isEmpty())
+                return false;
+
+            identifiers.add (name);
+        }
+
+        auto numChanges = input.readCompressedInt();
+        Array<int> previousPath;
+
+        for (int i = 0; i < numChanges; ++i)
+        {
+            auto changeType = (ChangeType) input.readByte();
+            auto v = readBatchedPath (input, root, previousPath);
+
+            if (! v.isValid() || ! applyChangeToTree (changeType, input, v, &identifiers, undoManager))
+                return false;
+        }
+
+        return true;
+    }
+
+    ValueTree v (readSubTreeLocation (input, root));
 
     if (! v.isValid())
         return false;
 
-    switch (type)
+    return applyChangeToTree (type, input, v, nullptr, undoManager);
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ValueTreeSynchroniserTests  : public UnitTest
+{
+public:
+    ValueTreeSynchroniserTests() : UnitTest ("ValueTreeSynchroniser", "Values") {}
+
+    struct Mirror  : public ValueTreeSynchroniser
     {
-        case ValueTreeSynchroniserHelpers::propertyChanged:
+        Mirror (const ValueTree& source) : ValueTreeSynchroniser (source) {}
+
+        void stateChanged (const void* data, size_t size) override
         {
-            Identifier property (input.readString());
-            v.setProperty (property, var::readFromStream (input), undoManager);
-            return true;
+            ++numMessages;
+            numBytes += size;
+            messageTypes.add (static_cast<const uint8*> (data)[0]);
+
+            auto start = Time::getMillisecondCounterHiRes();
+
+            if (! applyChange (replica, data, size, nullptr))
+                ++numFailures;
+
+            applyTime += Time::getMillisecondCounterHiRes() - start;
         }
 
-        case ValueTreeSynchroniserHelpers::propertyRemoved:
+        ValueTree replica;
+        Array<int> messageTypes;
+        int numMessages = 0, numFailures = 0;
+        size_t numBytes = 0;
+        double applyTime = 0;
+    };
+
+    static void collectTrees (const ValueTree& v, Array<ValueTree>& result)
+    {
+        result.add (v);
+
+        for (auto child : v)
+            collectTrees (child, result);
+    }
+
+    static void makeRandomChange (ValueTree& root, Random& r)
+    {
+        Array<ValueTree> trees;
+        collectTrees (root, trees);
+
+        auto v = trees[r.nextInt (trees.size())];
+        auto numChildren = v.getNumChildren();
+        Identifier name ("p" + String (r.nextInt (4)));
+
+        switch (r.nextInt (8))
         {
-            Identifier property (input.readString());
-            v.removeProperty (property, undoManager);
-            return true;
+            case 0:
+            case 1:
+            case 2:  v.setProperty (name, r.nextInt (100), nullptr); break;
+            case 3:  v.setProperty (name, "text" + String (r.nextInt (100)), nullptr); break;
+            case 4:  v.removeProperty (name, nullptr); break;
+            case 5:  if (trees.size() < 200) v.addChild (ValueTree ("t" + String (r.nextInt (3)), { { "x", r.nextInt (100) } }), r.nextInt (numChildren + 1), nullptr); break;
+            case 6:  if (numChildren > 0) v.removeChild (r.nextInt (numChildren), nullptr); break;
+            case 7:  if (numChildren > 1) v.moveChild (r.nextInt (numChildren), r.nextInt (numChildren), nullptr); break;
+            default: break;
         }
+    }
 
-        case ValueTreeSynchroniserHelpers::childAdded:
+    void runTest() override
+    {
+        auto r = getRandom();
+
+        beginTest ("Immediate changes");
         {
-            const int index = input.readCompressedInt();
-            v.addChild (ValueTree::readFromStream (input), index, undoManager);
-            return true;
+            ValueTree root ("root");
+            Mirror mirror (root);
+            mirror.sendFullSyncCallback();
+            expect (mirror.replica.isEquivalentTo (root));
+
+            for (int i = 0; i < 1000; ++i)
+            {
+                auto numMessages = mirror.numMessages;
+                makeRandomChange (root, r);
+                expect (mirror.numMessages <= numMessages + 1);
+                expect (mirror.replica.isEquivalentTo (root));
+            }
+
+            expectEquals (mirror.numFailures, 0);
         }
 
-        case ValueTreeSynchroniserHelpers::childRemoved:
+        beginTest ("Batched changes");
         {
-            const int index = input.readCompressedInt();
+            ValueTree root ("root");
+            Mirror mirror (root);
+            mirror.sendFullSyncCallback();
+            mirror.setBatchInterval (60000);
 
-            if (isPositiveAndBelow (index, v.getNumChildren()))
+            int numChanges = 0;
+
+            for (int i = 0; i < 200; ++i)
             {
-                v.removeChild (index, undoManager);
-                return true;
+                auto numMessages = mirror.numMessages;
+
+                for (int j = r.nextInt (40); --j >= 0;)
+                {
+                    makeRandomChange (root, r);
+                    ++numChanges;
+                }
+
+                expectEquals (mirror.numMessages, numMessages);
+
+                mirror.flush();
+                expect (mirror.numMessages <= numMessages + 1);
+                expect (mirror.replica.isEquivalentTo (root));
             }
 
-            jassertfalse; // Either received some corrupt data, or the trees have drifted out of sync
-            break;
+            expectEquals (mirror.numFailures, 0);
+            expect (mirror.numMessages < numChanges);
+
+            mirror.setBatchInterval (0);
+            root.setProperty ("x", 1, nullptr);
+            expect (mirror.replica.isEquivalentTo (root));
         }
 
-        case ValueTreeSynchroniserHelpers::childMoved:
+        beginTest ("Compression");
         {
-            const int oldIndex = input.readCompressedInt();
-            const int newIndex = input.readCompressedInt();
+            ValueTree root ("root");
+
+            for (int i = 0; i < 100; ++i)
+                root.appendChild (ValueTree ("item", { { "name", "item" + String (i) }, { "value", i } }), nullptr);
 
-            if (isPositiveAndBelow (oldIndex, v.getNumChildren())
-                 && isPositiveAndBelow (newIndex, v.getNumChildren()))
+            Mirror mirror (root);
+            mirror.setCompressionEnabled (true, 64);
+            mirror.sendFullSyncCallback();
+            expect (mirror.replica.isEquivalentTo (root));
+            expectEquals (mirror.messageTypes.getLast(), (int) ValueTreeSynchroniserHelpers::compressed);
+
+            mirror.setBatchInterval (60000);
+
+            for (int i = 0; i < 50; ++i)
             {
-                v.moveChild (oldIndex, newIndex, undoManager);
-                return true;
+                for (int j = 0; j < 100; ++j)
+                    makeRandomChange (root, r);
+
+                mirror.flush();
+                expect (mirror.replica.isEquivalentTo (root));
+            }
+
+            // small messages aren't worth compressing
+            mirror.setBatchInterval (0);
+            root.getChild (0).setProperty ("value", -1, nullptr);
+            expectEquals (mirror.messageTypes.getLast(), (int) ValueTreeSynchroniserHelpers::propertyChanged);
+            expect (mirror.replica.isEquivalentTo (root));
+            expectEquals (mirror.numFailures, 0);
+
+            // a message that would expand to more than the limit is rejected
+            MemoryOutputStream bomb;
+            bomb.writeByte ((char) ValueTreeSynchroniserHelpers::compressed);
+
+            {
+                GZIPCompressorOutputStream zipper (bomb);
+                zipper.writeByte ((char) ValueTreeSynchroniserHelpers::fullSync);
+                zipper.writeRepeatedByte (0, ValueTreeSynchroniserHelpers::maxDecompressedSize);
             }
 
-            jassertfalse; // Either received some corrupt data, or the trees have drifted out of sync
-            break;
+            expect (bomb.getDataSize() < 1024 * 1024);
+            expect (! ValueTreeSynchroniser::applyChange (mirror.replica, bomb.getData(), bomb.getDataSize(), nullptr));
+            expect (mirror.replica.isEquivalentTo (root));
         }
 
-        default:
-            jassertfalse; // Seem to have received some corrupt data?
-            break;
+        beginTest ("Automation benchmark");
+        {
+            ValueTree root ("SESSION");
+
+            for (int i = 0; i < 500; ++i)
+            {
+                ValueTree track ("TRACK", { { "name", "Track " + String (i) } });
+
+                for (int j = 0; j < 99; ++j)
+                    track.appendChild (ValueTree ("PARAM", { { "id", "param" + String (j) }, { "value", 0.0 } }), nullptr);
+
+                root.appendChild (track, nullptr);
+            }
+
+            const int numTicks = 20, numParametersPerTick = 1000, numWritesPerParameter = 4;
+
+            for (int mode = 0; mode < 3; ++mode)
+            {
+                Mirror mirror (root);
+                mirror.setCompressionEnabled (mode == 2);
+                mirror.sendFullSyncCallback();
+
+                auto fullSyncBytes = mirror.numBytes;
+                mirror.numBytes = 0;
+                mirror.numMessages = 0;
+                mirror.applyTime = 0;
+
+                if (mode > 0)
+                    mirror.setBatchInterval (60000);
+
+                Random automation (1234);
+                auto start = Time::getMillisecondCounterHiRes();
+
+                for (int tick = 0; tick < numTicks; ++tick)
+                {
+                    for (int i = 0; i < numParametersPerTick; ++i)
+                    {
+                        auto param = root.getChild (automation.nextInt (500)).getChild (automation.nextInt (99));
+
+                        for (int j = 0; j < numWritesPerParameter; ++j)
+                            param.setProperty ("value", automation.nextDouble(), nullptr);
+                    }
+
+                    mirror.flush();
+                }
+
+                auto totalTime = Time::getMillisecondCounterHiRes() - start;
+
+                expect (mirror.replica.isEquivalentTo (root));
+                expectEquals (mirror.numFailures, 0);
+
+                logMessage (String ("  ") + (mode == 0 ? "immediate:          " : (mode == 1 ? "batched:            " : "batched, compressed:"))
+                              + " full sync " + String ((int) fullSyncBytes / 1024) + " KB, "
+                              + String (mirror.numMessages) + " messages, "
+                              + String ((int) mirror.numBytes / numTicks) + " bytes per tick, "
+                              + String ((totalTime - mirror.applyTime) / numTicks, 2) + " ms encoding and "
+                              + String (mirror.applyTime / numTicks, 2) + " ms applying per tick");
+            }
+        }
     }
+};
 
-    return false;
-}
+static ValueTreeSynchroniserTests valueTreeSynchroniserTests;
+
+#endif
 
 } // namespace juce
@@ -41,9 +41,15 @@ namespace juce
     via a network or other means) to a remote destination, where it can be
     applied to a target tree.
 
+    By default, each change is sent as soon as it happens. If the tree changes
+    rapidly (e.g. while parameters are being automated), you can use setBatchInterval()
+    to collect the changes and send them together, and setCompressionEnabled() to
+    zip the larger messages.
+
     @tags{DataStructures}
 */
-class JUCE_API  ValueTreeSynchroniser  : private ValueTree::Listener
+class JUCE_API  ValueTreeSynchroniser  : private ValueTree::Listener,
+                                         private Timer
 {
 public:
     /** Creates a ValueTreeSynchroniser that watches the given tree.
@@ -71,11 +77,43 @@ public:
     */
     void sendFullSyncCallback();
 
+    //==============================================================================
+    /** Makes the synchroniser hold back the changes to the tree and send them together.
+
+        When the interval is greater than zero, the first change to the tree starts a timer,
+        and all the changes that happen before it fires are sent in one stateChanged()
+        message. If a property is changed several times during that time, only its final
+        value is sent, and the paths to the trees that have changed are delta-encoded, so
+        the messages are much smaller than the equivalent individual changes.
+
+        An interval of zero (the default) sends each change as soon as it happens.
+
+        The timer needs the message thread to be running, but you can also call flush()
+        at any time to send the pending changes immediately. Any changes that are still
+        pending when the synchroniser is deleted are discarded.
+    */
+    void setBatchInterval (int intervalMilliseconds);
+
+    /** Immediately sends any changes that are being held back by setBatchInterval(). */
+    void flush();
+
+    /** Enables zlib compression of the messages that are sent.
+
+        Only messages of at least minimumSizeToCompress bytes will be compressed, as
+        the small ones don't get any smaller. applyChange() will handle both kinds.
+    */
+    void setCompressionEnabled (bool shouldCompress, size_t minimumSizeToCompress = 256);
+
+    //==============================================================================
+
     /** Applies an encoded change to the given destination tree.
 
         When you implement a receiver for changes that were sent by the stateChanged()
         message, this is the function that you'll need to call to apply them to the
         target tree that you want to be synced.
+
+        A compressed message that would expand to more than 64MB is rejected, and
+        this returns false without changing the tree.
     */
     static bool applyChange (ValueTree& target,
                              const void* encodedChangeData, size_t encodedChangeDataSize,
@@ -85,7 +123,18 @@ public:
     const ValueTree& getRoot() noexcept       { return valueTree; }
 
 private:
+    struct PendingChanges;
+
     ValueTree valueTree;
+    std::unique_ptr<PendingChanges> pendingChanges;
+    int batchInterval = 0;
+    bool compressionEnabled = false;
+    size_t compressionThreshold = 256;
+
+    void send (const MemoryOutputStream&);
+    MemoryOutputStream& startStructuralChange (MemoryOutputStream&, int changeType, ValueTree&);
+    void finishStructuralChange (const MemoryOutputStream&);
+    void timerCallback() override;
 
     void valueTreePropertyChanged (ValueTree&, const Identifier&) override;
     void valueTreeChildAdded (ValueTree&, ValueTree&) override;
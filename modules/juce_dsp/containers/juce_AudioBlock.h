@@ -36,6 +36,31 @@ namespace SampleTypeHelpers // Internal classes needed for handling sample type
     template <> struct ElementType<float>            { using Type = float;  };
     template <> struct ElementType<double>           { using Type = double; };
     template <> struct ElementType<long double>      { using Type = long double; };
+
+    // Gives access to the individual lanes of a sample type: the elements of a
+    // SIMDRegister, or the sample itself for primitive types. The raw arrays
+    // must be aligned like the sample type.
+    template <typename SampleType>
+    struct Lanes
+    {
+        static constexpr size_t size = 1;
+
+        static SampleType expand (SampleType value) noexcept                          { return value; }
+        static SampleType fromRawArray (const SampleType* values) noexcept           { return *values; }
+        static void copyToRawArray (SampleType sample, SampleType* values) noexcept  { *values = sample; }
+    };
+
+   #if JUCE_USE_SIMD
+    template <typename Type>
+    struct Lanes<SIMDRegister<Type>>
+    {
+        static constexpr size_t size = SIMDRegister<Type>::SIMDNumElements;
+
+        static SIMDRegister<Type> expand (Type value) noexcept                               { return SIMDRegister<Type>::expand (value); }
+        static SIMDRegister<Type> fromRawArray (const Type* values) noexcept                 { return SIMDRegister<Type>::fromRawArray (values); }
+        static void copyToRawArray (SIMDRegister<Type> sample, Type* values) noexcept        { sample.copyToRawArray (values); }
+    };
+   #endif
 }
 #endif
 
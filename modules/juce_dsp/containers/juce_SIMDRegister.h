@@ -190,6 +190,9 @@ struct SIMDRegister
     /** Multiplies another SIMDRegister to the receiver. */
     inline SIMDRegister& JUCE_VECTOR_CALLTYPE operator*= (SIMDRegister v) noexcept      { value = CmplxOps::mul (value, v.value); return *this; }
 
+    /** Divides the receiver by another SIMDRegister. Only available for float and double. */
+    inline SIMDRegister& JUCE_VECTOR_CALLTYPE operator/= (SIMDRegister v) noexcept      { value = divide (value, v.value); return *this; }
+
     //==============================================================================
     /** Broadcasts the scalar to all elements of the receiver. */
     inline SIMDRegister& JUCE_VECTOR_CALLTYPE operator=  (ElementType s) noexcept       { value  = CmplxOps::expand (s); return *this; }
@@ -203,6 +206,9 @@ struct SIMDRegister
     /** Multiplies a scalar to the receiver. */
     inline SIMDRegister& JUCE_VECTOR_CALLTYPE operator*= (ElementType s) noexcept       { value = CmplxOps::mul (value, CmplxOps::expand (s)); return *this; }
 
+    /** Divides the receiver by a scalar. Only available for float and double. */
+    inline SIMDRegister& JUCE_VECTOR_CALLTYPE operator/= (ElementType s) noexcept       { value = divide (value, CmplxOps::expand (s)); return *this; }
+
     //==============================================================================
     /** Bit-and the reciver with SIMDRegister v and store the result in the receiver. */
     inline SIMDRegister& JUCE_VECTOR_CALLTYPE operator&= (vMaskType v) noexcept         { value = NativeOps::bit_and (value, toVecType (v.value)); return *this; }
@@ -233,6 +239,9 @@ struct SIMDRegister
     /** Returns the product of the receiver and v.*/
     inline SIMDRegister JUCE_VECTOR_CALLTYPE operator* (SIMDRegister v) const noexcept  { return { CmplxOps::mul (value, v.value) }; }
 
+    /** Returns the quotient of the receiver and v. Only available for float and double. */
+    inline SIMDRegister JUCE_VECTOR_CALLTYPE operator/ (SIMDRegister v) const noexcept  { return { divide (value, v.value) }; }
+
     //==============================================================================
     /** Returns a vector where each element is the sum of the corresponding element in the receiver and the scalar s.*/
     inline SIMDRegister JUCE_VECTOR_CALLTYPE operator+ (ElementType s) const noexcept   { return { NativeOps::add (value, CmplxOps::expand (s)) }; }
@@ -243,6 +252,10 @@ struct SIMDRegister
     /** Returns a vector where each element is the product of the corresponding element in the receiver and the scalar s.*/
     inline SIMDRegister JUCE_VECTOR_CALLTYPE operator* (ElementType s) const noexcept   { return { CmplxOps::mul (value, CmplxOps::expand (s)) }; }
 
+    /** Returns a vector where each element is the corresponding element in the receiver divided by the scalar s.
+        Only available for float and double. */
+    inline SIMDRegister JUCE_VECTOR_CALLTYPE operator/ (ElementType s) const noexcept   { return { divide (value, CmplxOps::expand (s)) }; }
+
     //==============================================================================
     /** Returns the bit-and of the receiver and v. */
     inline SIMDRegister JUCE_VECTOR_CALLTYPE operator& (vMaskType v) const noexcept     { return { NativeOps::bit_and (value, toVecType (v.value)) }; }
@@ -354,6 +367,14 @@ struct SIMDRegister
    #endif
 
 private:
+    static inline vSIMDType JUCE_VECTOR_CALLTYPE divide (vSIMDType a, vSIMDType b) noexcept
+    {
+        static_assert (std::is_floating_point<ElementType>::value,
+                       "Only SIMDRegisters of float or double can be divided");
+
+        return NativeOps::div (a, b);
+    }
+
     static inline vMaskType JUCE_VECTOR_CALLTYPE toMaskType (vSIMDType a) noexcept
     {
         union
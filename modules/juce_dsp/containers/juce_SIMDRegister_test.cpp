@@ -713,6 +713,49 @@ public:
         }
     };
 
+    struct CheckDivision
+    {
+        template <typename type>
+        static void run (UnitTest& u, Random& random)
+        {
+            for (int i = 0; i < 100; ++i)
+            {
+                type array_a [SIMDRegister<type>::SIMDNumElements];
+                type array_b [SIMDRegister<type>::SIMDNumElements];
+                type array_c [SIMDRegister<type>::SIMDNumElements];
+                type array_d [SIMDRegister<type>::SIMDNumElements];
+
+                SIMDRegister_test_internal::VecFiller<type>::fill (array_a, SIMDRegister<type>::SIMDNumElements, random);
+
+                // keep the divisors away from zero
+                for (size_t j = 0; j < SIMDRegister<type>::SIMDNumElements; ++j)
+                    array_b[j] = static_cast<type> (1.0 + random.nextFloat() * 8.0);
+
+                for (size_t j = 0; j < SIMDRegister<type>::SIMDNumElements; ++j)
+                {
+                    array_c[j] = array_a[j] / array_b[j];
+                    array_d[j] = array_a[j] / static_cast<type> (4);
+                }
+
+                SIMDRegister<type> a (static_cast<type> (0));
+                SIMDRegister<type> b (static_cast<type> (0));
+
+                copy (a, array_a);
+                copy (b, array_b);
+
+                u.expect (vecEqualToArray (a / b, array_c));
+                u.expect (vecEqualToArray (a / static_cast<type> (4), array_d));
+
+                a /= b;
+                u.expect (vecEqualToArray (a, array_c));
+
+                copy (a, array_a);
+                a /= static_cast<type> (4);
+                u.expect (vecEqualToArray (a, array_d));
+            }
+        }
+    };
+
     struct CheckSum
     {
         template <typename type>
@@ -813,6 +856,17 @@ public:
         TheTest::template run<uint64_t>(*this, random);
     }
 
+    template <class TheTest>
+    void runTestFloatingPoint (const char* unitTestName)
+    {
+        beginTest (unitTestName);
+
+        Random random = getRandom();
+
+        TheTest::template run<float>   (*this, random);
+        TheTest::template run<double>  (*this, random);
+    }
+
     void runTest()
     {
         runTestForAllTypes<InitializationTest> ("InitializationTest");
@@ -831,6 +885,8 @@ public:
         runTestNonComplex<CheckBoolEquals> ("CheckBoolEquals");
         runTestNonComplex<CheckMinMax> ("CheckMinMax");
 
+        runTestFloatingPoint<CheckDivision> ("CheckDivision");
+
         runTestForAllTypes<CheckMultiplyAdd> ("CheckMultiplyAdd");
         runTestForAllTypes<CheckSum> ("CheckSum");
     }
@@ -88,5 +88,6 @@
 #endif
 #include "frequency/juce_FFT_test.cpp"
 #include "processors/juce_FIRFilter_test.cpp"
+#include "processors/juce_MultiVoiceFilter_test.cpp"
 #endif
 #endif
@@ -251,6 +251,7 @@ namespace juce
 #include "maths/juce_FastMathApproximations.h"
 #include "maths/juce_LookupTable.h"
 #include "containers/juce_AudioBlock.h"
+#include "maths/juce_FixedSizeMatrix.h"
 #include "processors/juce_ProcessContext.h"
 #include "processors/juce_ProcessorWrapper.h"
 #include "processors/juce_ProcessorChain.h"
@@ -263,6 +264,7 @@ namespace juce
 #include "processors/juce_Oscillator.h"
 #include "processors/juce_LadderFilter.h"
 #include "processors/juce_StateVariableFilter.h"
+#include "processors/juce_MultiVoiceLadderFilter.h"
 #include "processors/juce_Oversampling.h"
 #include "processors/juce_Reverb.h"
 #include "frequency/juce_FFT.h"
@@ -97,13 +97,15 @@ struct FastMathApproximations
 
         Note : this is an approximation which works on a limited range. You are
         advised to use input values only between -5 and +5 for limiting the error.
+
+        The FloatType can also be a SIMDRegister of float or double.
     */
     template <typename FloatType>
     static FloatType tanh (FloatType x) noexcept
     {
         auto x2 = x * x;
-        auto numerator = x * (135135 + x2 * (17325 + x2 * (378 + x2)));
-        auto denominator = 135135 + x2 * (62370 + x2 * (3150 + 28 * x2));
+        auto numerator = x * (((x2 + 378) * x2 + 17325) * x2 + 135135);
+        auto denominator = ((x2 * 28 + 3150) * x2 + 62370) * x2 + 135135;
         return numerator / denominator;
     }
 
@@ -182,13 +184,15 @@ struct FastMathApproximations
 
         Note : this is an approximation which works on a limited range. You are
         advised to use input values only between -pi/2 and +pi/2 for limiting the error.
+
+        The FloatType can also be a SIMDRegister of float or double.
     */
     template <typename FloatType>
     static FloatType tan (FloatType x) noexcept
     {
         auto x2 = x * x;
-        auto numerator = x * (-135135 + x2 * (17325 + x2 * (-378 + x2)));
-        auto denominator = -135135 + x2 * (62370 + x2 * (-3150 + 28 * x2));
+        auto numerator = x * (((x2 - 378) * x2 + 17325) * x2 - 135135);
+        auto denominator = ((x2 * 28 - 3150) * x2 + 62370) * x2 - 135135;
         return numerator / denominator;
     }
 
@@ -211,12 +215,14 @@ struct FastMathApproximations
 
         Note : this is an approximation which works on a limited range. You are
         advised to use input values only between -6 and +4 for limiting the error.
+
+        The FloatType can also be a SIMDRegister of float or double.
     */
     template <typename FloatType>
     static FloatType exp (FloatType x) noexcept
     {
-        auto numerator = 1680 + x * (840 + x * (180 + x * (20 + x)));
-        auto denominator = 1680 + x *(-840 + x * (180 + x * (-20 + x)));
+        auto numerator = (((x + 20) * x + 180) * x + 840) * x + 1680;
+        auto denominator = (((x - 20) * x + 180) * x - 840) * x + 1680;
         return numerator / denominator;
     }
 
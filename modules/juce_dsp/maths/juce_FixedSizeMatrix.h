@@ -0,0 +1,311 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 5 End-User License
+   Agreement and JUCE 5 Privacy Policy (both updated and effective as of the
+   27th April 2017).
+
+   End User License Agreement: www.juce.com/juce-5-licence
+   Privacy Policy: www.juce.com/juce-5-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+/**
+    A matrix whose dimensions are known at compile-time.
+
+    This is a lightweight alternative to the Matrix class for small matrices, such as
+    the coefficient matrices of ambisonic decoders or small channel mixers. Its
+    elements are stored inline in row-major order, so it never allocates, and all its
+    loops have constant trip counts which the compiler can unroll and vectorise.
+
+    @see Matrix
+
+    @tags{DSP}
+*/
+template <typename ElementType, size_t numRows, size_t numColumns>
+class FixedSizeMatrix
+{
+public:
+    //==============================================================================
+    /** Creates a matrix filled with zeroes. */
+    FixedSizeMatrix() noexcept                                  { clear(); }
+
+    /** Creates a matrix with initial data coming from an array, stored in row-major order. */
+    explicit FixedSizeMatrix (const ElementType* dataPointer) noexcept
+    {
+        std::copy (dataPointer, dataPointer + numRows * numColumns, data.begin());
+    }
+
+    /** Creates a matrix from a list of values, stored in row-major order. */
+    FixedSizeMatrix (std::initializer_list<ElementType> values) noexcept
+    {
+        jassert (values.size() == numRows * numColumns);
+        clear();
+        std::copy (values.begin(), values.begin() + jmin (values.size(), numRows * numColumns), data.begin());
+    }
+
+    /** Creates a fixed-size copy of a Matrix object, which must have the same dimensions. */
+    explicit FixedSizeMatrix (const Matrix<ElementType>& other) noexcept
+    {
+        jassert (other.getNumRows() == numRows && other.getNumColumns() == numColumns);
+        std::copy (other.begin(), other.end(), data.begin());
+    }
+
+    //==============================================================================
+    /** Creates the identity matrix. */
+    static FixedSizeMatrix identity() noexcept
+    {
+        static_assert (numRows == numColumns, "The identity matrix must be square");
+
+        FixedSizeMatrix result;
+
+        for (size_t i = 0; i < numRows; ++i)
+            result (i, i) = 1;
+
+        return result;
+    }
+
+    /** Returns a copy of this matrix as a dynamically-sized Matrix object. */
+    Matrix<ElementType> toMatrix() const               { return Matrix<ElementType> (numRows, numColumns, data.data()); }
+
+    //==============================================================================
+    /** Returns the number of rows in the matrix. */
+    static constexpr size_t getNumRows() noexcept      { return numRows; }
+
+    /** Returns the number of columns in the matrix. */
+    static constexpr size_t getNumColumns() noexcept   { return numColumns; }
+
+    /** Fills the contents of the matrix with zeroes. */
+    void clear() noexcept                              { data.fill (0); }
+
+    /** Returns the value of the matrix at a given row and column (for reading). */
+    inline ElementType operator() (size_t row, size_t column) const noexcept
+    {
+        jassert (row < numRows && column < numColumns);
+        return data[row * numColumns + column];
+    }
+
+    /** Returns the value of the matrix at a given row and column (for modifying). */
+    inline ElementType& operator() (size_t row, size_t column) noexcept
+    {
+        jassert (row < numRows && column < numColumns);
+        return data[row * numColumns + column];
+    }
+
+    /** Returns a pointer to the raw data of the matrix, in row-major order (for modifying). */
+    inline ElementType* getRawDataPointer() noexcept                  { return data.data(); }
+
+    /** Returns a pointer to the raw data of the matrix, in row-major order (for reading). */
+    inline const ElementType* getRawDataPointer() const noexcept      { return data.data(); }
+
+    //==============================================================================
+    /** Addition of two matrices */
+    FixedSizeMatrix& operator+= (const FixedSizeMatrix& other) noexcept
+    {
+        for (size_t i = 0; i < data.size(); ++i)
+            data[i] += other.data[i];
+
+        return *this;
+    }
+
+    /** Subtraction of two matrices */
+    FixedSizeMatrix& operator-= (const FixedSizeMatrix& other) noexcept
+    {
+        for (size_t i = 0; i < data.size(); ++i)
+            data[i] -= other.data[i];
+
+        return *this;
+    }
+
+    /** Scalar multiplication */
+    FixedSizeMatrix& operator*= (ElementType scalar) noexcept
+    {
+        for (auto& x : data)
+            x *= scalar;
+
+        return *this;
+    }
+
+    /** Addition of two matrices */
+    FixedSizeMatrix operator+ (const FixedSizeMatrix& other) const noexcept     { auto result (*this); result += other;  return result; }
+
+    /** Subtraction of two matrices */
+    FixedSizeMatrix operator- (const FixedSizeMatrix& other) const noexcept     { auto result (*this); result -= other;  return result; }
+
+    /** Scalar multiplication */
+    FixedSizeMatrix operator* (ElementType scalar) const noexcept               { auto result (*this); result *= scalar; return result; }
+
+    /** Matrix multiplication */
+    template <size_t otherNumColumns>
+    FixedSizeMatrix<ElementType, numRows, otherNumColumns> operator* (const FixedSizeMatrix<ElementType, numColumns, otherNumColumns>& other) const noexcept
+    {
+        FixedSizeMatrix<ElementType, numRows, otherNumColumns> result;
+
+        for (size_t i = 0; i < numRows; ++i)
+            for (size_t k = 0; k < numColumns; ++k)
+            {
+                auto aik = (*this) (i, k);
+
+                for (size_t j = 0; j < otherNumColumns; ++j)
+                    result (i, j) += aik * other (k, j);
+            }
+
+        return result;
+    }
+
+    /** Returns the transpose of this matrix. */
+    FixedSizeMatrix<ElementType, numColumns, numRows> transposed() const noexcept
+    {
+        FixedSizeMatrix<ElementType, numColumns, numRows> result;
+
+        for (size_t i = 0; i < numRows; ++i)
+            for (size_t j = 0; j < numColumns; ++j)
+                result (j, i) = (*this) (i, j);
+
+        return result;
+    }
+
+    //==============================================================================
+    /** Compare two matrices with a given tolerance */
+    static bool compare (const FixedSizeMatrix& a, const FixedSizeMatrix& b, ElementType tolerance = 0) noexcept
+    {
+        tolerance = std::abs (tolerance);
+
+        for (size_t i = 0; i < a.data.size(); ++i)
+            if (std::abs (a.data[i] - b.data[i]) > tolerance)
+                return false;
+
+        return true;
+    }
+
+    /* Comparison operator */
+    bool operator== (const FixedSizeMatrix& other) const noexcept     { return compare (*this, other); }
+
+    //==============================================================================
+    /** Solves the linear system of equations represented by this square matrix and the
+        vector b, using a Gaussian elimination with partial pivoting.
+
+        After the execution of the algorithm, the vector b will contain the solution.
+        Returns false if the matrix is singular, in which case b is left in an
+        undefined state.
+    */
+    bool solve (FixedSizeMatrix<ElementType, numRows, 1>& b) const noexcept
+    {
+        static_assert (numRows == numColumns, "Only square systems can be solved");
+
+        auto M = *this;
+        auto* x = b.getRawDataPointer();
+
+        for (size_t j = 0; j < numRows; ++j)
+        {
+            auto pivot = j;
+
+            for (auto i = j + 1; i < numRows; ++i)
+                if (std::abs (M (i, j)) > std::abs (M (pivot, j)))
+                    pivot = i;
+
+            if (M (pivot, j) == 0)
+                return false;
+
+            if (pivot != j)
+            {
+                for (size_t k = 0; k < numColumns; ++k)
+                    std::swap (M (j, k), M (pivot, k));
+
+                std::swap (x[j], x[pivot]);
+            }
+
+            auto t = 1 / M (j, j);
+
+            for (auto i = j + 1; i < numRows; ++i)
+            {
+                auto u = M (i, j) * t;
+
+                for (auto k = j; k < numColumns; ++k)
+                    M (i, k) -= u * M (j, k);
+
+                x[i] -= u * x[j];
+            }
+        }
+
+        for (auto i = numRows; i-- > 0;)
+        {
+            auto sum = x[i];
+
+            for (auto k = i + 1; k < numColumns; ++k)
+                sum -= M (i, k) * x[k];
+
+            x[i] = sum / M (i, i);
+        }
+
+        return true;
+    }
+
+    //==============================================================================
+    /** Mixes the channels of an AudioBlock through this matrix.
+
+        Each output channel i is set to the sum of the input channels j weighted by
+        the element (i, j) of the matrix. The input block must have numColumns
+        channels, the output block numRows channels, and they must have the same
+        number of samples and not share any channel data.
+
+        @see Matrix::mixChannels
+    */
+    void mixChannels (const AudioBlock<ElementType>& input, AudioBlock<ElementType>& output) const noexcept
+    {
+        jassert (input.getNumChannels() == numColumns && output.getNumChannels() == numRows);
+        jassert (input.getNumSamples() == output.getNumSamples());
+
+        auto numSamples = static_cast<int> (output.getNumSamples());
+
+        for (size_t i = 0; i < numRows; ++i)
+        {
+            auto* dst = output.getChannelPointer (i);
+
+            if (numColumns == 0)
+            {
+                FloatVectorOperations::clear (dst, numSamples);
+                continue;
+            }
+
+            FloatVectorOperations::copyWithMultiply (dst, input.getChannelPointer (0), (*this) (i, 0), numSamples);
+
+            for (size_t j = 1; j < numColumns; ++j)
+                if ((*this) (i, j) != 0)
+                    FloatVectorOperations::addWithMultiply (dst, input.getChannelPointer (j), (*this) (i, j), numSamples);
+        }
+    }
+
+    //==============================================================================
+    ElementType* begin() noexcept                   { return data.data(); }
+    ElementType* end() noexcept                     { return data.data() + data.size(); }
+
+    const ElementType* begin() const noexcept       { return data.data(); }
+    const ElementType* end() const noexcept         { return data.data() + data.size(); }
+
+private:
+    //==============================================================================
+    std::array<ElementType, numRows * numColumns> data;
+};
+
+} // namespace dsp
+} // namespace juce
@@ -109,6 +109,61 @@ Matrix<ElementType>& Matrix<ElementType>::swapRows (size_t rowOne, size_t rowTwo
     return *this;
 }
 
+//==============================================================================
+namespace MatrixHelpers
+{
+    // The blocking sizes are chosen so that a panel of the right-hand matrix, and the
+    // strip of the result which is being accumulated, both stay in the cache.
+    static constexpr size_t innerBlockSize  = 64;
+    static constexpr size_t columnBlockSize = 256;
+
+    // Below this width, the overhead of calling the vector operations isn't worth it.
+    static constexpr size_t minColumnsForVectorOps = 8;
+
+    // The number of samples of each channel which are mixed in one pass.
+    static constexpr size_t mixingBlockSize = 256;
+
+   #if JUCE_USE_SIMD
+    template <typename ElementType>
+    static inline SIMDRegister<ElementType> loadUnaligned (const ElementType* source) noexcept
+    {
+        SIMDRegister<ElementType> reg;
+        memcpy (&reg.value, source, sizeof (reg.value)); // this compiles to a single unaligned load
+        return reg;
+    }
+   #endif
+
+    template <typename ElementType>
+    static ElementType dotProduct (const ElementType* a, const ElementType* b, size_t num) noexcept
+    {
+        ElementType result = 0;
+        size_t i = 0;
+
+       #if JUCE_USE_SIMD
+        using Register = SIMDRegister<ElementType>;
+        constexpr auto numLanes = Register::SIMDNumElements;
+
+        if (num >= 2 * numLanes)
+        {
+            auto sum1 = Register::expand (0), sum2 = Register::expand (0);
+
+            for (; i + 2 * numLanes <= num; i += 2 * numLanes)
+            {
+                sum1 += loadUnaligned (a + i) * loadUnaligned (b + i);
+                sum2 += loadUnaligned (a + i + numLanes) * loadUnaligned (b + i + numLanes);
+            }
+
+            result = (sum1 + sum2).sum();
+        }
+       #endif
+
+        for (; i < num; ++i)
+            result += a[i] * b[i];
+
+        return result;
+    }
+}
+
 //==============================================================================
 template <typename ElementType>
 Matrix<ElementType> Matrix<ElementType>::operator* (const Matrix<ElementType>& other) const
@@ -118,32 +173,101 @@ Matrix<ElementType> Matrix<ElementType>::operator* (const Matrix<ElementType>& o
 
     jassert (p == other.getNumRows());
 
-    size_t offsetMat = 0, offsetlhs = 0;
-
     auto* dst = result.getRawDataPointer();
     auto* a = getRawDataPointer();
     auto* b = other.getRawDataPointer();
 
-    for (size_t i = 0; i < n; ++i)
+    if (m == 1)
     {
-        size_t offsetrhs = 0;
+        for (size_t i = 0; i < n; ++i)
+            dst[i] = MatrixHelpers::dotProduct (a + i * p, b, p);
+
+        return result;
+    }
 
-        for (size_t k = 0; k < p; ++k)
+    if (m < MatrixHelpers::minColumnsForVectorOps)
+    {
+        size_t offsetMat = 0, offsetlhs = 0;
+
+        for (size_t i = 0; i < n; ++i)
         {
-            auto ak = a[offsetlhs++];
+            size_t offsetrhs = 0;
+
+            for (size_t k = 0; k < p; ++k)
+            {
+                auto ak = a[offsetlhs++];
 
-            for (size_t j = 0; j < m; ++j)
-                dst[offsetMat + j] += ak * b[offsetrhs + j];
+                for (size_t j = 0; j < m; ++j)
+                    dst[offsetMat + j] += ak * b[offsetrhs + j];
 
-            offsetrhs += m;
+                offsetrhs += m;
+            }
+
+            offsetMat += m;
         }
 
-        offsetMat += m;
+        return result;
+    }
+
+    for (size_t k0 = 0; k0 < p; k0 += MatrixHelpers::innerBlockSize)
+    {
+        auto kEnd = jmin (p, k0 + MatrixHelpers::innerBlockSize);
+
+        for (size_t j0 = 0; j0 < m; j0 += MatrixHelpers::columnBlockSize)
+        {
+            auto numColumnsInBlock = static_cast<int> (jmin (MatrixHelpers::columnBlockSize, m - j0));
+
+            for (size_t i = 0; i < n; ++i)
+            {
+                auto* dstRow = dst + i * m + j0;
+                auto* lhsRow = a + i * p;
+
+                for (size_t k = k0; k < kEnd; ++k)
+                    FloatVectorOperations::addWithMultiply (dstRow, b + k * m + j0, lhsRow[k], numColumnsInBlock);
+            }
+        }
     }
 
     return result;
 }
 
+//==============================================================================
+template <typename ElementType>
+void Matrix<ElementType>::mixChannels (const AudioBlock<ElementType>& input, AudioBlock<ElementType>& output) const noexcept
+{
+    auto numInputs  = input.getNumChannels();
+    auto numOutputs = output.getNumChannels();
+    auto numSamples = output.getNumSamples();
+
+    jassert (rows == numOutputs && columns == numInputs);
+    jassert (input.getNumSamples() == numSamples);
+
+    auto* gains = getRawDataPointer();
+
+    for (size_t start = 0; start < numSamples; start += MatrixHelpers::mixingBlockSize)
+    {
+        auto num = static_cast<int> (jmin (MatrixHelpers::mixingBlockSize, numSamples - start));
+
+        for (size_t i = 0; i < numOutputs; ++i)
+        {
+            auto* dst = output.getChannelPointer (i) + start;
+            auto* rowGains = gains + i * columns;
+
+            if (numInputs == 0)
+            {
+                FloatVectorOperations::clear (dst, num);
+                continue;
+            }
+
+            FloatVectorOperations::copyWithMultiply (dst, input.getChannelPointer (0) + start, rowGains[0], num);
+
+            for (size_t j = 1; j < numInputs; ++j)
+                if (rowGains[j] != 0)
+                    FloatVectorOperations::addWithMultiply (dst, input.getChannelPointer (j) + start, rowGains[j], num);
+        }
+    }
+}
+
 //==============================================================================
 template <typename ElementType>
 bool Matrix<ElementType>::compare (const Matrix& a, const Matrix& b, ElementType tolerance) noexcept
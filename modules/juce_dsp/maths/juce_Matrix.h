@@ -29,6 +29,8 @@ namespace juce
 namespace dsp
 {
 
+template <typename SampleType> class AudioBlock;
+
 /**
     General matrix and vectors class, meant for classic math manipulation such as
     additions, multiplications, and linear systems of equations solving.
@@ -158,7 +160,12 @@ public:
     /** Scalar multiplication */
     inline Matrix operator* (ElementType scalar) const                  { Matrix result (*this); result *= scalar; return result; }
 
-    /** Matrix multiplication */
+    /** Matrix multiplication.
+
+        Large products are computed with a cache-blocked kernel which uses the
+        vectorised FloatVectorOperations for its inner loops, and multiplications
+        by a one column vector use a SIMD dot product.
+    */
     Matrix operator* (const Matrix& other) const;
 
     /** Does a hadarmard product with the receiver and other and stores the result in the receiver */
@@ -202,6 +209,20 @@ public:
      */
     bool solve (Matrix& b) const noexcept;
 
+    //==============================================================================
+    /** Mixes the channels of an AudioBlock through this matrix.
+
+        Each output channel i is set to the sum of the input channels j weighted by
+        the element (i, j) of the matrix, so the matrix must have as many rows as
+        the output block has channels, and as many columns as the input block has
+        channels. This is the typical operation for a MIMO mixer or an ambisonic
+        decoder.
+
+        The input and output blocks must have the same number of samples, and must
+        not share any channel data.
+    */
+    void mixChannels (const AudioBlock<ElementType>& input, AudioBlock<ElementType>& output) const noexcept;
+
     //==============================================================================
     /** Returns a String displaying in a convenient way the matrix contents. */
     String toString() const;
@@ -145,6 +145,165 @@ struct LinearAlgebraUnitTest  : public UnitTest
         }
     };
 
+    template <typename ElementType>
+    static Matrix<ElementType> createRandomMatrix (Random& random, size_t numRows, size_t numColumns)
+    {
+        Matrix<ElementType> result (numRows, numColumns);
+
+        for (auto& x : result)
+            x = static_cast<ElementType> (random.nextDouble() * 2.0 - 1.0);
+
+        return result;
+    }
+
+    // The straightforward triple loop which the blocked kernels are checked against
+    template <typename ElementType>
+    static Matrix<ElementType> referenceMultiply (const Matrix<ElementType>& a, const Matrix<ElementType>& b)
+    {
+        auto n = a.getNumRows(), m = b.getNumColumns(), p = a.getNumColumns();
+        Matrix<ElementType> result (n, m);
+
+        auto* dst = result.getRawDataPointer();
+        auto* lhs = a.getRawDataPointer();
+        auto* rhs = b.getRawDataPointer();
+
+        for (size_t i = 0; i < n; ++i)
+            for (size_t k = 0; k < p; ++k)
+                for (size_t j = 0; j < m; ++j)
+                    dst[i * m + j] += lhs[i * p + k] * rhs[k * m + j];
+
+        return result;
+    }
+
+    struct BlockedMultiplicationTest
+    {
+        template <typename ElementType>
+        static void run (LinearAlgebraUnitTest& u)
+        {
+            auto random = u.getRandom();
+
+            const size_t sizes[][3] = { { 3, 5, 4 }, { 37, 70, 300 }, { 64, 64, 64 }, { 130, 9, 11 }, { 17, 201, 1 }, { 5, 3, 1 } };
+
+            for (auto& size : sizes)
+            {
+                auto a = createRandomMatrix<ElementType> (random, size[0], size[1]);
+                auto b = createRandomMatrix<ElementType> (random, size[1], size[2]);
+
+                u.expect (Matrix<ElementType>::compare (a * b, referenceMultiply (a, b), (ElementType) 1e-4));
+            }
+        }
+    };
+
+    struct MixChannelsTest
+    {
+        template <typename ElementType>
+        static void run (LinearAlgebraUnitTest& u)
+        {
+            auto random = u.getRandom();
+            const int numInputs = 5, numOutputs = 3, numSamples = 700;
+
+            auto gains = createRandomMatrix<ElementType> (random, numOutputs, numInputs);
+            gains (1, 2) = 0;
+
+            AudioBuffer<ElementType> input (numInputs, numSamples), output (numOutputs, numSamples);
+
+            for (int ch = 0; ch < numInputs; ++ch)
+                for (int i = 0; i < numSamples; ++i)
+                    input.setSample (ch, i, static_cast<ElementType> (random.nextDouble() * 2.0 - 1.0));
+
+            AudioBlock<ElementType> inputBlock (input), outputBlock (output);
+            gains.mixChannels (inputBlock, outputBlock);
+
+            FixedSizeMatrix<ElementType, numOutputs, numInputs> fixedGains (gains);
+            AudioBuffer<ElementType> fixedOutput (numOutputs, numSamples);
+            AudioBlock<ElementType> fixedOutputBlock (fixedOutput);
+            fixedGains.mixChannels (inputBlock, fixedOutputBlock);
+
+            bool allMatch = true;
+
+            for (int ch = 0; ch < numOutputs; ++ch)
+            {
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    ElementType expected = 0;
+
+                    for (int j = 0; j < numInputs; ++j)
+                        expected += gains ((size_t) ch, (size_t) j) * input.getSample (j, i);
+
+                    allMatch = allMatch && std::abs (output.getSample (ch, i) - expected) < (ElementType) 1e-4
+                                        && std::abs (fixedOutput.getSample (ch, i) - expected) < (ElementType) 1e-4;
+                }
+            }
+
+            u.expect (allMatch);
+        }
+    };
+
+    struct FixedSizeMatrixTest
+    {
+        template <typename ElementType>
+        static void run (LinearAlgebraUnitTest& u)
+        {
+            using Mat24 = FixedSizeMatrix<ElementType, 2, 4>;
+            using Mat42 = FixedSizeMatrix<ElementType, 4, 2>;
+            using Mat22 = FixedSizeMatrix<ElementType, 2, 2>;
+
+            Mat24 mat1 { 1,  2, 3,  4,  5,  6,  7,  8 };
+            Mat42 mat2 { 1, -1, 3, -1,  5, -1,  7, -1 };
+
+            u.expect ((mat1 * mat2) == Mat22 { 50, -10, 114, -26 });
+            u.expect ((mat1 + mat1) == mat1 * (ElementType) 2);
+            u.expect (mat1.transposed().transposed() == mat1);
+            u.expect (Matrix<ElementType>::compare ((mat1 * mat2).toMatrix(), mat1.toMatrix() * mat2.toMatrix()));
+
+            const ElementType a[] = { 1, 4, 2, 1, -1, 1, 4, 3, -2, -1, 1, 1, -1, 0, 1, 4 };
+            FixedSizeMatrix<ElementType, 4, 4> A (a);
+            FixedSizeMatrix<ElementType, 4, 1> B { -1, 0, -1, -7 }, X { 1, -1, 2, -2 };
+
+            u.expect (A.solve (B));
+            u.expect (FixedSizeMatrix<ElementType, 4, 1>::compare (X, B, (ElementType) 1e-4));
+            u.expect ((FixedSizeMatrix<ElementType, 4, 4>::identity() * A) == A);
+
+            FixedSizeMatrix<ElementType, 2, 1> y;
+            u.expect (! Mat22 { 1, 2, 2, 4 }.solve (y));
+        }
+    };
+
+    void runMultiplicationBenchmark()
+    {
+        beginTest ("MultiplicationBenchmark");
+
+        // A 64x64 mixing matrix applied to a block of 512 samples, and a 64x64 product.
+        const size_t sizes[][3] = { { 64, 64, 512 }, { 64, 64, 64 } };
+        const int numIterations = 20;
+        auto random = getRandom();
+
+        for (auto& size : sizes)
+        {
+            auto a = createRandomMatrix<float> (random, size[0], size[1]);
+            auto b = createRandomMatrix<float> (random, size[1], size[2]);
+
+            auto startTicks = Time::getHighResolutionTicks();
+
+            for (int i = 0; i < numIterations; ++i)
+                referenceMultiply (a, b);
+
+            auto referenceTicks = Time::getHighResolutionTicks() - startTicks;
+            startTicks = Time::getHighResolutionTicks();
+
+            for (int i = 0; i < numIterations; ++i)
+                a * b;
+
+            auto blockedTicks = Time::getHighResolutionTicks() - startTicks;
+
+            logMessage ("  " + String (size[0]) + "x" + String (size[1]) + " * " + String (size[1]) + "x" + String (size[2])
+                          + ": naive " + String (Time::highResolutionTicksToSeconds (referenceTicks) * 1000.0 / numIterations, 3)
+                          + " ms, blocked " + String (Time::highResolutionTicksToSeconds (blockedTicks) * 1000.0 / numIterations, 3) + " ms");
+
+            expect (Matrix<float>::compare (a * b, referenceMultiply (a, b), 1e-3f));
+        }
+    }
+
     template <class TheTest>
     void runTestForAllTypes (const char* unitTestName)
     {
@@ -163,6 +322,11 @@ struct LinearAlgebraUnitTest  : public UnitTest
         runTestForAllTypes<MultiplicationTest> ("MultiplicationTest");
         runTestForAllTypes<IdentityMatrixTest> ("IdentityMatrixTest");
         runTestForAllTypes<SolvingTest> ("SolvingTest");
+        runTestForAllTypes<BlockedMultiplicationTest> ("BlockedMultiplicationTest");
+        runTestForAllTypes<MixChannelsTest> ("MixChannelsTest");
+        runTestForAllTypes<FixedSizeMatrixTest> ("FixedSizeMatrixTest");
+
+        runMultiplicationBenchmark();
     }
 };
 
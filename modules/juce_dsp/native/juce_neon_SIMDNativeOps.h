@@ -413,6 +413,20 @@ struct SIMDNativeOps<float>
     static forcedinline vSIMDType add (vSIMDType a, vSIMDType b) noexcept                      { return vaddq_f32 (a, b); }
     static forcedinline vSIMDType sub (vSIMDType a, vSIMDType b) noexcept                      { return vsubq_f32 (a, b); }
     static forcedinline vSIMDType mul (vSIMDType a, vSIMDType b) noexcept                      { return vmulq_f32 (a, b); }
+
+    static forcedinline vSIMDType div (vSIMDType a, vSIMDType b) noexcept
+    {
+       #if defined (__arm64__) || defined (__aarch64__)
+        return vdivq_f32 (a, b);
+       #else
+        // 32-bit NEON has no division, so refine the reciprocal estimate twice
+        auto r = vrecpeq_f32 (b);
+        r = vmulq_f32 (vrecpsq_f32 (b, r), r);
+        r = vmulq_f32 (vrecpsq_f32 (b, r), r);
+        return vmulq_f32 (a, r);
+       #endif
+    }
+
     static forcedinline vSIMDType bit_and (vSIMDType a, vSIMDType b) noexcept                  { return (vSIMDType) vandq_u32 ((vMaskType) a, (vMaskType) b); }
     static forcedinline vSIMDType bit_or  (vSIMDType a, vSIMDType b) noexcept                  { return (vSIMDType) vorrq_u32 ((vMaskType) a, (vMaskType) b); }
     static forcedinline vSIMDType bit_xor (vSIMDType a, vSIMDType b) noexcept                  { return (vSIMDType) veorq_u32 ((vMaskType) a, (vMaskType) b); }
@@ -467,6 +481,7 @@ struct SIMDNativeOps<double>
     static forcedinline vSIMDType add (vSIMDType a, vSIMDType b) noexcept                      { return {{a.v[0] + b.v[0], a.v[1] + b.v[1]}}; }
     static forcedinline vSIMDType sub (vSIMDType a, vSIMDType b) noexcept                      { return {{a.v[0] - b.v[0], a.v[1] - b.v[1]}}; }
     static forcedinline vSIMDType mul (vSIMDType a, vSIMDType b) noexcept                      { return {{a.v[0] * b.v[0], a.v[1] * b.v[1]}}; }
+    static forcedinline vSIMDType div (vSIMDType a, vSIMDType b) noexcept                      { return {{a.v[0] / b.v[0], a.v[1] / b.v[1]}}; }
     static forcedinline vSIMDType bit_and (vSIMDType a, vSIMDType b) noexcept                  { return fb::bit_and (a, b); }
     static forcedinline vSIMDType bit_or  (vSIMDType a, vSIMDType b) noexcept                  { return fb::bit_or  (a, b); }
     static forcedinline vSIMDType bit_xor (vSIMDType a, vSIMDType b) noexcept                  { return fb::bit_xor (a, b); }
@@ -0,0 +1,355 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 5 End-User License
+   Agreement and JUCE 5 Privacy Policy (both updated and effective as of the
+   27th April 2017).
+
+   End User License Agreement: www.juce.com/juce-5-licence
+   Privacy Policy: www.juce.com/juce-5-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+class MultiVoiceFilterTest : public UnitTest
+{
+public:
+    MultiVoiceFilterTest() : UnitTest ("Multi-voice filters", "DSP") {}
+
+    void runTest() override
+    {
+        beginTest ("State variable filter");
+        runTestForAllTypes<StateVariableFilterTest>();
+
+        beginTest ("Ladder filter");
+        runTestForAllTypes<LadderFilterTest>();
+
+        beginTest ("Changing the sample rate");
+        runTestForAllTypes<SampleRateChangeTest>();
+
+        beginTest ("Voices per core benchmark");
+        runBenchmark<float>();
+       #if JUCE_USE_SIMD
+        runBenchmark<SIMDRegister<float>>();
+       #endif
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr size_t numSamples = 1000;
+
+    template <typename NumericType>
+    static NumericType getVoiceCutoff (size_t voice)     { return static_cast<NumericType> (300.0 * (1.0 + 1.7 * (double) voice)); }
+
+    template <typename NumericType>
+    static NumericType getVoiceResonance (size_t voice)  { return static_cast<NumericType> (0.2 + 0.1 * (double) voice); }
+
+    // Builds a sample which holds the given value for each voice
+    template <typename SampleType, typename Function>
+    static SampleType createLanes (Function getValueForVoice)
+    {
+        using NumericType = typename SampleTypeHelpers::ElementType<SampleType>::Type;
+        constexpr auto numVoices = SampleTypeHelpers::Lanes<SampleType>::size;
+
+        alignas (SampleType) NumericType values[numVoices];
+
+        for (size_t v = 0; v < numVoices; ++v)
+            values[v] = getValueForVoice (v);
+
+        return SampleTypeHelpers::Lanes<SampleType>::fromRawArray (values);
+    }
+
+    //==============================================================================
+    struct StateVariableFilterTest
+    {
+        template <typename SampleType>
+        static void run (MultiVoiceFilterTest& u, const float* noise)
+        {
+            using NumericType = typename SampleTypeHelpers::ElementType<SampleType>::Type;
+            using Type = typename StateVariableFilter::Parameters<NumericType>::Type;
+            constexpr auto numVoices = SampleTypeHelpers::Lanes<SampleType>::size;
+
+            for (auto type : { Type::lowPass, Type::bandPass, Type::highPass })
+            {
+                StateVariableFilter::MultiVoiceFilter<SampleType> filter;
+                filter.prepare ({ sampleRate, (uint32) numSamples, 1 });
+                filter.setType (type);
+                filter.setCutoffFrequency (createLanes<SampleType> (getVoiceCutoff<NumericType>),
+                                           createLanes<SampleType> ([] (size_t v) { return NumericType (0.5) + getVoiceResonance<NumericType> (v); }));
+
+                HeapBlock<char> blockData;
+                AudioBlock<SampleType> block (blockData, 1, numSamples);
+                auto* samples = reinterpret_cast<NumericType*> (block.getChannelPointer (0));
+
+                for (size_t i = 0; i < numSamples * numVoices; ++i)
+                    samples[i] = static_cast<NumericType> (noise[i]);
+
+                filter.process (ProcessContextReplacing<SampleType> (block));
+
+                NumericType maxError = 0;
+
+                for (size_t v = 0; v < numVoices; ++v)
+                {
+                    StateVariableFilter::Filter<NumericType> reference;
+                    reference.parameters->type = type;
+                    reference.parameters->setCutOffFrequency (sampleRate, getVoiceCutoff<NumericType> (v),
+                                                              NumericType (0.5) + getVoiceResonance<NumericType> (v));
+
+                    for (size_t i = 0; i < numSamples; ++i)
+                    {
+                        auto expected = reference.processSample (static_cast<NumericType> (noise[i * numVoices + v]));
+                        maxError = jmax (maxError, std::abs (expected - samples[i * numVoices + v]));
+                    }
+                }
+
+                u.expect (maxError < NumericType (1e-3), "Error was " + String (maxError));
+            }
+        }
+    };
+
+    struct LadderFilterTest
+    {
+        template <typename SampleType>
+        static void run (MultiVoiceFilterTest& u, const float* noise)
+        {
+            using NumericType = typename SampleTypeHelpers::ElementType<SampleType>::Type;
+            using Mode = typename LadderFilter<NumericType>::Mode;
+            constexpr auto numVoices = SampleTypeHelpers::Lanes<SampleType>::size;
+
+            for (auto mode : { Mode::LPF12, Mode::HPF12, Mode::LPF24, Mode::HPF24 })
+            {
+                MultiVoiceLadderFilter<SampleType> filter;
+                filter.prepare ({ sampleRate, (uint32) numSamples, 1 });
+                filter.setMode (mode);
+                filter.setDrive (NumericType (2));
+
+                HeapBlock<char> inputData, outputData;
+                AudioBlock<SampleType> input (inputData, 1, numSamples), output (outputData, 1, numSamples);
+                auto* inputSamples = reinterpret_cast<NumericType*> (input.getChannelPointer (0));
+                auto* outputSamples = reinterpret_cast<NumericType*> (output.getChannelPointer (0));
+
+                for (size_t i = 0; i < numSamples * numVoices; ++i)
+                    inputSamples[i] = static_cast<NumericType> (noise[i]);
+
+                // Modulating with constant values must be the same as setting them
+                HeapBlock<char> cutoffData, resonanceData;
+                auto* cutoffs    = AudioBlock<SampleType> (cutoffData,    1, numSamples).getChannelPointer (0);
+                auto* resonances = AudioBlock<SampleType> (resonanceData, 1, numSamples).getChannelPointer (0);
+
+                for (size_t i = 0; i < numSamples; ++i)
+                {
+                    cutoffs[i] = createLanes<SampleType> (getVoiceCutoff<NumericType>);
+                    resonances[i] = createLanes<SampleType> (getVoiceResonance<NumericType>);
+                }
+
+                filter.process (input.getChannelPointer (0), output.getChannelPointer (0),
+                                cutoffs, resonances, numSamples);
+
+                NumericType maxError = 0;
+
+                for (size_t v = 0; v < numVoices; ++v)
+                {
+                    LadderFilter<NumericType> reference;
+                    reference.prepare ({ sampleRate, (uint32) numSamples, 1 });
+                    reference.setMode (mode);
+                    reference.setDrive (NumericType (2));
+                    reference.setCutoffFrequencyHz (getVoiceCutoff<NumericType> (v));
+                    reference.setResonance (getVoiceResonance<NumericType> (v));
+                    reference.reset();
+
+                    HeapBlock<char> referenceData;
+                    AudioBlock<NumericType> referenceBlock (referenceData, 1, numSamples);
+
+                    for (size_t i = 0; i < numSamples; ++i)
+                        referenceBlock.getChannelPointer (0)[i] = static_cast<NumericType> (noise[i * numVoices + v]);
+
+                    reference.process (ProcessContextReplacing<NumericType> (referenceBlock));
+
+                    for (size_t i = 0; i < numSamples; ++i)
+                        maxError = jmax (maxError, std::abs (referenceBlock.getChannelPointer (0)[i] - outputSamples[i * numVoices + v]));
+                }
+
+                u.expect (maxError < NumericType (1e-2), "Error was " + String (maxError));
+            }
+        }
+    };
+
+    // The parameters set before prepare() is called must be kept at the new sample rate
+    struct SampleRateChangeTest
+    {
+        template <typename SampleType>
+        static void run (MultiVoiceFilterTest& u, const float* noise)
+        {
+            using NumericType = typename SampleTypeHelpers::ElementType<SampleType>::Type;
+            const ProcessSpec oldSpec { 22050.0, (uint32) numSamples, 1 }, newSpec { sampleRate, (uint32) numSamples, 1 };
+
+            auto cutoffs    = createLanes<SampleType> (getVoiceCutoff<NumericType>);
+            auto resonances = createLanes<SampleType> ([] (size_t v) { return NumericType (0.5) + getVoiceResonance<NumericType> (v); });
+
+            {
+                StateVariableFilter::MultiVoiceFilter<SampleType> filter, reference;
+                filter.prepare (oldSpec);
+                filter.setCutoffFrequency (cutoffs, resonances);
+                filter.prepare (newSpec);
+
+                reference.prepare (newSpec);
+                reference.setCutoffFrequency (cutoffs, resonances);
+
+                u.expect (getMaxDifference<SampleType> (filter, reference, noise) < NumericType (1e-6));
+
+                // the default cutoff frequency is 200Hz
+                StateVariableFilter::MultiVoiceFilter<SampleType> defaultFilter, defaultReference;
+                defaultFilter.prepare (newSpec);
+                defaultReference.prepare (newSpec);
+                defaultReference.setCutoffFrequency (createLanes<SampleType> ([] (size_t) { return NumericType (200); }),
+                                                     createLanes<SampleType> ([] (size_t) { return static_cast<NumericType> (1.0 / MathConstants<double>::sqrt2); }));
+
+                u.expect (getMaxDifference<SampleType> (defaultFilter, defaultReference, noise) < NumericType (1e-6));
+            }
+
+            {
+                MultiVoiceLadderFilter<SampleType> filter, reference;
+                filter.setCutoffFrequencyHz (cutoffs);
+                filter.prepare (oldSpec);
+                filter.prepare (newSpec);
+
+                reference.prepare (newSpec);
+                reference.setCutoffFrequencyHz (cutoffs);
+
+                u.expect (getMaxDifference<SampleType> (filter, reference, noise) < NumericType (1e-6));
+
+                MultiVoiceLadderFilter<SampleType> defaultFilter, defaultReference;
+                defaultFilter.prepare (newSpec);
+                defaultReference.prepare (newSpec);
+                defaultReference.setCutoffFrequencyHz (createLanes<SampleType> ([] (size_t) { return NumericType (200); }));
+
+                u.expect (getMaxDifference<SampleType> (defaultFilter, defaultReference, noise) < NumericType (1e-6));
+            }
+        }
+
+        template <typename SampleType, typename FilterType>
+        static typename SampleTypeHelpers::ElementType<SampleType>::Type getMaxDifference (FilterType& filter, FilterType& reference, const float* noise)
+        {
+            using NumericType = typename SampleTypeHelpers::ElementType<SampleType>::Type;
+            constexpr auto numVoices = SampleTypeHelpers::Lanes<SampleType>::size;
+            NumericType maxDifference = 0;
+
+            for (size_t i = 0; i < numSamples; ++i)
+            {
+                auto input = createLanes<SampleType> ([=] (size_t v) { return static_cast<NumericType> (noise[i * numVoices + v]); });
+
+                alignas (SampleType) NumericType filtered[numVoices], expected[numVoices];
+                SampleTypeHelpers::Lanes<SampleType>::copyToRawArray (filter.processSample (input), filtered);
+                SampleTypeHelpers::Lanes<SampleType>::copyToRawArray (reference.processSample (input), expected);
+
+                for (size_t v = 0; v < numVoices; ++v)
+                    maxDifference = jmax (maxDifference, std::abs (filtered[v] - expected[v]));
+            }
+
+            return maxDifference;
+        }
+    };
+
+    template <typename TheTest>
+    void runTestForAllTypes()
+    {
+        auto random = getRandom();
+        HeapBlock<float> noise (numSamples * 8);
+
+        for (size_t i = 0; i < numSamples * 8; ++i)
+            noise[i] = random.nextFloat() * 2.0f - 1.0f;
+
+        TheTest::template run<float> (*this, noise);
+        TheTest::template run<double> (*this, noise);
+       #if JUCE_USE_SIMD
+        TheTest::template run<SIMDRegister<float>> (*this, noise);
+        TheTest::template run<SIMDRegister<double>> (*this, noise);
+       #endif
+    }
+
+    //==============================================================================
+    // Measures how many voices with audio-rate cutoff modulation can run in real time
+    // on one core, compared to running one of the existing scalar filters per voice.
+    template <typename SampleType>
+    void runBenchmark()
+    {
+        using NumericType = typename SampleTypeHelpers::ElementType<SampleType>::Type;
+        constexpr auto numVoices = SampleTypeHelpers::Lanes<SampleType>::size;
+        constexpr size_t numBenchmarkSamples = 48000;
+        const auto secondsOfAudio = (double) numBenchmarkSamples / sampleRate;
+
+        HeapBlock<char> blockData;
+        AudioBlock<SampleType> block (blockData, 1, numBenchmarkSamples);
+        HeapBlock<char> cutoffData, resonanceData;
+        auto* cutoffs    = AudioBlock<SampleType> (cutoffData,    1, numBenchmarkSamples).getChannelPointer (0);
+        auto* resonances = AudioBlock<SampleType> (resonanceData, 1, numBenchmarkSamples).getChannelPointer (0);
+
+        for (size_t i = 0; i < numBenchmarkSamples; ++i)
+        {
+            auto lfo = std::sin (MathConstants<double>::twoPi * 5.0 * (double) i / sampleRate);
+            cutoffs[i] = createLanes<SampleType> ([lfo] (size_t v) { return static_cast<NumericType> (1000.0 + 800.0 * lfo + 100.0 * (double) v); });
+            resonances[i] = createLanes<SampleType> ([] (size_t) { return NumericType (0.7); });
+        }
+
+        auto* samples = block.getChannelPointer (0);
+        block.clear();
+
+        StateVariableFilter::MultiVoiceFilter<SampleType> svf;
+        svf.prepare ({ sampleRate, (uint32) numBenchmarkSamples, 1 });
+
+        auto startTicks = Time::getHighResolutionTicks();
+        svf.process (samples, samples, cutoffs, resonances, numBenchmarkSamples);
+        auto svfSeconds = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - startTicks);
+
+        MultiVoiceLadderFilter<SampleType> ladder;
+        ladder.prepare ({ sampleRate, (uint32) numBenchmarkSamples, 1 });
+
+        startTicks = Time::getHighResolutionTicks();
+        ladder.process (samples, samples, cutoffs, resonances, numBenchmarkSamples);
+        auto ladderSeconds = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - startTicks);
+
+        // The existing filter, with its coefficients recomputed for every sample
+        StateVariableFilter::Filter<NumericType> scalarFilter;
+        NumericType scalarSample = 0;
+
+        startTicks = Time::getHighResolutionTicks();
+
+        for (size_t i = 0; i < numBenchmarkSamples; ++i)
+        {
+            scalarFilter.parameters->setCutOffFrequency (sampleRate, static_cast<NumericType> (1000.0 + 800.0 * std::sin (MathConstants<double>::twoPi * 5.0 * (double) i / sampleRate)));
+            scalarSample = scalarFilter.processSample (scalarSample);
+        }
+
+        auto scalarSeconds = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - startTicks);
+
+        logMessage ("  " + String ((int) numVoices) + " voice(s) per sample: state variable "
+                      + String (roundToInt (numVoices * secondsOfAudio / jmax (svfSeconds, 1.0e-9))) + " voices/core, ladder "
+                      + String (roundToInt (numVoices * secondsOfAudio / jmax (ladderSeconds, 1.0e-9))) + " voices/core, scalar state variable "
+                      + String (roundToInt (secondsOfAudio / jmax (scalarSeconds, 1.0e-9))) + " voices/core");
+
+        expect (svfSeconds > 0 && ladderSeconds > 0);
+    }
+};
+
+static MultiVoiceFilterTest multiVoiceFilterTest;
+
+} // namespace dsp
+} // namespace juce
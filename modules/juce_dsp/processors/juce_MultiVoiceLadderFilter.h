@@ -0,0 +1,264 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 5 End-User License
+   Agreement and JUCE 5 Privacy Policy (both updated and effective as of the
+   27th April 2017).
+
+   End User License Agreement: www.juce.com/juce-5-licence
+   Privacy Policy: www.juce.com/juce-5-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+/**
+    A bank of Moog-style ladder filters processing several voices at once, each voice
+    in its own lane of a SIMDRegister, and each with its own cutoff and resonance.
+
+    This is the multi-voice counterpart of LadderFilter, meant for polyphonic
+    synthesisers with one filter per voice. The cutoff and resonance of every voice
+    can be modulated at audio rate by passing them for each sample. The cutoff
+    coefficients and the saturation are computed with fast approximations of exp()
+    and tanh() on all the voices at once. Unlike LadderFilter, the parameters are
+    not smoothed.
+
+    The SampleType can be float or double, or a SIMDRegister of those, in which case
+    each sample passed to the filter holds one sample of every voice.
+
+    @see LadderFilter
+
+    @tags{DSP}
+*/
+template <typename SampleType>
+class MultiVoiceLadderFilter
+{
+public:
+    //==============================================================================
+    using NumericType = typename SampleTypeHelpers::ElementType<SampleType>::Type;
+    using Mode = typename LadderFilter<NumericType>::Mode;
+
+    /** The number of voices which are processed simultaneously. */
+    static constexpr size_t numVoices = SampleTypeHelpers::Lanes<SampleType>::size;
+
+    //==============================================================================
+    /** Creates a filter bank. Call prepare() before first use. */
+    MultiVoiceLadderFilter()
+    {
+        setSampleRate (NumericType (1000));    // intentionally setting unrealistic default
+                                               // sample rate to catch missing initialisation bugs
+        setResonance (expand (0));
+        setDrive (NumericType (1.2));
+        setMode (Mode::LPF12);
+    }
+
+    /** Sets the filter mode, which is shared by all voices. */
+    void setMode (Mode newValue) noexcept
+    {
+        switch (newValue)
+        {
+            case Mode::LPF12:   A = {{ NumericType (0), NumericType (0),  NumericType (1), NumericType (0),  NumericType (0) }}; comp = NumericType (0.5);  break;
+            case Mode::HPF12:   A = {{ NumericType (1), NumericType (-2), NumericType (1), NumericType (0),  NumericType (0) }}; comp = NumericType (0);    break;
+            case Mode::LPF24:   A = {{ NumericType (0), NumericType (0),  NumericType (0), NumericType (0),  NumericType (1) }}; comp = NumericType (0.5);  break;
+            case Mode::HPF24:   A = {{ NumericType (1), NumericType (-4), NumericType (6), NumericType (-4), NumericType (1) }}; comp = NumericType (0);    break;
+            default:            jassertfalse;                                                                                     break;
+        }
+
+        for (auto& a : A)
+            a *= NumericType (1.2);
+
+        reset();
+    }
+
+    /** Initialises the filter bank. */
+    void prepare (const ProcessSpec& spec)
+    {
+        setSampleRate (NumericType (spec.sampleRate));
+        reset();
+    }
+
+    /** Resets the state of all the voices. */
+    void reset() noexcept
+    {
+        for (auto& s : state)
+            s = expand (0);
+    }
+
+    /** Resets the state of one voice, e.g. when it starts a new note. */
+    void resetVoice (size_t voice) noexcept
+    {
+        jassert (voice < numVoices);
+
+        for (auto& s : state)
+        {
+            alignas (SampleType) NumericType values[numVoices];
+            SampleTypeHelpers::Lanes<SampleType>::copyToRawArray (s, values);
+            values[voice] = 0;
+            s = SampleTypeHelpers::Lanes<SampleType>::fromRawArray (values);
+        }
+    }
+
+    /** Sets the cutoff frequency of each voice, in Hz. */
+    void setCutoffFrequencyHz (SampleType frequency) noexcept
+    {
+        voiceCutoffs = frequency;
+        cutoffTransform = FastMathApproximations::exp (jmin (jmax (frequency, expand (0)), expand (maxFrequency)) * cutoffFreqScaler);
+    }
+
+    /** Sets the resonance of each voice.
+        The values must be between 0 and 1; higher values increase the resonance and can
+        result in self oscillation!
+    */
+    void setResonance (SampleType newResonance) noexcept
+    {
+        scaledResonance = newResonance * NumericType (0.9) + NumericType (0.1);
+    }
+
+    /** Sets the amount of saturation, which is shared by all voices.
+        It can be any number greater than or equal to one.
+    */
+    void setDrive (NumericType newValue) noexcept
+    {
+        jassert (newValue >= NumericType (1));
+
+        drive  = newValue;
+        gain   = std::pow (drive,  NumericType (-2.642)) * NumericType (0.6103) + NumericType (0.3903);
+        drive2 = drive * NumericType (0.04) + NumericType (0.96);
+        gain2  = std::pow (drive2, NumericType (-2.642)) * NumericType (0.6103) + NumericType (0.3903);
+    }
+
+    //==============================================================================
+    /** Processes one sample of every voice with the current parameters. */
+    SampleType JUCE_VECTOR_CALLTYPE processSample (SampleType input) noexcept
+    {
+        auto& s = state;
+
+        const auto a1 = cutoffTransform;
+        const auto g  = expand (1) - a1;
+        const auto b0 = g * NumericType (0.76923076923);
+        const auto b1 = g * NumericType (0.23076923076);
+
+        const auto dx = saturate (input * drive) * gain;
+        const auto a = dx + scaledResonance * NumericType (-4) * (saturate (s[4] * drive2) * gain2 - dx * comp);
+
+        const auto b = b1 * s[0] + a1 * s[1] + b0 * a;
+        const auto c = b1 * s[1] + a1 * s[2] + b0 * b;
+        const auto d = b1 * s[2] + a1 * s[3] + b0 * c;
+        const auto e = b1 * s[3] + a1 * s[4] + b0 * d;
+
+        s[0] = a;
+        s[1] = b;
+        s[2] = c;
+        s[3] = d;
+        s[4] = e;
+
+        return a * A[0] + b * A[1] + c * A[2] + d * A[3] + e * A[4];
+    }
+
+    /** Updates the cutoff and resonance of every voice, then processes one sample. */
+    SampleType JUCE_VECTOR_CALLTYPE processSample (SampleType input, SampleType cutoffFrequencyHz, SampleType resonance) noexcept
+    {
+        setCutoffFrequencyHz (cutoffFrequencyHz);
+        setResonance (resonance);
+        return processSample (input);
+    }
+
+    /** Processes a block of samples with audio-rate modulation of the cutoff
+        frequencies and resonances, which must contain numSamples values each.
+        The input and output may point to the same data.
+    */
+    void process (const SampleType* input, SampleType* output,
+                  const SampleType* cutoffFrequenciesHz, const SampleType* resonances,
+                  size_t numSamples) noexcept
+    {
+        for (size_t i = 0; i < numSamples; ++i)
+            output[i] = processSample (input[i], cutoffFrequenciesHz[i], resonances[i]);
+
+        snapToZero();
+    }
+
+    /** Processes a mono block of samples with the current parameters. */
+    template <typename ProcessContext>
+    void process (const ProcessContext& context) noexcept
+    {
+        auto&& inputBlock  = context.getInputBlock();
+        auto&& outputBlock = context.getOutputBlock();
+
+        // The voices are in the lanes of each sample, so the blocks must be mono
+        jassert (inputBlock.getNumChannels()  == 1);
+        jassert (outputBlock.getNumChannels() == 1);
+
+        if (context.isBypassed)
+        {
+            outputBlock.copy (inputBlock);
+            return;
+        }
+
+        auto n = inputBlock.getNumSamples();
+        auto* src = inputBlock .getChannelPointer (0);
+        auto* dst = outputBlock.getChannelPointer (0);
+
+        for (size_t i = 0; i < n; ++i)
+            dst[i] = processSample (src[i]);
+
+        snapToZero();
+    }
+
+private:
+    //==============================================================================
+    static SampleType expand (NumericType value) noexcept    { return SampleTypeHelpers::Lanes<SampleType>::expand (value); }
+
+    // The tanh() approximation is accurate enough within the same range as
+    // LadderFilter's lookup table, and works on all the voices at once
+    static SampleType JUCE_VECTOR_CALLTYPE saturate (SampleType x) noexcept
+    {
+        return FastMathApproximations::tanh (jmin (jmax (x, expand (-5)), expand (5)));
+    }
+
+    void snapToZero() noexcept
+    {
+        for (auto& s : state)
+            util::snapToZero (s);
+    }
+
+    void setSampleRate (NumericType newValue) noexcept
+    {
+        jassert (newValue > NumericType (0));
+        cutoffFreqScaler = NumericType (-2.0 * MathConstants<double>::pi) / newValue;
+        maxFrequency = newValue * NumericType (0.5);
+
+        setCutoffFrequencyHz (voiceCutoffs);
+    }
+
+    //==============================================================================
+    static constexpr size_t numStates = 5;
+    std::array<SampleType, numStates> state;
+    std::array<NumericType, numStates> A;
+
+    SampleType voiceCutoffs = expand (200), cutoffTransform, scaledResonance;
+    NumericType drive, drive2, gain, gain2, comp;
+    NumericType cutoffFreqScaler, maxFrequency;
+
+    //==============================================================================
+    JUCE_LEAK_DETECTOR (MultiVoiceLadderFilter)
+};
+
+} // namespace dsp
+} // namespace juce
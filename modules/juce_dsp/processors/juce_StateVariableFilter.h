@@ -232,6 +232,200 @@ namespace StateVariableFilter
         NumericType R2  = static_cast<NumericType> (MathConstants<double>::sqrt2);
         NumericType h   = static_cast<NumericType> (1.0 / (1.0 + R2 * g + g * g));
     };
+
+    //==============================================================================
+    /**
+        A bank of state variable filters processing several voices at once, each voice
+        in its own lane of a SIMDRegister, and each with its own cutoff and resonance.
+
+        This is meant for polyphonic synthesisers with one filter per voice. The filter
+        structure is the same as in the Filter class, but the coefficients are stored
+        per lane and are computed with a fast approximation of tan(), so that they can
+        be modulated at audio rate by passing a cutoff and resonance for each sample.
+
+        The SampleType can be float or double, or a SIMDRegister of those, in which case
+        each sample passed to the filter holds one sample of every voice.
+
+        @tags{DSP}
+    */
+    template <typename SampleType>
+    class MultiVoiceFilter
+    {
+    public:
+        //==============================================================================
+        using NumericType = typename SampleTypeHelpers::ElementType<SampleType>::Type;
+        using Type = typename Parameters<NumericType>::Type;
+
+        /** The number of voices which are processed simultaneously. */
+        static constexpr size_t numVoices = SampleTypeHelpers::Lanes<SampleType>::size;
+
+        //==============================================================================
+        /** Creates a low-pass filter bank with default parameters. */
+        MultiVoiceFilter()                                  { setCutoffFrequency (expand (200), expand (defaultResonance())); reset(); }
+
+        //==============================================================================
+        /** Initialization of the filter bank. */
+        void prepare (const ProcessSpec& spec) noexcept
+        {
+            jassert (spec.sampleRate > 0);
+            frequencyScaler = static_cast<NumericType> (MathConstants<double>::pi / spec.sampleRate);
+            maxFrequency    = static_cast<NumericType> (spec.sampleRate * 0.45);
+
+            setCutoffFrequency (voiceCutoffs, voiceResonances);
+            reset();
+        }
+
+        /** Resets the state of all the voices. */
+        void reset() noexcept                               { s1 = s2 = expand (0); }
+
+        /** Resets the state of one voice, e.g. when it starts a new note. */
+        void resetVoice (size_t voice) noexcept
+        {
+            jassert (voice < numVoices);
+            setLane (s1, voice, 0);
+            setLane (s2, voice, 0);
+        }
+
+        /** Rounds the state variables to zero if they are denormals. */
+        void snapToZero() noexcept                          { util::snapToZero (s1); util::snapToZero (s2); }
+
+        //==============================================================================
+        /** Sets the type of the filters, which is shared by all voices. */
+        void setType (Type newType) noexcept                { type = newType; }
+
+        /** Returns the type of the filters. */
+        Type getType() const noexcept                       { return type; }
+
+        /** Sets the cutoff frequency and resonance of each voice.
+
+            Frequencies are clipped below 45% of the sample rate, which keeps the tan()
+            approximation accurate. The resonances must be greater than zero, and a
+            resonance of 1 / sqrt (2) gives a standard 12 dB/octave response.
+        */
+        void setCutoffFrequency (SampleType frequency, SampleType resonance) noexcept
+        {
+            jassert (allLanesArePositive (resonance));
+            updateCoefficients (frequency, resonance);
+        }
+
+        //==============================================================================
+        /** Processes one sample of every voice with the current coefficients. */
+        SampleType JUCE_VECTOR_CALLTYPE processSample (SampleType input) noexcept
+        {
+            auto yHP = (input - s1 * (R2 + g) - s2) * h;
+
+            auto yBP = yHP * g + s1;
+            s1       = yHP * g + yBP;
+
+            auto yLP = yBP * g + s2;
+            s2       = yBP * g + yLP;
+
+            switch (type)
+            {
+                case Type::lowPass:   return yLP;
+                case Type::bandPass:  return yBP;
+                case Type::highPass:  return yHP;
+                default:              jassertfalse; break;
+            }
+
+            return yLP;
+        }
+
+        /** Updates the coefficients of every voice, then processes one sample.
+            The resonances must be greater than zero, as for setCutoffFrequency().
+        */
+        SampleType JUCE_VECTOR_CALLTYPE processSample (SampleType input, SampleType cutoffFrequency, SampleType resonance) noexcept
+        {
+            updateCoefficients (cutoffFrequency, resonance);
+            return processSample (input);
+        }
+
+        /** Processes a block of samples with audio-rate modulation of the cutoff
+            frequencies and resonances, which must contain numSamples values each.
+            The resonances must be greater than zero. The input and output may point
+            to the same data.
+        */
+        void process (const SampleType* input, SampleType* output,
+                      const SampleType* cutoffFrequencies, const SampleType* resonances,
+                      size_t numSamples) noexcept
+        {
+            for (size_t i = 0; i < numSamples; ++i)
+                output[i] = processSample (input[i], cutoffFrequencies[i], resonances[i]);
+
+            snapToZero();
+        }
+
+        /** Processes a mono block of samples with the current coefficients. */
+        template <typename ProcessContext>
+        void process (const ProcessContext& context) noexcept
+        {
+            static_assert (std::is_same<typename ProcessContext::SampleType, SampleType>::value,
+                           "The sample-type of the filter must match the sample-type supplied to this process callback");
+
+            auto&& inputBlock  = context.getInputBlock();
+            auto&& outputBlock = context.getOutputBlock();
+
+            // The voices are in the lanes of each sample, so the blocks must be mono
+            jassert (inputBlock.getNumChannels()  == 1);
+            jassert (outputBlock.getNumChannels() == 1);
+
+            if (context.isBypassed)
+            {
+                outputBlock.copy (inputBlock);
+                return;
+            }
+
+            auto n = inputBlock.getNumSamples();
+            auto* src = inputBlock .getChannelPointer (0);
+            auto* dst = outputBlock.getChannelPointer (0);
+
+            for (size_t i = 0; i < n; ++i)
+                dst[i] = processSample (src[i]);
+
+            snapToZero();
+        }
+
+    private:
+        //==============================================================================
+        static SampleType expand (NumericType value) noexcept   { return SampleTypeHelpers::Lanes<SampleType>::expand (value); }
+        static NumericType defaultResonance() noexcept           { return static_cast<NumericType> (1.0 / MathConstants<double>::sqrt2); }
+
+        // The coefficients are computed on all the lanes at once, so that modulating
+        // them at audio rate stays vectorised
+        void updateCoefficients (SampleType frequency, SampleType resonance) noexcept
+        {
+            voiceCutoffs = frequency;
+            voiceResonances = resonance;
+
+            g  = FastMathApproximations::tan (jmin (jmax (frequency, expand (0)), expand (maxFrequency)) * frequencyScaler);
+            R2 = expand (1) / resonance;
+            h  = expand (1) / (g * (R2 + g) + NumericType (1));
+        }
+
+        static bool allLanesArePositive (SampleType sample) noexcept
+        {
+            alignas (SampleType) NumericType values[numVoices];
+            SampleTypeHelpers::Lanes<SampleType>::copyToRawArray (sample, values);
+            return std::all_of (values, values + numVoices, [] (NumericType v) { return v > 0; });
+        }
+
+        static void setLane (SampleType& sample, size_t lane, NumericType value) noexcept
+        {
+            alignas (SampleType) NumericType values[numVoices];
+            SampleTypeHelpers::Lanes<SampleType>::copyToRawArray (sample, values);
+            values[lane] = value;
+            sample = SampleTypeHelpers::Lanes<SampleType>::fromRawArray (values);
+        }
+
+        //==============================================================================
+        SampleType voiceCutoffs, voiceResonances, g, R2, h, s1, s2;
+        NumericType frequencyScaler = static_cast<NumericType> (MathConstants<double>::pi / 44100.0);
+        NumericType maxFrequency = static_cast<NumericType> (44100.0 * 0.45);
+        Type type = Type::lowPass;
+
+        //==============================================================================
+        JUCE_LEAK_DETECTOR (MultiVoiceFilter)
+    };
 }
 
 } // namespace dsp
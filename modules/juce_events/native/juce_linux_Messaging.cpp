@@ -62,6 +62,8 @@ public:
 
     ~InternalMessageQueue()
     {
+        while (popNextMessage (-1) != nullptr) {}
+
         close (getReadHandle());
         close (getWriteHandle());
 
@@ -71,19 +73,28 @@ public:
     //==============================================================================
     void postMessage (MessageManager::MessageBase* const msg) noexcept
     {
-        ScopedLock sl (lock);
-        queue.add (msg);
+        msg->incReferenceCount();
+
+        // once the queue has overflowed, everything goes into the overflow list until
+        // it's been emptied, so that messages from each thread stay in order
+        if (numOverflowMessages.load() > 0 || ! pendingMessages.push (msg))
+        {
+            const ScopedLock sl (overflowLock);
+            overflow.add (msg);
+            ++numOverflowMessages;
+        }
 
         const int maxBytesInSocketQueue = 128;
 
-        if (bytesInSocket < maxBytesInSocketQueue)
+        for (auto numBytes = bytesInSocket.load(); numBytes < maxBytesInSocketQueue;)
         {
-            bytesInSocket++;
-
-            ScopedUnlock ul (lock);
-            const unsigned char x = 0xff;
-            ssize_t bytesWritten = write (getWriteHandle(), &x, 1);
-            ignoreUnused (bytesWritten);
+            if (bytesInSocket.compare_exchange_weak (numBytes, numBytes + 1))
+            {
+                const unsigned char x = 0xff;
+                ssize_t bytesWritten = write (getWriteHandle(), &x, 1);
+                ignoreUnused (bytesWritten);
+                break;
+            }
         }
     }
 
@@ -136,32 +147,53 @@ public:
 
 private:
     CriticalSection lock;
-    ReferenceCountedArray <MessageManager::MessageBase> queue;
+    MPMCQueue<MessageManager::MessageBase*> pendingMessages { 4096 };
+    CriticalSection overflowLock;
+    Array<MessageManager::MessageBase*> overflow;
+    std::atomic<int> numOverflowMessages { 0 };
     int fd[2];
     pollfd pfds[FD_COUNT];
     std::unique_ptr<LinuxEventLoop::CallbackFunctionBase> readCallback[FD_COUNT];
     int fdCount = 1;
     int loopCount = 0;
-    int bytesInSocket = 0;
+    std::atomic<int> bytesInSocket { 0 };
 
     int getWriteHandle() const noexcept     { return fd[0]; }
     int getReadHandle() const noexcept      { return fd[1]; }
 
     MessageManager::MessageBase::Ptr popNextMessage (int _fd) noexcept
     {
-        const ScopedLock sl (lock);
+        for (auto numBytes = bytesInSocket.load(); numBytes > 0 && _fd >= 0;)
+        {
+            if (bytesInSocket.compare_exchange_weak (numBytes, numBytes - 1))
+            {
+                unsigned char x;
+                ssize_t numBytesRead = read (_fd, &x, 1);
+                ignoreUnused (numBytesRead);
+                break;
+            }
+        }
+
+        MessageManager::MessageBase* msg = nullptr;
 
-        if (bytesInSocket > 0)
+        if (! pendingMessages.pop (msg) && numOverflowMessages.load() > 0)
         {
-            --bytesInSocket;
+            const ScopedLock sl (overflowLock);
 
-            const ScopedUnlock ul (lock);
-            unsigned char x;
-            ssize_t numBytes = read (_fd, &x, 1);
-            ignoreUnused (numBytes);
+            if (! overflow.isEmpty())
+            {
+                msg = overflow.removeAndReturn (0);
+                --numOverflowMessages;
+            }
         }
 
-        return queue.removeAndReturn (0);
+        // takes over the reference that was added by postMessage()
+        MessageManager::MessageBase::Ptr result (msg);
+
+        if (msg != nullptr)
+            msg->decReferenceCountWithoutDeleting();
+
+        return result;
     }
 };
 